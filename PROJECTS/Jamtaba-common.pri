@@ -45,8 +45,12 @@ PRECOMPILED_HEADER += PreCompiledHeaders.h
 
 HEADERS += midi/MidiDriver.h
 HEADERS += midi/MidiMessage.h
+HEADERS += midi/MidiBuffer.h
 HEADERS += looper/Looper.h
 HEADERS += looper/LooperLayer.h
+HEADERS += looper/PeaksPyramid.h
+HEADERS += looper/LayersMixer.h
+HEADERS += looper/CompactSamples.h
 HEADERS += looper/LooperStates.h
 HEADERS += looper/LooperPersistence.h
 HEADERS += audio/core/AudioDriver.h
@@ -56,23 +60,32 @@ HEADERS += audio/core/LocalInputGroup.h
 HEADERS += audio/core/AudioNodeProcessor.h
 HEADERS += audio/core/AudioMixer.h
 HEADERS += audio/core/SamplesBuffer.h
+HEADERS += audio/core/SamplesRingBuffer.h
+HEADERS += audio/core/PeaksTelemetry.h
+HEADERS += audio/core/AudioLoadMonitor.h
 HEADERS += audio/core/AudioPeak.h
 HEADERS += audio/core/Plugins.h
 HEADERS += audio/core/Filters.h
+HEADERS += audio/core/NativeEffects.h
+HEADERS += audio/core/NativePlugins.h
 HEADERS += audio/core/PluginDescriptor.h
 HEADERS += audio/Encoder.h
 HEADERS += audio/vorbis/VorbisDecoder.h
 HEADERS += audio/vorbis/VorbisEncoder.h
 HEADERS += audio/RoomStreamerNode.h
+HEADERS += audio/RoomStreamsPrefetcher.h
 HEADERS += audio/NinjamTrackNode.h
 HEADERS += audio/MetronomeTrackNode.h
+HEADERS += audio/MetronomeSoundBank.h
 HEADERS += audio/SamplesBufferResampler.h
 HEADERS += audio/SamplesBufferRecorder.h
 HEADERS += audio/Mp3Decoder.h
 HEADERS += audio/Resampler.h
 HEADERS += video/FFMpegMuxer.h
 HEADERS += video/FFMpegDemuxer.h
+HEADERS += video/RemoteVideoStream.h
 HEADERS += video/VideoFrameGrabber.h
+HEADERS += video/VideoCapturePipeline.h
 HEADERS += video/VideoWidget.h
 HEADERS += file/FileReader.h
 HEADERS += file/FileReaderFactory.h
@@ -113,6 +126,7 @@ HEADERS += gui/BusyDialog.h
 HEADERS += gui/chat/ChatPanel.h
 HEADERS += gui/chat/ChatMessagePanel.h
 HEADERS += gui/chat/NinjamChatMessageParser.h
+HEADERS += gui/chat/KeywordMatcher.h
 HEADERS += gui/chat/ChatTextEditor.h
 HEADERS += gui/chat/EmojiWidget.h
 HEADERS += gui/chat/EmojiManager.h
@@ -134,6 +148,7 @@ HEADERS += gui/widgets/PeakMeter.h
 HEADERS += gui/widgets/WavePeakPanel.h
 HEADERS += gui/widgets/UserNameLineEdit.h
 HEADERS += gui/widgets/MapWidget.h
+HEADERS += gui/widgets/MapTilesCache.h
 HEADERS += gui/widgets/MapMarker.h
 HEADERS += gui/widgets/MultiStateButton.h
 HEADERS += gui/widgets/BlinkableButton.h
@@ -163,6 +178,7 @@ HEADERS += persistence/Settings.h
 HEADERS += persistence/UsersDataCache.h
 HEADERS += persistence/CacheHeader.h
 HEADERS += log/Logging.h
+HEADERS += log/StartupTimeline.h
 HEADERS += UploadIntervalData.h
 HEADERS += performance/PerformanceMonitor.h
 HEADERS += upnp/UPnPManager.h
@@ -172,8 +188,12 @@ SOURCES += NinjamController.cpp
 SOURCES += MetronomeUtils.cpp
 SOURCES += midi/MidiDriver.cpp
 SOURCES += midi/MidiMessage.cpp
+SOURCES += midi/MidiBuffer.cpp
 SOURCES += looper/Looper.cpp
 SOURCES += looper/LooperLayer.cpp
+SOURCES += looper/PeaksPyramid.cpp
+SOURCES += looper/LayersMixer.cpp
+SOURCES += looper/CompactSamples.cpp
 SOURCES += looper/LooperStates.cpp
 SOURCES += file/WaveFileWriter.cpp
 SOURCES += looper/LooperPersistence.cpp
@@ -185,11 +205,18 @@ SOURCES += audio/core/AudioNodeProcessor.cpp
 SOURCES += audio/core/AudioMixer.cpp
 SOURCES += audio/core/Filters.cpp
 SOURCES += audio/RoomStreamerNode.cpp
+SOURCES += audio/RoomStreamsPrefetcher.cpp
 SOURCES += audio/core/Plugins.cpp
+SOURCES += audio/core/NativeEffects.cpp
+SOURCES += audio/core/NativePlugins.cpp
 SOURCES += audio/Mp3Decoder.cpp
 SOURCES += audio/NinjamTrackNode.cpp
 SOURCES += audio/MetronomeTrackNode.cpp
+SOURCES += audio/MetronomeSoundBank.cpp
 SOURCES += audio/core/SamplesBuffer.cpp
+SOURCES += audio/core/SamplesRingBuffer.cpp
+SOURCES += audio/core/PeaksTelemetry.cpp
+SOURCES += audio/core/AudioLoadMonitor.cpp
 SOURCES += audio/core/PluginDescriptor.cpp
 SOURCES += audio/SamplesBufferResampler.cpp
 SOURCES += audio/vorbis/VorbisDecoder.cpp
@@ -198,7 +225,9 @@ SOURCES += audio/core/AudioPeak.cpp
 SOURCES += audio/Resampler.cpp
 SOURCES += video/FFMpegMuxer.cpp
 SOURCES += video/FFMpegDemuxer.cpp
+SOURCES += video/RemoteVideoStream.cpp
 SOURCES += video/VideoFrameGrabber.cpp
+SOURCES += video/VideoCapturePipeline.cpp
 SOURCES += video/VideoWidget.cpp
 SOURCES += file/FileReaderFactory.cpp
 SOURCES += file/WaveFileReader.cpp
@@ -242,6 +271,7 @@ SOURCES += gui/chat/ChatTextEditor.cpp
 SOURCES += gui/chat/EmojiWidget.cpp
 SOURCES += gui/chat/EmojiManager.cpp
 SOURCES += gui/chat/NinjamChatMessageParser.cpp
+SOURCES += gui/chat/KeywordMatcher.cpp
 win32:SOURCES += gui/screensaver/WindowsScreensaverBlocker.cpp
 linux:SOURCES += gui/screensaver/LinuxScreensaverBlocker.cpp
 OBJECTIVE_SOURCES += gui/screensaver/MacScreensaverBlocker.mm
@@ -265,6 +295,7 @@ SOURCES += gui/widgets/IntervalChunksDisplay.cpp
 SOURCES += gui/widgets/MarqueeLabel.cpp
 SOURCES += gui/widgets/MapMarker.cpp
 SOURCES += gui/widgets/MapWidget.cpp
+SOURCES += gui/widgets/MapTilesCache.cpp
 SOURCES += gui/widgets/MultiStateButton.cpp
 SOURCES += gui/widgets/BlinkableButton.cpp
 SOURCES += gui/widgets/BoostSpinBox.cpp
@@ -283,6 +314,7 @@ SOURCES += gui/GuiUtils.cpp
 SOURCES += gui/ThemeLoader.cpp
 SOURCES += geo/IpToLocationResolver.cpp
 SOURCES += log/logging.cpp
+SOURCES += log/StartupTimeline.cpp
 SOURCES += geo/WebIpToLocationResolver.cpp
 SOURCES += loginserver/LoginService.cpp
 SOURCES += loginserver/MainChat.cpp
@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 
 SUBDIRS += VstScanner
+SUBDIRS += VstSandbox
 
 mac {
     SUBDIRS += AUScanner
@@ -37,6 +37,9 @@ HEADERS += vst/VstHost.h
 HEADERS += vst/VstLoader.h
 HEADERS += PluginFinder.h
 HEADERS += vst/VstPluginFinder.h
+HEADERS += vst/VstScanDatabase.h
+HEADERS += vst/SandboxedVstPlugin.h
+HEADERS += audio/PluginSandboxChannel.h
 HEADERS += vst/Utils.h
 HEADERS += Libs/SingleApplication/singleapplication.h
 HEADERS += Libs/RtMidi/RtMidi.h
@@ -60,6 +63,9 @@ SOURCES += vst/VstPlugin.cpp
 SOURCES += vst/VstHost.cpp
 SOURCES += PluginFinder.cpp
 SOURCES += vst/VstPluginFinder.cpp
+SOURCES += vst/VstScanDatabase.cpp
+SOURCES += vst/SandboxedVstPlugin.cpp
+SOURCES += audio/PluginSandboxChannel.cpp
 SOURCES += vst/Utils.cpp
 SOURCES += vst/VstLoader.cpp
 SOURCES += Libs/SingleApplication/singleapplication.cpp
@@ -95,6 +101,15 @@ macx{
 linux{
     SOURCES += audio/LinuxPortAudioDriver.cpp
     SOURCES += vst/LinuxVstPluginChecker.cpp
+
+    # the native JACK driver is compiled only when the JACK development files are installed
+    packagesExist(jack) {
+        CONFIG += link_pkgconfig
+        PKGCONFIG += jack
+        DEFINES += JAMTABA_JACK
+        HEADERS += audio/JackAudioDriver.h
+        SOURCES += audio/JackAudioDriver.cpp
+    }
 }
 
 
@@ -48,6 +48,7 @@ SOURCES += vst/VstLoader.cpp
 SOURCES += vst/Utils.cpp
 SOURCES += audio/core/PluginDescriptor.cpp
 SOURCES += midi/MidiMessage.cpp
+SOURCES += midi/MidiBuffer.cpp
 SOURCES += log/logging.cpp
 
 
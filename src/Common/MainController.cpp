@@ -11,7 +11,9 @@
 #include "audio/core/AudioNode.h"
 #include "audio/core/LocalInputNode.h"
 #include "audio/core/LocalInputGroup.h"
+#include "audio/core/Plugins.h"
 #include "audio/RoomStreamerNode.h"
+#include "audio/RoomStreamsPrefetcher.h"
 #include "ninjam/client/Service.h"
 #include "recorder/JamRecorder.h"
 #include "recorder/ReaperProjectGenerator.h"
@@ -26,6 +28,8 @@
 #include <QDateTime>
 #include <QSize>
 
+#include <algorithm>
+
 using ninjam::client::Service;
 using ninjam::client::ServerInfo;
 using persistence::Settings;
@@ -37,6 +41,9 @@ const QSize MainController::MAX_VIDEO_SIZE(320, 240); // max video resolution in
 
 const QString MainController::CRASH_FLAG_STRING = "JamTaba closed without crash :)";
 
+const int MainController::AUDIO_LOAD_REPORT_PERIOD = 1000;
+const int MainController::AUDIO_LOAD_LOG_PERIOD = 30; // logging the audio load every 30 seconds
+
 // ++++++++++++++++++++++++++++++++++++++++++++++
 
 MainController::MainController(const Settings &settings) :
@@ -47,14 +54,18 @@ MainController::MainController(const Settings &settings) :
     mainWindow(nullptr),
     mutex(QMutex::Recursive),
     videoEncoder(),
+    videoCapturePipeline(&videoEncoder, CAMERA_FPS),
     currentStreamingRoomID(-1000),
     started(false),
     ipToLocationResolver(nullptr),
     masterGain(1),
+    masterPeaksSlot(peaksTelemetry.acquireSlot()),
     usersDataCache(Configurator::getInstance()->getCacheDir()),
+    metronomeSoundBank(Configurator::getInstance()->getCacheDir()),
     lastInputTrackID(0),
-    lastFrameTimeStamp(0),
-    emojiManager(":/emoji/emoji.json", ":/emoji/icons")
+    emojiManager(":/emoji/emoji.json", ":/emoji/icons", settings.getRecentEmojis()),
+    compactingLoopersLockedLayers(false),
+    audioLoadReportsCount(0)
 {
     QDir cacheDir = Configurator::getInstance()->getCacheDir();
     ipToLocationResolver.reset(new geo::WebIpToLocationResolver(cacheDir));
@@ -67,8 +78,8 @@ MainController::MainController(const Settings &settings) :
 
     connect(&videoEncoder, &FFMpegMuxer::dataEncoded, this, &MainController::enqueueVideoDataToUpload);
 
-    for (auto emojiCode: settings.getRecentEmojis())
-        emojiManager.addRecent(emojiCode);
+    audioLoadTimer.setInterval(AUDIO_LOAD_REPORT_PERIOD);
+    connect(&audioLoadTimer, &QTimer::timeout, this, &MainController::updateAudioLoadReport);
 }
 
 void MainController::setChannelReceiveStatus(const QString &userFullName, quint8 channelIndex, bool receiveChannel)
@@ -213,13 +224,16 @@ void MainController::setupNinjamControllerSignals()
     connect(controller, &NinjamController::startingNewInterval, this, &MainController::handleNewNinjamInterval);
     connect(controller, &NinjamController::currentBpiChanged, this, &MainController::updateBpi);
     connect(controller, &NinjamController::currentBpmChanged, this, &MainController::updateBpm);
-    connect(controller, &NinjamController::startProcessing, this, &MainController::requestCameraFrame);
+    connect(controller, &NinjamController::startProcessing, this, &MainController::updateCameraEncodingStatus);
 }
 
 void MainController::connectInNinjamServer(const ServerInfo &server)
 {
     qCDebug(jtCore) << "connected in ninjam server";
 
+    if (roomStreamsPrefetcher)
+        roomStreamsPrefetcher->stopAll();
+
     stopNinjamController();
 
     auto newNinjamController = createNinjamController();
@@ -268,27 +282,45 @@ void MainController::handleNewNinjamInterval()
     }
 
     if (mainWindow->cameraIsActivated())
-        videoEncoder.startNewInterval();
+        videoCapturePipeline.startNewInterval();
+
+    updateLoopersMemoryUsage();
 }
 
-void MainController::processCapturedFrame(int frameID, const QImage &frame)
+void MainController::updateLoopersMemoryUsage()
 {
-    Q_UNUSED(frameID);
+    quint64 memoryUsage = 0;
+    quint64 uncompactedMemoryUsage = 0;
+    uint compactedLayers = 0;
+    for (auto inputTrack : inputTracks.values()) {
+        auto looper = inputTrack->getLooper();
+        memoryUsage += looper->getMemoryUsage();
+        uncompactedMemoryUsage += looper->getUncompactedMemoryUsage();
+        compactedLayers += looper->getCompactedLayers();
+    }
+
+    // using the uncompacted memory usage to avoid compact/expand layers in each interval
+    const quint64 memoryBudget = static_cast<quint64>(settings.getLooperMemoryBudget()) * 1024 * 1024;
+    const bool compacting = settings.isCompactingLooperLockedLayers() && uncompactedMemoryUsage > memoryBudget;
+
+    if (compacting != compactingLoopersLockedLayers) {
+        compactingLoopersLockedLayers = compacting;
+
+        for (auto inputTrack : inputTracks.values())
+            inputTrack->getLooper()->setCompactingLockedLayers(compacting);
 
-    if (ninjamController && ninjamController->isPreparedForTransmit())
-        videoEncoder.encodeImage(frame); // video encoder will emit a signal when video frame is encoded
+        qCInfo(jtCore) << "Loopers memory usage:" << (memoryUsage / (1024 * 1024)) << "MB,"
+                       << (uncompactedMemoryUsage / (1024 * 1024)) << "MB without compaction,"
+                       << compactedLayers << "compacted layers. Compacting locked layers:" << compacting;
+    }
 }
 
-void MainController::requestCameraFrame(int intervalPosition)
+void MainController::updateCameraEncodingStatus()
 {
-    if (isPlayingInNinjamRoom() && mainWindow->cameraIsActivated()) {
-        bool isFirstPart = intervalPosition == 0;
-        if (isFirstPart || canGrabNewFrameFromCamera()) {
-            static int frameID = 0;
-            processCapturedFrame(frameID++, mainWindow->pickCameraFrame());
-            lastFrameTimeStamp = QDateTime::currentMSecsSinceEpoch();
-        }
-    }
+    // the camera frames are encoded in the video capture pipeline threads, GUI thread is just enabling/disabling the encoding
+    bool encoding = isPlayingInNinjamRoom() && mainWindow->cameraIsActivated() && ninjamController->isPreparedForTransmit();
+
+    videoCapturePipeline.setEncoding(encoding);
 }
 
 uint MainController::getFramesPerInterval() const
@@ -457,6 +489,7 @@ void MainController::removeInputTrackNode(int inputTrackIndex)
         }
 
         inputTracks.remove(inputTrackIndex);
+        peaksTelemetry.releaseSlot(inputTrack->getLooper()->getPeaksTelemetrySlot());
         removeTrack(inputTrackIndex);
     }
 }
@@ -467,6 +500,9 @@ int MainController::addInputTrackNode(audio::LocalInputNode *inputTrackNode)
     inputTracks.insert(inputTrackID, inputTrackNode);
     addTrack(inputTrackID, inputTrackNode);
 
+    inputTrackNode->getLooper()->setCompactingLockedLayers(compactingLoopersLockedLayers);
+    inputTrackNode->getLooper()->setPeaksTelemetry(&peaksTelemetry, acquirePeaksSlot());
+
     int trackGroupIndex = inputTrackNode->getChanneGrouplIndex();
     if (!trackGroups.contains(trackGroupIndex))
         trackGroups.insert(trackGroupIndex, new audio::LocalInputGroup(trackGroupIndex, inputTrackNode));
@@ -498,6 +534,9 @@ bool MainController::addTrack(long trackID, audio::AudioNode *trackNode)
 {
     QMutexLocker locker(&mutex);
 
+    if (trackNode->getPeaksTelemetrySlot() < 0)
+        trackNode->setPeaksTelemetry(&peaksTelemetry, acquirePeaksSlot());
+
     tracksNodes.insert(trackID, trackNode);
     audioMixer.addNode(trackNode);
 
@@ -583,19 +622,28 @@ void MainController::storeMetronomeSettings(float metronomeGain, float metronome
 void MainController::setBuiltInMetronome(const QString &metronomeAlias)
 {
     settings.setBuiltInMetronome(metronomeAlias);
-    recreateMetronome();
+    updateMetronomeSounds();
 }
 
 void MainController::setCustomMetronome(const QString &primaryBeatFile, const QString &offBeatFile, const QString &accentBeatFile)
 {
     settings.setCustomMetronome(primaryBeatFile, offBeatFile, accentBeatFile);
-    recreateMetronome();
+    updateMetronomeSounds();
 }
 
-void MainController::recreateMetronome()
+void MainController::updateMetronomeSounds()
 {
     if (isPlayingInNinjamRoom())
-        ninjamController->recreateMetronome(getSampleRate());
+        ninjamController->updateMetronomeSounds(getSampleRate());
+}
+
+audio::MetronomeSoundsPtr MainController::getMetronomeSounds(int sampleRate)
+{
+    if (settings.isUsingCustomMetronomeSounds())
+        return metronomeSoundBank.getCustomSounds(settings.getMetronomeFirstBeatFile(), settings.getMetronomeOffBeatFile(),
+                                                  settings.getMetronomeAccentBeatFile(), sampleRate);
+
+    return metronomeSoundBank.getBuiltInSounds(settings.getBuiltInMetronome(), sampleRate);
 }
 
 void MainController::storeIntervalProgressShape(int shape)
@@ -625,6 +673,7 @@ void MainController::removeTrack(long trackID)
         trackNode->suspendProcessors();
         audioMixer.removeNode(trackNode);
         tracksNodes.remove(trackID);
+        peaksTelemetry.releaseSlot(trackNode->getPeaksTelemetrySlot()); // the node is not publishing anymore
         delete trackNode;
     }
 }
@@ -635,22 +684,33 @@ void MainController::setAllLoopersStatus(bool activated)
         inputTrack->getLooper()->setActivated(activated);
 }
 
-void MainController::doAudioProcess(const audio::SamplesBuffer &in, audio::SamplesBuffer &out, int sampleRate)
+void MainController::doAudioProcess(const audio::SamplesBuffer &in, audio::SamplesBuffer &out, int sampleRate, int blockOffset)
 {
-    auto incommingMidi = pullMidiMessagesFromDevices();
-    audioMixer.process(in, out, sampleRate, incommingMidi);
+    // only the midi messages scheduled in this part of the block, and using the part start as reference
+    incommingMidiBuffer.clear();
+    devicesMidiBuffer.copyRange(incommingMidiBuffer, blockOffset, out.getFrameLenght());
+
+    audioMixer.process(in, out, sampleRate, incommingMidiBuffer);
 
     out.applyGain(masterGain, 1.0f); // using 1 as boost factor/multiplier (no boost)
-    masterPeak.update(out.computePeak());
+    peaksTelemetry.publish(masterPeaksSlot, out.computePeak());
 }
 
 void MainController::process(const audio::SamplesBuffer &in, audio::SamplesBuffer &out, int sampleRate)
 {
+    const qint64 callbackStart = audio::AudioLoadMonitor::timestamp(); // waiting the mutex is part of the callback time
+
     QMutexLocker locker(&mutex);
 
     if (!started)
         return;
 
+    // timestamped at capture, the messages are scheduled in the block using the capture time
+    const qint64 blockTimestamp = midi::MidiMessage::currentTimestamp();
+    devicesMidiBuffer.clear();
+    pullMidiMessagesFromDevices(devicesMidiBuffer);
+    devicesMidiBuffer.computeDeltaFrames(blockTimestamp, out.getFrameLenght(), sampleRate);
+
     try
     {
         if (!isPlayingInNinjamRoom()) {
@@ -671,6 +731,70 @@ void MainController::process(const audio::SamplesBuffer &in, audio::SamplesBuffe
 
         qFatal("Aborting in  MainController::process!");
     }
+
+    audioLoadMonitor.addCallback(callbackStart, audio::AudioLoadMonitor::timestamp(), out.getFrameLenght(), sampleRate);
+}
+
+void MainController::updateAudioLoadReport()
+{
+    // the nodes CPU time is compared with the real time elapsed since the last report
+    const qint64 elapsedTime = qMax(audioLoadClock.restart() * 1000000, static_cast<qint64>(1));
+
+    audio::AudioLoadReport report;
+    const bool audioIsRunning = audioLoadMonitor.takeStats(report.callbacks);
+
+    audioLoadCounters.resize(0); // keeping the capacity
+    {
+        QMutexLocker locker(&mutex); // tracks can be added and removed by other threads
+        for (auto i = tracksNodes.constBegin(); i != tracksNodes.constEnd(); ++i) {
+            AudioNode *node = i.value();
+
+            TrackLoadCounters counters;
+            counters.trackID = i.key();
+            counters.node = node;
+            counters.elapsed = node->getProcessingTime().takeElapsed(); // taken in all reports, so the next report is not accumulating
+            for (quint32 slot = 0; slot < AudioNode::MAX_PROCESSORS_PER_TRACK; ++slot) {
+                counters.processorsElapsed[slot] = node->getProcessorProcessingTime(slot).takeElapsed();
+                counters.processors[slot] = node->getProcessor(slot);
+            }
+
+            audioLoadCounters.append(counters);
+        }
+    }
+
+    // the nodes are not dereferenced without the mutex, the plugins are removed only in this (GUI) thread
+    for (const TrackLoadCounters &counters : audioLoadCounters) {
+        if (!audioIsRunning)
+            break; // the counters are taken anyway, so the next report is not accumulating
+
+        audio::AudioLoadReport::NodeLoad nodeLoad;
+        nodeLoad.trackID = counters.trackID;
+        nodeLoad.localTrack = false;
+        for (auto inputTrack : inputTracks)
+            nodeLoad.localTrack |= inputTrack == counters.node;
+
+        nodeLoad.load = counters.elapsed * 100.0f / elapsedTime;
+
+        for (quint32 slot = 0; slot < AudioNode::MAX_PROCESSORS_PER_TRACK; ++slot) {
+            auto plugin = dynamic_cast<audio::Plugin *>(counters.processors[slot]);
+            nodeLoad.processorsLoad.append(counters.processorsElapsed[slot] * 100.0f / elapsedTime);
+            nodeLoad.processorsNames.append(plugin ? plugin->getName() : QString());
+        }
+
+        report.nodes.append(nodeLoad);
+    }
+
+    std::sort(report.nodes.begin(), report.nodes.end(), [](const audio::AudioLoadReport::NodeLoad &n1, const audio::AudioLoadReport::NodeLoad &n2) {
+        return n1.load > n2.load;
+    });
+
+    audioLoadReport = report;
+
+    if (++audioLoadReportsCount >= AUDIO_LOAD_LOG_PERIOD) {
+        audioLoadReportsCount = 0;
+        if (!audioLoadReport.isEmpty())
+            qCInfo(jtAudio) << audioLoadReport.toString();
+    }
 }
 
 void MainController::syncWithNinjamIntervalStart(uint intervalLenght)
@@ -679,24 +803,34 @@ void MainController::syncWithNinjamIntervalStart(uint intervalLenght)
         inputTrack->startNewLoopCycle(intervalLenght);
 }
 
-audio::AudioPeak MainController::getTrackPeak(int trackID)
+int MainController::getTrackPeaksSlot(long trackID) const
 {
-    // QMutexLocker locker(&mutex);
+    auto trackNode = tracksNodes.value(trackID);
+    if (!trackNode) {
+        qWarning(jtGUI) << "trackNode not found! ID:" << trackID;
+        return -1;
+    }
 
-    auto trackNode = tracksNodes[trackID];
+    return trackNode->getPeaksTelemetrySlot();
+}
 
-    if (trackNode && !trackNode->isMuted())
-        return trackNode->getLastPeak();
+int MainController::acquirePeaksSlot()
+{
+    const int slotID = peaksTelemetry.acquireSlot();
+    if (slotID < 0)
+        qCWarning(jtCore) << "All" << audio::PeaksTelemetry::MAX_SLOTS << "peaks telemetry slots are used, the new node meter will not be painted!";
 
-    if (!trackNode)
-        qWarning(jtGUI) << "trackNode not found! ID:" << trackID;
+    return slotID;
+}
 
-    return audio::AudioPeak();
+audio::AudioPeak MainController::getTrackPeak(int trackID)
+{
+    return peaksTelemetry.getPeak(getTrackPeaksSlot(trackID)); // muted tracks are publishing ZERO peaks
 }
 
 audio::AudioPeak MainController::getRoomStreamPeak()
 {
-    return roomStreamer->getLastPeak();
+    return peaksTelemetry.getPeak(roomStreamer->getPeaksTelemetrySlot());
 }
 
 void MainController::setTransmitingStatus(int channelID, bool transmiting)
@@ -907,7 +1041,17 @@ void MainController::setAllTracksActivation(bool activated)
 void MainController::playRoomStream(const login::RoomInfo &roomInfo)
 {
     if (roomInfo.hasStream()) {
-        roomStreamer->setStreamPath(roomInfo.getStreamUrl());
+        const QString streamUrl = roomInfo.getStreamUrl();
+
+        // using the prefetched stream (if available) to avoid the buffering time
+        auto ninjamRoomStreamer = qobject_cast<audio::NinjamRoomStreamerNode *>(roomStreamer.data());
+        QByteArray prefetchedBytes;
+        QNetworkReply *prefetchedReply = ninjamRoomStreamer ? roomStreamsPrefetcher->takeStream(streamUrl, prefetchedBytes) : nullptr;
+        if (prefetchedReply)
+            ninjamRoomStreamer->playPrefetchedStream(streamUrl, prefetchedReply, prefetchedBytes);
+        else
+            roomStreamer->setStreamPath(streamUrl);
+
         currentStreamingRoomID = roomInfo.getID();
 
         // mute all tracks and unmute the room Streamer
@@ -930,6 +1074,22 @@ bool MainController::isPlayingRoomStream() const
     return roomStreamer && roomStreamer->isStreaming();
 }
 
+void MainController::setPrefetchedRoomStreams(const QList<login::RoomInfo> &rooms)
+{
+    if (!roomStreamsPrefetcher)
+        return;
+
+    QStringList streamsUrls;
+    if (!isPlayingInNinjamRoom()) { // saving bandwidth when playing in a ninjam server
+        for (const auto &room : rooms) {
+            if (room.hasStream() && !room.isEmpty() && room.getID() != currentStreamingRoomID)
+                streamsUrls.append(room.getStreamUrl());
+        }
+    }
+
+    roomStreamsPrefetcher->setStreamsToPrefetch(streamsUrls);
+}
+
 void MainController::enterInRoom(const login::RoomInfo &room, const QStringList &channelsNames, const QString &password)
 {
     qCDebug(jtCore) << "EnterInRoom slot";
@@ -975,7 +1135,9 @@ void MainController::start()
     if (!started) {
         qCInfo(jtCore) << "Creating roomStreamer ...";
 
+        roomStreamsPrefetcher.reset(new audio::RoomStreamsPrefetcher());
         roomStreamer.reset(new audio::NinjamRoomStreamerNode()); // new Audio::AudioFileStreamerNode(":/teste.mp3");
+        roomStreamer->setPeaksTelemetry(&peaksTelemetry, acquirePeaksSlot());
         this->audioMixer.addNode(roomStreamer.data());
 
         connect(ninjamService.data(), &Service::connectedInServer, this, &MainController::connectInNinjamServer);
@@ -986,6 +1148,10 @@ void MainController::start()
 
         qInfo() << "Starting " + getUserEnvironmentString();
 
+        audioLoadMonitor.reset();
+        audioLoadTimer.start();
+        audioLoadClock.start();
+
         started = true;
     }
 }
@@ -1027,6 +1193,11 @@ void MainController::stop()
 
         started = false;
 
+        audioLoadTimer.stop();
+
+        if (roomStreamsPrefetcher)
+            roomStreamsPrefetcher->stopAll();
+
         qCDebug(jtCore) << "disconnecting from login server...";
         loginService.disconnectFromServer();
     }
@@ -1073,6 +1244,7 @@ void MainController::stopNinjamController()
 
     audioIntervalsToUpload.clear();
 
+    videoCapturePipeline.setEncoding(false);
     videoEncoder.finish(); // release memory used by video encoder
 }
 
@@ -1114,15 +1286,6 @@ audio::LocalInputNode *MainController::getInputTrackInGroup(quint8 groupIndex, q
     return trackGroup->getInputNode(trackIndex);
 }
 
-bool MainController::canGrabNewFrameFromCamera() const
-{
-    static const quint64 timeBetweenFrames = 1000/CAMERA_FPS;
-
-    const quint64 now = QDateTime::currentMSecsSinceEpoch();
-
-    return (now - lastFrameTimeStamp) >= timeBetweenFrames;
-}
-
 QList<recorder::JamRecorder *> MainController::getActiveRecorders() const
 {
     QList<recorder::JamRecorder *> activeRecorders;
@@ -3,6 +3,8 @@
 
 #include <QScopedPointer>
 #include <QImage>
+#include <QTimer>
+#include <QElapsedTimer>
 
 #include "UploadIntervalData.h"
 #include "geo/IpToLocationResolver.h"
@@ -10,8 +12,13 @@
 #include "persistence/Settings.h"
 #include "persistence/UsersDataCache.h"
 #include "audio/core/AudioMixer.h"
+#include "audio/core/PeaksTelemetry.h"
+#include "audio/core/AudioLoadMonitor.h"
+#include "audio/core/AudioNode.h"
+#include "audio/MetronomeSoundBank.h"
 #include "midi/MidiDriver.h"
 #include "video/FFMpegMuxer.h"
+#include "video/VideoCapturePipeline.h"
 #include "gui/chat/EmojiManager.h"
 
 class MainWindow;
@@ -34,6 +41,7 @@ class LocalInputGroup;
 class AudioPeak;
 class SamplesBuffer;
 class AbstractMp3Streamer;
+class RoomStreamsPrefetcher;
 }
 
 namespace recorder {
@@ -94,7 +102,7 @@ public:
 
     MainWindow *getMainWindow() const;
 
-    virtual std::vector<midi::MidiMessage> pullMidiMessagesFromPlugins() = 0;     // pull midi messages generated by plugins. This function can be called many times in each audio processing cicle because every VSTi can be a midi messages generator, and we need get the generated messages after call the plugin 'process' function.
+    virtual void pullMidiMessagesFromPlugins(midi::MidiBuffer &outBuffer) = 0;     // pull midi messages generated by plugins. This function can be called many times in each audio processing cicle because every VSTi can be a midi messages generator, and we need get the generated messages after call the plugin 'process' function.
 
     void saveLastUserSettings(const LocalInputTrackSettings &inputsSettings);
 
@@ -121,6 +129,7 @@ public:
 
     void playRoomStream(const RoomInfo &roomInfo);
     bool isPlayingRoomStream() const;
+    void setPrefetchedRoomStreams(const QList<RoomInfo> &rooms); // rooms visible in the screen
 
     bool isPlayingInNinjamRoom() const;
     virtual void stopNinjamController();
@@ -168,6 +177,12 @@ public:
     void setTrackStereoInversion(int trackID, bool stereoInverted);
     bool trackStereoIsInverted(int trackID) const;
 
+    // the peaks of all tracks are read in one sweep per GUI frame, the track views are caching the tracks peaks slots
+    void readAllPeaks();
+    int getTrackPeaksSlot(long trackID) const;
+    bool getTrackPeakBySlot(int peaksSlot, AudioPeak &peak) const; // return false if the slot is not valid anymore (track removed or recreated)
+    quint32 getTrackClipsBySlot(int peaksSlot) const; // clipped audio blocks since the track node was added
+
     AudioPeak getRoomStreamPeak();
     AudioPeak getTrackPeak(int trackID);
     AudioPeak getMasterPeak();
@@ -178,6 +193,10 @@ public:
 
     AudioNode *getTrackNode(long ID);
 
+    // audio callbacks timing and the load of each track and plugin slot, updated every second (empty when audio is not running)
+    const audio::AudioLoadReport &getAudioLoadReport() const;
+    int getAudioDropouts() const; // late audio callbacks since Jamtaba started
+
     bool isStarted() const;
 
     geo::Location getGeoLocation(const QString &ip);
@@ -238,6 +257,8 @@ public:
     QString getMetronomeOffBeatFile() const;
     QString getMetronomeAccentBeatFile() const;
 
+    audio::MetronomeSoundsPtr getMetronomeSounds(int sampleRate); // the sounds selected in preferences, cached
+
     void saveEncodedAudio(const QString &userName, quint8 channelIndex,
                           const QByteArray &encodedAudio);
 
@@ -282,6 +303,7 @@ public:
     quint8 getLooperPreferedMode() const;
     bool getLooperAudioEncodingFlag() const;
     quint8 getLooperBitDepth() const;
+    void storeLooperMemorySettings(bool compactingLockedLayers, quint32 memoryBudgetInMB);
 
     void setAllLoopersStatus(bool activated);
 
@@ -322,7 +344,7 @@ public slots:
     void blockUserInChat(const QString &userNameToBlock);
     void unblockUserInChat(const QString &userNameToUnblock);
 
-    void processCapturedFrame(int frameID, const QImage &frame);
+    VideoCapturePipeline *getVideoCapturePipeline(); // camera frames are pushed in the pipeline
 
     virtual void connectInNinjamServer(const ServerInfo &server);
 
@@ -334,6 +356,8 @@ protected:
 
     LoginService loginService;
 
+    audio::PeaksTelemetry peaksTelemetry; // declared before audioMixer, the mixer nodes are publishing in telemetry slots
+
     AudioMixer audioMixer;
 
     // ninjam
@@ -354,23 +378,31 @@ protected:
 
     QMutex mutex;
 
+    // midi messages pulled in each audio callback, the deltaFrames are relative to the whole callback block
+    midi::MidiBuffer devicesMidiBuffer;
+    midi::MidiBuffer incommingMidiBuffer; // the messages in the processed part of the callback block
+
     virtual void setupNinjamControllerSignals();
 
     virtual void setCSS(const QString &css) = 0;
 
-    virtual std::vector<midi::MidiMessage> pullMidiMessagesFromDevices() = 0;     // pull midi messages generated by midi controllers. This function is called just one time in each audio processing cicle.
+    virtual void pullMidiMessagesFromDevices(midi::MidiBuffer &outBuffer) = 0;     // pull midi messages generated by midi controllers. This function is called just one time in each audio processing cicle.
 
     // audio process is here too (see MainController::process)
     virtual void doAudioProcess(const SamplesBuffer &in, SamplesBuffer &out,
-                                int sampleRate);
+                                int sampleRate, int blockOffset = 0); // blockOffset: position of 'out' in the whole audio callback block, ninjam controller is processing the block in parts
 
     virtual void syncWithNinjamIntervalStart(uint intervalLenght);
 
+    void resetAudioLoadMonitor(); // called when the audio driver is stopped or started, the restart is not a dropout
+
     FFMpegMuxer videoEncoder;
+    VideoCapturePipeline videoCapturePipeline; // declared after videoEncoder, the pipeline is using the encoder
 
 private:
     void setAllTracksActivation(bool activated);
 
+    QScopedPointer<audio::RoomStreamsPrefetcher> roomStreamsPrefetcher; // declared before roomStreamer because the prefetched replies are owned by prefetcher
     QScopedPointer<AbstractMp3Streamer> roomStreamer;
     long long currentStreamingRoomID;
 
@@ -393,19 +425,17 @@ private:
 
     // master
     float masterGain;
-    AudioPeak masterPeak;
+    int masterPeaksSlot;
 
     UsersDataCache usersDataCache;
 
+    audio::MetronomeSoundBank metronomeSoundBank;
+
     int lastInputTrackID;     // used to generate a unique key/ID for each input track
 
     const static quint8 CAMERA_FPS;
 
-    bool canGrabNewFrameFromCamera() const;
-
-    quint64 lastFrameTimeStamp;
-
-    void recreateMetronome();
+    void updateMetronomeSounds();
 
     uint getFramesPerInterval() const;
 
@@ -415,6 +445,31 @@ private:
 
     QSet<QString> chatBlockedUsers;
 
+    bool compactingLoopersLockedLayers;
+    void updateLoopersMemoryUsage(); // start/stop compacting loopers locked layers using the memory budget
+
+    int acquirePeaksSlot(); // -1 when all telemetry slots are used, the node meters are not painted
+
+    // the tracks load counters, taken holding the audio mutex. The report is built after releasing the mutex.
+    struct TrackLoadCounters
+    {
+        long trackID;
+        AudioNode *node;
+        quint32 elapsed;
+        quint32 processorsElapsed[AudioNode::MAX_PROCESSORS_PER_TRACK];
+        audio::AudioNodeProcessor *processors[AudioNode::MAX_PROCESSORS_PER_TRACK];
+    };
+
+    audio::AudioLoadMonitor audioLoadMonitor;
+    audio::AudioLoadReport audioLoadReport;
+    QVector<TrackLoadCounters> audioLoadCounters; // reused in all reports, not allocating while holding the mutex
+    QTimer audioLoadTimer;
+    QElapsedTimer audioLoadClock;
+    int audioLoadReportsCount;
+
+    static const int AUDIO_LOAD_REPORT_PERIOD; // milliseconds
+    static const int AUDIO_LOAD_LOG_PERIOD; // in reports
+
 protected slots:
 
     // ninjam
@@ -430,7 +485,10 @@ protected slots:
     // TODO move this slot to NinjamController
     virtual void handleNewNinjamInterval();
 
-    void requestCameraFrame(int intervalPosition);
+    void updateCameraEncodingStatus();
+
+private slots:
+    void updateAudioLoadReport();
 
 };
 
@@ -439,6 +497,16 @@ inline MainWindow *MainController::getMainWindow() const
     return mainWindow;
 }
 
+inline const audio::AudioLoadReport &MainController::getAudioLoadReport() const
+{
+    return audioLoadReport;
+}
+
+inline int MainController::getAudioDropouts() const
+{
+    return audioLoadMonitor.getTotalLateCallbacks();
+}
+
 inline void MainController::setLocalChannelsCollapsed(bool collapsed)
 {
     settings.setLocalChannelsCollapsed(collapsed);
@@ -489,6 +557,11 @@ inline bool MainController::userNameWasChoosed() const
     return !settings.getUserName().isEmpty();
 }
 
+inline VideoCapturePipeline *MainController::getVideoCapturePipeline()
+{
+    return &videoCapturePipeline;
+}
+
 inline AbstractMp3Streamer *MainController::getRoomStreamer() const
 {
     return roomStreamer.data();
@@ -551,7 +624,27 @@ inline bool MainController::isStarted() const
 
 inline AudioPeak MainController::getMasterPeak()
 {
-    return masterPeak;
+    return peaksTelemetry.getPeak(masterPeaksSlot);
+}
+
+inline void MainController::readAllPeaks()
+{
+    peaksTelemetry.readAll();
+}
+
+inline void MainController::resetAudioLoadMonitor()
+{
+    audioLoadMonitor.reset();
+}
+
+inline bool MainController::getTrackPeakBySlot(int peaksSlot, AudioPeak &peak) const
+{
+    return peaksTelemetry.getPeak(peaksSlot, peak);
+}
+
+inline quint32 MainController::getTrackClipsBySlot(int peaksSlot) const
+{
+    return peaksTelemetry.getClips(peaksSlot);
 }
 
 inline float MainController::getMasterGain() const
@@ -619,6 +712,12 @@ inline quint8 MainController::getLooperBitDepth() const
     return settings.getLooperBitDepth();
 }
 
+inline void MainController::storeLooperMemorySettings(bool compactingLockedLayers, quint32 memoryBudgetInMB)
+{
+    settings.setCompactingLooperLockedLayers(compactingLockedLayers);
+    settings.setLooperMemoryBudget(memoryBudgetInMB);
+}
+
 inline void MainController::storeLooperPreferredLayerCount(quint8 layersCount)
 {
     settings.setLooperPreferredLayersCount(layersCount);
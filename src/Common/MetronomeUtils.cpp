@@ -3,18 +3,20 @@
 #include "audio/core/SamplesBuffer.h"
 #include "file/FileReaderFactory.h"
 #include "file/FileReader.h"
-#include "audio/Resampler.h"
 #include <QString>
 #include <QFileInfo>
 #include <QFile>
 #include <QDir>
 #include <QDebug>
+#include <QtMath>
+#include <cmath>
 
 using audio::SamplesBuffer;
 using audio::metronomeUtils;
 
 const QString metronomeUtils::DEFAULT_BUILT_IN_METRONOME_ALIAS("Default");
 const QString metronomeUtils::DEFAULT_BUILT_IN_METRONOME_DIR(":/metronome");
+const int metronomeUtils::SINC_HALF_WINDOW = 8;
 
 QList<QString> metronomeUtils::getBuiltInMetronomeAliases()
 {
@@ -159,9 +161,38 @@ void metronomeUtils::createResampledBuffer(const SamplesBuffer &buffer, SamplesB
         outBuffer.setToMono();
     outBuffer.setFrameLenght(finalSize);
 
+    // the clicks are resampled only once and cached (MetronomeSoundBank), so a windowed sinc
+    // interpolation is used instead of the SimpleResampler used in real time
+    const double ratio = (double)finalSampleRate/originalSampleRate;
+    const double cutoff = qMin(1.0, ratio); // low pass when downsampling
+    const double radius = SINC_HALF_WINDOW / cutoff; // in input samples
+    const int inputLenght = buffer.getFrameLenght();
+
     for (int c = 0; c < channels; ++c) {
-        SimpleResampler resampler;
-        resampler.process(buffer.getSamplesArray(c),
-                          buffer.getFrameLenght(), outBuffer.getSamplesArray(c), finalSize);
+        const float *in = buffer.getSamplesArray(c);
+        float *out = outBuffer.getSamplesArray(c);
+        for (int s = 0; s < finalSize; ++s) {
+            const double position = s / ratio;
+            const int first = qMax(0, (int)std::ceil(position - radius));
+            const int last = qMin(inputLenght - 1, (int)std::floor(position + radius));
+            double sum = 0;
+            double weights = 0;
+            for (int i = first; i <= last; ++i) {
+                const double x = (position - i) * cutoff;
+                const double weight = sinc(x) * sinc(x / SINC_HALF_WINDOW); // lanczos window
+                sum += in[i] * weight;
+                weights += weight;
+            }
+            out[s] = weights != 0 ? (float)(sum / weights) : 0.0f;
+        }
     }
 }
+
+double metronomeUtils::sinc(double x)
+{
+    if (x == 0.0)
+        return 1.0;
+
+    const double piX = M_PI * x;
+    return std::sin(piX) / piX;
+}
@@ -31,12 +31,15 @@ private:
     static void createBuffer(const QString &audioFilePath, SamplesBuffer &outBuffer, quint32 localSampleRate);
     static void createResampledBuffer(const SamplesBuffer &buffer, SamplesBuffer &outBuffer, int originalSampleRate, int finalSampleRate);
 
+    static double sinc(double x);
+
     static QString buildMetronomeFileNameFromAlias(const QString &alias, const QString &Beat);
 
     static void createBuiltInSound(const QString &alias, const QString &beat, SamplesBuffer &beatBuffer, quint32 localSampleRate);
 
     static const QString DEFAULT_BUILT_IN_METRONOME_ALIAS;
     static const QString DEFAULT_BUILT_IN_METRONOME_DIR;
+    static const int SINC_HALF_WINDOW; // lanczos kernel size, in zero crossings
 };
 
 }//namespace
@@ -320,7 +320,7 @@ void NinjamController::process(const audio::SamplesBuffer &in, audio::SamplesBuf
         bool isLastPart = intervalPosition + samplesToProcessInThisStep >= samplesInInterval;
         for (NinjamTrackNode *track : trackNodes)
             track->setProcessingLastPartOfInterval(isLastPart); // TODO resampler still need a flag indicating the last part?
-        mainController->doAudioProcess(tempInBuffer, tempOutBuffer, sampleRate);
+        mainController->doAudioProcess(tempInBuffer, tempOutBuffer, sampleRate, offset);
         out.add(tempOutBuffer, offset); // generate audio output
         // ++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
@@ -362,52 +362,13 @@ void NinjamController::process(const audio::SamplesBuffer &in, audio::SamplesBuf
 
 audio::MetronomeTrackNode *NinjamController::createMetronomeTrackNode(int sampleRate)
 {
-    audio::SamplesBuffer firstBeatBuffer(2);
-    audio::SamplesBuffer offBeatBuffer(2);
-    audio::SamplesBuffer accentBeatBuffer(2);
-    if (!(mainController->isUsingCustomMetronomeSounds()))
-    {
-        QString builtInMetronomeAlias = mainController->getSettings().getBuiltInMetronome();
-        audio::metronomeUtils::createBuiltInSounds(builtInMetronomeAlias, firstBeatBuffer,
-                                                   offBeatBuffer, accentBeatBuffer, sampleRate);
-    }
-    else
-    {
-        QString firstBeatAudioFile = mainController->getMetronomeFirstBeatFile();
-        QString offBeatAudioFile = mainController->getMetronomeOffBeatFile();
-        QString accentBeatAudioFile = mainController->getMetronomeOffBeatFile();
-        audio::metronomeUtils::createCustomSounds(firstBeatAudioFile, offBeatAudioFile,
-                                                  accentBeatAudioFile, firstBeatBuffer,
-                                                  offBeatBuffer, accentBeatBuffer, sampleRate);
-    }
-
-    audio::metronomeUtils::removeSilenceInBufferStart(firstBeatBuffer);
-    audio::metronomeUtils::removeSilenceInBufferStart(offBeatBuffer);
-    audio::metronomeUtils::removeSilenceInBufferStart(accentBeatBuffer);
-
-    return new audio::MetronomeTrackNode(firstBeatBuffer, offBeatBuffer, accentBeatBuffer);
+    return new audio::MetronomeTrackNode(mainController->getMetronomeSounds(sampleRate));
 }
 
-void NinjamController::recreateMetronome(int newSampleRate)
+void NinjamController::updateMetronomeSounds(int sampleRate)
 {
-    // remove the old metronome
-    float oldGain = metronomeTrackNode->getGain();
-    float oldPan = metronomeTrackNode->getPan();
-    bool oldMutedStatus = metronomeTrackNode->isMuted();
-    bool oldSoloStatus = metronomeTrackNode->isSoloed();
-    QList<int> oldAccentBeats = metronomeTrackNode->getAccentBeats();
-
-    mainController->removeTrack(METRONOME_TRACK_ID);
-
-    // recreate metronome using the new sample rate
-    this->metronomeTrackNode = createMetronomeTrackNode(newSampleRate);
-    this->metronomeTrackNode->setSamplesPerBeat(getSamplesPerBeat());
-    this->metronomeTrackNode->setGain(oldGain);
-    this->metronomeTrackNode->setPan(oldPan);
-    this->metronomeTrackNode->setMute(oldMutedStatus);
-    this->metronomeTrackNode->setSolo(oldSoloStatus);
-    this->metronomeTrackNode->setAccentBeats(oldAccentBeats);
-    mainController->addTrack(METRONOME_TRACK_ID, this->metronomeTrackNode);
+    // the cached sounds are swapped in the running metronome, gain, pan, mute, etc. are preserved
+    metronomeTrackNode->setSounds(mainController->getMetronomeSounds(sampleRate));
 }
 
 void NinjamController::stop(bool emitDisconnectedSignal)
@@ -924,7 +885,8 @@ void NinjamController::setSampleRate(int newSampleRate)
 
     this->samplesInInterval = computeTotalSamplesInInterval();
 
-    recreateMetronome(newSampleRate);
+    updateMetronomeSounds(newSampleRate);
+    metronomeTrackNode->setSamplesPerBeat(getSamplesPerBeat());
 
     recreateEncoders();
 }
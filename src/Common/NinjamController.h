@@ -75,7 +75,7 @@ public:
 
     bool isPreparedForTransmit() const;
 
-    void recreateMetronome(int newSampleRate);
+    void updateMetronomeSounds(int sampleRate);
 
     bool userIsBot(const QString userName) const;
 
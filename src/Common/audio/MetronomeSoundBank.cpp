@@ -0,0 +1,191 @@
+#include "MetronomeSoundBank.h"
+#include "MetronomeUtils.h"
+#include "log/Logging.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+using audio::MetronomeSoundBank;
+using audio::MetronomeSounds;
+using audio::MetronomeSoundsPtr;
+using audio::SamplesBuffer;
+
+const quint32 MetronomeSoundBank::CACHE_FILE_MAGIC = 0x4a544d43; // JTMC
+const quint32 MetronomeSoundBank::CACHE_FILE_REVISION = 1;
+
+namespace {
+
+const QString CACHE_SUB_DIR("metronome");
+
+const quint32 MAX_CLICK_FRAMES = 10 * 192000; // sanity check when reading the cache files
+
+void writeBuffer(QDataStream &stream, const SamplesBuffer &buffer)
+{
+    stream << static_cast<quint8>(buffer.getChannels());
+    stream << static_cast<quint32>(buffer.getFrameLenght());
+    for (int c = 0; c < buffer.getChannels(); ++c) {
+        const float *samples = buffer.getSamplesArray(c);
+        for (uint s = 0; s < buffer.getFrameLenght(); ++s)
+            stream << samples[s];
+    }
+}
+
+bool readBuffer(QDataStream &stream, SamplesBuffer &buffer)
+{
+    quint8 channels = 0;
+    quint32 frames = 0;
+    stream >> channels >> frames;
+
+    if (stream.status() != QDataStream::Ok || channels < 1 || channels > 2 || frames > MAX_CLICK_FRAMES)
+        return false;
+
+    buffer = SamplesBuffer(channels, frames);
+    for (int c = 0; c < channels; ++c) {
+        float *samples = buffer.getSamplesArray(c);
+        for (uint s = 0; s < frames; ++s)
+            stream >> samples[s];
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+} // namespace
+
+MetronomeSoundBank::MetronomeSoundBank(const QDir &cacheDir) :
+    cacheDir(cacheDir.absoluteFilePath(CACHE_SUB_DIR))
+{
+
+}
+
+MetronomeSoundsPtr MetronomeSoundBank::getBuiltInSounds(const QString &alias, int sampleRate)
+{
+    // built-in sounds are in resources, the Jamtaba version is in the key to invalidate the cache when the sounds are changed
+    const QString key = QString("builtin|%1|%2|%3")
+            .arg(QCoreApplication::applicationVersion())
+            .arg(alias)
+            .arg(sampleRate);
+
+    return getSounds(key, [&](MetronomeSounds &sounds) {
+        metronomeUtils::createBuiltInSounds(alias, sounds.firstBeat, sounds.offBeat, sounds.accentBeat, sampleRate);
+    });
+}
+
+MetronomeSoundsPtr MetronomeSoundBank::getCustomSounds(const QString &firstBeatFile, const QString &offBeatFile,
+                                                     const QString &accentBeatFile, int sampleRate)
+{
+    const QString key = QString("custom|%1|%2|%3|%4")
+            .arg(sampleRate)
+            .arg(getFileKey(firstBeatFile))
+            .arg(getFileKey(offBeatFile))
+            .arg(getFileKey(accentBeatFile));
+
+    return getSounds(key, [&](MetronomeSounds &sounds) {
+        metronomeUtils::createCustomSounds(firstBeatFile, offBeatFile, accentBeatFile,
+                                           sounds.firstBeat, sounds.offBeat, sounds.accentBeat, sampleRate);
+    });
+}
+
+void MetronomeSoundBank::clear()
+{
+    QMutexLocker locker(&mutex);
+
+    sounds.clear(); // the sounds used by metronome nodes are still alive, they are shared
+}
+
+MetronomeSoundsPtr MetronomeSoundBank::getSounds(const QString &key, std::function<void(MetronomeSounds &)> createSounds)
+{
+    QMutexLocker locker(&mutex);
+
+    MetronomeSoundsPtr cachedSounds = sounds.value(key);
+    if (cachedSounds)
+        return cachedSounds;
+
+    QSharedPointer<MetronomeSounds> newSounds(new MetronomeSounds());
+    if (!loadFromDisk(key, *newSounds)) {
+        createSounds(*newSounds); // decoding and resampling
+
+        metronomeUtils::removeSilenceInBufferStart(newSounds->firstBeat);
+        metronomeUtils::removeSilenceInBufferStart(newSounds->offBeat);
+        metronomeUtils::removeSilenceInBufferStart(newSounds->accentBeat);
+
+        saveToDisk(key, *newSounds);
+    }
+
+    sounds.insert(key, newSounds);
+
+    return newSounds;
+}
+
+QString MetronomeSoundBank::getFileKey(const QString &filePath)
+{
+    QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists())
+        return QString(); // default built-in sound will be used
+
+    return QString("%1:%2:%3")
+            .arg(fileInfo.absoluteFilePath())
+            .arg(fileInfo.size())
+            .arg(fileInfo.lastModified().toMSecsSinceEpoch());
+}
+
+QString MetronomeSoundBank::getCacheFilePath(const QString &key) const
+{
+    const QByteArray hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5).toHex();
+
+    return cacheDir.absoluteFilePath(QString::fromLatin1(hash) + ".bin");
+}
+
+bool MetronomeSoundBank::loadFromDisk(const QString &key, MetronomeSounds &sounds) const
+{
+    QFile file(getCacheFilePath(key));
+    if (!file.exists() || !file.open(QFile::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic = 0;
+    quint32 revision = 0;
+    QString fileKey;
+    stream >> magic >> revision >> fileKey;
+
+    if (magic != CACHE_FILE_MAGIC || revision != CACHE_FILE_REVISION || fileKey != key)
+        return false; // old revision or hash collision, the file will be overwritten
+
+    if (!readBuffer(stream, sounds.firstBeat) || !readBuffer(stream, sounds.offBeat) || !readBuffer(stream, sounds.accentBeat)) {
+        qCWarning(jtMetronome) << "Invalid metronome cache file:" << file.fileName();
+        return false;
+    }
+
+    qCDebug(jtMetronome) << "Metronome sounds loaded from cache:" << key;
+
+    return true;
+}
+
+void MetronomeSoundBank::saveToDisk(const QString &key, const MetronomeSounds &sounds) const
+{
+    if (!cacheDir.exists() && !cacheDir.mkpath(".")) {
+        qCWarning(jtMetronome) << "Can't create the metronome cache dir:" << cacheDir.absolutePath();
+        return;
+    }
+
+    QFile file(getCacheFilePath(key));
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qCWarning(jtMetronome) << "Can't write the metronome cache file:" << file.fileName();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    stream << CACHE_FILE_MAGIC << CACHE_FILE_REVISION << key;
+
+    writeBuffer(stream, sounds.firstBeat);
+    writeBuffer(stream, sounds.offBeat);
+    writeBuffer(stream, sounds.accentBeat);
+}
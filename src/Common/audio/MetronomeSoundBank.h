@@ -0,0 +1,75 @@
+#ifndef METRONOME_SOUND_BANK_H
+#define METRONOME_SOUND_BANK_H
+
+#include "audio/core/SamplesBuffer.h"
+
+#include <QDir>
+#include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+
+#include <functional>
+
+namespace audio {
+
+// the decoded and resampled metronome clicks, ready to play in a specific sample rate. Immutable after creation.
+struct MetronomeSounds
+{
+    MetronomeSounds();
+
+    SamplesBuffer firstBeat;
+    SamplesBuffer offBeat;
+    SamplesBuffer accentBeat;
+};
+
+typedef QSharedPointer<const MetronomeSounds> MetronomeSoundsPtr;
+
+/**
+ * Cache of metronome sounds per (sound set, sample rate). The clicks are decoded and resampled
+ * only once, the result is kept in memory and in a disk cache, so changing the sample rate or
+ * the metronome sounds is just a lookup most of the time. Custom sounds are cached using the
+ * file path, size and modification time, so editing a custom sound file invalidates the cache.
+ */
+
+class MetronomeSoundBank
+{
+public:
+    explicit MetronomeSoundBank(const QDir &cacheDir);
+
+    MetronomeSoundsPtr getBuiltInSounds(const QString &alias, int sampleRate);
+
+    MetronomeSoundsPtr getCustomSounds(const QString &firstBeatFile, const QString &offBeatFile,
+                                       const QString &accentBeatFile, int sampleRate);
+
+    void clear(); // discard the sounds cached in memory, the disk cache is preserved
+
+private:
+    MetronomeSoundsPtr getSounds(const QString &key, std::function<void(MetronomeSounds &)> createSounds);
+
+    bool loadFromDisk(const QString &key, MetronomeSounds &sounds) const;
+    void saveToDisk(const QString &key, const MetronomeSounds &sounds) const;
+
+    QString getCacheFilePath(const QString &key) const;
+
+    static QString getFileKey(const QString &filePath);
+
+    QDir cacheDir;
+    QMap<QString, MetronomeSoundsPtr> sounds;
+    QMutex mutex;
+
+    static const quint32 CACHE_FILE_MAGIC;
+    static const quint32 CACHE_FILE_REVISION;
+};
+
+inline MetronomeSounds::MetronomeSounds() :
+    firstBeat(2),
+    offBeat(2),
+    accentBeat(2)
+{
+
+}
+
+} // namespace
+
+#endif
@@ -3,19 +3,24 @@
 #include "audio/core/AudioDriver.h"
 #include "audio/core/SamplesBuffer.h"
 
+#include <QMutexLocker>
+
 using audio::MetronomeTrackNode;
+using audio::MetronomeSounds;
 using audio::SamplesBuffer;
 
-MetronomeTrackNode::MetronomeTrackNode(const SamplesBuffer &firstBeatSamples, const SamplesBuffer &offBeatSamples, const SamplesBuffer &accentBeatSamples) :
-    firstBeatBuffer(firstBeatSamples),
-    offBeatBuffer(offBeatSamples),
-    accentBeatBuffer(accentBeatSamples),
+MetronomeTrackNode::MetronomeTrackNode(const MetronomeSoundsPtr &sounds) :
+    sounds(sounds),
+    activeSounds(sounds.data()),
+    soundsInUse(nullptr),
     samplesPerBeat(0),
     intervalPosition(0),
     beatPosition(0),
     currentBeat(0),
     accentBeats(QList<int>())
 {
+    Q_ASSERT(sounds);
+
     resetInterval();
 }
 
@@ -24,19 +29,43 @@ MetronomeTrackNode::~MetronomeTrackNode()
 
 }
 
-void MetronomeTrackNode::setPrimaryBeatSamples(const SamplesBuffer &firstBeatSamples)
+void MetronomeTrackNode::setSounds(const MetronomeSoundsPtr &newSounds)
 {
-    firstBeatBuffer.set(firstBeatSamples);
+    if (!newSounds)
+        return;
+
+    QMutexLocker locker(&soundsMutex);
+
+    retiredSounds.append(sounds);
+    sounds = newSounds;
+    activeSounds.fetchAndStoreOrdered(newSounds.data());
+
+    releaseRetiredSounds();
 }
 
-void MetronomeTrackNode::setOffBeatSamples(const SamplesBuffer &offBeatSamples)
+void MetronomeTrackNode::releaseRetiredSounds()
 {
-    offBeatBuffer.set(offBeatSamples);
+    const MetronomeSounds *inUse = soundsInUse.loadAcquire();
+
+    for (int i = retiredSounds.size() - 1; i >= 0; --i) {
+        if (retiredSounds.at(i).data() != inUse)
+            retiredSounds.removeAt(i);
+    }
 }
 
-void MetronomeTrackNode::setAccentBeatSamples(const SamplesBuffer &accentBeatSamples)
+const MetronomeSounds *MetronomeTrackNode::acquireSounds()
 {
-    accentBeatBuffer.set(accentBeatSamples);
+    // publish the pointer before using it and check if it was not replaced meanwhile
+    const MetronomeSounds *current = activeSounds.loadAcquire();
+    forever {
+        soundsInUse.fetchAndStoreOrdered(current);
+
+        const MetronomeSounds *check = activeSounds.loadAcquire();
+        if (check == current)
+            return current;
+
+        current = check;
+    }
 }
 
 void MetronomeTrackNode::setAccentBeats(QList<int> accentBeats)
@@ -78,41 +107,84 @@ void MetronomeTrackNode::setIntervalPosition(long intervalPosition)
     this->currentBeat = (intervalPosition / samplesPerBeat);
 }
 
-SamplesBuffer *MetronomeTrackNode::getSamplesBuffer(int beat)
+const SamplesBuffer &MetronomeTrackNode::getSamplesBuffer(const MetronomeSounds &sounds, int beat) const
 {
     if (beat == 0) {
-        return &firstBeatBuffer;
+        return sounds.firstBeat;
     }
     if (this->accentBeats.contains(beat)) {
-        return &accentBeatBuffer;
+        return sounds.accentBeat;
     }
-    return &offBeatBuffer;
+    return sounds.offBeat;
 }
 
+void MetronomeTrackNode::renderClick(const SamplesBuffer &click, uint clickOffset, SamplesBuffer &out, uint outOffset,
+                                     uint frames, float *peaks, float *squaredSums) const
+{
+    const float commonGain = getGain() * getBoost();
+    const int channels = qMin(out.getChannels(), 2);
+    const int clickChannels = click.getChannels();
+
+    for (int c = 0; c < channels; ++c) {
+        const float channelGain = out.isMono() ? commonGain : commonGain * (c == 0 ? leftGain : rightGain);
+        const float *source = click.getSamplesArray(qMin(c, clickChannels - 1)) + clickOffset; // mono clicks are played in both channels
+        float *destination = out.getSamplesArray(c) + outOffset;
+
+        float peak = peaks[c];
+        float squaredSum = squaredSums[c];
+        for (uint s = 0; s < frames; ++s) {
+            const float sample = source[s] * channelGain;
+            destination[s] += sample;
+
+            const float absSample = sample < 0 ? -sample : sample;
+            if (absSample > peak)
+                peak = absSample;
+
+            squaredSum += sample * sample;
+        }
+        peaks[c] = peak;
+        squaredSums[c] = squaredSum;
+    }
+}
+
+/**
+ * The clicks are mixed directly in the output buffer, with gain and pan. The metronome has no
+ * plugins, so the AudioNode pipeline (internal buffers copies, plugins chain, gain in the entire
+ * buffer) is skipped and most of the audio callbacks (between the clicks) are just a peak update.
+ */
+
 void MetronomeTrackNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out,
-                                          int SampleRate, std::vector<midi::MidiMessage> &midiBuffer)
+                                          int sampleRate, midi::MidiBuffer &midiBuffer)
 {
-    if (samplesPerBeat <= 0)
+    Q_UNUSED(in)
+    Q_UNUSED(sampleRate)
+    Q_UNUSED(midiBuffer)
+
+    if (samplesPerBeat <= 0 || !isActivated())
         return;
 
-    internalInputBuffer.setFrameLenght(out.getFrameLenght());
-    internalInputBuffer.zero();
-
-    auto samplesBuffer = getSamplesBuffer(currentBeat);
-    uint samplesToCopy = qMin(static_cast<uint>(samplesBuffer->getFrameLenght() - beatPosition), out.getFrameLenght());
-    int nextBeatSample = beatPosition + out.getFrameLenght();
-    int internalOffset = 0;
-    int samplesBufferOffset = beatPosition;
-    if (nextBeatSample > samplesPerBeat) { // next beat starting in this audio buffer?
-        samplesBuffer = getSamplesBuffer(currentBeat + 1);
-        internalOffset = samplesPerBeat - beatPosition;
-        samplesToCopy = std::min(nextBeatSample - samplesPerBeat,
-                                 (long)samplesBuffer->getFrameLenght());
-        samplesBufferOffset = 0;
+    const MetronomeSounds *currentSounds = acquireSounds();
+    const uint frames = out.getFrameLenght();
+
+    float peaks[2] = {0.0f, 0.0f};
+    float squaredSums[2] = {0.0f, 0.0f};
+
+    // the tail of the current beat click
+    const SamplesBuffer &currentClick = getSamplesBuffer(*currentSounds, currentBeat);
+    if (beatPosition < static_cast<long>(currentClick.getFrameLenght())) {
+        const long framesInCurrentBeat = qMin(samplesPerBeat - beatPosition, static_cast<long>(frames));
+        const uint clickFrames = qMin(static_cast<uint>(currentClick.getFrameLenght() - beatPosition), static_cast<uint>(framesInCurrentBeat));
+        renderClick(currentClick, beatPosition, out, 0, clickFrames, peaks, squaredSums);
+    }
+
+    // next beats starting in this audio buffer
+    int beat = currentBeat + 1;
+    for (long beatStart = samplesPerBeat - beatPosition; beatStart < static_cast<long>(frames); beatStart += samplesPerBeat, ++beat) {
+        const SamplesBuffer &click = getSamplesBuffer(*currentSounds, beat);
+        const uint clickFrames = qMin(click.getFrameLenght(), static_cast<uint>(qMin(static_cast<long>(frames) - beatStart, samplesPerBeat)));
+        renderClick(click, 0, out, beatStart, clickFrames, peaks, squaredSums);
     }
 
-    if (samplesToCopy > 0)
-        internalInputBuffer.set(*samplesBuffer, samplesBufferOffset, samplesToCopy,
-                                internalOffset);
-    AudioNode::processReplacing(in, out, SampleRate, midiBuffer);
+    // the clicks are not mixed in the internal buffer, only its rms window is used, so the meter is consistent with the other tracks
+    publishPeak(internalOutputBuffer.computePeak(peaks, squaredSums, out.isMono() ? 1 : 2, frames));
 }
@@ -2,6 +2,9 @@
 #define METRONOMETRACKNODE_H
 
 #include "core/AudioNode.h"
+#include "MetronomeSoundBank.h"
+
+#include <QAtomicPointer>
 
 namespace audio {
 
@@ -11,10 +14,10 @@ class MetronomeTrackNode : public audio::AudioNode
 {
 
 public:
-    MetronomeTrackNode(const audio::SamplesBuffer &firstBeatSamples, const audio::SamplesBuffer &offBeatSamples, const SamplesBuffer &accentBeatSamples);
+    explicit MetronomeTrackNode(const MetronomeSoundsPtr &sounds);
 
     ~MetronomeTrackNode();
-    void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, std::vector<midi::MidiMessage> &midiBuffer) override;
+    void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, midi::MidiBuffer &midiBuffer) override;
     void setSamplesPerBeat(long samplesPerBeat);
     void setIntervalPosition(long intervalPosition);
     void resetInterval();
@@ -28,14 +31,17 @@ public:
     void setAccentBeats(QList<int> accents); // pass empty list to turn off accents
     QList<int> getAccentBeats(); // returns the beats with accents
 
-    void setPrimaryBeatSamples(const audio::SamplesBuffer &firstBeatSamples);
-    void setOffBeatSamples(const audio::SamplesBuffer &offBeatSamples);
-    void setAccentBeatSamples(const audio::SamplesBuffer &accentBeatSamples);
+    // the new sounds are used in the next audio callback, the node is not recreated. Don't call in audio thread.
+    void setSounds(const MetronomeSoundsPtr &sounds);
 
 private:
-    SamplesBuffer firstBeatBuffer;
-    SamplesBuffer offBeatBuffer;
-    SamplesBuffer accentBeatBuffer;
+    // the audio thread is using 'activeSounds' and publishing the pointer in use in 'soundsInUse', the
+    // replaced sounds are released only when the audio thread is not using them (no deallocations in audio thread)
+    MetronomeSoundsPtr sounds;
+    QList<MetronomeSoundsPtr> retiredSounds;
+    QAtomicPointer<const MetronomeSounds> activeSounds;
+    QAtomicPointer<const MetronomeSounds> soundsInUse;
+    QMutex soundsMutex; // serializing setSounds() calls, never locked in audio thread
 
     long samplesPerBeat;
     long intervalPosition;
@@ -43,7 +49,14 @@ private:
     int currentBeat;
     QList<int> accentBeats = QList<int>();
 
-    SamplesBuffer *getSamplesBuffer(int beat); // return the correct buffer to play in each beat
+    const MetronomeSounds *acquireSounds(); // audio thread
+    void releaseRetiredSounds();
+
+    const SamplesBuffer &getSamplesBuffer(const MetronomeSounds &sounds, int beat) const; // return the correct buffer to play in each beat
+
+    // mix a click segment in 'out' applying gain and pan, and update the peaks
+    void renderClick(const SamplesBuffer &click, uint clickOffset, SamplesBuffer &out, uint outOffset, uint frames,
+                     float *peaks, float *squaredSums) const;
 };
 
 inline bool MetronomeTrackNode::isPlayingAccents() const
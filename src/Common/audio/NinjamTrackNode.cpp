@@ -7,6 +7,7 @@
 #include <QMutexLocker>
 #include <QDateTime>
 #include <QtConcurrent/QtConcurrent>
+#include <QAtomicInt>
 
 #include "audio/core/Filters.h"
 #include "audio/core/AudioDriver.h"
@@ -16,51 +17,68 @@ const double NinjamTrackNode::LOW_CUT_DRASTIC_FREQUENCY = 220.0; // in Hertz
 const double NinjamTrackNode::LOW_CUT_NORMAL_FREQUENCY = 120.0; // in Hertz
 
 using audio::Filter;
+using audio::FilterBank;
 
 class NinjamTrackNode::LowCutFilter
 {
 public:
     explicit LowCutFilter(double sampleRate);
-    void process(audio::SamplesBuffer &buffer);
-    //inline bool isActivated() const { return activated; }
-    inline NinjamTrackNode::LowCutState getState(){ return this->state; }
-    void setState(NinjamTrackNode::LowCutState state);
+    void process(audio::SamplesBuffer &buffer, int sampleRate);
+    inline NinjamTrackNode::LowCutState getState() const { return static_cast<LowCutState>(state.loadAcquire()); }
+    void setState(NinjamTrackNode::LowCutState state); // the new state is applied in the audio thread
 private:
-    NinjamTrackNode::LowCutState state;
-    Filter leftFilter;
-    Filter rightFilter;
+    static const int INTERPOLATION_TIME_IN_MS = 30;
+
+    static double getFrequency(NinjamTrackNode::LowCutState state);
+
+    QAtomicInt state;
+    NinjamTrackNode::LowCutState activeState; // audio thread
+    FilterBank filters; // a lane per channel
 };
 
 NinjamTrackNode::LowCutFilter::LowCutFilter(double sampleRate) :
     state(LowCutState::OFF),
-    leftFilter(Filter::FilterType::HighPass, sampleRate, LOW_CUT_NORMAL_FREQUENCY, 1.0, 1.0),
-    rightFilter(Filter::FilterType::HighPass, sampleRate, LOW_CUT_NORMAL_FREQUENCY, 1.0, 1.0)
+    activeState(LowCutState::OFF),
+    filters(Filter::FilterType::HighPass, sampleRate, LOW_CUT_NORMAL_FREQUENCY, 1.0, 1.0)
 {
 
 }
 
+double NinjamTrackNode::LowCutFilter::getFrequency(NinjamTrackNode::LowCutState state)
+{
+    if (state == LowCutState::DRASTIC)
+        return LOW_CUT_DRASTIC_FREQUENCY;
+
+    return LOW_CUT_NORMAL_FREQUENCY;
+}
+
 void NinjamTrackNode::LowCutFilter::setState(NinjamTrackNode::LowCutState state)
 {
-    this->state = state;
-    if (state != LowCutState::OFF){
-        double frequency = LOW_CUT_NORMAL_FREQUENCY;
-        if (state == LowCutState::DRASTIC)
-            frequency = LOW_CUT_DRASTIC_FREQUENCY;
-
-        leftFilter.setFrequency(frequency);
-        rightFilter.setFrequency(frequency);
-    }
+    this->state.storeRelease(state);
 }
 
-void NinjamTrackNode::LowCutFilter::process(audio::SamplesBuffer &buffer)
+void NinjamTrackNode::LowCutFilter::process(audio::SamplesBuffer &buffer, int sampleRate)
 {
-    if (state == LowCutState::OFF)
+    const LowCutState newState = getState();
+    if (newState == LowCutState::OFF) {
+        activeState = newState;
         return;
+    }
+
+    filters.setSampleRate(sampleRate); // the buffer is already resampled
+
+    if (newState != activeState) {
+        if (activeState == LowCutState::OFF) { // starting from a clean filter
+            filters.setFrequency(getFrequency(newState));
+            filters.reset();
+        }
+        else {
+            filters.setFrequency(getFrequency(newState), sampleRate * INTERPOLATION_TIME_IN_MS / 1000);
+        }
+        activeState = newState;
+    }
 
-    quint32 samples = buffer.getFrameLenght();
-    leftFilter.process(buffer.getSamplesArray(0), samples);
-    if (!buffer.isMono())
-        rightFilter.process(buffer.getSamplesArray(1), samples);
+    filters.process(buffer);
 }
 
 //--------------------------------------------------------------------------
@@ -259,7 +277,7 @@ int NinjamTrackNode::getFramesToProcess(int targetSampleRate, int outFrameLenght
 }
 
 void NinjamTrackNode::processReplacing(const audio::SamplesBuffer &in, audio::SamplesBuffer &out,
-                                       int sampleRate, std::vector<midi::MidiMessage> &midiBuffer)
+                                       int sampleRate, midi::MidiBuffer &midiBuffer)
 {
     if (!isPlaying())
         return;
@@ -279,7 +297,7 @@ void NinjamTrackNode::processReplacing(const audio::SamplesBuffer &in, audio::Sa
                            << out.getFrameLenght();
         }
 
-        lowCut->process(internalInputBuffer);
+        lowCut->process(internalInputBuffer, sampleRate);
 
         audio::AudioNode::processReplacing(in, out, sampleRate, midiBuffer); // process internal buffer pan, gain, etc
     }
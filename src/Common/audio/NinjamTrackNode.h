@@ -24,7 +24,7 @@ public:
     virtual ~NinjamTrackNode();
     void addVorbisEncodedInterval(const QByteArray &encodedBytes);
     void processReplacing(const audio::SamplesBuffer &in, audio::SamplesBuffer &out, int sampleRate,
-                          std::vector<midi::MidiMessage> &midiBuffer) override;
+                          midi::MidiBuffer &midiBuffer) override;
 
     void setLowCutState(LowCutState newState);
     LowCutState setLowCutToNextState();
@@ -0,0 +1,338 @@
+#include "PluginSandboxChannel.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <QUuid>
+#include <QDebug>
+
+#include <new>
+#include <climits>
+
+#if defined(Q_OS_LINUX)
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <ctime>
+#elif defined(Q_OS_WIN)
+    #include <windows.h>
+#elif defined(Q_OS_MAC)
+    #include <QDir>
+    #include <QFile>
+    #include <sys/types.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <unistd.h>
+#endif
+
+using audio::PluginSandboxChannel;
+
+const quint32 PluginSandboxChannel::SIGNATURE = 0x4A545342; // 'JTSB'
+const int PluginSandboxChannel::SPIN_COUNT = 2000; // most plugins process a block in a few microseconds
+
+PluginSandboxChannel::PluginSandboxChannel(const QString &key) :
+    memory(key),
+    state(nullptr),
+    nextRequest(0),
+    pendingRequest(0)
+{
+    // the futex and the atomic operations are working in the int stored in shared memory
+    static_assert(sizeof(QAtomicInt) == sizeof(int), "QAtomicInt must be a plain int in shared memory");
+
+    for (int slot = 0; slot < SLOTS; ++slot)
+        slotRequests[slot] = 0;
+
+#if defined(Q_OS_WIN)
+    events[RequestSignal] = events[ResponseSignal] = nullptr;
+#elif defined(Q_OS_MAC)
+    fifos[RequestSignal] = fifos[ResponseSignal] = -1;
+    fifosOwner = false;
+#endif
+}
+
+PluginSandboxChannel::~PluginSandboxChannel()
+{
+    closeSignals();
+
+    if (memory.isAttached())
+        memory.detach();
+}
+
+QString PluginSandboxChannel::createKey()
+{
+    return QString("JamtabaSandbox-%1").arg(QUuid::createUuid().toString());
+}
+
+bool PluginSandboxChannel::create()
+{
+    if (!memory.create(sizeof(SharedState))) {
+        qCritical() << "Can't create the sandbox shared memory" << memory.errorString();
+        return false;
+    }
+
+    if (!openSignals(true)) {
+        memory.detach();
+        return false;
+    }
+
+    state = new (memory.data()) SharedState();
+    state->signature = SIGNATURE;
+    state->requestPosition.storeRelease(0);
+    state->responsePosition.storeRelease(0);
+    state->shutdown.storeRelease(0);
+
+    nextRequest = 0;
+    for (int slot = 0; slot < SLOTS; ++slot)
+        slotRequests[slot] = 0;
+
+    return true;
+}
+
+bool PluginSandboxChannel::attach()
+{
+    if (!memory.attach()) {
+        qCritical() << "Can't attach the sandbox shared memory" << memory.errorString();
+        return false;
+    }
+
+    if (memory.size() < static_cast<int>(sizeof(SharedState))) {
+        qCritical() << "Invalid sandbox shared memory size" << memory.size();
+        memory.detach();
+        return false;
+    }
+
+    SharedState *sharedState = reinterpret_cast<SharedState *>(memory.data());
+    if (sharedState->signature != SIGNATURE) {
+        qCritical() << "Invalid sandbox shared memory signature";
+        memory.detach();
+        return false;
+    }
+
+    if (!openSignals(false)) {
+        memory.detach();
+        return false;
+    }
+
+    state = sharedState;
+    pendingRequest = state->responsePosition.loadAcquire();
+
+    return true;
+}
+
+PluginSandboxChannel::Block *PluginSandboxChannel::getRequestBlock()
+{
+    if (!state)
+        return nullptr;
+
+    // the sandbox is acknowledging the requests in order, a slot is free when the last request written in it was acknowledged
+    const int slot = getSlot(nextRequest + 1);
+    if (!reached(state->responsePosition.loadAcquire(), slotRequests[slot]))
+        return nullptr;
+
+    return &state->blocks[slot];
+}
+
+bool PluginSandboxChannel::sendRequest(qint64 timeoutUs)
+{
+    if (!state)
+        return false;
+
+    const int request = ++nextRequest;
+    slotRequests[getSlot(request)] = request;
+
+    state->requestPosition.storeRelease(request);
+    wake(RequestSignal);
+
+    if (!waitPosition(ResponseSignal, request, timeoutUs))
+        return false;
+
+    return true;
+}
+
+void PluginSandboxChannel::shutdown()
+{
+    if (!state)
+        return;
+
+    state->shutdown.storeRelease(1);
+    state->requestPosition.fetchAndAddOrdered(0); // a full barrier before waking
+    wake(RequestSignal);
+}
+
+bool PluginSandboxChannel::isShutdown() const
+{
+    return !state || state->shutdown.loadAcquire() != 0;
+}
+
+PluginSandboxChannel::Block *PluginSandboxChannel::waitRequest(qint64 timeoutUs)
+{
+    if (!state)
+        return nullptr;
+
+    const int target = pendingRequest + 1;
+
+    // the requests timed out in Jamtaba are skipped, only the last request is processed
+    if (!waitPosition(RequestSignal, target, timeoutUs) || isShutdown())
+        return nullptr;
+
+    pendingRequest = state->requestPosition.loadAcquire();
+
+    return &state->blocks[getSlot(pendingRequest)];
+}
+
+void PluginSandboxChannel::finishRequest()
+{
+    if (!state)
+        return;
+
+    state->responsePosition.storeRelease(pendingRequest); // the skipped requests are acknowledged too
+    wake(ResponseSignal);
+}
+
+bool PluginSandboxChannel::reached(int position, int target)
+{
+    // positions are ever-increasing, the difference is safe when the counters wrap around
+    return static_cast<int>(static_cast<uint>(position) - static_cast<uint>(target)) >= 0;
+}
+
+int PluginSandboxChannel::getSlot(int request)
+{
+    return static_cast<int>((static_cast<uint>(request) - 1) % SLOTS); // the first request is 1
+}
+
+QAtomicInt &PluginSandboxChannel::getPosition(Signal signal)
+{
+    return signal == RequestSignal ? state->requestPosition : state->responsePosition;
+}
+
+bool PluginSandboxChannel::openSignals(bool create)
+{
+#if defined(Q_OS_WIN)
+    const QString names[2] = { QString("Local\\%1-request").arg(getKey()), QString("Local\\%1-response").arg(getKey()) };
+    for (int signal = RequestSignal; signal <= ResponseSignal; ++signal) {
+        const LPCWSTR name = reinterpret_cast<LPCWSTR>(names[signal].utf16());
+        events[signal] = create ? CreateEventW(nullptr, FALSE, FALSE, name) // auto reset, a stale signal is just a spurious wake up
+                                : OpenEventW(SYNCHRONIZE | EVENT_MODIFY_STATE, FALSE, name);
+        if (!events[signal]) {
+            qCritical() << "Can't open the sandbox event" << names[signal] << GetLastError();
+            closeSignals();
+            return false;
+        }
+    }
+#elif defined(Q_OS_MAC)
+    const QString paths[2] = { QDir::temp().absoluteFilePath(getKey() + "-request"), QDir::temp().absoluteFilePath(getKey() + "-response") };
+    fifosOwner = create;
+    for (int signal = RequestSignal; signal <= ResponseSignal; ++signal) {
+        const QByteArray path = QFile::encodeName(paths[signal]);
+        if (create && mkfifo(path.constData(), 0600) != 0) {
+            qCritical() << "Can't create the sandbox pipe" << paths[signal];
+            closeSignals();
+            return false;
+        }
+
+        // read and write in both sides, so opening is not blocking until the other side opens the pipe
+        fifos[signal] = open(path.constData(), O_RDWR | O_NONBLOCK);
+        if (fifos[signal] < 0) {
+            qCritical() << "Can't open the sandbox pipe" << paths[signal];
+            closeSignals();
+            return false;
+        }
+    }
+#else
+    Q_UNUSED(create);
+#endif
+
+    return true;
+}
+
+void PluginSandboxChannel::closeSignals()
+{
+#if defined(Q_OS_WIN)
+    for (int signal = RequestSignal; signal <= ResponseSignal; ++signal) {
+        if (events[signal])
+            CloseHandle(events[signal]);
+        events[signal] = nullptr;
+    }
+#elif defined(Q_OS_MAC)
+    for (int signal = RequestSignal; signal <= ResponseSignal; ++signal) {
+        if (fifos[signal] >= 0)
+            close(fifos[signal]);
+        fifos[signal] = -1;
+    }
+
+    if (fifosOwner) {
+        QFile::remove(QDir::temp().absoluteFilePath(getKey() + "-request"));
+        QFile::remove(QDir::temp().absoluteFilePath(getKey() + "-response"));
+        fifosOwner = false;
+    }
+#endif
+}
+
+bool PluginSandboxChannel::waitPosition(Signal signal, int target, qint64 timeoutUs)
+{
+    QAtomicInt &position = getPosition(signal);
+
+    for (int i = 0; i < SPIN_COUNT; ++i) {
+        if (reached(position.loadAcquire(), target))
+            return true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    forever {
+        const int current = position.loadAcquire();
+        if (reached(current, target))
+            return true;
+
+        const qint64 remainingUs = timeoutUs - timer.nsecsElapsed() / 1000;
+        if (remainingUs <= 0)
+            return false;
+
+#if defined(Q_OS_LINUX)
+        // shared futex (no FUTEX_PRIVATE_FLAG), the other process is waking us using the same shared memory address
+        timespec timeout;
+        timeout.tv_sec = remainingUs / 1000000;
+        timeout.tv_nsec = (remainingUs % 1000000) * 1000;
+        syscall(SYS_futex, reinterpret_cast<int *>(&position), FUTEX_WAIT, current, &timeout, nullptr, 0);
+#else
+        // the event and the pipe timeouts are in milliseconds, the last fraction of millisecond is not slept
+        const int timeoutMs = static_cast<int>(qMin(remainingUs / 1000, static_cast<qint64>(INT_MAX)));
+        if (timeoutMs <= 0) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+
+    #if defined(Q_OS_WIN)
+        WaitForSingleObject(events[signal], static_cast<DWORD>(timeoutMs));
+    #elif defined(Q_OS_MAC)
+        pollfd descriptor;
+        descriptor.fd = fifos[signal];
+        descriptor.events = POLLIN;
+        descriptor.revents = 0;
+        if (poll(&descriptor, 1, timeoutMs) > 0) {
+            char bytes[64];
+            while (read(fifos[signal], bytes, sizeof(bytes)) > 0) {} // the position is checked again after consuming the wake ups
+        }
+    #else
+        QThread::yieldCurrentThread();
+    #endif
+#endif
+    }
+}
+
+void PluginSandboxChannel::wake(Signal signal)
+{
+#if defined(Q_OS_LINUX)
+    syscall(SYS_futex, reinterpret_cast<int *>(&getPosition(signal)), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#elif defined(Q_OS_WIN)
+    SetEvent(events[signal]);
+#elif defined(Q_OS_MAC)
+    const char byte = 1;
+    if (write(fifos[signal], &byte, 1) < 0) {
+        // the pipe is full, the waiting side will wake up anyway
+    }
+#else
+    Q_UNUSED(signal);
+#endif
+}
@@ -0,0 +1,135 @@
+#ifndef PLUGIN_SANDBOX_CHANNEL_H
+#define PLUGIN_SANDBOX_CHANNEL_H
+
+#include <QSharedMemory>
+#include <QAtomicInt>
+#include <QString>
+#include <QtGlobal>
+
+namespace audio {
+
+/**
+ * Audio and MIDI transport between Jamtaba and a plugin running in a sandbox process. The blocks
+ * are exchanged in a ring of slots in shared memory, synchronized with ever-increasing atomic
+ * positions (one writer per position). Jamtaba writes the input samples and the MIDI events in
+ * the next slot, publishes the request position and waits (spinning first, then sleeping in a
+ * futex in Linux, a named event in Windows or a named pipe in Mac) until the sandbox publishes the
+ * same response position. A slot is written again only after the sandbox acknowledged the last
+ * request written in it, so a late sandbox never reads a slot rewritten by Jamtaba. No locks, no
+ * allocations and no system calls other than the wait/wake are used in the audio thread.
+ */
+
+class PluginSandboxChannel
+{
+public:
+    static const int MAX_CHANNELS = 8;
+    static const int MAX_FRAMES = 4096;
+    static const int MAX_MIDI_EVENTS = 64;
+    static const int SLOTS = 2;
+
+    struct MidiEvent
+    {
+        qint32 data; // packed status, data1 and data2, as in midi::MidiMessage
+        qint32 deltaFrames; // frame offset inside the block
+    };
+
+    struct Block
+    {
+        qint32 frames;
+        qint32 inputChannels;
+        qint32 outputChannels;
+        qint32 midiEventsCount;
+        MidiEvent midiEvents[MAX_MIDI_EVENTS];
+
+        // host transport, the plugin is synchronized with the ninjam interval
+        qint64 positionInSamples;
+        qint32 tempo;
+        qint32 playing;
+
+        float input[MAX_CHANNELS][MAX_FRAMES];
+        float output[MAX_CHANNELS][MAX_FRAMES];
+    };
+
+    explicit PluginSandboxChannel(const QString &key);
+    ~PluginSandboxChannel();
+
+    bool create(); // Jamtaba side
+    bool attach(); // sandbox side
+    bool isValid() const;
+
+    QString getKey() const;
+
+    // Jamtaba side, audio thread
+    Block *getRequestBlock(); // the slot used by the next request, nullptr while the sandbox can be using this slot
+    bool sendRequest(qint64 timeoutUs); // return false if the sandbox is not responding in time (stalled or crashed)
+    bool isWaitingResponse() const; // a timed out request is not processed by the sandbox yet
+    void shutdown(); // the sandbox stop waiting requests
+
+    // sandbox side, plugin processing thread
+    Block *waitRequest(qint64 timeoutUs); // return nullptr in timeout or shutdown
+    void finishRequest();
+    bool isShutdown() const;
+
+    static QString createKey(); // a unique key per plugin instance
+
+private:
+    struct SharedState
+    {
+        quint32 signature;
+        QAtomicInt requestPosition; // written by Jamtaba
+        QAtomicInt responsePosition; // written by the sandbox
+        QAtomicInt shutdown;
+        Block blocks[SLOTS];
+    };
+
+    enum Signal
+    {
+        RequestSignal, // waited by the sandbox
+        ResponseSignal // waited by Jamtaba
+    };
+
+    bool openSignals(bool create);
+    void closeSignals();
+
+    bool waitPosition(Signal signal, int target, qint64 timeoutUs);
+    void wake(Signal signal);
+    QAtomicInt &getPosition(Signal signal);
+
+    static bool reached(int position, int target);
+    static int getSlot(int request);
+
+    QSharedMemory memory;
+    SharedState *state;
+    int nextRequest; // Jamtaba side
+    int slotRequests[SLOTS]; // Jamtaba side, the last request written in each slot
+    int pendingRequest; // sandbox side
+
+#if defined(Q_OS_WIN)
+    void *events[2]; // named events (HANDLEs) signaled when a position is published
+#elif defined(Q_OS_MAC)
+    int fifos[2]; // named pipes, a byte is written when a position is published
+    bool fifosOwner; // the pipes files are removed by Jamtaba
+#endif
+
+    static const quint32 SIGNATURE;
+    static const int SPIN_COUNT;
+};
+
+inline bool PluginSandboxChannel::isValid() const
+{
+    return state != nullptr;
+}
+
+inline QString PluginSandboxChannel::getKey() const
+{
+    return memory.key();
+}
+
+inline bool PluginSandboxChannel::isWaitingResponse() const
+{
+    return state && !reached(state->responsePosition.loadAcquire(), nextRequest);
+}
+
+} // namespace
+
+#endif
@@ -13,6 +13,7 @@
 #include <QObject>
 #include <QDateTime>
 #include <QWaitCondition>
+#include <QThread>
 #include <cmath>
 #include <QMutexLocker>
 #include <QFile>
@@ -34,6 +35,7 @@ const int AbstractMp3Streamer::MAX_BYTES_PER_DECODING = 2048;
 AbstractMp3Streamer::AbstractMp3Streamer(Mp3Decoder *decoder) :
     decoder(decoder),
     device(nullptr),
+    bytesToDecodeOffset(0),
     streaming(false),
     bufferedSamples(2, 4096)
 {
@@ -46,6 +48,14 @@ AbstractMp3Streamer::~AbstractMp3Streamer()
 }
 
 void AbstractMp3Streamer::stopCurrentStream()
+{
+    if (device)
+        bufferedSamples.zero();// discard samples
+
+    closeStream();
+}
+
+void AbstractMp3Streamer::closeStream()
 {
     qCDebug(jtNinjamRoomStreamer) << "stopping room stream";
 
@@ -53,11 +63,9 @@ void AbstractMp3Streamer::stopCurrentStream()
         decoder->reset();// discard unprocessed bytes
         device->deleteLater();
         device = nullptr;
-        bufferedSamples.zero();// discard samples
-        streaming = false;
+        streaming.storeRelease(false);
     }
-    bytesToDecode.clear();
-    lastPeak.zero();
+    clearBytesToDecode(); // the meters are ZERO when nothing is published
 }
 
 int AbstractMp3Streamer::getSamplesToRender(int targetSampleRate, int outLenght)
@@ -68,11 +76,11 @@ int AbstractMp3Streamer::getSamplesToRender(int targetSampleRate, int outLenght)
     return samplesToRender;
 }
 
-void AbstractMp3Streamer::processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int targetSampleRate, std::vector<midi::MidiMessage> &)
+void AbstractMp3Streamer::processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int targetSampleRate, midi::MidiBuffer &)
 {
     Q_UNUSED(in);
 
-    if (bufferedSamples.isEmpty() || !streaming)
+    if (bufferedSamples.isEmpty() || !isStreaming())
         return;
 
     int samplesToRender = getSamplesToRender(targetSampleRate, out.getFrameLenght());
@@ -97,14 +105,14 @@ void AbstractMp3Streamer::processReplacing(const SamplesBuffer &in, SamplesBuffe
         qCDebug(jtNinjamRoomStreamer) << out.getFrameLenght()
             - internalOutputBuffer.getFrameLenght() << " samples missing";
 
-    this->lastPeak.update(internalOutputBuffer.computePeak());
+    publishPeak(internalOutputBuffer.computePeak());
 
     out.add(internalOutputBuffer);
 }
 
 void AbstractMp3Streamer::initialize(const QString &streamPath)
 {
-    streaming = !streamPath.isNull() && !streamPath.isEmpty();
+    streaming.storeRelease(!streamPath.isNull() && !streamPath.isEmpty());
 }
 
 int AbstractMp3Streamer::getSampleRate() const
@@ -114,17 +122,17 @@ int AbstractMp3Streamer::getSampleRate() const
 
 bool AbstractMp3Streamer::needResamplingFor(int targetSampleRate) const
 {
-    if (!streaming)
+    if (!isStreaming())
         return false;
     return targetSampleRate != getSampleRate();
 }
 
-void AbstractMp3Streamer::decode(const unsigned int maxBytesToDecode)
+void AbstractMp3Streamer::decode(const unsigned int maxBytesToDecode, SamplesBuffer &outBuffer)
 {
     if (!device)
         return;
-    qint64 totalBytesToProcess = std::min((int)maxBytesToDecode, bytesToDecode.size());
-    char *in = bytesToDecode.data();
+    qint64 totalBytesToProcess = std::min((int)maxBytesToDecode, getPendingBytesToDecode());
+    char *in = bytesToDecode.data() + bytesToDecodeOffset;
 
     if (totalBytesToProcess > 0) {
         int bytesProcessed = 0;
@@ -138,13 +146,30 @@ void AbstractMp3Streamer::decode(const unsigned int maxBytesToDecode)
             in += bytesToProcess;
             bytesProcessed += bytesToProcess;
             // +++++++++++++++++  PROCESS DECODED SAMPLES ++++++++++++++++
-            bufferedSamples.append(decodedBuffer);
+            outBuffer.append(decodedBuffer);
         }
 
-        bytesToDecode = bytesToDecode.right(bytesToDecode.size() - bytesProcessed);
+        bytesToDecodeOffset += bytesProcessed;
+
+        // discarding the decoded bytes only when they are the bigger part of the array, so each byte is moved (amortized) once
+        if (bytesToDecodeOffset >= bytesToDecode.size() / 2) {
+            bytesToDecode.remove(0, bytesToDecodeOffset);
+            bytesToDecodeOffset = 0;
+        }
     }
 }
 
+void AbstractMp3Streamer::appendBytesToDecode(const QByteArray &bytes)
+{
+    bytesToDecode.append(bytes);
+}
+
+void AbstractMp3Streamer::clearBytesToDecode()
+{
+    bytesToDecode.clear();
+    bytesToDecodeOffset = 0;
+}
+
 void AbstractMp3Streamer::setStreamPath(const QString &streamPath)
 {
     stopCurrentStream();
@@ -154,41 +179,181 @@ void AbstractMp3Streamer::setStreamPath(const QString &streamPath)
 // +++++++++++++++++++++++++++++++++++++++
 
 const int NinjamRoomStreamerNode::BUFFER_SIZE = 128000;
+const int NinjamRoomStreamerNode::DECODED_BUFFER_LATENCY = 500; // milliseconds
+
+// +++++++++++++  DECODING THREAD  +++++++++++++
+
+class NinjamRoomStreamerNode::DecodingThread : public QThread
+{
+public:
+    explicit DecodingThread(NinjamRoomStreamerNode *streamer) :
+        streamer(streamer),
+        pendingSamples(2, 4096),
+        stopRequested(false)
+    {
+        pendingSamples.setFrameLenght(0);
+        start(QThread::HighPriority);
+    }
+
+    ~DecodingThread()
+    {
+        stop();
+        wait();
+    }
+
+    void stop()
+    {
+        QMutexLocker locker(&mutex);
+        stopRequested = true;
+        hasWorkToDo.wakeAll();
+    }
+
+    void addBytesToDecode(const QByteArray &bytes) // called by Qt main thread (the producer thread)
+    {
+        QMutexLocker locker(&mutex);
+        streamer->appendBytesToDecode(bytes);
+        hasWorkToDo.wakeAll();
+    }
+
+    void stopStream() // called by Qt main thread when the stream is stopped or changed
+    {
+        QMutexLocker locker(&mutex);
+        streamer->closeStream();
+        pendingSamples.setFrameLenght(0);
+
+        // the samples decoded from this stream are discarded by the audio thread (the ring consumer)
+        streamer->streamChanges.fetchAndAddOrdered(1);
+    }
+
+    void setDevice(QIODevice *device)
+    {
+        QMutexLocker locker(&mutex);
+        streamer->device = device;
+    }
+
+    int getPendingBytesToDecode()
+    {
+        QMutexLocker locker(&mutex);
+        return streamer->getPendingBytesToDecode();
+    }
+
+protected:
+    void run() override
+    {
+        static const uint BYTES_PER_DECODING = 1024;
+        static const ulong WAIT_TIME = 10; // waiting the audio thread consume the decoded samples
+
+        QMutexLocker locker(&mutex);
+        while (!stopRequested) {
+
+            // first, trying to write the samples decoded in the last iteration
+            if (!pendingSamples.isEmpty()) {
+                uint writtenFrames = streamer->decodedSamples.write(pendingSamples);
+                pendingSamples.discardFirstSamples(writtenFrames);
+            }
+
+            const bool canDecode = pendingSamples.isEmpty() && streamer->getPendingBytesToDecode() > 0;
+            if (canDecode) {
+                streamer->decode(BYTES_PER_DECODING, pendingSamples);
+                uint writtenFrames = streamer->decodedSamples.write(pendingSamples);
+                pendingSamples.discardFirstSamples(writtenFrames);
+            }
+
+            // buffering until we have downloaded bytes to survive network jitter and a half full decoded ring
+            if (streamer->isBuffering() && streamer->oldStreamSamplesDiscarded()) {
+                const bool enoughBytes = streamer->getPendingBytesToDecode() >= streamer->bufferingBytes.loadAcquire();
+                const bool enoughSamples = streamer->decodedSamples.getAvailableFrames() >= streamer->decodedSamples.getCapacity()/2;
+                if (enoughBytes && enoughSamples) {
+                    streamer->bufferingBytes.storeRelease(BUFFER_SIZE); // the prefetched bytes are not helping in the next bufferings
+                    streamer->buffering.storeRelease(false);
+                }
+            }
+
+            if (!canDecode) // no bytes to decode, or the decoded samples ring is full
+                hasWorkToDo.wait(&mutex, WAIT_TIME);
+        }
+
+        qCDebug(jtNinjamRoomStreamer) << "Decoding thread stopped!";
+    }
+
+private:
+    NinjamRoomStreamerNode *streamer;
+    SamplesBuffer pendingSamples; // decoded samples not written in the ring because the ring is full
+    QMutex mutex;
+    QWaitCondition hasWorkToDo;
+    bool stopRequested;
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++
 
 NinjamRoomStreamerNode::NinjamRoomStreamerNode(const QUrl &streamPath) :
     AbstractMp3Streamer(new Mp3DecoderMiniMp3()),
     httpClient(nullptr),
-    buffering(false)
+    buffering(false),
+    streamChanges(0),
+    discardedStreamChanges(0),
+    bufferingBytes(BUFFER_SIZE),
+    decodedSamples(48000 * DECODED_BUFFER_LATENCY / 1000) // using the max mp3 sample rate
 {
+    decodingThread.reset(new DecodingThread(this));
     setStreamPath(streamPath.toString());
 }
 
 bool NinjamRoomStreamerNode::needResamplingFor(int targetSampleRate) const
 {
-    if (!streaming)
+    if (!isStreaming())
         return false;
     return AbstractMp3Streamer::needResamplingFor(targetSampleRate);
 }
 
 void NinjamRoomStreamerNode::initialize(const QString &streamPath)
 {
-    AbstractMp3Streamer::initialize(streamPath);
+    buffering.storeRelease(true); // the audio thread is not locked, it is just waiting the buffering
+    bufferingBytes.storeRelease(BUFFER_SIZE);
 
-    buffering = true;
-    bufferedSamples.zero();
-    bytesToDecode.clear();
+    AbstractMp3Streamer::initialize(streamPath);
 
     if (!streamPath.isEmpty()) {
 
         qCDebug(jtNinjamRoomStreamer) << "connecting in " << streamPath;
 
-        QNetworkReply *reply = httpClient.get(QNetworkRequest(QUrl(streamPath)));
-        QObject::connect(reply, SIGNAL(readyRead()), this, SLOT(on_reply_read()));
-        QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(on_reply_error(QNetworkReply::NetworkError)));
-        this->device = reply;
+        setStreamReply(httpClient.get(QNetworkRequest(QUrl(streamPath))));
     }
 }
 
+void NinjamRoomStreamerNode::setStreamReply(QNetworkReply *reply)
+{
+    QObject::connect(reply, SIGNAL(readyRead()), this, SLOT(on_reply_read()));
+    QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(on_reply_error(QNetworkReply::NetworkError)));
+    decodingThread->setDevice(reply);
+}
+
+void NinjamRoomStreamerNode::playPrefetchedStream(const QString &streamPath, QNetworkReply *reply, const QByteArray &prefetchedBytes)
+{
+    stopCurrentStream();
+
+    // the prefetched bytes are decoded as soon as possible, so they are not counted as pending bytes to decode. Just
+    // the missing bytes are waited, and a fully prefetched stream is waiting only the decoded samples.
+    buffering.storeRelease(true);
+    bufferingBytes.storeRelease(qMax(BUFFER_SIZE - prefetchedBytes.size(), 0));
+
+    AbstractMp3Streamer::initialize(streamPath);
+
+    qCDebug(jtNinjamRoomStreamer) << "playing prefetched stream " << streamPath << " prefetched bytes:" << prefetchedBytes.size();
+
+    setStreamReply(reply);
+    decodingThread->addBytesToDecode(prefetchedBytes);
+
+    if (reply->bytesAvailable() > 0)
+        on_reply_read(); // reading the bytes downloaded before the signals connection
+}
+
+void NinjamRoomStreamerNode::stopCurrentStream()
+{
+    buffering.storeRelease(true); // the audio thread stops reading the decoded samples
+    decodingThread->stopStream(); // the decoder and the downloaded bytes are shared with the decoding thread
+}
+
 void NinjamRoomStreamerNode::on_reply_error(QNetworkReply::NetworkError /*error*/)
 {
     QString msg = "ERROR playing room stream";
@@ -203,11 +368,10 @@ void NinjamRoomStreamerNode::on_reply_read()
         return;
     }
     if (device->isOpen() && device->isReadable()) {
-        QMutexLocker locker(&mutex);
-        bytesToDecode.append(device->readAll());
-        if (buffering) {
-            qCDebug(jtNinjamRoomStreamer) << "bytes downloaded  bytesToDecode:"<<bytesToDecode.size()
-                                      << " bufferedSamples: " << bufferedSamples.getFrameLenght();
+        decodingThread->addBytesToDecode(device->readAll());
+        if (isBuffering()) {
+            qCDebug(jtNinjamRoomStreamer) << "bytes downloaded  bytesToDecode:" << decodingThread->getPendingBytesToDecode()
+                                      << " decodedSamples: " << decodedSamples.getAvailableFrames();
         }
     } else {
         qCritical() << "problem in device!";
@@ -216,38 +380,50 @@ void NinjamRoomStreamerNode::on_reply_read()
 
 NinjamRoomStreamerNode::~NinjamRoomStreamerNode()
 {
+    decodingThread.reset(); // stop the decoding thread before destroy the decoder and the decoded samples ring
 }
 
 void NinjamRoomStreamerNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out,
-                                              int sampleRate, std::vector<midi::MidiMessage> &midiBuffer)
+                                              int sampleRate, midi::MidiBuffer &midiBuffer)
 {
     Q_UNUSED(in)
-    QMutexLocker locker(&mutex);
-    if (buffering && bytesToDecode.size() >= BUFFER_SIZE)
-        buffering = false;
-    if (!buffering && bytesToDecode.isEmpty())
-        buffering = true;
-    if (buffering)
+
+    // no locks here, the decoded samples ring is single producer (decoding thread) and single consumer (this thread)
+    const int currentStreamChanges = streamChanges.loadAcquire();
+    if (discardedStreamChanges.loadAcquire() != currentStreamChanges) { // stream changed, discarding the old samples
+        decodedSamples.discard(decodedSamples.getAvailableFrames());
+        bufferedSamples.setFrameLenght(0);
+        discardedStreamChanges.storeRelease(currentStreamChanges);
+    }
+
+    if (isBuffering() || !isStreaming())
         return;
+
+    // just copying the decoded samples, the mp3 decoding is done in decoding thread
     uint samplesToRender = getSamplesToRender(sampleRate, out.getFrameLenght());
-    while (bufferedSamples.getFrameLenght() < samplesToRender) {// need decoding?
-        decode(256);
-        if (bytesToDecode.isEmpty()) {// no more bytes to decode
-            qCritical() << "no more bytes to decode and not enough buffered samples. Buffering ...";
-            buffering = true;
-            break;
-        }
+    if (decodedSamples.getAvailableFrames() < samplesToRender) {
+        qCritical() << "not enough decoded samples. Buffering ...";
+        buffering.storeRelease(true);
+        return;
     }
-    if (!bufferedSamples.isEmpty())
-        AbstractMp3Streamer::processReplacing(in, out, sampleRate, midiBuffer);
+
+    bufferedSamples.setFrameLenght(samplesToRender);
+    decodedSamples.read(bufferedSamples, samplesToRender);
+
+    AbstractMp3Streamer::processReplacing(in, out, sampleRate, midiBuffer);
 }
 
 int NinjamRoomStreamerNode::getBufferingPercentage() const
 {
-    if (buffering)
-        return bytesToDecode.size()/(float)BUFFER_SIZE * 100;
+    if (isBuffering()) {
+        const int bytes = bufferingBytes.loadAcquire();
+        if (bytes <= 0) // prefetched stream, waiting just the decoded samples
+            return qMin(decodedSamples.getAvailableFrames()/(float)(decodedSamples.getCapacity()/2) * 100, 100.0f);
+
+        return qMin(getPendingBytesToDecode()/(float)bytes * 100, 100.0f);
+    }
 
-    if (!streaming)
+    if (!isStreaming())
         return 0;
     return 100;//if not buffering and is streaming, the buffer is completed (100%)
 }
@@ -266,7 +442,7 @@ void AudioFileStreamerNode::initialize(const QString &streamPath)
     if (!f->open(QIODevice::ReadOnly))
         qCritical() << "error opening the file " << streamPath;
     this->device = f;
-    bytesToDecode.append(f->readAll());
+    appendBytesToDecode(f->readAll());
 }
 
 AudioFileStreamerNode::~AudioFileStreamerNode()
@@ -274,10 +450,10 @@ AudioFileStreamerNode::~AudioFileStreamerNode()
 }
 
 void AudioFileStreamerNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out,
-                                             int sampleRate, std::vector<midi::MidiMessage> &midiBuffer)
+                                             int sampleRate, midi::MidiBuffer &midiBuffer)
 {
-    while (bufferedSamples.getFrameLenght() < out.getFrameLenght())
-        decode(1024 + 1024);
+    while (bufferedSamples.getFrameLenght() < out.getFrameLenght() && getPendingBytesToDecode() > 0)
+        decode(1024 + 1024, bufferedSamples);
 
     AbstractMp3Streamer::processReplacing(in, out, sampleRate, midiBuffer);
 }
@@ -2,8 +2,11 @@
 #define ROOM_STREAMER_NODE_H
 
 #include "core/AudioNode.h"
+#include "core/SamplesRingBuffer.h"
 #include <QNetworkReply>
 #include <QNetworkAccessManager>
+#include <QScopedPointer>
+#include <QAtomicInt>
 #include "SamplesBufferResampler.h"
 
 class QIODevice;
@@ -20,7 +23,7 @@ public:
     explicit AbstractMp3Streamer(audio::Mp3Decoder *decoder);
     virtual ~AbstractMp3Streamer();
     void processReplacing(const audio::SamplesBuffer &in, audio::SamplesBuffer &out,
-                          int sampleRate, std::vector<midi::MidiMessage> &midiBuffer) override;
+                          int sampleRate, midi::MidiBuffer &midiBuffer) override;
     virtual void stopCurrentStream();
     virtual void setStreamPath(const QString &streamPath);
     bool isStreaming() const;
@@ -41,10 +44,17 @@ protected:
     audio::Mp3Decoder *decoder;
 
     QIODevice *device;
-    void decode(const unsigned int maxBytesToDecode);
+    void decode(const unsigned int maxBytesToDecode, SamplesBuffer &outBuffer);
+
+    // downloaded/readed bytes. The decoded bytes are discarded in amortized way to avoid copy the entire stream in each decoding
     QByteArray bytesToDecode;
+    int bytesToDecodeOffset;
+    int getPendingBytesToDecode() const;
+    void appendBytesToDecode(const QByteArray &bytes);
+    void clearBytesToDecode();
+    void closeStream(); // stop decoding, the samples used in audio thread are not touched
     virtual void initialize(const QString &streamPath);
-    bool streaming;
+    QAtomicInt streaming; // set in GUI thread, read in audio thread
     SamplesBuffer bufferedSamples;
     SamplesBufferResampler resampler;
 
@@ -53,7 +63,12 @@ protected:
 
 inline bool AbstractMp3Streamer::isStreaming() const
 {
-    return streaming;
+    return streaming.loadAcquire();
+}
+
+inline int AbstractMp3Streamer::getPendingBytesToDecode() const
+{
+    return bytesToDecode.size() - bytesToDecodeOffset;
 }
 
 // +++++++++++++++++++++++++++++++++++++++++++++
@@ -66,21 +81,43 @@ public:
     explicit NinjamRoomStreamerNode(const QUrl &streamPath = QUrl(""));
     ~NinjamRoomStreamerNode();
 
-    void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, std::vector<midi::MidiMessage> &midiBuffer) override;
+    void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, midi::MidiBuffer &midiBuffer) override;
     bool needResamplingFor(int targetSampleRate) const override;
+    void stopCurrentStream() override;
 
     bool isBuffering() const override;
 
     int getBufferingPercentage() const override;
 
+    // play a stream opened (and partially downloaded) by RoomStreamsPrefetcher. The reply ownership is transferred to this node.
+    void playPrefetchedStream(const QString &streamPath, QNetworkReply *reply, const QByteArray &prefetchedBytes);
+
 protected:
     void initialize(const QString &streamPath) override;
 
 private:
+    void setStreamReply(QNetworkReply *reply);
+
     QNetworkAccessManager httpClient;
-    bool buffering;
+
+    // cleared in decoding thread when the buffering is completed, set in audio thread when the decoded samples are not enough
+    QAtomicInt buffering;
+
+    // the audio thread (the decoded samples consumer) discards the samples of the previous stream when the stream is changed
+    QAtomicInt streamChanges;
+    QAtomicInt discardedStreamChanges;
+    bool oldStreamSamplesDiscarded() const;
+
+    // downloaded bytes needed to complete the buffering, the prefetched bytes are already downloaded
+    QAtomicInt bufferingBytes;
 
     static const int BUFFER_SIZE;
+    static const int DECODED_BUFFER_LATENCY; // in milliseconds
+
+    // mp3 is decoded in a separated thread, the audio thread is just copying the decoded samples
+    class DecodingThread;
+    QScopedPointer<DecodingThread> decodingThread;
+    SamplesRingBuffer decodedSamples;
 
 private slots:
     void on_reply_error(QNetworkReply::NetworkError);
@@ -89,7 +126,12 @@ private slots:
 
 inline bool NinjamRoomStreamerNode::isBuffering() const
 {
-    return buffering;
+    return buffering.loadAcquire();
+}
+
+inline bool NinjamRoomStreamerNode::oldStreamSamplesDiscarded() const
+{
+    return discardedStreamChanges.loadAcquire() == streamChanges.loadAcquire();
 }
 
 // ++++++++++++++++++++++++++++
@@ -104,7 +146,7 @@ public:
     explicit AudioFileStreamerNode(const QString &file);
     ~AudioFileStreamerNode();
     void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate,
-                                  std::vector<midi::MidiMessage> &midiBuffer) override;
+                                  midi::MidiBuffer &midiBuffer) override;
 };
 
 } // namespace end
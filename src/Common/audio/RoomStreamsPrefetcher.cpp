@@ -0,0 +1,139 @@
+#include "RoomStreamsPrefetcher.h"
+#include "log/Logging.h"
+
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QUrl>
+
+using audio::RoomStreamsPrefetcher;
+
+const int RoomStreamsPrefetcher::MAX_STREAMS = 4;
+const int RoomStreamsPrefetcher::MAX_PREFETCHED_BYTES = 128000; // the same amount of bytes used by room streamer buffering
+const int RoomStreamsPrefetcher::MAX_BYTES_PER_SECOND = 96 * 1024; // enough to 4 streams in 192 kbps
+
+RoomStreamsPrefetcher::RoomStreamsPrefetcher(QObject *parent) :
+    QObject(parent),
+    bandwidthBudget(MAX_BYTES_PER_SECOND),
+    firstStreamToRead(0)
+{
+    bandwidthTimer.setInterval(1000);
+    connect(&bandwidthTimer, &QTimer::timeout, this, &RoomStreamsPrefetcher::restoreBandwidthBudget);
+}
+
+RoomStreamsPrefetcher::~RoomStreamsPrefetcher()
+{
+    stopAll();
+}
+
+void RoomStreamsPrefetcher::setStreamsToPrefetch(const QStringList &streamsUrls)
+{
+    for (const QString &streamUrl : streams.keys()) {
+        if (!streamsUrls.contains(streamUrl))
+            closeStream(streamUrl);
+    }
+
+    for (const QString &streamUrl : streamsUrls) {
+        if (streams.size() >= MAX_STREAMS)
+            break;
+
+        if (!streamUrl.isEmpty() && !streams.contains(streamUrl))
+            openStream(streamUrl);
+    }
+
+    if (streams.isEmpty())
+        bandwidthTimer.stop();
+    else if (!bandwidthTimer.isActive())
+        bandwidthTimer.start();
+}
+
+void RoomStreamsPrefetcher::stopAll()
+{
+    for (const QString &streamUrl : streams.keys())
+        closeStream(streamUrl);
+
+    bandwidthTimer.stop();
+}
+
+void RoomStreamsPrefetcher::openStream(const QString &streamUrl)
+{
+    qCDebug(jtNinjamRoomStreamer) << "prefetching " << streamUrl;
+
+    QNetworkRequest request((QUrl(streamUrl)));
+    request.setPriority(QNetworkRequest::LowPriority);
+
+    QNetworkReply *reply = httpClient.get(request);
+
+    // unread bytes are stopping the download when the bandwidth budget is exhausted
+    reply->setReadBufferSize(MAX_BYTES_PER_SECOND / MAX_STREAMS);
+
+    connect(reply, &QNetworkReply::readyRead, this, &RoomStreamsPrefetcher::readStreams);
+    connect(reply, &QNetworkReply::finished, this, [=]() {
+        closeStream(streamUrl); // finished streams (or errors) are not useful
+    });
+
+    PrefetchedStream stream;
+    stream.reply = reply;
+    streams.insert(streamUrl, stream);
+}
+
+void RoomStreamsPrefetcher::closeStream(const QString &streamUrl)
+{
+    if (!streams.contains(streamUrl))
+        return;
+
+    QNetworkReply *reply = streams.take(streamUrl).reply;
+    reply->disconnect(this);
+    reply->abort();
+    reply->deleteLater();
+}
+
+QNetworkReply *RoomStreamsPrefetcher::takeStream(const QString &streamUrl, QByteArray &prefetchedBytes)
+{
+    if (!streams.contains(streamUrl))
+        return nullptr;
+
+    PrefetchedStream stream = streams.take(streamUrl);
+    stream.reply->disconnect(this);
+    stream.reply->setReadBufferSize(0); // the reply is not limited anymore
+
+    prefetchedBytes = stream.bytes.right(MAX_PREFETCHED_BYTES);
+
+    if (streams.isEmpty())
+        bandwidthTimer.stop();
+
+    return stream.reply;
+}
+
+void RoomStreamsPrefetcher::readStreams()
+{
+    const QStringList streamsUrls = streams.keys();
+    const int totalStreams = streamsUrls.size();
+
+    for (int i = 0; i < totalStreams; ++i) {
+        if (bandwidthBudget <= 0)
+            return;
+
+        const int streamIndex = (firstStreamToRead + i) % totalStreams;
+        PrefetchedStream &stream = streams[streamsUrls.at(streamIndex)];
+
+        const qint64 bytesToRead = qMin(stream.reply->bytesAvailable(), static_cast<qint64>(bandwidthBudget));
+        if (bytesToRead <= 0)
+            continue;
+
+        stream.bytes.append(stream.reply->read(bytesToRead));
+        bandwidthBudget -= bytesToRead;
+
+        firstStreamToRead = (streamIndex + 1) % totalStreams; // the streams after this one are the first in the next read
+
+        // keeping just the last bytes. The old bytes are discarded only when the array is 2x bigger to avoid copy the bytes in every read
+        if (stream.bytes.size() >= MAX_PREFETCHED_BYTES * 2)
+            stream.bytes.remove(0, stream.bytes.size() - MAX_PREFETCHED_BYTES);
+    }
+}
+
+void RoomStreamsPrefetcher::restoreBandwidthBudget()
+{
+    bandwidthBudget = MAX_BYTES_PER_SECOND;
+
+    readStreams(); // reading the bytes waiting in the replies buffers
+}
@@ -0,0 +1,77 @@
+#ifndef ROOM_STREAMS_PREFETCHER_H
+#define ROOM_STREAMS_PREFETCHER_H
+
+#include <QObject>
+#include <QMap>
+#include <QStringList>
+#include <QByteArray>
+#include <QNetworkAccessManager>
+#include <QTimer>
+
+class QNetworkReply;
+
+namespace audio {
+
+/**
+ * Download (in low priority) the streams of the public rooms visible in screen. Only the
+ * last downloaded bytes of each stream are kept, so when the user click to listen a room the
+ * room streamer can start playing without wait the buffering. The total of streams and
+ * the total of downloaded bytes per second are limited.
+ */
+
+class RoomStreamsPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RoomStreamsPrefetcher(QObject *parent = nullptr);
+    ~RoomStreamsPrefetcher();
+
+    void setStreamsToPrefetch(const QStringList &streamsUrls); // new streams are opened and non listed streams are closed
+    void stopAll();
+
+    bool isPrefetching(const QString &streamUrl) const;
+    int getPrefetchedBytes(const QString &streamUrl) const;
+
+    // the stream connection and the prefetched bytes are transferred to the caller
+    QNetworkReply *takeStream(const QString &streamUrl, QByteArray &prefetchedBytes);
+
+    static const int MAX_STREAMS;
+    static const int MAX_PREFETCHED_BYTES; // per stream
+    static const int MAX_BYTES_PER_SECOND; // for all streams
+
+private slots:
+    void readStreams();
+    void restoreBandwidthBudget();
+
+private:
+    struct PrefetchedStream
+    {
+        QNetworkReply *reply = nullptr;
+        QByteArray bytes;
+    };
+
+    void openStream(const QString &streamUrl);
+    void closeStream(const QString &streamUrl);
+
+    QNetworkAccessManager httpClient;
+    QMap<QString, PrefetchedStream> streams;
+
+    QTimer bandwidthTimer;
+    int bandwidthBudget; // bytes that can be readed in the current second
+    int firstStreamToRead; // rotated in each read, so the last streams are not starving when the budget is exhausted
+};
+
+inline bool RoomStreamsPrefetcher::isPrefetching(const QString &streamUrl) const
+{
+    return streams.contains(streamUrl);
+}
+
+inline int RoomStreamsPrefetcher::getPrefetchedBytes(const QString &streamUrl) const
+{
+    return streams.value(streamUrl).bytes.size();
+}
+
+} // namespace
+
+#endif
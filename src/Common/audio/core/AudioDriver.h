@@ -78,6 +78,7 @@ class AudioDriver : public QObject
 
 signals:
     void sampleRateChanged(int newSampleRate);
+    void bufferSizeChanged(int newBufferSize); // emitted when the buffer size is changed outside Jamtaba (JACK server, etc.)
     void stopped();
     void started();
 
@@ -0,0 +1,176 @@
+#include "AudioLoadMonitor.h"
+
+#include <QElapsedTimer>
+#include <QStringList>
+
+#include <cstring>
+
+using audio::ProcessingTime;
+using audio::AudioLoadMonitor;
+using audio::AudioLoadReport;
+
+ProcessingTime::ProcessingTime() :
+    nanoseconds(0),
+    lastRead(0)
+{
+
+}
+
+quint32 ProcessingTime::takeElapsed()
+{
+    const quint32 current = static_cast<quint32>(nanoseconds.loadAcquire());
+    const quint32 elapsed = current - lastRead; // wrapping difference
+    lastRead = current;
+    return elapsed;
+}
+
+// +++++++++++++++++++++++++++++++++++++++++++
+
+AudioLoadMonitor::Stats::Stats() :
+    callbacks(0),
+    deadlineMisses(0),
+    lateCallbacks(0),
+    minNs(0),
+    averageNs(0),
+    p99Ns(0),
+    maxNs(0),
+    deadlineNs(0),
+    totalDeadlineNs(0)
+{
+
+}
+
+AudioLoadMonitor::AudioLoadMonitor(qint64 windowLength) :
+    windowLength(windowLength),
+    windowTotalNs(0),
+    lastCallbackStart(0),
+    lastDeadline(0),
+    resetRequested(0),
+    statsPublished(0),
+    totalDeadlineMisses(0),
+    totalLateCallbacks(0)
+{
+    std::memset(histogram, 0, sizeof(histogram));
+}
+
+qint64 AudioLoadMonitor::timestamp()
+{
+    static QElapsedTimer clock;
+    static bool clockStarted = (clock.start(), true);
+    Q_UNUSED(clockStarted)
+
+    return clock.nsecsElapsed();
+}
+
+void AudioLoadMonitor::addCallback(qint64 startNs, qint64 endNs, int frames, int sampleRate)
+{
+    if (frames <= 0 || sampleRate <= 0)
+        return;
+
+    const qint64 elapsed = endNs - startNs;
+    const qint64 deadline = static_cast<qint64>(frames) * 1000000000 / sampleRate;
+
+    if (window.callbacks == 0 || elapsed < window.minNs)
+        window.minNs = elapsed;
+
+    if (elapsed > window.maxNs)
+        window.maxNs = elapsed;
+
+    window.callbacks++;
+    window.totalDeadlineNs += deadline;
+    windowTotalNs += elapsed;
+
+    if (elapsed > deadline) {
+        window.deadlineMisses++;
+        totalDeadlineMisses.fetchAndAddRelaxed(1);
+    }
+
+    if (resetRequested.loadAcquire() && resetRequested.fetchAndStoreAcquire(0))
+        lastCallbackStart = 0; // first callback after a driver restart
+
+    if (lastCallbackStart > 0 && (startNs - lastCallbackStart) > lastDeadline * 3 / 2) {
+        window.lateCallbacks++;
+        totalLateCallbacks.fetchAndAddRelaxed(1);
+    }
+
+    lastCallbackStart = startNs;
+    lastDeadline = deadline;
+
+    const qint64 bin = elapsed / HISTOGRAM_BIN_WIDTH;
+    histogram[qBound(static_cast<qint64>(0), bin, static_cast<qint64>(HISTOGRAM_BINS - 1))]++;
+
+    if (window.totalDeadlineNs >= windowLength && !statsPublished.loadAcquire())
+        publish();
+}
+
+void AudioLoadMonitor::publish()
+{
+    published = window;
+    published.averageNs = windowTotalNs / window.callbacks;
+    published.deadlineNs = window.totalDeadlineNs / window.callbacks;
+
+    // p99 is the upper limit of the bin containing the 99th percentile, clamped by the max duration
+    const int p99Callbacks = window.callbacks - window.callbacks / 100;
+    int accumulated = 0;
+    for (int bin = 0; bin < HISTOGRAM_BINS; ++bin) {
+        accumulated += histogram[bin];
+        if (accumulated >= p99Callbacks) {
+            published.p99Ns = qMin(static_cast<qint64>(bin + 1) * HISTOGRAM_BIN_WIDTH, window.maxNs);
+            break;
+        }
+    }
+
+    statsPublished.storeRelease(1); // the reader can read 'published' now
+
+    // starting a new window
+    window = Stats();
+    windowTotalNs = 0;
+    std::memset(histogram, 0, sizeof(histogram));
+}
+
+bool AudioLoadMonitor::takeStats(Stats &stats)
+{
+    if (!statsPublished.loadAcquire())
+        return false; // the audio thread is not running or the window is not complete
+
+    stats = published;
+
+    statsPublished.storeRelease(0); // the audio thread can publish the next window
+
+    return true;
+}
+
+// +++++++++++++++++++++++++++++++++++++++++++
+
+QString AudioLoadReport::toString(int maxNodes) const
+{
+    if (isEmpty())
+        return "Audio load: no audio callbacks";
+
+    QString text = QString("Audio load: avg %1% p99 %2% max %3% (min %4 ms, avg %5 ms, max %6 ms, deadline %7 ms) callbacks: %8 deadline misses: %9 late callbacks: %10")
+            .arg(callbacks.getLoad(callbacks.averageNs), 0, 'f', 1)
+            .arg(callbacks.getLoad(callbacks.p99Ns), 0, 'f', 1)
+            .arg(callbacks.getLoad(callbacks.maxNs), 0, 'f', 1)
+            .arg(callbacks.minNs / 1000000.0, 0, 'f', 3)
+            .arg(callbacks.averageNs / 1000000.0, 0, 'f', 3)
+            .arg(callbacks.maxNs / 1000000.0, 0, 'f', 3)
+            .arg(callbacks.deadlineNs / 1000000.0, 0, 'f', 3)
+            .arg(callbacks.callbacks)
+            .arg(callbacks.deadlineMisses)
+            .arg(callbacks.lateCallbacks);
+
+    for (int i = 0; i < nodes.size() && i < maxNodes; ++i) {
+        const NodeLoad &node = nodes.at(i);
+        text += QString(" | %1 track %2: %3%")
+                .arg(node.localTrack ? "local" : "remote")
+                .arg(node.trackID)
+                .arg(node.load, 0, 'f', 1);
+
+        for (int slot = 0; slot < node.processorsLoad.size(); ++slot) {
+            if (slot < node.processorsNames.size() && !node.processorsNames.at(slot).isEmpty())
+                text += QString(" [%1: %2%]").arg(node.processorsNames.at(slot)).arg(node.processorsLoad.at(slot), 0, 'f', 1);
+        }
+    }
+
+    return text;
+}
@@ -0,0 +1,148 @@
+#ifndef AUDIO_LOAD_MONITOR_H
+#define AUDIO_LOAD_MONITOR_H
+
+#include <QAtomicInt>
+#include <QList>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+
+namespace audio {
+
+/**
+ * CPU time spent by an audio graph element (a node, a plugin slot). Written by the audio thread and
+ * read by one reader thread. The counter is a wrapping 32 bits nanoseconds sum, the reader takes the
+ * difference since the last read, so the audio thread never waits or resets anything.
+ */
+
+class ProcessingTime
+{
+public:
+    ProcessingTime();
+
+    void add(qint64 nanoseconds); // audio thread
+    quint32 takeElapsed(); // reader thread, nanoseconds since the last call
+
+private:
+    QAtomicInt nanoseconds;
+    quint32 lastRead; // reader thread only
+};
+
+/**
+ * Audio callbacks timing. The audio thread adds the duration of each callback in a window
+ * (min/avg/max, a duration histogram and the deadline misses). When the window is covering
+ * 'windowLength' of audio it is published, if the reader thread already took the previous
+ * window, otherwise the window is extended. No locks, no allocations in audio thread.
+ */
+
+class AudioLoadMonitor
+{
+public:
+    struct Stats
+    {
+        Stats();
+
+        int callbacks;
+        int deadlineMisses; // callbacks taking more time than the buffer period
+        int lateCallbacks; // callbacks started more than 1.5 buffer period after the previous callback (dropouts, xruns)
+        qint64 minNs;
+        qint64 averageNs;
+        qint64 p99Ns;
+        qint64 maxNs;
+        qint64 deadlineNs; // average buffer period
+        qint64 totalDeadlineNs; // the sum of all callbacks periods, used to compute the nodes load
+
+        float getLoad(qint64 nanoseconds) const; // % of the deadline
+    };
+
+    explicit AudioLoadMonitor(qint64 windowLength = 500000000); // nanoseconds of audio
+
+    void addCallback(qint64 startNs, qint64 endNs, int frames, int sampleRate); // audio thread
+
+    // any thread, the audio driver was stopped or restarted. The next callback is not compared with the
+    // last callback before the restart, so the restart is not counted as a late callback
+    void reset();
+
+    bool takeStats(Stats &stats); // reader thread, return false when no window was published since the last call
+
+    int getTotalDeadlineMisses() const;
+    int getTotalLateCallbacks() const; // the audible dropouts since the monitor was created
+
+    static qint64 timestamp(); // monotonic nanoseconds
+
+    static const int HISTOGRAM_BINS = 2048;
+    static const int HISTOGRAM_BIN_WIDTH = 10000; // nanoseconds, callbacks slower than 20 ms are in the last bin
+
+private:
+    void publish(); // audio thread
+
+    const qint64 windowLength;
+
+    // audio thread only
+    Stats window;
+    qint64 windowTotalNs;
+    qint64 lastCallbackStart;
+    qint64 lastDeadline;
+    int histogram[HISTOGRAM_BINS];
+
+    QAtomicInt resetRequested;
+
+    Stats published; // written by the audio thread while 'statsPublished' is 0, read by the reader while 1
+    QAtomicInt statsPublished;
+    QAtomicInt totalDeadlineMisses;
+    QAtomicInt totalLateCallbacks;
+};
+
+// the last audio load measured in the audio graph, with the breakdown per track and plugin slot
+struct AudioLoadReport
+{
+    struct NodeLoad
+    {
+        long trackID;
+        bool localTrack;
+        float load; // % of the deadline, including the plugins
+        QVector<float> processorsLoad;
+        QStringList processorsNames;
+    };
+
+    AudioLoadMonitor::Stats callbacks;
+    QList<NodeLoad> nodes; // the most expensive nodes first
+
+    bool isEmpty() const;
+    QString toString(int maxNodes = 3) const;
+};
+
+inline void AudioLoadMonitor::reset()
+{
+    resetRequested.storeRelease(1);
+}
+
+inline int AudioLoadMonitor::getTotalDeadlineMisses() const
+{
+    return totalDeadlineMisses.loadAcquire();
+}
+
+inline int AudioLoadMonitor::getTotalLateCallbacks() const
+{
+    return totalLateCallbacks.loadAcquire();
+}
+
+inline void ProcessingTime::add(qint64 nanoseconds)
+{
+    const quint32 sum = static_cast<quint32>(this->nanoseconds.loadAcquire()) + static_cast<quint32>(nanoseconds); // wrapping
+    this->nanoseconds.storeRelease(static_cast<int>(sum)); // single writer, no read-modify-write
+}
+
+inline float AudioLoadMonitor::Stats::getLoad(qint64 nanoseconds) const
+{
+    return deadlineNs > 0 ? nanoseconds * 100.0f / deadlineNs : 0.0f;
+}
+
+inline bool AudioLoadReport::isEmpty() const
+{
+    return callbacks.callbacks == 0;
+}
+
+} // namespace
+
+#endif
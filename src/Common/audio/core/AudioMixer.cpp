@@ -39,30 +39,32 @@ AudioMixer::~AudioMixer()
     qCDebug(jtAudio) << "Audio mixer destructor finished!";
 }
 
-void AudioMixer::process(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, const std::vector<midi::MidiMessage> &midiBuffer, bool attenuateAfterSumming)
+void AudioMixer::process(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, const midi::MidiBuffer &midiBuffer, bool attenuateAfterSumming)
 {
     static int soloedBuffersInLastProcess = 0;
     // --------------------------------------
     bool hasSoloedBuffers = soloedBuffersInLastProcess > 0;
     soloedBuffersInLastProcess = 0;
     for (auto node : nodes) {
+        const qint64 nodeStart = audio::AudioLoadMonitor::timestamp();
         bool canProcess = (!hasSoloedBuffers && !node->isMuted()) || (hasSoloedBuffers && node->isSoloed());
         if (canProcess) {
 
             // each channel (not subchannel) will receive a full copy of incomming midi messages
-            std::vector<midi::MidiMessage> midiMessages(midiBuffer.size());
-            midiMessages.insert(midiMessages.begin(), midiBuffer.begin(), midiBuffer.end());
+            nodeMidiBuffer = midiBuffer;
 
-            node->processReplacing(in, out, sampleRate, midiMessages);
+            node->processReplacing(in, out, sampleRate, nodeMidiBuffer);
         }
         else { // just discard the samples if node is muted, the internalBuffer is not copyed to out buffer
             static audio::SamplesBuffer internalBuffer(2);
-            static std::vector<midi::MidiMessage> emptyMidiBuffer;
             internalBuffer.setFrameLenght(out.getFrameLenght());
+            emptyMidiBuffer.clear();
             node->processReplacing(in, internalBuffer, sampleRate, emptyMidiBuffer);
         }
         if (node->isSoloed())
             soloedBuffersInLastProcess++;
+
+        node->getProcessingTime().add(audio::AudioLoadMonitor::timestamp() - nodeStart);
     }
 
     if (attenuateAfterSumming) {
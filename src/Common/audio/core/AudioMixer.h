@@ -6,10 +6,7 @@
 #include <QMap>
 #include <QScopedPointer>
 #include "audio/SamplesBufferResampler.h"
-
-namespace midi {
-class MidiMessage;
-}
+#include "midi/MidiBuffer.h"
 
 namespace audio {
 
@@ -26,7 +23,7 @@ private:
 public:
     explicit AudioMixer(int sampleRate);
     ~AudioMixer();
-    void process(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, const std::vector<midi::MidiMessage> &midiBuffer, bool attenuateAfterSumming = false);
+    void process(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, const midi::MidiBuffer &midiBuffer, bool attenuateAfterSumming = false);
     void addNode(AudioNode *node);
     void removeNode(AudioNode *node);
 
@@ -37,6 +34,10 @@ private:
     int sampleRate;
     QMap<AudioNode *, SamplesBufferResampler> resamplers;
 
+    // preallocated, no allocations in audio thread
+    midi::MidiBuffer nodeMidiBuffer;
+    midi::MidiBuffer emptyMidiBuffer;
+
 };
 
 inline void AudioMixer::setSampleRate(int newSampleRate)
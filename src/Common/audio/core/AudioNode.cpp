@@ -3,6 +3,7 @@
 #include "SamplesBuffer.h"
 #include "AudioNodeProcessor.h"
 #include "AudioPeak.h"
+#include "PeaksTelemetry.h"
 #include <cmath>
 #include <cassert>
 #include <QDebug>
@@ -14,12 +15,13 @@
 using audio::AudioNode;
 using audio::SamplesBuffer;
 using audio::AudioPeak;
+using audio::PeaksTelemetry;
 using audio::AudioNodeProcessor;
 
 const double AudioNode::ROOT_2_OVER_2 = 1.414213562373095 * 0.5;
 const double AudioNode::PI_OVER_2 = 3.141592653589793238463 * 0.5;
 
-void AudioNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, std::vector<midi::MidiMessage> &midiBuffer)
+void AudioNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, midi::MidiBuffer &midiBuffer)
 {
     Q_UNUSED(in);
 
@@ -47,15 +49,16 @@ void AudioNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out, in
             tempInputBuffer.setFrameLenght(internalOutputBuffer.getFrameLenght());
             tempInputBuffer.set(internalOutputBuffer); // the output from previous plugin is used as input to the next plugin in the chain
 
+            const qint64 processorStart = AudioLoadMonitor::timestamp();
             processor->process(tempInputBuffer, internalOutputBuffer, midiBuffer);
+            processorsTime[i].add(AudioLoadMonitor::timestamp() - processorStart);
 
             // some plugins are blocking the midi messages. If a VSTi can't generate messages the previous messages list will be sended for the next plugin in the chain. The messages list is cleared only when the plugin can generate midi messages.
             if (processor->isVirtualInstrument() && processor->canGenerateMidiMessages())
                 midiBuffer.clear(); // only the fresh messages will be passed by the next plugin in the chain
 
 
-            auto pulledMessages = pullMidiMessagesGeneratedByPlugins();
-            midiBuffer.insert(midiBuffer.end(), pulledMessages.begin(), pulledMessages.end());
+            pullMidiMessagesGeneratedByPlugins(midiBuffer);
         }
     }
 
@@ -63,7 +66,7 @@ void AudioNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out, in
 
     internalOutputBuffer.applyGain(gain, leftGain, rightGain, boost);
 
-    lastPeak.update(internalOutputBuffer.computePeak());
+    publishPeak(internalOutputBuffer.computePeak());
 
     postFaderProcess(internalOutputBuffer);
 
@@ -78,7 +81,6 @@ void AudioNode::setRmsWindowSize(int samples)
 AudioNode::AudioNode() :
     internalInputBuffer(2),
     internalOutputBuffer(2),
-    lastPeak(),
     pan(0),
     leftGain(1.0),
     rightGain(1.0),
@@ -87,7 +89,9 @@ AudioNode::AudioNode() :
     activated(true),
     gain(1),
     boost(1),
-    resamplingCorrection(0)
+    resamplingCorrection(0),
+    peaksTelemetry(nullptr),
+    peaksTelemetrySlot(-1)
 {
 
     for (int i=0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
@@ -95,9 +99,9 @@ AudioNode::AudioNode() :
     }
 }
 
-std::vector<midi::MidiMessage> AudioNode::pullMidiMessagesGeneratedByPlugins() const
+void AudioNode::pullMidiMessagesGeneratedByPlugins(midi::MidiBuffer &outBuffer) const
 {
-    return std::vector<midi::MidiMessage>(); // returning empty vector by default, is overrided in LocalInputNode
+    Q_UNUSED(outBuffer) // no messages by default, is overrided in LocalInputNode
 }
 
 int AudioNode::getInputResamplingLength(int sourceSampleRate, int targetSampleRate, int outFrameLenght)
@@ -116,14 +120,22 @@ int AudioNode::getInputResamplingLength(int sourceSampleRate, int targetSampleRa
     return intValue;
 }
 
-AudioPeak AudioNode::getLastPeak() const
+void AudioNode::setPeaksTelemetry(PeaksTelemetry *telemetry, int slotID)
 {
-    return this->lastPeak;
+    peaksTelemetry = telemetry;
+    peaksTelemetrySlot = slotID;
+}
+
+void AudioNode::publishPeak(const AudioPeak &peak)
+{
+    if (peaksTelemetry)
+        peaksTelemetry->publish(peaksTelemetrySlot, isMuted() ? AudioPeak() : peak); // muted tracks meters are ZERO
 }
 
 void AudioNode::resetLastPeak()
 {
-    lastPeak.zero();
+    if (peaksTelemetry)
+        peaksTelemetry->reset(peaksTelemetrySlot);
 }
 
 void AudioNode::setPan(float pan)
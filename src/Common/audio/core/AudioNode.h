@@ -5,13 +5,15 @@
 #include <QMutex>
 #include "SamplesBuffer.h"
 #include "AudioDriver.h"
-#include "midi/MidiMessage.h"
+#include "midi/MidiBuffer.h"
+#include "AudioLoadMonitor.h"
 #include <QDebug>
 #include <QList>
 
 namespace audio {
 
 class AudioNodeProcessor;
+class PeaksTelemetry;
 
 class AudioNode : public QObject
 {
@@ -21,9 +23,9 @@ public:
     AudioNode();
     virtual ~AudioNode();
 
-    virtual void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, std::vector<midi::MidiMessage> &midiBuffer);
+    virtual void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, midi::MidiBuffer &midiBuffer);
 
-    virtual std::vector<midi::MidiMessage> pullMidiMessagesGeneratedByPlugins() const;
+    virtual void pullMidiMessagesGeneratedByPlugins(midi::MidiBuffer &outBuffer) const; // append the messages in outBuffer
 
     virtual void setMute(bool muted);
 
@@ -50,10 +52,17 @@ public:
     void setPan(float pan);
     float getPan() const;
 
-    AudioPeak getLastPeak() const;
+    // the peaks are published in a telemetry slot, read by GUI without locks
+    void setPeaksTelemetry(PeaksTelemetry *telemetry, int slotID);
+    int getPeaksTelemetrySlot() const;
 
     void resetLastPeak();
 
+    // CPU time measured in audio thread, the node time (including the plugins) is measured by the AudioMixer
+    ProcessingTime &getProcessingTime();
+    ProcessingTime &getProcessorProcessingTime(quint32 slotIndex);
+    AudioNodeProcessor *getProcessor(quint32 slotIndex) const;
+
     void setRmsWindowSize(int samples);
 
     void deactivate();
@@ -78,7 +87,8 @@ protected:
     SamplesBuffer internalInputBuffer;
     SamplesBuffer internalOutputBuffer;
 
-    mutable audio::AudioPeak lastPeak;
+    void publishPeak(const AudioPeak &peak); // called in audio thread
+
     QMutex mutex; // used to protected connections manipulation because nodes can be added or removed by different threads
 
     // pan
@@ -103,6 +113,12 @@ private:
 
     double resamplingCorrection;
 
+    PeaksTelemetry *peaksTelemetry;
+    int peaksTelemetrySlot;
+
+    ProcessingTime processingTime;
+    ProcessingTime processorsTime[MAX_PROCESSORS_PER_TRACK];
+
     void updateGains();
 
 signals:
@@ -154,6 +170,28 @@ inline bool AudioNode::isSoloed() const
     return soloed;
 }
 
+inline int AudioNode::getPeaksTelemetrySlot() const
+{
+    return peaksTelemetrySlot;
+}
+
+inline ProcessingTime &AudioNode::getProcessingTime()
+{
+    return processingTime;
+}
+
+inline ProcessingTime &AudioNode::getProcessorProcessingTime(quint32 slotIndex)
+{
+    Q_ASSERT(slotIndex < MAX_PROCESSORS_PER_TRACK);
+
+    return processorsTime[slotIndex];
+}
+
+inline AudioNodeProcessor *AudioNode::getProcessor(quint32 slotIndex) const
+{
+    return slotIndex < MAX_PROCESSORS_PER_TRACK ? processors[slotIndex] : nullptr;
+}
+
 
 }//namespace
 
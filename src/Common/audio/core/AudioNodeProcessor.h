@@ -2,7 +2,7 @@
 #define _AUDIO_NODE_PROCESSOR_H_
 
 #include <QObject>
-#include "midi/MidiMessage.h"
+#include "midi/MidiBuffer.h"
 
 
 namespace audio {
@@ -17,13 +17,14 @@ public:
 
     virtual ~AudioNodeProcessor();
 
-    virtual void process(const SamplesBuffer &in, SamplesBuffer &out, std::vector<midi::MidiMessage> &midiMessages) = 0;
+    virtual void process(const SamplesBuffer &in, SamplesBuffer &out, midi::MidiBuffer &midiMessages) = 0;
     virtual void suspend() = 0;
     virtual void resume() = 0;
     virtual void updateGui() = 0;
     virtual void openEditor(const QPoint &centerOfScreen) = 0;
     virtual void closeEditor() = 0;
     virtual void setSampleRate(int newSampleRate);
+    virtual void setTempo(int bpm); // used by tempo synced processors (native delay)
 
     virtual void setBypass(bool state);
     bool isBypassed() const;
@@ -63,6 +64,11 @@ inline void AudioNodeProcessor::setSampleRate(int newSampleRate)
     Q_UNUSED(newSampleRate);
 }
 
+inline void AudioNodeProcessor::setTempo(int bpm)
+{
+    Q_UNUSED(bpm);
+}
+
 
 }//namespace
 
@@ -1,9 +1,11 @@
 #include "Filters.h"
+#include "SamplesBuffer.h"
 #include <cfloat>
 #include <cmath>
 #include <cstdint>
 
 using audio::Filter;
+using audio::FilterBank;
 
 #define SQUARE(x) ((x) * (x))
 
@@ -47,6 +49,16 @@ void Filter::setFrequency(double newFrequency)
 }
 
 void Filter::initialize(FilterType type, double freq, double Q, double gain)
+{
+    const Coefficients coefficients = computeCoefficients(type, sampleRate, freq, Q, gain);
+    b0 = coefficients.b0;
+    b1 = coefficients.b1;
+    b2 = coefficients.b2;
+    a1 = coefficients.a1;
+    a2 = coefficients.a2;
+}
+
+Filter::Coefficients Filter::computeCoefficients(FilterType type, double sampleRate, double freq, double Q, double gain)
 {
     if (Q <= .001)
         Q = 0.001;
@@ -68,7 +80,8 @@ void Filter::initialize(FilterType type, double freq, double Q, double gain)
     const double alpha = sinW0 / (2.0 * Q);
     const double beta = sqrt(A) / Q;
 
-    double a0 = 0;
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0;
+    double a0 = 1.0, a1 = 0.0, a2 = 0.0;
 
     switch (type) {
     case LowPass:
@@ -153,11 +166,13 @@ void Filter::initialize(FilterType type, double freq, double Q, double gain)
         break;
     }
 
-    b0 /= a0;
-    b1 /= a0;
-    b2 /= a0;
-    a1 /= a0;
-    a2 /= a0;
+    Coefficients coefficients;
+    coefficients.b0 = b0 / a0;
+    coefficients.b1 = b1 / a0;
+    coefficients.b2 = b2 / a0;
+    coefficients.a1 = a1 / a0;
+    coefficients.a2 = a2 / a0;
+    return coefficients;
 }
 
 float Filter::dBAtFrequency(float freq) const
@@ -184,3 +199,167 @@ float Filter::dBAtFrequency(float freq) const
 
     return std::min(120.f, std::max(-120.f, rv));
 }
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+FilterBank::FilterBank(Filter::FilterType type, double sampleRate, double frequency, double Q, double gain) :
+    type(type),
+    sampleRate(sampleRate),
+    frequency(frequency),
+    Q(Q),
+    gain(gain),
+    interpolationFramesLeft(0)
+{
+    setParameters(frequency, Q, gain);
+    reset();
+}
+
+void FilterBank::reset()
+{
+    for (int l = 0; l < MAX_LANES; ++l)
+        z1[l] = z2[l] = 0.0f;
+}
+
+void FilterBank::setSampleRate(double newSampleRate)
+{
+    if (newSampleRate <= 0 || newSampleRate == sampleRate)
+        return;
+
+    sampleRate = newSampleRate;
+    setParameters(frequency, Q, gain);
+    reset(); // the history was computed with the old coefficients
+}
+
+void FilterBank::setFrequency(double newFrequency, quint32 interpolationFrames)
+{
+    setParameters(newFrequency, Q, gain, interpolationFrames);
+}
+
+void FilterBank::setParameters(double newFrequency, double newQ, double newGain, quint32 interpolationFrames)
+{
+    frequency = newFrequency;
+    Q = newQ;
+    gain = newGain;
+
+    const Filter::Coefficients newCoefficients = Filter::computeCoefficients(type, sampleRate, frequency, Q, gain);
+    targetCoefficients.b0 = newCoefficients.b0;
+    targetCoefficients.b1 = newCoefficients.b1;
+    targetCoefficients.b2 = newCoefficients.b2;
+    targetCoefficients.a1 = newCoefficients.a1;
+    targetCoefficients.a2 = newCoefficients.a2;
+
+    if (interpolationFrames == 0) {
+        coefficients = targetCoefficients;
+        interpolationFramesLeft = 0;
+        return;
+    }
+
+    increments.b0 = (targetCoefficients.b0 - coefficients.b0) / interpolationFrames;
+    increments.b1 = (targetCoefficients.b1 - coefficients.b1) / interpolationFrames;
+    increments.b2 = (targetCoefficients.b2 - coefficients.b2) / interpolationFrames;
+    increments.a1 = (targetCoefficients.a1 - coefficients.a1) / interpolationFrames;
+    increments.a2 = (targetCoefficients.a2 - coefficients.a2) / interpolationFrames;
+    interpolationFramesLeft = interpolationFrames;
+}
+
+void FilterBank::advanceInterpolation(quint32 frames)
+{
+    if (frames >= interpolationFramesLeft) {
+        coefficients = targetCoefficients;
+        interpolationFramesLeft = 0;
+        return;
+    }
+
+    coefficients.b0 += increments.b0 * frames;
+    coefficients.b1 += increments.b1 * frames;
+    coefficients.b2 += increments.b2 * frames;
+    coefficients.a1 += increments.a1 * frames;
+    coefficients.a2 += increments.a2 * frames;
+    interpolationFramesLeft -= frames;
+}
+
+void FilterBank::process(SamplesBuffer &buffer)
+{
+    float *lanes[MAX_LANES];
+    const int lanesCount = qMin(buffer.getChannels(), static_cast<int>(MAX_LANES));
+    for (int l = 0; l < lanesCount; ++l)
+        lanes[l] = buffer.getSamplesArray(l);
+
+    process(lanes, lanesCount, buffer.getFrameLenght());
+}
+
+void FilterBank::process(float * const *lanes, int lanesCount, quint32 samples)
+{
+    Q_ASSERT(lanesCount <= MAX_LANES);
+    lanesCount = qMin(lanesCount, static_cast<int>(MAX_LANES));
+
+    for (quint32 offset = 0; offset < samples; offset += BLOCK_SIZE) {
+        const quint32 blockSamples = qMin(static_cast<quint32>(BLOCK_SIZE), samples - offset);
+
+        // the interpolated coefficients are changed in steps of BLOCK_SIZE samples
+        if (interpolationFramesLeft > 0)
+            advanceInterpolation(blockSamples);
+
+        for (int firstLane = 0; firstLane < lanesCount; firstLane += LANES_PER_GROUP) {
+            const int lanesInGroup = qMin(static_cast<int>(LANES_PER_GROUP), lanesCount - firstLane);
+            processGroup(lanes, firstLane, lanesInGroup, offset, blockSamples);
+        }
+    }
+
+    for (int l = 0; l < lanesCount; ++l) {
+        if (!std::isfinite(z1[l]) || !std::isfinite(z2[l]))
+            z1[l] = z2[l] = 0.0f;
+    }
+}
+
+void FilterBank::processGroup(float * const *lanes, int firstLane, int lanesInGroup, quint32 offset, quint32 samples)
+{
+    // interleaving the group lanes, the unused lanes are processing silence
+    float block[BLOCK_SIZE][LANES_PER_GROUP];
+    for (int l = 0; l < LANES_PER_GROUP; ++l) {
+        if (l < lanesInGroup) {
+            const float *input = lanes[firstLane + l] + offset;
+            for (quint32 i = 0; i < samples; ++i)
+                block[i][l] = input[i];
+        }
+        else {
+            for (quint32 i = 0; i < samples; ++i)
+                block[i][l] = 0.0f;
+        }
+    }
+
+    const float b0 = coefficients.b0;
+    const float b1 = coefficients.b1;
+    const float b2 = coefficients.b2;
+    const float a1 = coefficients.a1;
+    const float a2 = coefficients.a2;
+
+    static_assert(MAX_LANES % LANES_PER_GROUP == 0, "the lanes history is stored in complete groups");
+
+    float s1[LANES_PER_GROUP];
+    float s2[LANES_PER_GROUP];
+    for (int l = 0; l < LANES_PER_GROUP; ++l) {
+        s1[l] = z1[firstLane + l];
+        s2[l] = z2[firstLane + l];
+    }
+
+    // transposed direct form II, the same as Filter::process() in 4 lanes
+    for (quint32 i = 0; i < samples; ++i) {
+        for (int l = 0; l < LANES_PER_GROUP; ++l) {
+            const float xn = block[i][l];
+            const float z = b0 * xn + s1[l];
+            s1[l] = b1 * xn - a1 * z + s2[l];
+            s2[l] = b2 * xn - a2 * z;
+            block[i][l] = z;
+        }
+    }
+
+    for (int l = 0; l < lanesInGroup; ++l) {
+        z1[firstLane + l] = s1[l];
+        z2[firstLane + l] = s2[l];
+
+        float *output = lanes[firstLane + l] + offset;
+        for (quint32 i = 0; i < samples; ++i)
+            output[i] = block[i][l];
+    }
+}
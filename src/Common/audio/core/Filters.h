@@ -6,6 +6,8 @@
 namespace audio
 {
 
+class SamplesBuffer;
+
 /** Biquad Filter - Adapted from Ardour code: http://ardour.org/ */
 
 class Filter
@@ -24,8 +26,16 @@ public:
         HighShelf
     };
 
+    struct Coefficients
+    {
+        double b0, b1, b2;
+        double a1, a2; // normalized, a0 is 1
+    };
+
     Filter (FilterType type, double samplerate, double frequency, double Q = 1.0, double gain = 1.0);
 
+    static Coefficients computeCoefficients(FilterType type, double sampleRate, double frequency, double Q, double gain);
+
     void process(float *data, const quint32 samples);
 
     void setFrequency(double newFrequency);
@@ -59,6 +69,83 @@ private:
     FilterType type;
 };
 
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+/**
+ * The same biquad applied in many channels (lanes) at the same time. The coefficients are shared by all
+ * lanes and the history samples are stored per lane. The lanes are processed in groups of 4, interleaved in
+ * a small block, and the inner loop in the group lanes is vectorized by the compiler (one SIMD register
+ * with 4 lanes), the recursion in time is not vectorizable in a single channel.
+ *
+ * The coefficients are linearly interpolated when the parameters are changed. The stable biquads region is
+ * convex, so the interpolated filters are stable too.
+ */
+
+class FilterBank
+{
+public:
+    static const int MAX_LANES = 16;
+
+    FilterBank(Filter::FilterType type, double sampleRate, double frequency, double Q = 1.0, double gain = 1.0);
+
+    void process(float * const *lanes, int lanesCount, quint32 samples);
+    void process(SamplesBuffer &buffer); // a lane per channel
+
+    // the new coefficients are reached after 'interpolationFrames', the filter history is preserved
+    void setParameters(double frequency, double Q, double gain, quint32 interpolationFrames = 0);
+    void setFrequency(double frequency, quint32 interpolationFrames = 0); // keeping Q and gain
+
+    void setSampleRate(double sampleRate); // no interpolation, the history is cleared
+
+    void reset();
+
+    bool isInterpolating() const;
+    double getFrequency() const;
+    double getSampleRate() const;
+
+private:
+    static const int LANES_PER_GROUP = 4;
+    static const int BLOCK_SIZE = 64; // the interpolated coefficients are updated in each block
+
+    struct LanesCoefficients
+    {
+        float b0, b1, b2;
+        float a1, a2;
+    };
+
+    void processGroup(float * const *lanes, int firstLane, int lanesInGroup, quint32 offset, quint32 samples);
+    void advanceInterpolation(quint32 frames);
+
+    Filter::FilterType type;
+    double sampleRate;
+    double frequency;
+    double Q;
+    double gain;
+
+    LanesCoefficients coefficients;
+    LanesCoefficients targetCoefficients;
+    LanesCoefficients increments; // per frame
+    quint32 interpolationFramesLeft;
+
+    float z1[MAX_LANES];
+    float z2[MAX_LANES];
+};
+
+inline bool FilterBank::isInterpolating() const
+{
+    return interpolationFramesLeft > 0;
+}
+
+inline double FilterBank::getFrequency() const
+{
+    return frequency;
+}
+
+inline double FilterBank::getSampleRate() const
+{
+    return sampleRate;
+}
+
 } // namespace
 
 #endif
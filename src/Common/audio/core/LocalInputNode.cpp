@@ -2,9 +2,6 @@
 #include "audio/core/AudioNodeProcessor.h"
 #include "midi/MidiMessage.h"
 #include "MainController.h"
-#include "NinjamController.h"
-
-#include <QDateTime>
 
 using audio::LocalInputNode;
 using audio::Looper;
@@ -154,6 +151,14 @@ void LocalInputNode::setProcessorsSampleRate(int newSampleRate)
     }
 }
 
+void LocalInputNode::setProcessorsTempo(int bpm)
+{
+    for (int i = 0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
+        if (processors[i])
+            processors[i]->setTempo(bpm);
+    }
+}
+
 void LocalInputNode::closeProcessorsWindows()
 {
     for (int i = 0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
@@ -224,7 +229,7 @@ bool LocalInputNode::isReceivingAllMidiChannels() const
 }
 
 void LocalInputNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out,
-                                           int sampleRate, std::vector<midi::MidiMessage> &midiBuffer)
+                                           int sampleRate, midi::MidiBuffer &midiBuffer)
 {
     Q_UNUSED(sampleRate);
 
@@ -238,7 +243,7 @@ void LocalInputNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &ou
     *
     */
 
-    std::vector<midi::MidiMessage> filteredMidiBuffer(midiBuffer.size());
+    filteredMidiBuffer.clear();
     internalInputBuffer.setFrameLenght(out.getFrameLenght());
     internalOutputBuffer.setFrameLenght(out.getFrameLenght());
     internalInputBuffer.zero();
@@ -265,7 +270,7 @@ void LocalInputNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &ou
     }
 
     if (isRoutingMidiInput()) {
-        lastPeak.update(AudioPeak()); // ensure the audio meters will be ZERO
+        publishPeak(AudioPeak()); // ensure the audio meters will be ZERO
 
         return; // when routing midi this track will not render midi data, this data will be rendered by first subchannel. But the midi data is processed above to update MIDI activity meter
     }
@@ -302,25 +307,22 @@ void LocalInputNode::setReceivingRoutedMidiInput(bool receiveRoutedMidiInput)
         routingMidiInput = false;
 }
 
-void LocalInputNode::processIncommingMidi(std::vector<midi::MidiMessage> &inBuffer, std::vector<midi::MidiMessage> &outBuffer)
+void LocalInputNode::processIncommingMidi(midi::MidiBuffer &inBuffer, midi::MidiBuffer &outBuffer)
 {
-    auto iterator = inBuffer.begin();
-    while(iterator != inBuffer.end()) {
-        auto message(*iterator);
-        if (canProcessMidiMessage(message)) {
-            message.transpose(getTranspose());
+    const qint8 transpose = getTranspose();
 
-            outBuffer.push_back(message);
+    // the accepted messages are moved to outBuffer, the other messages can be processed by other subchannel
+    inBuffer.moveTo(outBuffer, [&](midi::MidiMessage &message) {
+        if (!canProcessMidiMessage(message))
+            return false;
 
-            // save the midi activity peak value for notes or controls
-            midiInput.updateActivity(message);
+        message.transpose(transpose);
 
-            iterator = inBuffer.erase(iterator);
-        }
-        else {
-            ++iterator;
-        }
-    }
+        // save the midi activity peak value for notes or controls
+        midiInput.updateActivity(message);
+
+        return true;
+    });
 }
 
 qint8 LocalInputNode::getTranspose() const
@@ -387,9 +389,9 @@ bool LocalInputNode::canProcessMidiMessage(const midi::MidiMessage &message) con
     return midiInput.accept(message);
 }
 
-std::vector<midi::MidiMessage> LocalInputNode::pullMidiMessagesGeneratedByPlugins() const
+void LocalInputNode::pullMidiMessagesGeneratedByPlugins(midi::MidiBuffer &outBuffer) const
 {
-    return mainController->pullMidiMessagesFromPlugins();
+    mainController->pullMidiMessagesFromPlugins(outBuffer);
 }
 
 void LocalInputNode::startMidiNoteLearn()
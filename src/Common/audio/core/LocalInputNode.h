@@ -21,7 +21,7 @@ class LocalInputNode : public AudioNode
 public:
     LocalInputNode(controller::MainController *controller, int parentChannelIndex, bool isMono = true);
     ~LocalInputNode();
-    void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, std::vector<midi::MidiMessage> &midiBuffer) override;
+    void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, midi::MidiBuffer &midiBuffer) override;
     virtual int getSampleRate() const;
 
     int getChannels() const;
@@ -52,7 +52,7 @@ public:
 
     bool isReceivingAllMidiChannels() const;
 
-    std::vector<midi::MidiMessage> pullMidiMessagesGeneratedByPlugins() const override;
+    void pullMidiMessagesGeneratedByPlugins(midi::MidiBuffer &outBuffer) const override;
 
     ChannelRange getAudioInputRange() const;
 
@@ -62,6 +62,7 @@ public:
     SamplesBuffer getLastBufferMixedToMono() const;
 
     void setProcessorsSampleRate(int newSampleRate);
+    void setProcessorsTempo(int bpm);
 
     void closeProcessorsWindows();
 
@@ -162,7 +163,9 @@ private:
 
     bool canProcessMidiMessage(const midi::MidiMessage &msg) const;
 
-    void processIncommingMidi(std::vector<midi::MidiMessage> &inBuffer, std::vector<midi::MidiMessage> &outBuffer);
+    void processIncommingMidi(midi::MidiBuffer &inBuffer, midi::MidiBuffer &outBuffer);
+
+    midi::MidiBuffer filteredMidiBuffer; // preallocated, reused in each audio callback
 
     audio::Looper* looper;
 
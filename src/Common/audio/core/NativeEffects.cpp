@@ -0,0 +1,577 @@
+#include "NativeEffects.h"
+
+#include <algorithm>
+#include <cmath>
+
+using audio::SmoothedValue;
+using audio::DelayEffect;
+using audio::EqualizerEffect;
+using audio::CompressorEffect;
+using audio::SamplesBuffer;
+using audio::Filter;
+using audio::FilterBank;
+
+namespace {
+
+const int DELAY_RAMP_IN_MS = 100; // delay time changes are played like a tape delay, without clicks
+const int GAIN_RAMP_IN_MS = 20;
+const int FILTER_RAMP_IN_MS = 50;
+
+const int DELAY_LINE_SAMPLE_RATE = 96000; // the delay line capacity is MAX_DELAY_IN_SECONDS in this sample rate
+
+int msToFrames(int ms, int sampleRate)
+{
+    return ms * sampleRate / 1000;
+}
+
+float dbToLinear(float db)
+{
+    return std::pow(10.0f, db / 20.0f);
+}
+
+} // namespace
+
+SmoothedValue::SmoothedValue(float value) :
+    current(value),
+    target(value),
+    increment(0.0f),
+    remainingFrames(0),
+    rampLength(0)
+{
+
+}
+
+void SmoothedValue::setRampLength(int frames)
+{
+    rampLength = qMax(frames, 0);
+}
+
+void SmoothedValue::setTarget(float newTarget)
+{
+    if (newTarget == target)
+        return;
+
+    target = newTarget;
+
+    if (rampLength <= 0) {
+        reset(newTarget);
+        return;
+    }
+
+    remainingFrames = rampLength;
+    increment = (target - current) / rampLength;
+}
+
+void SmoothedValue::reset(float value)
+{
+    current = target = value;
+    increment = 0.0f;
+    remainingFrames = 0;
+}
+
+void SmoothedValue::nextRamp(int frames, float &start, float &step)
+{
+    start = current;
+
+    if (remainingFrames <= 0 || frames <= 0) {
+        step = 0.0f;
+        return;
+    }
+
+    if (frames < remainingFrames) {
+        step = increment;
+        current += increment * frames;
+        remainingFrames -= frames;
+    }
+    else {
+        step = (target - current) / frames;
+        current = target;
+        remainingFrames = 0;
+    }
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+const int DelayEffect::MAX_DELAY_IN_SECONDS = 3;
+const float DelayEffect::MAX_FEEDBACK = 0.95f;
+
+DelayEffect::DelayEffect(int sampleRate) :
+    delayTime(500.0f),
+    feedback(0.3f),
+    level(0.5f),
+    syncDivision(NoSync),
+    tempo(120),
+    delayLine(2, MAX_DELAY_IN_SECONDS * qMax(sampleRate, DELAY_LINE_SAMPLE_RATE) + 2),
+    lineLength(0),
+    writeIndex(0),
+    sampleRate(0),
+    pendingSampleRate(0)
+{
+    applySampleRate(sampleRate);
+}
+
+void DelayEffect::setSampleRate(int newSampleRate)
+{
+    if (newSampleRate > 0)
+        pendingSampleRate.storeRelease(newSampleRate);
+}
+
+void DelayEffect::applySampleRate(int newSampleRate)
+{
+    if (newSampleRate == sampleRate)
+        return;
+
+    sampleRate = newSampleRate;
+
+    lineLength = qMin(static_cast<uint>(MAX_DELAY_IN_SECONDS * sampleRate + 2), delayLine.getFrameLenght());
+    clear();
+
+    smoothedDelay.setRampLength(msToFrames(DELAY_RAMP_IN_MS, sampleRate));
+    smoothedFeedback.setRampLength(msToFrames(GAIN_RAMP_IN_MS, sampleRate));
+    smoothedLevel.setRampLength(msToFrames(GAIN_RAMP_IN_MS, sampleRate));
+
+    smoothedDelay.reset(getDelayTimeInSamples());
+    smoothedFeedback.reset(feedback.load());
+    smoothedLevel.reset(level.load());
+}
+
+void DelayEffect::setTempo(int bpm)
+{
+    if (bpm > 0)
+        tempo.storeRelease(bpm);
+}
+
+void DelayEffect::setDelayTime(float delayTimeInMs)
+{
+    delayTime.store(qBound(1.0f, delayTimeInMs, MAX_DELAY_IN_SECONDS * 1000.0f));
+}
+
+void DelayEffect::setSyncDivision(SyncDivision division)
+{
+    if (division >= NoSync && division < SYNC_DIVISIONS)
+        syncDivision.storeRelease(division);
+}
+
+void DelayEffect::setFeedback(float feedback)
+{
+    this->feedback.store(qBound(0.0f, feedback, MAX_FEEDBACK));
+}
+
+void DelayEffect::setLevel(float level)
+{
+    this->level.store(qBound(0.0f, level, 1.0f));
+}
+
+void DelayEffect::clear()
+{
+    for (int c = 0; c < delayLine.getChannels(); ++c)
+        std::fill(delayLine.getSamplesArray(c), delayLine.getSamplesArray(c) + lineLength, 0.0f);
+
+    writeIndex = 0;
+}
+
+float DelayEffect::getDivisionInBeats(SyncDivision division)
+{
+    switch (division) {
+    case Whole:             return 4.0f;
+    case Half:              return 2.0f;
+    case DottedQuarter:     return 1.5f;
+    case Quarter:           return 1.0f;
+    case QuarterTriplet:    return 2.0f / 3.0f;
+    case DottedEighth:      return 0.75f;
+    case Eighth:            return 0.5f;
+    case EighthTriplet:     return 1.0f / 3.0f;
+    case Sixteenth:         return 0.25f;
+    default:
+        return 0.0f;
+    }
+}
+
+float DelayEffect::getDelayTimeInSamples() const
+{
+    const SyncDivision division = static_cast<SyncDivision>(syncDivision.loadAcquire());
+
+    float samples;
+    if (division == NoSync)
+        samples = delayTime.load() / 1000.0f * sampleRate;
+    else
+        samples = getDivisionInBeats(division) * 60.0f / tempo.loadAcquire() * sampleRate;
+
+    // rounded, the stable delay time is processed without interpolation
+    const float maxDelay = lineLength - 2;
+    return qBound(2.0f, std::floor(samples + 0.5f), maxDelay);
+}
+
+void DelayEffect::process(SamplesBuffer &buffer)
+{
+    const int newSampleRate = pendingSampleRate.fetchAndStoreOrdered(0);
+    if (newSampleRate > 0)
+        applySampleRate(newSampleRate);
+
+    const uint frames = buffer.getFrameLenght();
+
+    smoothedDelay.setTarget(getDelayTimeInSamples());
+    smoothedFeedback.setTarget(feedback.load());
+    smoothedLevel.setTarget(level.load());
+
+    uint offset = 0;
+    while (offset < frames) {
+        if (smoothedDelay.isSmoothing()) {
+            processModulated(buffer, offset, frames - offset);
+            break;
+        }
+
+        // chunks are not longer than the delay time, so the read and write regions are not overlapping
+        const uint delayInSamples = static_cast<uint>(smoothedDelay.getCurrent());
+        const uint readIndex = (writeIndex + lineLength - delayInSamples) % lineLength;
+        uint chunk = qMin(frames - offset, delayInSamples);
+        chunk = qMin(chunk, lineLength - writeIndex);
+        chunk = qMin(chunk, lineLength - readIndex);
+
+        processChunk(buffer, offset, chunk, readIndex);
+
+        writeIndex = (writeIndex + chunk) % lineLength;
+        offset += chunk;
+    }
+}
+
+void DelayEffect::processChunk(SamplesBuffer &buffer, uint offset, uint frames, uint readIndex)
+{
+    float feedbackStart, feedbackStep;
+    float levelStart, levelStep;
+    smoothedFeedback.nextRamp(frames, feedbackStart, feedbackStep);
+    smoothedLevel.nextRamp(frames, levelStart, levelStep);
+
+    const int channels = qMin(buffer.getChannels(), delayLine.getChannels());
+    for (int c = 0; c < channels; ++c) {
+        float *samples = buffer.getSamplesArray(c) + offset;
+        const float *delayed = delayLine.getSamplesArray(c) + readIndex;
+        float *line = delayLine.getSamplesArray(c) + writeIndex;
+
+        for (uint i = 0; i < frames; ++i) {
+            const float dry = samples[i];
+            const float wet = delayed[i];
+            line[i] = dry + wet * (feedbackStart + feedbackStep * i);
+            samples[i] = dry + wet * (levelStart + levelStep * i);
+        }
+    }
+}
+
+void DelayEffect::processModulated(SamplesBuffer &buffer, uint offset, uint frames)
+{
+    float delayStart, delayStep;
+    float feedbackStart, feedbackStep;
+    float levelStart, levelStep;
+    smoothedDelay.nextRamp(frames, delayStart, delayStep);
+    smoothedFeedback.nextRamp(frames, feedbackStart, feedbackStep);
+    smoothedLevel.nextRamp(frames, levelStart, levelStep);
+
+    const int channels = qMin(buffer.getChannels(), delayLine.getChannels());
+    for (int c = 0; c < channels; ++c) {
+        float *samples = buffer.getSamplesArray(c) + offset;
+        float *line = delayLine.getSamplesArray(c);
+
+        uint index = writeIndex;
+        for (uint i = 0; i < frames; ++i) {
+            // linear interpolation in the fractional delay time
+            float readPosition = index - (delayStart + delayStep * i);
+            if (readPosition < 0)
+                readPosition += lineLength;
+
+            if (readPosition >= lineLength) // a tiny negative position is rounded to lineLength, reading out of the line
+                readPosition -= lineLength;
+
+            const uint readIndex = static_cast<uint>(readPosition);
+            const uint nextIndex = (readIndex + 1) % lineLength;
+            const float fraction = readPosition - readIndex;
+            const float wet = line[readIndex] + (line[nextIndex] - line[readIndex]) * fraction;
+
+            const float dry = samples[i];
+            line[index] = dry + wet * (feedbackStart + feedbackStep * i);
+            samples[i] = dry + wet * (levelStart + levelStep * i);
+
+            if (++index == lineLength)
+                index = 0;
+        }
+    }
+
+    writeIndex = (writeIndex + frames) % lineLength;
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+const float EqualizerEffect::MAX_GAIN = 15.0f;
+
+EqualizerEffect::EqualizerEffect(int sampleRate) :
+    sampleRate(0),
+    pendingSampleRate(0)
+{
+    for (int b = 0; b < BANDS; ++b) {
+        BandState &band = bands[b];
+        const float q = (b == LowShelf || b == HighShelf) ? 0.707f : 1.0f;
+
+        band.gain.store(0.0f);
+        band.frequency.store(getDefaultFrequency(static_cast<Band>(b)));
+        band.q.store(q);
+
+        band.smoothedGain.reset(0.0f);
+        band.smoothedFrequency.reset(getDefaultFrequency(static_cast<Band>(b)));
+        band.smoothedQ.reset(q);
+    }
+
+    applySampleRate(sampleRate);
+
+    for (int b = 0; b < BANDS; ++b)
+        filters.append(createFilter(b));
+}
+
+float EqualizerEffect::getDefaultFrequency(Band band)
+{
+    switch (band) {
+    case LowShelf:  return 100.0f;
+    case LowMid:    return 400.0f;
+    case HighMid:   return 2500.0f;
+    case HighShelf: return 8000.0f;
+    default:
+        return 1000.0f;
+    }
+}
+
+void EqualizerEffect::setSampleRate(int newSampleRate)
+{
+    if (newSampleRate > 0)
+        pendingSampleRate.storeRelease(newSampleRate);
+}
+
+void EqualizerEffect::applySampleRate(int newSampleRate)
+{
+    if (newSampleRate == sampleRate)
+        return;
+
+    sampleRate = newSampleRate;
+
+    const int rampLength = msToFrames(FILTER_RAMP_IN_MS, sampleRate);
+    for (BandState &band : bands) {
+        band.smoothedGain.setRampLength(rampLength);
+        band.smoothedFrequency.setRampLength(rampLength);
+        band.smoothedQ.setRampLength(rampLength);
+    }
+
+    // replacing the filters in the existing vector, no allocations in the audio thread
+    for (int b = 0; b < filters.size(); ++b)
+        filters[b] = createFilter(b);
+}
+
+FilterBank EqualizerEffect::createFilter(int b) const
+{
+    Filter::FilterType type = Filter::Peaking;
+    if (b == LowShelf)
+        type = Filter::LowShelf;
+    else if (b == HighShelf)
+        type = Filter::HighShelf;
+
+    const BandState &band = bands[b];
+    const float frequency = qMin(band.smoothedFrequency.getCurrent(), sampleRate * 0.49f);
+    return FilterBank(type, sampleRate, frequency, band.smoothedQ.getCurrent(), band.smoothedGain.getCurrent());
+}
+
+void EqualizerEffect::setBandGain(Band band, float gainInDb)
+{
+    bands[band].gain.store(qBound(-MAX_GAIN, gainInDb, MAX_GAIN));
+}
+
+void EqualizerEffect::setBandFrequency(Band band, float frequency)
+{
+    bands[band].frequency.store(qBound(20.0f, frequency, 20000.0f));
+}
+
+void EqualizerEffect::setBandQ(Band band, float q)
+{
+    bands[band].q.store(qBound(0.1f, q, 10.0f));
+}
+
+void EqualizerEffect::clear()
+{
+    for (FilterBank &filter : filters)
+        filter.reset();
+}
+
+bool EqualizerEffect::updateBand(int b, int frames)
+{
+    BandState &band = bands[b];
+    if (band.smoothedGain.isSmoothing() || band.smoothedFrequency.isSmoothing() || band.smoothedQ.isSmoothing()) {
+        float start, step;
+        band.smoothedGain.nextRamp(frames, start, step);
+        band.smoothedFrequency.nextRamp(frames, start, step);
+        band.smoothedQ.nextRamp(frames, start, step);
+
+        // the filter state is preserved, only the coefficients are changed
+        const float frequency = qMin(band.smoothedFrequency.getCurrent(), sampleRate * 0.49f);
+        filters[b].setParameters(frequency, band.smoothedQ.getCurrent(), band.smoothedGain.getCurrent());
+
+        return true;
+    }
+
+    return qAbs(band.smoothedGain.getCurrent()) >= 0.01f; // flat bands are skipped
+}
+
+void EqualizerEffect::process(SamplesBuffer &buffer)
+{
+    const int newSampleRate = pendingSampleRate.fetchAndStoreOrdered(0);
+    if (newSampleRate > 0)
+        applySampleRate(newSampleRate);
+
+    const uint frames = buffer.getFrameLenght();
+    const int channels = qMin(buffer.getChannels(), static_cast<int>(CHANNELS));
+    float *lanes[CHANNELS];
+
+    bool smoothing = false;
+    for (BandState &band : bands) {
+        band.smoothedGain.setTarget(band.gain.load());
+        band.smoothedFrequency.setTarget(band.frequency.load());
+        band.smoothedQ.setTarget(band.q.load());
+
+        smoothing |= band.smoothedGain.isSmoothing() || band.smoothedFrequency.isSmoothing() || band.smoothedQ.isSmoothing();
+    }
+
+    // the entire buffer is processed by each band when the parameters are stable
+    const uint blockSize = smoothing ? static_cast<uint>(SUB_BLOCK_SIZE) : frames;
+    for (uint offset = 0; offset < frames; offset += blockSize) {
+        const uint blockFrames = qMin(blockSize, frames - offset);
+        for (int b = 0; b < BANDS; ++b) {
+            if (!updateBand(b, blockFrames))
+                continue;
+
+            for (int c = 0; c < channels; ++c)
+                lanes[c] = buffer.getSamplesArray(c) + offset;
+
+            filters[b].process(lanes, channels, blockFrames);
+        }
+    }
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+CompressorEffect::CompressorEffect(int sampleRate) :
+    threshold(-18.0f),
+    ratio(4.0f),
+    attack(10.0f),
+    release(150.0f),
+    makeupGain(0.0f),
+    gainReduction(0.0f),
+    envelope(0.0f),
+    currentGain(1.0f),
+    sampleRate(0),
+    pendingSampleRate(0)
+{
+    applySampleRate(sampleRate);
+}
+
+void CompressorEffect::setSampleRate(int newSampleRate)
+{
+    if (newSampleRate > 0)
+        pendingSampleRate.storeRelease(newSampleRate);
+}
+
+void CompressorEffect::applySampleRate(int newSampleRate)
+{
+    sampleRate = newSampleRate;
+    smoothedMakeupGain.setRampLength(msToFrames(GAIN_RAMP_IN_MS, sampleRate));
+}
+
+void CompressorEffect::setThreshold(float thresholdInDb)
+{
+    threshold.store(qBound(-60.0f, thresholdInDb, 0.0f));
+}
+
+void CompressorEffect::setRatio(float ratio)
+{
+    this->ratio.store(qBound(1.0f, ratio, 20.0f));
+}
+
+void CompressorEffect::setAttack(float attackInMs)
+{
+    attack.store(qBound(0.1f, attackInMs, 200.0f));
+}
+
+void CompressorEffect::setRelease(float releaseInMs)
+{
+    release.store(qBound(10.0f, releaseInMs, 2000.0f));
+}
+
+void CompressorEffect::setMakeupGain(float gainInDb)
+{
+    makeupGain.store(qBound(0.0f, gainInDb, 24.0f));
+}
+
+void CompressorEffect::clear()
+{
+    envelope = 0.0f;
+    smoothedMakeupGain.reset(makeupGain.load());
+    currentGain = dbToLinear(smoothedMakeupGain.getCurrent());
+    gainReduction.store(0.0f);
+}
+
+float CompressorEffect::getCoefficient(float timeInMs) const
+{
+    return std::exp(-SUB_BLOCK_SIZE * 1000.0f / (timeInMs * sampleRate));
+}
+
+void CompressorEffect::process(SamplesBuffer &buffer)
+{
+    const int newSampleRate = pendingSampleRate.fetchAndStoreOrdered(0);
+    if (newSampleRate > 0)
+        applySampleRate(newSampleRate);
+
+    const uint frames = buffer.getFrameLenght();
+    const int channels = buffer.getChannels();
+
+    const float thresholdInDb = threshold.load();
+    const float slope = 1.0f - 1.0f / ratio.load();
+    const float attackCoefficient = getCoefficient(attack.load());
+    const float releaseCoefficient = getCoefficient(release.load());
+
+    smoothedMakeupGain.setTarget(makeupGain.load());
+
+    float maxReduction = 0.0f;
+    for (uint offset = 0; offset < frames; offset += SUB_BLOCK_SIZE) {
+        const uint blockFrames = qMin(static_cast<uint>(SUB_BLOCK_SIZE), frames - offset);
+
+        // stereo linked peak detection, both channels are compressed by the same amount
+        float peak = 0.0f;
+        for (int c = 0; c < channels; ++c) {
+            const float *samples = buffer.getSamplesArray(c) + offset;
+            for (uint i = 0; i < blockFrames; ++i) {
+                const float absSample = std::fabs(samples[i]);
+                peak = absSample > peak ? absSample : peak;
+            }
+        }
+
+        const float coefficient = peak > envelope ? attackCoefficient : releaseCoefficient;
+        envelope = peak + coefficient * (envelope - peak);
+        if (envelope < 1e-9f)
+            envelope = 0.0f; // avoiding denormals in the silence
+
+        const float envelopeInDb = envelope > 0.0f ? 20.0f * std::log10(envelope) : -200.0f;
+        const float over = envelopeInDb - thresholdInDb;
+        const float reduction = over > 0.0f ? over * slope : 0.0f;
+        maxReduction = qMax(maxReduction, reduction);
+
+        float makeupStart, makeupStep;
+        smoothedMakeupGain.nextRamp(blockFrames, makeupStart, makeupStep);
+
+        // linear gain ramp until the new gain in the sub block end
+        const float targetGain = dbToLinear(smoothedMakeupGain.getCurrent() - reduction);
+        const float gainStep = (targetGain - currentGain) / blockFrames;
+        const float startGain = currentGain + gainStep;
+        for (int c = 0; c < channels; ++c) {
+            float *samples = buffer.getSamplesArray(c) + offset;
+            for (uint i = 0; i < blockFrames; ++i)
+                samples[i] *= startGain + gainStep * i;
+        }
+
+        currentGain = targetGain;
+    }
+
+    gainReduction.store(maxReduction);
+}
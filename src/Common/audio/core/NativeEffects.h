@@ -0,0 +1,263 @@
+#ifndef NATIVE_EFFECTS_H
+#define NATIVE_EFFECTS_H
+
+#include "SamplesBuffer.h"
+#include "Filters.h"
+
+#include <QAtomicInt>
+#include <QVector>
+
+#include <cstring>
+
+namespace audio {
+
+/**
+ * The DSP code of the Jamtaba native plugins (delay, equalizer and compressor). The effects are processing
+ * the samples in place, in contiguous and branch free loops per channel (auto vectorized by the compiler),
+ * and the parameters are smoothed to avoid clicks and zipper noise when they are changed.
+ *
+ * The setters are called in the GUI thread, the process() functions in the audio thread. The sample rate
+ * changes are applied in the audio thread too, in the next process() call.
+ */
+
+// a float parameter written in the GUI thread and read in the audio thread
+class AtomicFloat
+{
+public:
+    explicit AtomicFloat(float value = 0.0f);
+
+    void store(float value);
+    float load() const;
+
+private:
+    QAtomicInt bits;
+};
+
+// linear ramp between the parameter values
+class SmoothedValue
+{
+public:
+    explicit SmoothedValue(float value = 0.0f);
+
+    void setRampLength(int frames);
+    void setTarget(float newTarget);
+    void reset(float value); // jump to the value, no ramp
+
+    bool isSmoothing() const;
+    float getCurrent() const;
+    float getTarget() const;
+
+    // 'start' is the value in the first frame and 'step' the increment per frame in the next 'frames',
+    // a ramp ending inside the block is stretched until the block end to keep the increment constant
+    void nextRamp(int frames, float &start, float &step);
+
+private:
+    float current;
+    float target;
+    float increment;
+    int remainingFrames;
+    int rampLength;
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+class DelayEffect
+{
+public:
+    enum SyncDivision {
+        NoSync, // using the delay time in milliseconds
+        Whole,
+        Half,
+        DottedQuarter,
+        Quarter,
+        QuarterTriplet,
+        DottedEighth,
+        Eighth,
+        EighthTriplet,
+        Sixteenth,
+        SYNC_DIVISIONS
+    };
+
+    static const int MAX_DELAY_IN_SECONDS;
+    static const float MAX_FEEDBACK;
+
+    explicit DelayEffect(int sampleRate);
+
+    void process(SamplesBuffer &buffer);
+
+    void setSampleRate(int sampleRate);
+    void setTempo(int bpm);
+
+    void setDelayTime(float delayTimeInMs);
+    void setSyncDivision(SyncDivision division);
+    void setFeedback(float feedback);
+    void setLevel(float level);
+
+    void clear(); // audio thread
+
+    float getDelayTimeInSamples() const; // using the tempo when synced
+
+    static float getDivisionInBeats(SyncDivision division);
+
+private:
+    AtomicFloat delayTime;
+    AtomicFloat feedback;
+    AtomicFloat level;
+    QAtomicInt syncDivision;
+    QAtomicInt tempo;
+
+    SmoothedValue smoothedDelay; // in samples
+    SmoothedValue smoothedFeedback;
+    SmoothedValue smoothedLevel;
+
+    SamplesBuffer delayLine; // allocated in constructor, the max delay time is shorter in very high sample rates
+    uint lineLength;
+    uint writeIndex;
+    int sampleRate;
+    QAtomicInt pendingSampleRate;
+
+    void applySampleRate(int sampleRate);
+    void processChunk(SamplesBuffer &buffer, uint offset, uint frames, uint readIndex);
+    void processModulated(SamplesBuffer &buffer, uint offset, uint frames);
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+class EqualizerEffect
+{
+public:
+    enum Band {
+        LowShelf,
+        LowMid,
+        HighMid,
+        HighShelf,
+        BANDS
+    };
+
+    static const float MAX_GAIN; // in dB
+
+    explicit EqualizerEffect(int sampleRate);
+
+    void process(SamplesBuffer &buffer);
+
+    void setSampleRate(int sampleRate);
+
+    void setBandGain(Band band, float gainInDb);
+    void setBandFrequency(Band band, float frequency);
+    void setBandQ(Band band, float q);
+
+    void clear(); // audio thread
+
+    static float getDefaultFrequency(Band band);
+
+private:
+    static const int CHANNELS = 2;
+    static const int SUB_BLOCK_SIZE = 32; // coefficients are recomputed in each sub block while smoothing
+
+    struct BandState
+    {
+        AtomicFloat gain;
+        AtomicFloat frequency;
+        AtomicFloat q;
+        SmoothedValue smoothedGain;
+        SmoothedValue smoothedFrequency;
+        SmoothedValue smoothedQ;
+    };
+
+    BandState bands[BANDS];
+    QVector<FilterBank> filters; // a filter bank per band, both channels are processed together
+    int sampleRate;
+    QAtomicInt pendingSampleRate;
+
+    void applySampleRate(int sampleRate);
+    FilterBank createFilter(int band) const;
+    bool updateBand(int band, int frames); // true when the band is not flat
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+class CompressorEffect
+{
+public:
+    explicit CompressorEffect(int sampleRate);
+
+    void process(SamplesBuffer &buffer);
+
+    void setSampleRate(int sampleRate);
+
+    void setThreshold(float thresholdInDb);
+    void setRatio(float ratio);
+    void setAttack(float attackInMs);
+    void setRelease(float releaseInMs);
+    void setMakeupGain(float gainInDb);
+
+    void clear(); // audio thread
+
+    float getGainReduction() const; // in dB, for meters
+
+private:
+    static const int SUB_BLOCK_SIZE = 16; // the gain is computed per sub block and ramped inside the sub block
+
+    AtomicFloat threshold;
+    AtomicFloat ratio;
+    AtomicFloat attack;
+    AtomicFloat release;
+    AtomicFloat makeupGain;
+    AtomicFloat gainReduction;
+
+    SmoothedValue smoothedMakeupGain; // in dB
+
+    float envelope; // stereo linked peak envelope, linear
+    float currentGain;
+    int sampleRate;
+    QAtomicInt pendingSampleRate;
+
+    void applySampleRate(int sampleRate);
+    float getCoefficient(float timeInMs) const; // envelope follower coefficient per sub block
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+inline AtomicFloat::AtomicFloat(float value)
+{
+    store(value);
+}
+
+inline void AtomicFloat::store(float value)
+{
+    int intBits;
+    std::memcpy(&intBits, &value, sizeof(float));
+    bits.storeRelease(intBits);
+}
+
+inline float AtomicFloat::load() const
+{
+    const int intBits = bits.loadAcquire();
+    float value;
+    std::memcpy(&value, &intBits, sizeof(float));
+    return value;
+}
+
+inline bool SmoothedValue::isSmoothing() const
+{
+    return remainingFrames > 0;
+}
+
+inline float SmoothedValue::getCurrent() const
+{
+    return current;
+}
+
+inline float SmoothedValue::getTarget() const
+{
+    return target;
+}
+
+inline float CompressorEffect::getGainReduction() const
+{
+    return gainReduction.load();
+}
+
+} // namespace
+
+#endif // NATIVE_EFFECTS_H
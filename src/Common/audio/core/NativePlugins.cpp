@@ -0,0 +1,389 @@
+#include "NativePlugins.h"
+#include "SamplesBuffer.h"
+#include "gui/plugins/Guis.h"
+#include "log/Logging.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDialog>
+#include <QVBoxLayout>
+
+using audio::NativePlugin;
+using audio::JamtabaDelay;
+using audio::JamtabaEqualizer;
+using audio::JamtabaCompressor;
+using audio::PluginDescriptor;
+using audio::SamplesBuffer;
+
+const quint8 NativePlugin::SERIALIZATION_REVISION = 1;
+
+const char *NativePlugin::TRANSLATION_CONTEXT = "audio::NativePlugin";
+
+const QString JamtabaDelay::NAME("Delay");
+const QString JamtabaEqualizer::NAME("Equalizer");
+const QString JamtabaCompressor::NAME("Compressor");
+
+namespace {
+
+const QString MANUFACTURER("JamTaba");
+
+} // namespace
+
+QList<PluginDescriptor> NativePlugin::getDescriptors()
+{
+    QList<PluginDescriptor> descriptors;
+    descriptors << PluginDescriptor(JamtabaDelay::NAME, PluginDescriptor::Native_Plugin, MANUFACTURER);
+    descriptors << PluginDescriptor(JamtabaEqualizer::NAME, PluginDescriptor::Native_Plugin, MANUFACTURER);
+    descriptors << PluginDescriptor(JamtabaCompressor::NAME, PluginDescriptor::Native_Plugin, MANUFACTURER);
+    return descriptors;
+}
+
+NativePlugin *NativePlugin::createPlugin(const PluginDescriptor &descriptor, int sampleRate)
+{
+    if (!descriptor.isNative())
+        return nullptr;
+
+    const QString name = descriptor.getName();
+    if (name == JamtabaDelay::NAME)
+        return new JamtabaDelay(sampleRate);
+
+    if (name == JamtabaEqualizer::NAME)
+        return new JamtabaEqualizer(sampleRate);
+
+    if (name == JamtabaCompressor::NAME)
+        return new JamtabaCompressor(sampleRate);
+
+    return nullptr;
+}
+
+NativePlugin::NativePlugin(const QString &name) :
+    Plugin(PluginDescriptor(name, PluginDescriptor::Native_Plugin, MANUFACTURER)),
+    clearRequested(0)
+{
+
+}
+
+void NativePlugin::addParameter(const char *name, const QString &unit, float minValue, float maxValue,
+                                float defaultValue, bool logarithmic)
+{
+    Parameter parameter;
+    parameter.key = QString::fromLatin1(name);
+    parameter.name = translate(name);
+    parameter.unit = unit;
+    parameter.minValue = minValue;
+    parameter.maxValue = maxValue;
+    parameter.defaultValue = defaultValue;
+    parameter.logarithmic = logarithmic;
+
+    parameters.append(parameter);
+    values.append(defaultValue);
+}
+
+void NativePlugin::addParameter(const char *name, const QStringList &valueNames, int defaultValue)
+{
+    addParameter(name, QString(), 0, valueNames.size() - 1, defaultValue);
+    parameters.last().valueNames = valueNames;
+}
+
+QString NativePlugin::translate(const char *text)
+{
+    return QCoreApplication::translate(TRANSLATION_CONTEXT, text);
+}
+
+void NativePlugin::setParameterValue(int index, float value)
+{
+    if (index < 0 || index >= parameters.size())
+        return;
+
+    const Parameter &parameter = parameters.at(index);
+    value = qBound(parameter.minValue, value, parameter.maxValue);
+    if (!parameter.valueNames.isEmpty())
+        value = qRound(value);
+
+    values[index] = value;
+    parameterChanged(index, value);
+}
+
+QString NativePlugin::getParameterText(int index) const
+{
+    const Parameter &parameter = parameters.at(index);
+    const float value = values.at(index);
+
+    if (!parameter.valueNames.isEmpty())
+        return parameter.valueNames.at(static_cast<int>(value));
+
+    const int decimals = qAbs(value) < 10 ? 1 : 0;
+    return QString("%1 %2").arg(QString::number(value, 'f', decimals)).arg(parameter.unit).trimmed();
+}
+
+void NativePlugin::process(const SamplesBuffer &in, SamplesBuffer &out, midi::MidiBuffer &midiBuffer)
+{
+    Q_UNUSED(in) // the output buffer is containing the input samples, the effects are processed in place
+    Q_UNUSED(midiBuffer)
+
+    if (clearRequested.testAndSetOrdered(1, 0))
+        clear();
+
+    processEffect(out);
+}
+
+void NativePlugin::suspend()
+{
+
+}
+
+void NativePlugin::resume()
+{
+    clearRequested.storeRelease(1); // the old delay tails and filters history are not played after resuming
+}
+
+QByteArray NativePlugin::getSerializedData() const
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    // the parameters are stored by the untranslated name, new parameters can be added in the future
+    stream << SERIALIZATION_REVISION << static_cast<quint32>(parameters.size());
+    for (int i = 0; i < parameters.size(); ++i)
+        stream << parameters.at(i).key << values.at(i);
+
+    return data;
+}
+
+void NativePlugin::restoreFromSerializedData(const QByteArray &data)
+{
+    if (data.isEmpty())
+        return;
+
+    QDataStream stream(data);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint8 revision = 0;
+    quint32 count = 0;
+    stream >> revision >> count;
+    if (revision != SERIALIZATION_REVISION) {
+        qCWarning(jtCore) << "Unknown" << getName() << "data revision:" << revision;
+        return;
+    }
+
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString parameterKey;
+        float value = 0;
+        stream >> parameterKey >> value;
+
+        for (int p = 0; p < parameters.size(); ++p) {
+            if (parameters.at(p).key == parameterKey) {
+                setParameterValue(p, value);
+                break;
+            }
+        }
+    }
+}
+
+void NativePlugin::openEditor(const QPoint &centerOfScreen)
+{
+    if (editorWindow && editorWindow->isVisible()) {
+        editorWindow->raise();
+        editorWindow->activateWindow();
+        return;
+    }
+
+    if (editorWindow)
+        editorWindow->deleteLater();
+
+    editorWindow = new QDialog(0, Qt::WindowTitleHint | Qt::WindowCloseButtonHint);
+    editorWindow->setWindowTitle(getName());
+    QObject::connect(editorWindow, SIGNAL(finished(int)), this, SLOT(editorDialogFinished()));
+
+    QVBoxLayout *layout = new QVBoxLayout(editorWindow);
+    layout->addWidget(new NativePluginGui(this));
+
+    editorWindow->adjustSize();
+    editorWindow->move(centerOfScreen - editorWindow->rect().center());
+    editorWindow->show();
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+JamtabaDelay::JamtabaDelay(int sampleRate) :
+    NativePlugin(NAME),
+    delay(sampleRate)
+{
+    QStringList divisions;
+    divisions << translate(QT_TRANSLATE_NOOP("audio::NativePlugin", "Off"));
+    divisions << "1/1" << "1/2" << "1/4." << "1/4" << "1/4T" << "1/8." << "1/8" << "1/8T" << "1/16";
+    Q_ASSERT(divisions.size() == DelayEffect::SYNC_DIVISIONS);
+
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Time"), "ms", 1, DelayEffect::MAX_DELAY_IN_SECONDS * 1000, 500, true);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Sync"), divisions, DelayEffect::NoSync);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Feedback"), "%", 0, DelayEffect::MAX_FEEDBACK * 100, 30);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Level"), "%", 0, 100, 50);
+
+    for (int i = 0; i < getParametersCount(); ++i)
+        parameterChanged(i, getParameterValue(i));
+}
+
+void JamtabaDelay::setSampleRate(int newSampleRate)
+{
+    delay.setSampleRate(newSampleRate);
+}
+
+void JamtabaDelay::setTempo(int bpm)
+{
+    delay.setTempo(bpm);
+}
+
+void JamtabaDelay::processEffect(SamplesBuffer &buffer)
+{
+    delay.process(buffer);
+}
+
+void JamtabaDelay::clear()
+{
+    delay.clear();
+}
+
+void JamtabaDelay::parameterChanged(int index, float value)
+{
+    switch (index) {
+    case DelayTime:
+        delay.setDelayTime(value);
+        break;
+    case Sync:
+        delay.setSyncDivision(static_cast<DelayEffect::SyncDivision>(static_cast<int>(value)));
+        break;
+    case Feedback:
+        delay.setFeedback(value / 100.0f);
+        break;
+    case Level:
+        delay.setLevel(value / 100.0f);
+        break;
+    }
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+JamtabaEqualizer::JamtabaEqualizer(int sampleRate) :
+    NativePlugin(NAME),
+    equalizer(sampleRate)
+{
+    const float maxGain = EqualizerEffect::MAX_GAIN;
+
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Low Gain"), "dB", -maxGain, maxGain, 0);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Low Freq"), "Hz", 20, 1000, EqualizerEffect::getDefaultFrequency(EqualizerEffect::LowShelf), true);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Low Mid Gain"), "dB", -maxGain, maxGain, 0);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Low Mid Freq"), "Hz", 80, 5000, EqualizerEffect::getDefaultFrequency(EqualizerEffect::LowMid), true);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Low Mid Q"), "", 0.1f, 10, 1, true);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "High Mid Gain"), "dB", -maxGain, maxGain, 0);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "High Mid Freq"), "Hz", 500, 16000, EqualizerEffect::getDefaultFrequency(EqualizerEffect::HighMid), true);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "High Mid Q"), "", 0.1f, 10, 1, true);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "High Gain"), "dB", -maxGain, maxGain, 0);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "High Freq"), "Hz", 2000, 20000, EqualizerEffect::getDefaultFrequency(EqualizerEffect::HighShelf), true);
+
+    for (int i = 0; i < getParametersCount(); ++i)
+        parameterChanged(i, getParameterValue(i));
+}
+
+void JamtabaEqualizer::setSampleRate(int newSampleRate)
+{
+    equalizer.setSampleRate(newSampleRate);
+}
+
+void JamtabaEqualizer::processEffect(SamplesBuffer &buffer)
+{
+    equalizer.process(buffer);
+}
+
+void JamtabaEqualizer::clear()
+{
+    equalizer.clear();
+}
+
+void JamtabaEqualizer::parameterChanged(int index, float value)
+{
+    switch (index) {
+    case LowGain:
+        equalizer.setBandGain(EqualizerEffect::LowShelf, value);
+        break;
+    case LowFrequency:
+        equalizer.setBandFrequency(EqualizerEffect::LowShelf, value);
+        break;
+    case LowMidGain:
+        equalizer.setBandGain(EqualizerEffect::LowMid, value);
+        break;
+    case LowMidFrequency:
+        equalizer.setBandFrequency(EqualizerEffect::LowMid, value);
+        break;
+    case LowMidQ:
+        equalizer.setBandQ(EqualizerEffect::LowMid, value);
+        break;
+    case HighMidGain:
+        equalizer.setBandGain(EqualizerEffect::HighMid, value);
+        break;
+    case HighMidFrequency:
+        equalizer.setBandFrequency(EqualizerEffect::HighMid, value);
+        break;
+    case HighMidQ:
+        equalizer.setBandQ(EqualizerEffect::HighMid, value);
+        break;
+    case HighGain:
+        equalizer.setBandGain(EqualizerEffect::HighShelf, value);
+        break;
+    case HighFrequency:
+        equalizer.setBandFrequency(EqualizerEffect::HighShelf, value);
+        break;
+    }
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+JamtabaCompressor::JamtabaCompressor(int sampleRate) :
+    NativePlugin(NAME),
+    compressor(sampleRate)
+{
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Threshold"), "dB", -60, 0, -18);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Ratio"), ":1", 1, 20, 4, true);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Attack"), "ms", 0.1f, 200, 10, true);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Release"), "ms", 10, 2000, 150, true);
+    addParameter(QT_TRANSLATE_NOOP("audio::NativePlugin", "Makeup"), "dB", 0, 24, 0);
+
+    for (int i = 0; i < getParametersCount(); ++i)
+        parameterChanged(i, getParameterValue(i));
+}
+
+void JamtabaCompressor::setSampleRate(int newSampleRate)
+{
+    compressor.setSampleRate(newSampleRate);
+}
+
+void JamtabaCompressor::processEffect(SamplesBuffer &buffer)
+{
+    compressor.process(buffer);
+}
+
+void JamtabaCompressor::clear()
+{
+    compressor.clear();
+}
+
+void JamtabaCompressor::parameterChanged(int index, float value)
+{
+    switch (index) {
+    case Threshold:
+        compressor.setThreshold(value);
+        break;
+    case Ratio:
+        compressor.setRatio(value);
+        break;
+    case Attack:
+        compressor.setAttack(value);
+        break;
+    case Release:
+        compressor.setRelease(value);
+        break;
+    case MakeupGain:
+        compressor.setMakeupGain(value);
+        break;
+    }
+}
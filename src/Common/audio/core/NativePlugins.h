@@ -0,0 +1,195 @@
+#ifndef NATIVE_PLUGINS_H
+#define NATIVE_PLUGINS_H
+
+#include "Plugins.h"
+#include "NativeEffects.h"
+
+#include <QStringList>
+#include <QVector>
+
+namespace audio {
+
+// base class for the built-in plugins, the parameters are showed in a generic editor (NativePluginGui)
+class NativePlugin : public Plugin
+{
+public:
+    struct Parameter
+    {
+        QString key; // untranslated name, used in the serialized data
+        QString name; // translated name, showed in the editor
+        QString unit;
+        float minValue;
+        float maxValue;
+        float defaultValue;
+        bool logarithmic; // frequencies, times and ratios
+        QStringList valueNames; // discrete parameter, the value is the name index
+    };
+
+    static QList<PluginDescriptor> getDescriptors();
+    static NativePlugin *createPlugin(const PluginDescriptor &descriptor, int sampleRate); // nullptr for unknown plugins
+
+    void process(const SamplesBuffer &in, SamplesBuffer &out, midi::MidiBuffer &midiBuffer) override;
+
+    int getParametersCount() const;
+    const Parameter &getParameter(int index) const;
+    float getParameterValue(int index) const;
+    void setParameterValue(int index, float value); // GUI thread
+    QString getParameterText(int index) const;
+
+    void openEditor(const QPoint &centerOfScreen) override;
+    void updateGui() override;
+
+    void start() override;
+    QString getPath() const override;
+
+    QByteArray getSerializedData() const override;
+    void restoreFromSerializedData(const QByteArray &data) override;
+
+    void suspend() override;
+    void resume() override;
+
+protected:
+    explicit NativePlugin(const QString &name);
+
+    // the names are marked with QT_TRANSLATE_NOOP in TRANSLATION_CONTEXT, they are translated here
+    void addParameter(const char *name, const QString &unit, float minValue, float maxValue,
+                      float defaultValue, bool logarithmic = false);
+    void addParameter(const char *name, const QStringList &valueNames, int defaultValue);
+
+    virtual void processEffect(SamplesBuffer &buffer) = 0; // audio thread
+    virtual void parameterChanged(int index, float value) = 0; // GUI thread, passing the value to the effect
+    virtual void clear() = 0; // audio thread, clear the effect state (delay lines, filters history, etc.)
+
+    static QString translate(const char *text); // translated in TRANSLATION_CONTEXT
+
+private:
+    static const quint8 SERIALIZATION_REVISION;
+    static const char *TRANSLATION_CONTEXT; // NativePlugin has no Q_OBJECT, tr() would use the Plugin context
+
+    QList<Parameter> parameters;
+    QVector<float> values;
+    QAtomicInt clearRequested;
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+class JamtabaDelay : public NativePlugin
+{
+public:
+    enum ParameterIndex {
+        DelayTime,
+        Sync,
+        Feedback,
+        Level
+    };
+
+    static const QString NAME;
+
+    explicit JamtabaDelay(int sampleRate);
+
+    void setSampleRate(int newSampleRate) override;
+    void setTempo(int bpm) override;
+
+protected:
+    void processEffect(SamplesBuffer &buffer) override;
+    void parameterChanged(int index, float value) override;
+    void clear() override;
+
+private:
+    DelayEffect delay;
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+class JamtabaEqualizer : public NativePlugin
+{
+public:
+    enum ParameterIndex {
+        LowGain,
+        LowFrequency,
+        LowMidGain,
+        LowMidFrequency,
+        LowMidQ,
+        HighMidGain,
+        HighMidFrequency,
+        HighMidQ,
+        HighGain,
+        HighFrequency
+    };
+
+    static const QString NAME;
+
+    explicit JamtabaEqualizer(int sampleRate);
+
+    void setSampleRate(int newSampleRate) override;
+
+protected:
+    void processEffect(SamplesBuffer &buffer) override;
+    void parameterChanged(int index, float value) override;
+    void clear() override;
+
+private:
+    EqualizerEffect equalizer;
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+class JamtabaCompressor : public NativePlugin
+{
+public:
+    enum ParameterIndex {
+        Threshold,
+        Ratio,
+        Attack,
+        Release,
+        MakeupGain
+    };
+
+    static const QString NAME;
+
+    explicit JamtabaCompressor(int sampleRate);
+
+    void setSampleRate(int newSampleRate) override;
+
+protected:
+    void processEffect(SamplesBuffer &buffer) override;
+    void parameterChanged(int index, float value) override;
+    void clear() override;
+
+private:
+    CompressorEffect compressor;
+};
+
+inline int NativePlugin::getParametersCount() const
+{
+    return parameters.size();
+}
+
+inline const NativePlugin::Parameter &NativePlugin::getParameter(int index) const
+{
+    return parameters.at(index);
+}
+
+inline float NativePlugin::getParameterValue(int index) const
+{
+    return values.at(index);
+}
+
+inline QString NativePlugin::getPath() const
+{
+    return "";
+}
+
+inline void NativePlugin::start()
+{
+
+}
+
+inline void NativePlugin::updateGui()
+{
+
+}
+
+} // namespace
+
+#endif // NATIVE_PLUGINS_H
@@ -0,0 +1,221 @@
+#include "PeaksTelemetry.h"
+
+#include <QMutexLocker>
+#include <cstring>
+
+using audio::PeaksTelemetry;
+using audio::AudioPeak;
+
+PeaksTelemetry::Slot::Slot() :
+    used(0),
+    generation(0),
+    sequence(0),
+    clips(0),
+    readSequence(0),
+    clipsCount(0),
+    lastClips(0),
+    lastSequence(0),
+    lastGeneration(0)
+{
+    for (int i = 0; i < VALUES; ++i) {
+        values[i].storeRelease(0);
+        accumulated[i] = 0.0f;
+    }
+}
+
+PeaksTelemetry::PeaksTelemetry()
+{
+    blocks[0].storeRelease(new Slot[SLOTS_PER_BLOCK]);
+}
+
+PeaksTelemetry::~PeaksTelemetry()
+{
+    for (auto &block : blocks)
+        delete [] block.loadAcquire();
+}
+
+int PeaksTelemetry::acquireSlot()
+{
+    QMutexLocker locker(&slotsMutex);
+
+    for (int index = 0; index < MAX_SLOTS; ++index) {
+        auto &block = blocks[index / SLOTS_PER_BLOCK];
+        if (!block.loadAcquire()) // all slots in the allocated blocks are used
+            block.storeRelease(new Slot[SLOTS_PER_BLOCK]);
+
+        Slot &slot = getSlotByIndex(index);
+        if (slot.used.loadAcquire())
+            continue;
+
+        // the slot writer is not running yet, the old values are just discarded. The GUI side is reset in the next sweep.
+        slot.readSequence.storeRelease(slot.sequence.loadAcquire());
+        slot.clipsCount = 0;
+        slot.clips.storeRelease(0);
+
+        slot.used.storeRelease(1);
+
+        return slot.generation.loadAcquire() * MAX_SLOTS + index;
+    }
+
+    return -1;
+}
+
+void PeaksTelemetry::releaseSlot(int slotID)
+{
+    QMutexLocker locker(&slotsMutex);
+
+    Slot *slot = getSlot(slotID);
+    if (!slot)
+        return;
+
+    slot->generation.storeRelease((slot->generation.loadAcquire() + 1) % MAX_GENERATIONS);
+    slot->used.storeRelease(0);
+}
+
+PeaksTelemetry::Slot *PeaksTelemetry::getSlot(int slotID)
+{
+    return const_cast<Slot *>(static_cast<const PeaksTelemetry *>(this)->getSlot(slotID));
+}
+
+const PeaksTelemetry::Slot *PeaksTelemetry::getSlot(int slotID) const
+{
+    if (slotID < 0)
+        return nullptr;
+
+    const int index = slotID % MAX_SLOTS;
+    if (!blocks[index / SLOTS_PER_BLOCK].loadAcquire())
+        return nullptr;
+
+    const Slot &slot = getSlotByIndex(index);
+    if (!slot.used.loadAcquire() || slot.generation.loadAcquire() != slotID / MAX_SLOTS)
+        return nullptr;
+
+    return &slot;
+}
+
+void PeaksTelemetry::publish(int slotID, const AudioPeak &peak)
+{
+    if (slotID < 0)
+        return;
+
+    Slot &slot = getSlotByIndex(slotID % MAX_SLOTS); // only the slot owner is publishing, no need to check the generation
+
+    const float newValues[VALUES] = {peak.getLeftPeak(), peak.getRightPeak(), peak.getLeftRMS(), peak.getRightRMS()};
+
+    const int sequence = slot.sequence.loadAcquire();
+    const bool guiReadLastValues = slot.readSequence.loadAcquire() == sequence;
+    for (int i = 0; i < VALUES; ++i)
+        slot.accumulated[i] = guiReadLastValues ? newValues[i] : qMax(slot.accumulated[i], newValues[i]);
+
+    if (peak.getMaxPeak() > 1.0f)
+        slot.clipsCount++;
+
+    slot.sequence.fetchAndAddOrdered(1); // odd, writing
+
+    for (int i = 0; i < VALUES; ++i)
+        slot.values[i].storeRelease(floatToBits(slot.accumulated[i]));
+
+    slot.clips.storeRelease(static_cast<int>(slot.clipsCount));
+
+    slot.sequence.storeRelease(sequence + 2); // even, values are consistent again
+}
+
+void PeaksTelemetry::readAll()
+{
+    for (auto &block : blocks) {
+        Slot *slots = block.loadAcquire();
+        if (!slots)
+            return; // the blocks are allocated in order
+
+        for (int index = 0; index < SLOTS_PER_BLOCK; ++index) {
+            if (slots[index].used.loadAcquire())
+                readSlot(slots[index]);
+        }
+    }
+}
+
+void PeaksTelemetry::readSlot(Slot &slot)
+{
+    const int generation = slot.generation.loadAcquire();
+    if (generation != slot.lastGeneration) { // slot acquired by another node after the last sweep
+        slot.lastGeneration = generation;
+        slot.lastSequence = slot.readSequence.loadAcquire();
+        slot.lastPeak.zero();
+        slot.lastClips = 0;
+    }
+
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        const int sequence = slot.sequence.loadAcquire();
+        if (sequence & 1) // audio thread is writing
+            continue;
+
+        if (sequence == slot.lastSequence) { // no new values since last read
+            slot.lastPeak.zero();
+            return;
+        }
+
+        float values[VALUES];
+        for (int i = 0; i < VALUES; ++i)
+            values[i] = bitsToFloat(slot.values[i].loadAcquire());
+
+        const quint32 clips = static_cast<quint32>(slot.clips.loadAcquire());
+
+        if (slot.sequence.loadAcquire() != sequence) // values changed while reading, trying again
+            continue;
+
+        slot.lastPeak = AudioPeak(values[0], values[1], values[2], values[3]);
+        slot.lastClips = clips;
+        slot.lastSequence = sequence;
+        slot.readSequence.storeRelease(sequence);
+        return;
+    }
+
+    // the audio thread is writing all the time, keeping the last read values for this frame
+}
+
+bool PeaksTelemetry::getPeak(int slotID, AudioPeak &peak) const
+{
+    const Slot *slot = getSlot(slotID);
+    if (!slot) {
+        peak.zero();
+        return false;
+    }
+
+    if (slot->lastGeneration == slot->generation.loadAcquire())
+        peak = slot->lastPeak;
+    else
+        peak.zero(); // not read since the slot was acquired
+
+    return true;
+}
+
+quint32 PeaksTelemetry::getClips(int slotID) const
+{
+    const Slot *slot = getSlot(slotID);
+
+    if (!slot || slot->lastGeneration != slot->generation.loadAcquire())
+        return 0;
+
+    return slot->lastClips;
+}
+
+void PeaksTelemetry::reset(int slotID)
+{
+    Slot *slot = getSlot(slotID);
+    if (slot)
+        slot->lastPeak.zero();
+}
+
+int PeaksTelemetry::floatToBits(float value)
+{
+    int bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float PeaksTelemetry::bitsToFloat(int bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
@@ -0,0 +1,101 @@
+#ifndef PEAKS_TELEMETRY_H
+#define PEAKS_TELEMETRY_H
+
+#include "AudioPeak.h"
+
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QMutex>
+#include <QtGlobal>
+
+namespace audio {
+
+/**
+ * Peaks, RMS and clip counts published by the audio thread and read by the GUI thread without locks.
+ * The slots are preallocated in blocks, each audio node publishes in your own slot (one writer per slot)
+ * protected by a sequence lock, and the GUI thread reads all used slots in one sweep per frame.
+ * Between two GUI sweeps the published values are accumulated (max), so short peaks are not lost.
+ * A slot without new values since the last sweep is read as zero (the node is not processing audio).
+ * A new block of slots is allocated when all slots are used, the blocks are never moved or released
+ * while the telemetry exists, so the audio thread can publish while another block is allocated.
+ */
+
+class PeaksTelemetry
+{
+public:
+    PeaksTelemetry();
+    ~PeaksTelemetry();
+
+    // slot IDs are invalidated when released, so a GUI holding an old ID is reading zeros instead of another node peaks
+    int acquireSlot(); // allocate a new slots block when all slots are used, return -1 when all MAX_SLOTS are used
+    void releaseSlot(int slotID);
+
+    void publish(int slotID, const AudioPeak &peak); // audio thread, never blocks
+
+    // GUI thread
+    void readAll();
+    bool getPeak(int slotID, AudioPeak &peak) const; // return false when the slot ID is not valid anymore
+    AudioPeak getPeak(int slotID) const;
+    quint32 getClips(int slotID) const; // total of processed blocks with samples above 0 dB
+    void reset(int slotID); // zero the last read peak
+
+    static const int SLOTS_PER_BLOCK = 128;
+    static const int MAX_BLOCKS = 16;
+    static const int MAX_SLOTS = SLOTS_PER_BLOCK * MAX_BLOCKS;
+
+private:
+    static const int VALUES = 4; // left peak, right peak, left rms, right rms
+    static const int MAX_READ_ATTEMPTS = 4;
+    static const int MAX_GENERATIONS = 1 << 19; // slot IDs are 'generation * MAX_SLOTS + index'
+
+    struct Slot
+    {
+        Slot();
+
+        QAtomicInt used;
+        QAtomicInt generation; // incremented when the slot is released
+
+        QAtomicInt sequence; // odd while the audio thread is writing
+        QAtomicInt values[VALUES]; // float bits
+        QAtomicInt clips;
+        QAtomicInt readSequence; // last sequence read by the GUI, the audio thread starts a new accumulation after each read
+
+        // audio thread only
+        float accumulated[VALUES];
+        quint32 clipsCount;
+
+        // GUI thread only
+        AudioPeak lastPeak;
+        quint32 lastClips;
+        int lastSequence;
+        int lastGeneration;
+    };
+
+    Slot *getSlot(int slotID);
+    const Slot *getSlot(int slotID) const;
+    Slot &getSlotByIndex(int index) const; // the slot block must be allocated
+
+    static void readSlot(Slot &slot);
+
+    static int floatToBits(float value);
+    static float bitsToFloat(int bits);
+
+    QAtomicPointer<Slot> blocks[MAX_BLOCKS]; // null until allocated, the first block is allocated in constructor
+    QMutex slotsMutex; // protecting slots acquisition, release and blocks allocation only
+};
+
+inline PeaksTelemetry::Slot &PeaksTelemetry::getSlotByIndex(int index) const
+{
+    return blocks[index / SLOTS_PER_BLOCK].loadAcquire()[index % SLOTS_PER_BLOCK];
+}
+
+inline AudioPeak PeaksTelemetry::getPeak(int slotID) const
+{
+    AudioPeak peak;
+    getPeak(slotID, peak);
+    return peak;
+}
+
+} // namespace
+
+#endif
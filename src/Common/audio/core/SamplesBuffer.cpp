@@ -185,30 +185,41 @@ AudioPeak SamplesBuffer::computePeak()
 {
     float abs; // max peak absolute value
     float maxPeaks[2] = {0};// left and right peaks
-	unsigned maxChan = isMono() ? 1 : channels; // don't loop and mul/add twice if only one channel
+    float bufferSquaredSums[2] = {0};
+    unsigned maxChan = isMono() ? 1 : channels; // don't loop and mul/add twice if only one channel
 
     for (unsigned int c = 0; c < maxChan; ++c) {
         float maxPeak = 0;
-		const std::vector<float>& chanSamples = samples[c]; // optimize costly stl vector access out of the inner loop
+        float squaredSum = 0;
+        const std::vector<float>& chanSamples = samples[c]; // optimize costly stl vector access out of the inner loop
         for (unsigned int i = 0; i < frameLenght; ++i) {
             // max peak
             abs = chanSamples[i]; // access inner std:svector array only once, use it for square value below
-			if(abs<0) abs = -abs; // std::fabs is very slow, just negate if needed
+            if(abs<0) abs = -abs; // std::fabs is very slow, just negate if needed
 
             if (abs > maxPeak) maxPeak = abs;
 
             // rms running squared sum
-            squaredSums[c] += abs * abs; // squaring every sample and summing
+            squaredSum += abs * abs; // squaring every sample and summing
         }
-		maxPeaks[c] = maxPeak;
-        summedSamples += frameLenght;
+        maxPeaks[c] = maxPeak;
+        bufferSquaredSums[c] = squaredSum;
     }
 
-    if (isMono()) {
-        maxPeaks[1] = maxPeaks[0];
-        squaredSums[1] = squaredSums[0];
+    return computePeak(maxPeaks, bufferSquaredSums, maxChan, frameLenght);
+}
+
+AudioPeak SamplesBuffer::computePeak(const float *peaks, const float *bufferSquaredSums, uint peakChannels, uint frames)
+{
+    for (unsigned int c = 0; c < peakChannels; ++c) {
+        squaredSums[c] += bufferSquaredSums[c];
+        summedSamples += frames;
     }
 
+    const float rightPeak = peakChannels > 1 ? peaks[1] : peaks[0];
+    if (peakChannels == 1)
+        squaredSums[1] = squaredSums[0];
+
     // time to compute new rms values?
     if (summedSamples >= rmsWindowSize) {
         lastRmsValues[0] = std::sqrt(squaredSums[0]/summedSamples);
@@ -218,7 +229,7 @@ AudioPeak SamplesBuffer::computePeak()
         summedSamples = 0;
     }
 
-    return AudioPeak(maxPeaks[0], maxPeaks[1], lastRmsValues[0], lastRmsValues[1]);
+    return AudioPeak(peaks[0], rightPeak, lastRmsValues[0], lastRmsValues[1]);
 }
 
 int SamplesBuffer::computeRmsWindowSize(int sampleRate, int windowTimeInMs)
@@ -63,6 +63,9 @@ public:
 
     audio::AudioPeak computePeak();
 
+    // peaks and squared sums computed while mixing samples out of this buffer (the metronome clicks), using the same rms window
+    audio::AudioPeak computePeak(const float *peaks, const float *squaredSums, uint channels, uint frames);
+
     void add(const SamplesBuffer &buffer);
 
     void add(uint channel, uint sampleIndex, float sampleValue);
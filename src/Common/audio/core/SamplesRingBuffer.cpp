@@ -0,0 +1,77 @@
+#include "SamplesRingBuffer.h"
+#include "SamplesBuffer.h"
+
+#include <cstring>
+
+using audio::SamplesRingBuffer;
+using audio::SamplesBuffer;
+
+SamplesRingBuffer::SamplesRingBuffer(uint capacity) :
+    capacity(capacity),
+    writePosition(0),
+    readPosition(0)
+{
+    channels[0].resize(capacity);
+    channels[1].resize(capacity);
+}
+
+uint SamplesRingBuffer::write(const SamplesBuffer &samples, uint offset)
+{
+    if (offset >= samples.getFrameLenght())
+        return 0;
+
+    const uint frames = qMin(samples.getFrameLenght() - offset, getFreeFrames());
+    const uint position = getRingIndex(static_cast<uint>(writePosition.loadAcquire()));
+
+    // copying in 2 parts when wrapping around the ring end
+    const uint firstPart = qMin(frames, capacity - position);
+    const uint secondPart = frames - firstPart;
+
+    for (int c = 0; c < 2; ++c) {
+        const float *in = samples.getSamplesArray(samples.isMono() ? 0 : c) + offset; // mono samples are copied to both channels
+        float *ring = &(channels[c][0]);
+        std::memcpy(ring + position, in, firstPart * sizeof(float));
+        if (secondPart)
+            std::memcpy(ring, in + firstPart, secondPart * sizeof(float));
+    }
+
+    writePosition.storeRelease(static_cast<int>(advance(static_cast<uint>(writePosition.loadAcquire()), frames)));
+
+    return frames;
+}
+
+uint SamplesRingBuffer::read(SamplesBuffer &out, uint frames)
+{
+    frames = qMin(qMin(frames, getAvailableFrames()), out.getFrameLenght());
+    const uint position = getRingIndex(static_cast<uint>(readPosition.loadAcquire()));
+
+    const uint firstPart = qMin(frames, capacity - position);
+    const uint secondPart = frames - firstPart;
+
+    for (int c = 0; c < out.getChannels() && c < 2; ++c) {
+        float *outSamples = out.getSamplesArray(c);
+        const float *ring = &(channels[c][0]);
+        std::memcpy(outSamples, ring + position, firstPart * sizeof(float));
+        if (secondPart)
+            std::memcpy(outSamples + firstPart, ring, secondPart * sizeof(float));
+    }
+
+    readPosition.storeRelease(static_cast<int>(advance(static_cast<uint>(readPosition.loadAcquire()), frames)));
+
+    return frames;
+}
+
+uint SamplesRingBuffer::discard(uint frames)
+{
+    frames = qMin(frames, getAvailableFrames());
+
+    readPosition.storeRelease(static_cast<int>(advance(static_cast<uint>(readPosition.loadAcquire()), frames)));
+
+    return frames;
+}
+
+void SamplesRingBuffer::clear()
+{
+    writePosition.storeRelease(0);
+    readPosition.storeRelease(0);
+}
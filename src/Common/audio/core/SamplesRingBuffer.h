@@ -0,0 +1,75 @@
+#ifndef SAMPLES_RING_BUFFER_H
+#define SAMPLES_RING_BUFFER_H
+
+#include <vector>
+#include <QAtomicInt>
+#include <QtGlobal>
+
+namespace audio {
+
+class SamplesBuffer;
+
+/**
+ * Single producer/single consumer ring of stereo samples. The producer (a decoding thread)
+ * and the consumer (the audio thread) are synchronized using atomic positions only, so the
+ * audio thread never blocks or allocates memory when reading.
+ */
+
+class SamplesRingBuffer
+{
+public:
+    explicit SamplesRingBuffer(uint capacity);
+
+    uint write(const SamplesBuffer &samples, uint offset = 0); // producer side, return the written frames
+    uint read(SamplesBuffer &out, uint frames); // consumer side, return the read frames
+    uint discard(uint frames); // consumer side, skip frames without copy them, return the discarded frames
+
+    uint getAvailableFrames() const;
+    uint getFreeFrames() const;
+    uint getCapacity() const;
+
+    void clear(); // producer and consumer must be stopped
+
+private:
+    std::vector<float> channels[2];
+    const uint capacity;
+
+    uint advance(uint position, uint frames) const;
+    uint getRingIndex(uint position) const;
+
+    // positions wrapped at '2 * capacity', so a full ring is not confused with an empty ring and the counters never overflow
+    QAtomicInt writePosition;
+    QAtomicInt readPosition;
+};
+
+inline uint SamplesRingBuffer::advance(uint position, uint frames) const
+{
+    position += frames; // frames <= capacity
+    return position >= capacity * 2 ? position - capacity * 2 : position;
+}
+
+inline uint SamplesRingBuffer::getRingIndex(uint position) const
+{
+    return position >= capacity ? position - capacity : position;
+}
+
+inline uint SamplesRingBuffer::getCapacity() const
+{
+    return capacity;
+}
+
+inline uint SamplesRingBuffer::getAvailableFrames() const
+{
+    const uint write = static_cast<uint>(writePosition.loadAcquire());
+    const uint read = static_cast<uint>(readPosition.loadAcquire());
+    return write >= read ? write - read : write + capacity * 2 - read;
+}
+
+inline uint SamplesRingBuffer::getFreeFrames() const
+{
+    return capacity - getAvailableFrames();
+}
+
+} // namespace
+
+#endif
@@ -15,9 +15,11 @@
 #include <QTimer>
 #include <QPointF>
 #include "log/Logging.h"
+#include "log/StartupTimeline.h"
 #include "persistence/CacheHeader.h"
 #include <QSettings>
 #include <QApplication>
+#include <QtConcurrent>
 
 using geo::WebIpToLocationResolver;
 
@@ -38,6 +40,13 @@ WebIpToLocationResolver::WebIpToLocationResolver(const QDir &cacheDir) :
 {
     connect(&httpClient, SIGNAL(finished(QNetworkReply*)), this, SLOT(replyFinished(QNetworkReply*)));
 
+    cachesLoading = QtConcurrent::run(this, &WebIpToLocationResolver::loadCaches);
+}
+
+void WebIpToLocationResolver::loadCaches()
+{
+    StartupPhase phase("Loading geo location caches");
+
     loadCountryCodesFromFile();
     loadLatLongsFromFile();
 
@@ -49,8 +58,16 @@ WebIpToLocationResolver::WebIpToLocationResolver(const QDir &cacheDir) :
     }
 }
 
+void WebIpToLocationResolver::waitForCaches()
+{
+    if (!cachesLoading.isFinished())
+        cachesLoading.waitForFinished();
+}
+
 WebIpToLocationResolver::~WebIpToLocationResolver()
 {
+    waitForCaches();
+
     saveCountryCodesToFile();
     saveCountryNamesToFile();
     saveLatLongsToFile();
@@ -262,6 +279,8 @@ QString WebIpToLocationResolver::sanitizeLanguageCode(const QString &languageCod
 
 geo::Location WebIpToLocationResolver::resolve(const QString &ip, const QString &languageCode)
 {
+    waitForCaches();
+
     // check for language changes
     QString code = sanitizeLanguageCode(languageCode);
     if (code != currentLanguage) {
@@ -8,6 +8,7 @@
 #include <QNetworkReply>
 #include <QFile>
 #include <QDir>
+#include <QFuture>
 
 namespace geo
 {
@@ -28,7 +29,11 @@ namespace geo
 
         void requestDataFromWebService(const QString &ip, int retryCount);
 
-        // loading
+        // loading, the cache files are loaded in a worker thread and the first use is waiting the loading
+        void loadCaches();
+        void waitForCaches();
+        QFuture<void> cachesLoading;
+
         void loadCountryCodesFromFile();
         void loadCountryNamesFromFile(const QString &languageCode);
         void loadLatLongsFromFile();
@@ -36,7 +36,9 @@ BaseTrackView::BaseTrackView(MainController *mainController, long trackID) :
     trackID(trackID),
     activated(true),
     narrowed(false),
-    tintColor(Qt::black)
+    tintColor(Qt::black),
+    peaksSlot(-1),
+    clips(0)
 {
     createLayoutStructure();
     setupVerticalLayout();
@@ -216,7 +218,10 @@ void BaseTrackView::updateGuiElements()
     if (!mainController)
         return;
 
-    auto peak = mainController->getTrackPeak(getTrackID());
+    audio::AudioPeak peak;
+    if (!mainController->getTrackPeakBySlot(peaksSlot, peak)) // track node recreated or slot not cached yet?
+        peaksSlot = mainController->getTrackPeaksSlot(getTrackID());
+
     if (peak.getMaxPeak() > maxPeak.getMaxPeak()) {
         maxPeak.update(peak);
     }
@@ -224,6 +229,12 @@ void BaseTrackView::updateGuiElements()
     // update the track peaks
     setPeaks(peak.getLeftPeak(), peak.getRightPeak(), peak.getLeftRMS(), peak.getRightRMS());
 
+    const quint32 trackClips = mainController->getTrackClipsBySlot(peaksSlot); // zero when the track node is recreated
+    if (trackClips > clips)
+        levelSlider->setClipping();
+
+    clips = trackClips;
+
     // update the track processors. In this moment the VST plugins GUI are updated. Some plugins need this to run your animations (see Ez Drummer, for example);
     auto trackNode = mainController->getTrackNode(getTrackID());
     if (trackNode)
@@ -125,6 +125,8 @@ protected:
 private:
     static QMap<long, BaseTrackView *> trackViews;
     audio::AudioPeak maxPeak;
+    int peaksSlot; // track peaks telemetry slot, avoiding track lookups in each GUI frame
+    quint32 clips; // clipped audio blocks in the last GUI frame, the level slider clip indicator is lit when this count grows
 
 protected slots:
     virtual void toggleMuteStatus();
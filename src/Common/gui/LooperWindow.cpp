@@ -204,8 +204,9 @@ void LooperWindow::updateDrawings()
         update(); // paint vertical lines, current beat and wait count
     }
 
-    // update peak meters
-    AudioPeak lastPeak = looper->getLastPeak();
+    // update peak meters, the looper peaks were read by MainWindow in this GUI frame
+    AudioPeak lastPeak;
+    mainController->getTrackPeakBySlot(looper->getPeaksTelemetrySlot(), lastPeak);
     ui->mainLevelSlider->setPeak(lastPeak.getLeftPeak(), lastPeak.getRightPeak(), lastPeak.getLeftRMS(), lastPeak.getRightRMS());
 }
 
@@ -43,6 +43,9 @@
 #include <QImage>
 #include <QCameraInfo>
 #include <QToolTip>
+#include <QScrollBar>
+#include <QTimer>
+#include <QElapsedTimer>
 
 const QSize MainWindow::MAIN_WINDOW_MIN_SIZE = QSize(1100, 685);
 const QString MainWindow::NIGHT_MODE_SUFFIX = "_nm";
@@ -79,6 +82,7 @@ MainWindow::MainWindow(MainController *mainController, QWidget *parent) :
     busyDialog(new BusyDialog()),
     bpmVotingExpirationTimer(nullptr),
     bpiVotingExpiratonTimer(nullptr),
+    roomStreamsPrefetchTimer(nullptr),
     buttonCollapseLocalChannels(nullptr),
     buttonCollapseChat(nullptr),
     buttonCollapseBottomArea(nullptr),
@@ -90,7 +94,11 @@ MainWindow::MainWindow(MainController *mainController, QWidget *parent) :
     ninjamWindow(nullptr),
     roomToJump(nullptr),
     performanceMonitor(new PerformanceMonitor()),
-    lastPerformanceMonitorUpdate(0)
+    lastPerformanceMonitorUpdate(0),
+    showFrameTimeAction(nullptr),
+    frameTimeSum(0),
+    maxFrameTime(0),
+    measuredFrames(0)
 {
     qCDebug(jtGUI) << "Creating MainWindow...";
 
@@ -111,10 +119,12 @@ MainWindow::MainWindow(MainController *mainController, QWidget *parent) :
     initializeCameraWidget();
     setupWidgets();
     setupSignals();
+    initializeRoomStreamsPrefetchTimer();
 
     setNetworkUsageUpdatePeriod(MainWindow::DEFAULT_NETWORK_USAGE_UPDATE_PERIOD);
 
     ChatPanel::setFontSizeOffset(mainController->getChatFontSizeOffset());
+    ChatPanel::setHistoryLimit(mainController->getSettings().getChatHistoryLimit());
 
     qCDebug(jtGUI) << "MainWindow created!";
 
@@ -151,8 +161,8 @@ void MainWindow::setupMainTabCornerWidgets()
     performanceMonitorLabel = new QLabel();
     performanceMonitorLabel->setObjectName(QStringLiteral("labelPerformanceMonitor"));
 
-#ifndef Q_OS_WIN
-   performanceMonitorLabel->setVisible(false); // showing RAM monitor in windows only
+#ifdef Q_OS_MAC
+   performanceMonitorLabel->setVisible(false); // RAM monitor is not implemented in Mac
 #endif
 
     transmitTransferRateLabel = new QLabel(this);
@@ -326,14 +336,14 @@ void MainWindow::changeCameraStatus(bool activated)
     if (!videoFrameGrabber) {
         videoFrameGrabber = new CameraFrameGrabber(this);
 
-        connect(videoFrameGrabber, &CameraFrameGrabber::frameAvailable, [=](const QImage &frame) {
-
-            if (mainController && !mainController->isPlayingInNinjamRoom()) {
-                if (cameraView)
-                    cameraView->setCurrentFrame(frame);
-            }
-
+        connect(videoFrameGrabber, &CameraFrameGrabber::frameAvailable, this, [=](const QImage &frame) {
+            if (cameraView)
+                cameraView->setCurrentFrame(frame);
         });
+
+        // the frames are pushed directly in the capture thread, the GUI thread is not used to encode frames
+        connect(videoFrameGrabber, &CameraFrameGrabber::frameAvailable, mainController->getVideoCapturePipeline(),
+                &VideoCapturePipeline::pushFrame, Qt::DirectConnection);
     }
 
     initializeCamera(preferredCameraName);
@@ -411,24 +421,6 @@ bool MainWindow::cameraIsActivated() const
     return cameraView && cameraView->isActivated();
 }
 
-QImage MainWindow::pickCameraFrame() const
-{
-    if (videoFrameGrabber && cameraView) {
-        auto frame = videoFrameGrabber->grab();
-        cameraView->setCurrentFrame(frame);
-
-        // scale the grabed frame if is bigger than MAX_VIDEO_SIZE. This is necessary because some cameras
-        // have only big resolutions, and we have problems sensing big resolution videos to ninjam servers.
-
-        if (frame.width() > MainController::MAX_VIDEO_SIZE.width())
-            return frame.scaled(mainController->getVideoResolution(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-
-        return frame;
-    }
-
-    return QImage();
-}
-
 void MainWindow::initializeMeteringOptions()
 {
     const auto &settings = mainController->getSettings();
@@ -1231,6 +1223,8 @@ void MainWindow::refreshPublicRoomsList(const QList<login::RoomInfo> &publicRoom
     if (mainController->isPlayingInNinjamRoom())
         this->ninjamWindow->updateGeoLocations();
 
+    roomStreamsPrefetchTimer->start(); // the panels are not layouted yet, the visible rooms are computed later
+
     /** updating country flag and country names after refresh the public rooms list. This is necessary because the call to webservice used to get country codes and  country names is not synchronous. So, if country code and name are not cached we receive these data from the webservice after some seconds.*/
 }
 
@@ -1244,6 +1238,17 @@ void MainWindow::playPublicRoomStream(const login::RoomInfo &roomInfo)
         mainController->playRoomStream(roomInfo);
 }
 
+void MainWindow::updatePrefetchedRoomStreams()
+{
+    QList<login::RoomInfo> visibleRooms;
+    for (auto viewPanel : roomViewPanels.values()) {
+        if (viewPanel && !viewPanel->visibleRegion().isEmpty()) // hidden panels (or in a hidden tab) have an empty visible region
+            visibleRooms.append(viewPanel->getRoomInfo());
+    }
+
+    mainController->setPrefetchedRoomStreams(visibleRooms);
+}
+
 void MainWindow::stopPublicRoomStream(const login::RoomInfo &roomInfo)
 {
     Q_UNUSED(roomInfo)
@@ -2113,6 +2118,11 @@ void MainWindow::timerEvent(QTimerEvent *)
     if (!mainController)
         return;
 
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+
+    mainController->readAllPeaks(); // all peaks published by audio thread are read in one sweep
+
     // update local input track peaks
     for (TrackGroupView *channel : localGroupChannels)
         channel->updateGuiElements();
@@ -2129,7 +2139,7 @@ void MainWindow::timerEvent(QTimerEvent *)
     if (now - lastPerformanceMonitorUpdate >= PERFORMANCE_MONITOR_REFRESH_TIME) {
 
         if (performanceMonitorLabel)
-            performanceMonitorLabel->setText(QString("MEM: %1%").arg(performanceMonitor->getMemmoryUsed()));
+            updatePerformanceMonitorLabel();
 
         lastPerformanceMonitorUpdate = now;
     }
@@ -2170,6 +2180,9 @@ void MainWindow::timerEvent(QTimerEvent *)
     // update all blinkable buttons
     BlinkableButton::updateAllBlinkableButtons();
 
+    // all meters are updated in one pass after the peaks are collected, only the changed meters areas are repainted
+    AudioSlider::updateAllMeters();
+
     // update network transfer rate labels
     static qint64 lastNetworkTransferRateUpdate = QDateTime::currentMSecsSinceEpoch();
 
@@ -2202,6 +2215,70 @@ void MainWindow::timerEvent(QTimerEvent *)
         }
     }
 
+    if (isShowingFrameTime()) {
+        const qint64 frameTime = frameTimer.nsecsElapsed();
+        frameTimeSum += frameTime;
+        maxFrameTime = qMax(maxFrameTime, frameTime);
+        measuredFrames++;
+    }
+}
+
+bool MainWindow::isShowingFrameTime() const
+{
+    return showFrameTimeAction && showFrameTimeAction->isChecked();
+}
+
+void MainWindow::setShowingFrameTime(bool showing)
+{
+    AudioSlider::setMeasuringPaintTime(showing);
+
+    frameTimeSum = maxFrameTime = 0;
+    measuredFrames = 0;
+
+#ifdef Q_OS_MAC
+    performanceMonitorLabel->setVisible(showing); // RAM monitor is not implemented in Mac
+#endif
+
+    updatePerformanceMonitorLabel();
+}
+
+void MainWindow::updatePerformanceMonitorLabel()
+{
+    QString text = QString("MEM: %1%").arg(performanceMonitor->getMemmoryUsed());
+
+    // audio callback load, the tracks and plugins breakdown is showed in tooltip
+    const audio::AudioLoadReport &audioLoad = mainController->getAudioLoadReport();
+    if (!audioLoad.isEmpty()) {
+        const auto &callbacks = audioLoad.callbacks;
+        text += QString("  AUDIO: %1% (p99 %2%, max %3%)")
+                .arg(callbacks.getLoad(callbacks.averageNs), 0, 'f', 0)
+                .arg(callbacks.getLoad(callbacks.p99Ns), 0, 'f', 0)
+                .arg(callbacks.getLoad(callbacks.maxNs), 0, 'f', 0);
+
+        const int dropouts = mainController->getAudioDropouts();
+        if (dropouts > 0)
+            text += QString(" %1: %2").arg(tr("dropouts")).arg(dropouts);
+
+        performanceMonitorLabel->setToolTip(audioLoad.toString(5).replace(" | ", "\n"));
+    }
+
+    if (isShowingFrameTime()) {
+        // the meters are painted after the timer event, so the meters painting time is showed separated
+        const qreal averageFrameTime = measuredFrames ? frameTimeSum / (measuredFrames * 1000000.0) : 0.0;
+        const qreal metersPaintTime = measuredFrames ? AudioSlider::takePaintTime() / (measuredFrames * 1000000.0) : 0.0;
+        const uint repaintedMeters = measuredFrames ? AudioSlider::takeRepaintedMeters() / measuredFrames : 0;
+
+        text += QString("  GUI: %1 ms (max %2 ms)  Meters: %3 ms (%4 repaints)")
+                .arg(averageFrameTime, 0, 'f', 2)
+                .arg(maxFrameTime / 1000000.0, 0, 'f', 2)
+                .arg(metersPaintTime, 0, 'f', 2)
+                .arg(repaintedMeters);
+
+        frameTimeSum = maxFrameTime = 0;
+        measuredFrames = 0;
+    }
+
+    performanceMonitorLabel->setText(text);
 }
 
 void MainWindow::resizeEvent(QResizeEvent *ev)
@@ -2446,6 +2523,8 @@ void MainWindow::setupPreferencesDialogSignals(PreferencesDialog *dialog)
 
     connect(dialog, &PreferencesDialog::looperWaveFilesBitDepthChanged, mainController, &MainController::storeLooperBitDepth);
 
+    connect(dialog, &PreferencesDialog::looperMemorySettingsChanged, mainController, &MainController::storeLooperMemorySettings);
+
     connect(dialog, &PreferencesDialog::rememberRemoteUserSettingsChanged, mainController, &MainController::storeRemoteUserRememberSettings);
     connect(dialog, &PreferencesDialog::rememberCollapsibleSectionsSettingsChanged, mainController, &MainController::storeCollapsibleSectionsRememberSettings);
 }
@@ -2491,10 +2570,18 @@ void MainWindow::initializeViewMenu()
     meteringActionGroup->addAction(ui.actionShowPeaksOnly);
     meteringActionGroup->addAction(ui.actionShowRmsOnly);
     meteringActionGroup->addAction(ui.actionShowPeakAndRMS);
+
+    ui.menuMetering->addSeparator();
+    showFrameTimeAction = ui.menuMetering->addAction(tr("Show GUI frame time"));
+    showFrameTimeAction->setCheckable(true);
+    connect(showFrameTimeAction, &QAction::toggled, this, &MainWindow::setShowingFrameTime);
 }
 
 void MainWindow::handleMenuMeteringAction(QAction *action)
 {
+    if (action == showFrameTimeAction)
+        return;
+
     if (action == ui.actionShowMaxPeaks){
         AudioSlider::setPaintMaxPeakMarker(ui.actionShowMaxPeaks->isChecked());
     }
@@ -2909,6 +2996,19 @@ void MainWindow::initializeVotingExpirationTimers()
     connect(bpmVotingExpirationTimer, &QTimer::timeout, ninjamWindow.data(), &NinjamRoomWindow::resetBpmComboBox);
 }
 
+void MainWindow::initializeRoomStreamsPrefetchTimer()
+{
+    roomStreamsPrefetchTimer = new QTimer(this);
+    roomStreamsPrefetchTimer->setSingleShot(true);
+    roomStreamsPrefetchTimer->setInterval(1000);
+
+    connect(roomStreamsPrefetchTimer, &QTimer::timeout, this, &MainWindow::updatePrefetchedRoomStreams);
+
+    // the visible rooms are changed when the user is scrolling the rooms list or changing the current tab
+    connect(ui.allRoomsScroll->verticalScrollBar(), &QScrollBar::valueChanged, roomStreamsPrefetchTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(ui.contentTabWidget, &QTabWidget::currentChanged, roomStreamsPrefetchTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+}
+
 void MainWindow::initializeCollapseButtons()
 {
 
@@ -103,8 +103,6 @@ public:
 
     virtual TextEditorModifier *createTextEditorModifier() = 0;
 
-    QImage pickCameraFrame() const;
-
     bool cameraIsActivated() const;
 
     void closeAllFloatingWindows();
@@ -212,6 +210,7 @@ protected slots:
     // view menu
     void updateMeteringMenu();
     void handleMenuMeteringAction(QAction *);
+    void setShowingFrameTime(bool showing);
 
     // ninjam controller
     void startTransmission();
@@ -271,6 +270,7 @@ private slots:
     void showJamtabaCurrentVersion();
 
     void refreshPublicRoomsList(const QList<login::RoomInfo> &publicRooms);
+    void updatePrefetchedRoomStreams(); // prefetching the streams of the rooms visible in screen
 
     void showChordsPanel();
 
@@ -335,6 +335,8 @@ private:
     QTimer *bpmVotingExpirationTimer;
     QTimer *bpiVotingExpiratonTimer;
 
+    QTimer *roomStreamsPrefetchTimer; // waiting the user stop scrolling before prefetch the visible rooms streams
+
     QPushButton *buttonCollapseLocalChannels;
     QPushButton *buttonCollapseChat;
     QPushButton *buttonCollapseBottomArea;
@@ -367,6 +369,8 @@ private:
 
     void initializeVotingExpirationTimers();
 
+    void initializeRoomStreamsPrefetchTimer();
+
     void initializeCollapseButtons();
     void updateCollapseButtons();
 
@@ -470,6 +474,15 @@ private:
     qint64 lastPerformanceMonitorUpdate; // TODO move to PerformenceMonitor
     static const int PERFORMANCE_MONITOR_REFRESH_TIME;
 
+    // GUI frame time overlay, showed in the performance monitor label
+    QAction *showFrameTimeAction;
+    qint64 frameTimeSum; // in nanoseconds
+    qint64 maxFrameTime;
+    uint measuredFrames;
+
+    bool isShowingFrameTime() const;
+    void updatePerformanceMonitorLabel();
+
     static const QString NIGHT_MODE_SUFFIX;
 
 };
@@ -2,7 +2,6 @@
 #include "geo/IpToLocationResolver.h"
 #include "MainController.h"
 #include "NinjamController.h"
-#include "video/FFMpegDemuxer.h"
 #include "IconFactory.h"
 #include "ninjam/client/Service.h"
 #include "MainWindow.h"
@@ -27,7 +26,6 @@ NinjamTrackGroupView::NinjamTrackGroupView(MainController *mainController, long
     mainController(mainController),
     userIP(initialValues.getUserIP()),
     tracksLayoutEnum(TracksLayout::VerticalLayout),
-    videoFrameRate(10),
     intervalsWithoutReceiveVideo(0)
 {
 
@@ -128,28 +126,12 @@ void NinjamTrackGroupView::addVideoInterval(const QByteArray &encodedVideoData)
         }
     }
 
-    FFMpegDemuxer *videoDecoder = new FFMpegDemuxer(this, encodedVideoData);
-    connect(videoDecoder, &FFMpegDemuxer::imagesDecoded, this, [=](QList<QImage> images, uint frameRate){
-        if (!images.isEmpty()) {
-            videoFrameRate = frameRate;
-            decodedImages << images;
-
-            videoDecoder->deleteLater();
-        }
-    });
-
-    QtConcurrent::run(videoDecoder, &FFMpegDemuxer::decode);
+    videoStream.addInterval(encodedVideoData); // the frames are decoded on demand
 }
 
 void NinjamTrackGroupView::startVideoStream()
 {
-    lastVideoRender = 0;
-
-    if (!decodedImages.isEmpty()) {
-        while (decodedImages.size() > 1)
-            decodedImages.removeFirst(); // keep just the last decoded interval
-    }
-    else {
+    if (!videoStream.startNewInterval()) {
         intervalsWithoutReceiveVideo++;
         if (intervalsWithoutReceiveVideo > 1) {
             videoWidget->setVisible(false); // hide the video widget when transmition is stopped
@@ -454,22 +436,9 @@ void NinjamTrackGroupView::updateGuiElements()
     userNameLabel->updateMarquee();
 
     // video
-    if (!decodedImages.isEmpty()) {
-        quint64 now = QDateTime::currentMSecsSinceEpoch();
-
-        quint64 timePerFrame = 1000 / videoFrameRate;
-        quint64 diff = now - lastVideoRender;
-        if (diff >= timePerFrame) { // time to show a new video frame?
-            lastVideoRender = now - (diff % timePerFrame);
-            auto &currentImages = decodedImages.first();
-            if (!currentImages.isEmpty()) {
-                updateVideoFrame(currentImages.takeFirst());
-            }
-            else {
-                decodedImages.removeFirst(); // avoid show the last received frame forever
-            }
-        }
-    }
+    QImage videoFrame;
+    if (videoStream.getNextFrame(videoFrame)) // time to show a new video frame?
+        updateVideoFrame(videoFrame);
 }
 
 NinjamTrackGroupView::~NinjamTrackGroupView()
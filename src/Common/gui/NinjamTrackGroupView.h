@@ -5,6 +5,7 @@
 #include "NinjamTrackView.h"
 #include "widgets/MarqueeLabel.h"
 #include "video/VideoWidget.h"
+#include "video/RemoteVideoStream.h"
 
 #include <QLabel>
 #include <QBoxLayout>
@@ -72,10 +73,7 @@ private:
     TracksLayout tracksLayoutEnum;
 
     VideoWidget *videoWidget;
-    QByteArray encodedVideoData;
-    quint64 lastVideoRender;
-    QList<QList<QImage>> decodedImages;
-    uint videoFrameRate;
+    RemoteVideoStream videoStream;
     uint intervalsWithoutReceiveVideo;
 
     void setupHorizontalLayout();
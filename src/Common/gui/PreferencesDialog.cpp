@@ -152,6 +152,15 @@ void PreferencesDialog::setupSignals()
             ui->lineEditLoopsFolder->setText(newLoopsFolder);
         }
     });
+
+    connect(ui->checkBoxCompactLockedLayers, &QCheckBox::toggled, ui->spinBoxLooperMemoryBudget, &QSpinBox::setEnabled);
+    connect(ui->checkBoxCompactLockedLayers, &QCheckBox::toggled, this, &PreferencesDialog::emitLooperMemorySettingsChanged);
+    connect(ui->spinBoxLooperMemoryBudget, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &PreferencesDialog::emitLooperMemorySettingsChanged);
+}
+
+void PreferencesDialog::emitLooperMemorySettingsChanged()
+{
+    emit looperMemorySettingsChanged(ui->checkBoxCompactLockedLayers->isChecked(), static_cast<quint32>(ui->spinBoxLooperMemoryBudget->value()));
 }
 
 void PreferencesDialog::toggleRecording(bool recording)
@@ -269,6 +278,8 @@ void PreferencesDialog::populateLooperTab()
     QSignalBlocker lineEditSignalBlocker(ui->lineEditLoopsFolder);
     QSignalBlocker radioButtonSignalBlocker(ui->radioButtonLooperOggEncoding);
     QSignalBlocker bitDepthCheckBoxBlocker(ui->comboBoxBitRate);
+    QSignalBlocker compactLockedLayersCheckBoxBlocker(ui->checkBoxCompactLockedLayers);
+    QSignalBlocker memoryBudgetSpinBoxBlocker(ui->spinBoxLooperMemoryBudget);
 
     ui->lineEditLoopsFolder->setText(settings->getLooperFolder());
     ui->radioButtonLooperOggEncoding->setChecked(settings->getLooperAudioEncodingFlag());
@@ -283,6 +294,10 @@ void PreferencesDialog::populateLooperTab()
         comboBoxIndex = 1;
 
     ui->comboBoxBitRate->setCurrentIndex(comboBoxIndex);
+
+    ui->checkBoxCompactLockedLayers->setChecked(settings->isCompactingLooperLockedLayers());
+    ui->spinBoxLooperMemoryBudget->setValue(static_cast<int>(settings->getLooperMemoryBudget()));
+    ui->spinBoxLooperMemoryBudget->setEnabled(ui->checkBoxCompactLockedLayers->isChecked());
 }
 
 void PreferencesDialog::selectRecordingTab()
@@ -44,6 +44,7 @@ signals:
     void looperAudioEncodingFlagChanged(bool savingEncodedAudio);
     void looperWaveFilesBitDepthChanged(quint8 bitDepth);
     void looperFolderChanged(const QString &newLoopsFolder);
+    void looperMemorySettingsChanged(bool compactingLockedLayers, quint32 memoryBudgetInMB);
     void rememberRemoteUserSettingsChanged(bool boost, bool level, bool pan, bool mute, bool lowCut);
     void rememberCollapsibleSectionsSettingsChanged(bool localChannels, bool bottomSection, bool chatSection);
 
@@ -60,6 +61,7 @@ private slots:
     void openAccentBeatAudioFileBrowser();
 
     void emitEncodingQualityChanged();
+    void emitLooperMemorySettingsChanged();
 
     void toggleCustomMetronomeSounds(bool usingCustomMetronome);
     void toggleBuiltInMetronomeSounds(bool usingBuiltInMetronome);
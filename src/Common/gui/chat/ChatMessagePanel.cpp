@@ -15,6 +15,15 @@
 ChatMessagePanel::ChatMessagePanel(QWidget *parent, const QString &userFullName, const QString &msg,
                                    const QColor &backgroundColor, const QColor &textColor,
                                    bool showTranslationButton, bool showBlockButton, Emojifier *emojifier) :
+    ChatMessagePanel(parent, userFullName, msg, emojifier ? emojifier->emojify(msg.toHtmlEscaped()) : msg,
+                     backgroundColor, textColor, showTranslationButton, showBlockButton, emojifier)
+{
+
+}
+
+ChatMessagePanel::ChatMessagePanel(QWidget *parent, const QString &userFullName, const QString &msg, const QString &emojifiedMsg,
+                                   const QColor &backgroundColor, const QColor &textColor,
+                                   bool showTranslationButton, bool showBlockButton, Emojifier *emojifier) :
     QFrame(parent),
     ui(new Ui::ChatMessagePanel),
     userFullName(userFullName),
@@ -25,10 +34,7 @@ ChatMessagePanel::ChatMessagePanel(QWidget *parent, const QString &userFullName,
 {
     ui->setupUi(this);
 
-    if (emojifier)
-        emojifiedText = emojifier->emojify(msg.toHtmlEscaped());
-    else
-        emojifiedText = msg;
+    emojifiedText = emojifiedMsg;
 
     initialize(userFullName, msg, showTranslationButton, showBlockButton);
 
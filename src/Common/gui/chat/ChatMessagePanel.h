@@ -18,6 +18,10 @@ class ChatMessagePanel : public QFrame
 public:
     ChatMessagePanel(QWidget *parent, const QString &userFullName, const QString &msg, const QColor &backgroundColor,
                      const QColor &textColor, bool showTranslationButton, bool showBlockButton, Emojifier *emojifier = nullptr);
+
+    // used to recreate the messages kept in chat history, the emojified message is not computed again
+    ChatMessagePanel(QWidget *parent, const QString &userFullName, const QString &msg, const QString &emojifiedMsg, const QColor &backgroundColor,
+                     const QColor &textColor, bool showTranslationButton, bool showBlockButton, Emojifier *emojifier);
     ~ChatMessagePanel();
     void setPrefferedTranslationLanguage(const QString &targetLanguage);
     void translate();
@@ -24,6 +24,8 @@ const QColor ChatPanel::BOT_COLOR(255, 255, 255, 30);
 
 qint8 ChatPanel::fontSizeOffset = 0;
 
+uint ChatPanel::historyLimit = ChatPanel::DEFAULT_HISTORY_LIMIT;
+
 QList<ChatPanel *> ChatPanel::instances;
 
 ChatPanel::ChatPanel(const QStringList &botNames, UsersColorsPool *colorsPool,
@@ -32,6 +34,8 @@ ChatPanel::ChatPanel(const QStringList &botNames, UsersColorsPool *colorsPool,
     ui(new Ui::ChatPanel),
     emojiManager(emojiManager),
     botNames(botNames),
+    firstPanelIndex(0),
+    keepingScrollPosition(false),
     autoTranslating(false),
     colorsPool(colorsPool),
     unreadedMessages(0),
@@ -286,6 +290,8 @@ void ChatPanel::setupSignals()
     // this event is used to auto scroll down when new messages are added
     connect(ui->chatScroll->verticalScrollBar(), &QScrollBar::rangeChanged, this, &ChatPanel::autoScroll);
 
+    connect(ui->chatScroll->verticalScrollBar(), &QScrollBar::valueChanged, this, &ChatPanel::handleScrolling);
+
     connect(ui->buttonClear, &QPushButton::clicked, this, &ChatPanel::clearMessages);
 
     connect(ui->buttonAutoTranslate, &QPushButton::clicked, this, &ChatPanel::toggleAutoTranslate);
@@ -313,6 +319,11 @@ void ChatPanel::setFontSizeOffset(qint8 sizeOffset)
         chatPanel->setMessagesFontSizeOffset(fontSizeOffset);
 }
 
+void ChatPanel::setHistoryLimit(uint maxMessages)
+{
+    ChatPanel::historyLimit = qMax(maxMessages, static_cast<uint>(MAX_MESSAGES));
+}
+
 void ChatPanel::setMessagesFontSizeOffset(qint8 offset)
 {
     auto messages = ui->scrollContent->findChildren<ChatMessagePanel *>();
@@ -475,10 +486,17 @@ void ChatPanel::autoScroll(int min, int max)
 {
     Q_UNUSED(min)
 
+    int currentValue = ui->chatScroll->verticalScrollBar()->value();
+
+    if (keepingScrollPosition) { // older messages inserted in the top, keeping the visible messages in same position
+        keepingScrollPosition = false;
+        ui->chatScroll->verticalScrollBar()->setValue(currentValue + max - previousVerticalScrollBarMaxValue);
+        previousVerticalScrollBarMaxValue = max;
+        return;
+    }
 
     // used to auto scroll down to keep the last added message visible
 
-    int currentValue = ui->chatScroll->verticalScrollBar()->value();
     if (currentValue >= previousVerticalScrollBarMaxValue) { // avoid auto scroll if the vertical scroll bar is not in max value position (use is scrolling up)
         ui->chatScroll->verticalScrollBar()->setValue(max + 10);
     }
@@ -486,6 +504,18 @@ void ChatPanel::autoScroll(int min, int max)
     previousVerticalScrollBarMaxValue = max;
 }
 
+void ChatPanel::handleScrolling(int value)
+{
+    auto scrollBar = ui->chatScroll->verticalScrollBar();
+    if (scrollBar->maximum() <= 0)
+        return;
+
+    if (value == scrollBar->minimum())
+        createOlderMessagePanels();
+    else if (value == scrollBar->maximum())
+        destroyOlderMessagePanels();
+}
+
 void ChatPanel::sendNewMessage()
 {
     QString messageText = ui->chatText->text();
@@ -520,11 +550,19 @@ void ChatPanel::hideTranslationProgressFeedback()
 
 void ChatPanel::addLastChordsMessage(const QString &userName, const QString &message, QColor textColor, QColor backgroundColor)
 {
-    ChatMessagePanel *msgPanel = new ChatMessagePanel(ui->scrollContent, userName, message,
-                                                      backgroundColor, textColor, false, false);
-
-    addMessagePanelInLayout(msgPanel, Qt::AlignLeft);
+    HistoryMessage chordsMessage;
+    chordsMessage.userFullName = userName;
+    chordsMessage.text = message;
+    chordsMessage.emojifiedText = message;
+    chordsMessage.backgroundColor = backgroundColor;
+    chordsMessage.textColor = textColor;
+    chordsMessage.showTranslationButton = false;
+    chordsMessage.showBlockButton = false;
+    chordsMessage.showArrow = true;
+    chordsMessage.isLocalUser = false;
+    chordsMessage.panel = nullptr;
 
+    addMessageInHistory(chordsMessage);
 }
 
 void ChatPanel::addMessage(const QString &localUserName, const QString &msgAuthorFullName, const QString &msgText, bool showTranslationButton, bool showBlockButton)
@@ -537,29 +575,21 @@ void ChatPanel::addMessage(const QString &localUserName, const QString &msgAutho
     bool isBot = backgroundColor == BOT_COLOR;
     bool isLocalUser = ninjam::client::extractUserName(msgAuthorFullName) == localUserName;
 
-    QColor textColor = Qt::black;
-    QColor userNameBackgroundColor = backgroundColor;
+    HistoryMessage message;
+    message.userFullName = fullName;
+    message.text = msgText;
+    message.emojifiedText = emojiManager ? emojiManager->emojify(msgText.toHtmlEscaped()) : msgText;
+    message.backgroundColor = backgroundColor;
+    message.textColor = Qt::black;
+    message.showTranslationButton = showTranslationButton;
+    message.showBlockButton = showBlockButton;
+    message.showArrow = !isBot;
+    message.isLocalUser = isLocalUser;
+    message.panel = nullptr;
 
-    ChatMessagePanel *msgPanel = new ChatMessagePanel(this, fullName, msgText,
-                                                      userNameBackgroundColor, textColor, showTranslationButton, showBlockButton, emojiManager);
+    addMessageInHistory(message);
 
-    connect(msgPanel, &ChatMessagePanel::startingTranslation, this, &ChatPanel::showTranslationProgressFeedback);
-    connect(msgPanel, &ChatMessagePanel::translationFinished, this, &ChatPanel::hideTranslationProgressFeedback);
-
-    connect(msgPanel, &ChatMessagePanel::blockingUser, this, &ChatPanel::userBlockingChatMessagesFrom);
-
-    msgPanel->setPrefferedTranslationLanguage(autoTranslationLanguage);
-    msgPanel->setShowArrow(!isBot);
-    if (!isBot && isLocalUser) // local user messages are showed in right side
-        msgPanel->setArrowSide(ChatMessagePanel::RightSide);
-
-    Qt::Alignment alignment = Qt::AlignLeft;
-    if (isLocalUser)
-        alignment = Qt::AlignRight;
-
-    addMessagePanelInLayout(msgPanel, alignment);
-
-    msgPanel->setFontSizeOffset(ChatPanel::fontSizeOffset);
+    auto msgPanel = history.last().panel;
 
     bool canAutoTranslate = autoTranslating && !isLocalUser; // local user messages are not auto translated
     if (canAutoTranslate)
@@ -579,17 +609,94 @@ void ChatPanel::setUnreadedMessages(uint unreaded)
     }
 }
 
-void ChatPanel::addMessagePanelInLayout(ChatMessagePanel *msgPanel, Qt::Alignment alignment)
+void ChatPanel::addMessageInHistory(const HistoryMessage &message)
 {
-    ui->scrollContent->layout()->addWidget(msgPanel);
-    if (ui->scrollContent->layout()->count() > MAX_MESSAGES) {
-        // remove the first widget
-        QList<ChatMessagePanel *> panels = ui->scrollContent->findChildren<ChatMessagePanel *>();
-        ui->scrollContent->layout()->removeWidget(panels.first());
-        delete panels.first();
+    if (history.size() >= static_cast<int>(historyLimit)) { // discarding the oldest message
+        if (history.first().panel)
+            destroyMessagePanel(history.first());
+        history.removeFirst();
+        firstPanelIndex = qMax(firstPanelIndex - 1, 0);
     }
-    ui->scrollContent->layout()->setAlignment(Qt::AlignTop);
-    ui->scrollContent->layout()->setAlignment(msgPanel, Qt::AlignTop | alignment);
+
+    history.append(message);
+
+    HistoryMessage &newMessage = history.last();
+    newMessage.panel = createMessagePanel(newMessage);
+
+    auto layout = ui->scrollContent->layout();
+    layout->addWidget(newMessage.panel);
+    layout->setAlignment(Qt::AlignTop);
+    layout->setAlignment(newMessage.panel, Qt::AlignTop | (newMessage.isLocalUser ? Qt::AlignRight : Qt::AlignLeft));
+
+    // the older panels are kept while the user is reading old messages
+    auto scrollBar = ui->chatScroll->verticalScrollBar();
+    if (scrollBar->value() >= scrollBar->maximum())
+        destroyOlderMessagePanels();
+}
+
+ChatMessagePanel *ChatPanel::createMessagePanel(const HistoryMessage &message)
+{
+    auto msgPanel = new ChatMessagePanel(ui->scrollContent, message.userFullName, message.text, message.emojifiedText,
+                                         message.backgroundColor, message.textColor, message.showTranslationButton,
+                                         message.showBlockButton, emojiManager);
+
+    connect(msgPanel, &ChatMessagePanel::startingTranslation, this, &ChatPanel::showTranslationProgressFeedback);
+    connect(msgPanel, &ChatMessagePanel::translationFinished, this, &ChatPanel::hideTranslationProgressFeedback);
+
+    connect(msgPanel, &ChatMessagePanel::blockingUser, this, &ChatPanel::userBlockingChatMessagesFrom);
+
+    msgPanel->setPrefferedTranslationLanguage(autoTranslationLanguage);
+    msgPanel->setShowArrow(message.showArrow);
+    if (message.showArrow && message.isLocalUser)
+        msgPanel->setArrowSide(ChatMessagePanel::RightSide);
+
+    msgPanel->setFontSizeOffset(ChatPanel::fontSizeOffset);
+
+    return msgPanel;
+}
+
+int ChatPanel::getCreatedPanels() const
+{
+    return history.size() - firstPanelIndex;
+}
+
+void ChatPanel::createOlderMessagePanels()
+{
+    if (firstPanelIndex <= 0)
+        return;
+
+    auto layout = qobject_cast<QVBoxLayout *>(ui->scrollContent->layout());
+    Q_ASSERT(layout);
+
+    int layoutIndex = firstPanelIndex < history.size() ? layout->indexOf(history.at(firstPanelIndex).panel) : layout->count();
+    if (layoutIndex < 0)
+        layoutIndex = 0;
+
+    const int firstIndex = qMax(firstPanelIndex - OLDER_MESSAGES_BATCH, 0);
+    for (int i = firstPanelIndex - 1; i >= firstIndex; --i) {
+        HistoryMessage &message = history[i];
+        message.panel = createMessagePanel(message);
+        layout->insertWidget(layoutIndex, message.panel, 0, Qt::AlignTop | (message.isLocalUser ? Qt::AlignRight : Qt::AlignLeft));
+    }
+
+    firstPanelIndex = firstIndex;
+
+    keepingScrollPosition = true;
+}
+
+void ChatPanel::destroyOlderMessagePanels()
+{
+    while (getCreatedPanels() > MAX_MESSAGES) {
+        destroyMessagePanel(history[firstPanelIndex]);
+        firstPanelIndex++;
+    }
+}
+
+void ChatPanel::destroyMessagePanel(HistoryMessage &message)
+{
+    ui->scrollContent->layout()->removeWidget(message.panel);
+    delete message.panel;
+    message.panel = nullptr;
 }
 
 // +++++++++++++++++++++++++++++++++++=
@@ -612,13 +719,20 @@ ChatPanel::~ChatPanel()
 
 void ChatPanel::removeMessagesFrom(const QString &userFullName)
 {
-    // remove message panels from user 'userName'
-    auto panels = ui->scrollContent->findChildren<ChatMessagePanel *>();
-    for (auto msgPanel : panels) {
-        if (msgPanel->getUserFullName() == userFullName) {
-            ui->scrollContent->layout()->removeWidget(msgPanel);
-            msgPanel->deleteLater();
+    // remove messages and panels from user 'userName'
+    for (int i = history.size() - 1; i >= 0; --i) {
+        HistoryMessage &message = history[i];
+        if (message.userFullName != userFullName)
+            continue;
+
+        if (message.panel) {
+            ui->scrollContent->layout()->removeWidget(message.panel);
+            message.panel->deleteLater();
         }
+
+        history.removeAt(i);
+        if (i < firstPanelIndex)
+            firstPanelIndex--;
     }
 }
 
@@ -631,6 +745,9 @@ void ChatPanel::clearMessages()
         msgPanel->deleteLater();
     }
 
+    history.clear();
+    firstPanelIndex = 0;
+
     // remove Vote and 'load chords' buttons
     QList<QPushButton *> buttons = ui->scrollContent->findChildren<QPushButton *>();
     foreach (QPushButton *button, buttons) {
@@ -63,6 +63,9 @@ public:
     void turnOff();
 
     static void setFontSizeOffset(qint8 sizeOffset);
+    static void setHistoryLimit(uint maxMessages); // older messages are discarded
+
+    static const uint DEFAULT_HISTORY_LIMIT = 500;
 
 public slots:
     void setTopicMessage(const QString &topic);
@@ -86,6 +89,7 @@ signals:
 private slots:
     void sendNewMessage();
     void autoScroll(int min, int max);
+    void handleScrolling(int value);
     void clearMessages();
 
     void confirmVote();
@@ -118,7 +122,33 @@ private:
 
     QString remoteUserFulName; // used in private chats only
 
-    static const int MAX_MESSAGES = 50;
+    /**
+     * All messages are kept in history (the emojified text is computed just once), but message panels are created
+     * only for the last messages. Older panels are created in batches when the user scrolls to the top, and
+     * destroyed again when the user is back to the bottom, so the number of widgets is not growing in long sessions.
+     */
+    struct HistoryMessage
+    {
+        QString userFullName;
+        QString text;
+        QString emojifiedText;
+        QColor backgroundColor;
+        QColor textColor;
+        bool showTranslationButton;
+        bool showBlockButton;
+        bool showArrow;
+        bool isLocalUser; // local user messages are showed in right side
+        ChatMessagePanel *panel; // nullptr if the panel is not created
+    };
+
+    QList<HistoryMessage> history;
+    int firstPanelIndex; // index in history of the first (older) message with a created panel
+
+    static const int MAX_MESSAGES = 50; // message panels when the chat is scrolled to the bottom
+    static const int OLDER_MESSAGES_BATCH = 20;
+    static uint historyLimit;
+
+    bool keepingScrollPosition; // older panels inserted in the top
 
     int previousVerticalScrollBarMaxValue;
 
@@ -145,7 +175,12 @@ private:
 
     QColor getUserColor(const QString &userName);
 
-    void addMessagePanelInLayout(ChatMessagePanel *msgPanel, Qt::Alignment alignment);
+    void addMessageInHistory(const HistoryMessage &message);
+    ChatMessagePanel *createMessagePanel(const HistoryMessage &message);
+    void createOlderMessagePanels();
+    void destroyOlderMessagePanels();
+    void destroyMessagePanel(HistoryMessage &message);
+    int getCreatedPanels() const;
 
     void createVoteButton(const QString &voteType, quint32 value, quint32 expireTime);
 
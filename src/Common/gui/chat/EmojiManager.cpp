@@ -8,7 +8,9 @@
 #include <QFile>
 #include <QDateTime>
 #include <QStandardItemModel>
-#include <QRegularExpression>
+#include <QtConcurrent>
+
+#include "log/StartupTimeline.h"
 
 const uint EmojiManager::ICONS_SIZE = 24;
 
@@ -23,7 +25,7 @@ const QStringList EmojiManager::categories = QStringList()
         << "Objects"
         << "Symbols";
 
-const QMap<QString, QString> EmojiManager::combinationsMap = EmojiManager::getCombinationsMap();
+const KeywordMatcher EmojiManager::combinationsMatcher = EmojiManager::createCombinationsMatcher();
 
 
 Emoji::Emoji(const QString &name, const QString category, uint sortOrder, const QString &unifiedCode) :
@@ -59,6 +61,8 @@ QString EmojiManager::getEmojiIconUrl(const QString &emojiName) const
 
 QAbstractItemModel *EmojiManager::getDataModel(int completeRole)
 {
+    waitForData();
+
     QStandardItemModel *model = new QStandardItemModel();
     model->setColumnCount(1);
     model->setRowCount(generalMap.count());
@@ -84,34 +88,72 @@ bool emojiLessThan(const Emoji &e1, const Emoji &e2)
 
  bool EmojiManager::codeIsEmoji(uint code) const
  {
+     waitForData();
+
      return generalMap.contains(code);
  }
 
- EmojiManager::EmojiManager(const QString &emojisJsonPath, const QString &emojiIconsPath) :
-     iconsPath(emojiIconsPath)
+ EmojiManager::EmojiManager(const QString &emojisJsonPath, const QString &emojiIconsPath, const QStringList &recents) :
+     iconsPath(emojiIconsPath),
+     recents(recents)
  {
-     loadData(emojisJsonPath);
+     dataLoading = QtConcurrent::run(this, &EmojiManager::loadData, emojisJsonPath, recents);
  }
 
-QString EmojiManager::emojify(const QString &string)
+ EmojiManager::~EmojiManager()
+ {
+     dataLoading.waitForFinished();
+ }
+
+void EmojiManager::waitForData() const
 {
-    QString replacedString(string);
+    if (!dataLoading.isFinished())
+        dataLoading.waitForFinished();
+}
 
-    for (const QString &combination : combinationsMap.keys())
-        replacedString.replace(QRegularExpression(combination), emojiCodeToUtf8(combinationsMap[combination]));
+QString EmojiManager::emojify(const QString &string)
+{
+    waitForData();
 
-    QVector<uint> codes = replacedString.toUcs4();
+    // single pass, the combinations (shortcodes) and the unicode emojis are replaced in the same scan
     QString newString;
-    for (uint code : codes) {
-        if (!EmojiManager::codeIsEmoji(code)) {
-            newString.append(QString::fromUcs4(&code, 1));
+    newString.reserve(string.size());
+
+    const int size = string.size();
+    int position = 0;
+    while (position < size) {
+        uint code;
+        int length;
+
+        auto match = combinationsMatcher.matchAt(string, position);
+        if (match.isValid()) {
+            code = static_cast<uint>(match.value);
+            length = match.length;
         }
-        else{
-            Emoji emoji = getByCode(code);
-            newString.append(QString("<img src=%1>").arg(getEmojiIconUrl(emoji)));
+        else if (string.at(position).isHighSurrogate() && position + 1 < size && string.at(position + 1).isLowSurrogate()) {
+            code = QChar::surrogateToUcs4(string.at(position), string.at(position + 1));
+            length = 2;
         }
+        else if (string.at(position).unicode() < 0x80) { // plain ASCII, the most common case
+            newString.append(string.at(position));
+            position++;
+            continue;
+        }
+        else {
+            code = string.at(position).unicode();
+            length = 1;
+        }
+
+        auto emoji = generalMap.constFind(code);
+        if (emoji != generalMap.constEnd())
+            newString.append(QString("<img src=%1>").arg(getEmojiIconUrl(emoji.value())));
+        else
+            newString.append(QString::fromUcs4(&code, 1));
+
+        position += length;
     }
-     return newString;
+
+    return newString;
 }
 
 QStringList EmojiManager::getCategories() const
@@ -121,11 +163,14 @@ QStringList EmojiManager::getCategories() const
 
 QList<Emoji> EmojiManager::getByCategory(const QString &category) const
 {
+    waitForData();
+
     return categorizedMap[category];
 }
 
-void EmojiManager::loadData(const QString &jsonPath)
+void EmojiManager::loadData(const QString &jsonPath, const QStringList &recents)
 {
+    StartupPhase phase("Loading emojis");
 
     QStringList skipCategories;
     skipCategories << "Flags";
@@ -177,10 +222,18 @@ void EmojiManager::loadData(const QString &jsonPath)
         auto &emojis = categorizedMap[key];
         qSort(emojis.begin(), emojis.end(), emojiLessThan);
     }
+
+    for (const QString &emojiCode : recents) {
+        Emoji emoji = generalMap.value(emojiCode.toInt(0, 16));
+        categorizedMap["Recent"].removeAll(emoji);
+        categorizedMap["Recent"].push_front(emoji);
+    }
 }
 
 Emoji EmojiManager::getByCode(uint emojiCode) const
 {
+    waitForData();
+
     return generalMap[emojiCode];
 }
 
@@ -200,6 +253,8 @@ QString EmojiManager::emojiCodeToUtf8(const QString &emojiCode)
 
 void EmojiManager::addRecent(const QString &emojiCode)
 {
+    waitForData();
+
     Emoji emoji = getByCode(emojiCode.toInt(0, 16));
 
     categorizedMap["Recent"].removeAll(emoji);
@@ -209,36 +264,40 @@ void EmojiManager::addRecent(const QString &emojiCode)
         recents << emojiCode;
 }
 
-QMap<QString, QString> EmojiManager::getCombinationsMap()
+KeywordMatcher EmojiManager::createCombinationsMatcher()
 {
-    QMap<QString, QString> combinations;
-
-    combinations.insert(":\\)",   "1F600");
-    combinations.insert(":-\\)",  "1F600");
-    combinations.insert(":\\(",   "1F61E");
-    combinations.insert(":-\\(",  "1F61E");
-    combinations.insert(";\\)",   "1F609");
-    combinations.insert(";-\\)",  "1F609");
-    combinations.insert(":-o\\)", "1F632");
-    combinations.insert(":-O\\)", "1F632");
-    combinations.insert(":p",   "1F61B");
-    combinations.insert(":-p",  "1F61B");
-    combinations.insert(":P",   "1F61B");
-    combinations.insert(":-P",  "1F61B");
-    combinations.insert(":/\\)",  "1F615");
-    combinations.insert(":-/\\)", "1F615");
-    combinations.insert(":D",   "1F603");
-    combinations.insert(":-D\\)", "1F603");
-    combinations.insert(":@",   "1F620");
-    combinations.insert(":-@\\)", "1F620");
-    combinations.insert(":y",   "1F44D");
-    combinations.insert(":n",   "1F44E");
-    combinations.insert(":\\+1",  "1F44D");
-    combinations.insert(":-1",  "1F44E");
-    combinations.insert(":\\*",   "1F617");
-    combinations.insert(":-\\*",  "1F617");
-    combinations.insert(":'\\(",  "1F622");
-    combinations.insert(":'-\\(", "1F622");
+    KeywordMatcher combinations;
+
+    combinations.addKeyword(":)",   0x1F600);
+    combinations.addKeyword(":-)",  0x1F600);
+    combinations.addKeyword(":(",   0x1F61E);
+    combinations.addKeyword(":-(",  0x1F61E);
+    combinations.addKeyword(";)",   0x1F609);
+    combinations.addKeyword(";-)",  0x1F609);
+    combinations.addKeyword(":-o)", 0x1F632);
+    combinations.addKeyword(":-O)", 0x1F632);
+    combinations.addKeyword(":p",   0x1F61B);
+    combinations.addKeyword(":-p",  0x1F61B);
+    combinations.addKeyword(":P",   0x1F61B);
+    combinations.addKeyword(":-P",  0x1F61B);
+    combinations.addKeyword(":/)",  0x1F615);
+    combinations.addKeyword(":-/)", 0x1F615);
+    combinations.addKeyword(":D",   0x1F603);
+    combinations.addKeyword(":-D)", 0x1F603);
+    combinations.addKeyword(":@",   0x1F620);
+    combinations.addKeyword(":-@)", 0x1F620);
+    combinations.addKeyword(":y",   0x1F44D);
+    combinations.addKeyword(":n",   0x1F44E);
+    combinations.addKeyword("(y)",  0x1F44D);
+    combinations.addKeyword("(n)",  0x1F44E);
+    combinations.addKeyword(":+1",  0x1F44D);
+    combinations.addKeyword(":-1",  0x1F44E);
+    combinations.addKeyword("+1",   0x1F44D, true); // whole word, avoiding 'bpm+1', '4-1', etc.
+    combinations.addKeyword("-1",   0x1F44E, true);
+    combinations.addKeyword(":*",   0x1F617);
+    combinations.addKeyword(":-*",  0x1F617);
+    combinations.addKeyword(":'(",  0x1F622);
+    combinations.addKeyword(":'-(", 0x1F622);
 
     return combinations;
 }
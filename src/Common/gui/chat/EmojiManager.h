@@ -8,6 +8,9 @@
 #include <QList>
 #include <QPixmap>
 #include <QAbstractItemModel>
+#include <QFuture>
+
+#include "KeywordMatcher.h"
 
 class Emoji
 {
@@ -36,7 +39,8 @@ public:
 
     static const uint ICONS_SIZE;
 
-    EmojiManager(const QString &emojisJsonPath, const QString &emojiIconsPath);
+    EmojiManager(const QString &emojisJsonPath, const QString &emojiIconsPath, const QStringList &recents = QStringList());
+    ~EmojiManager();
 
     QList<Emoji> getByCategory(const QString  &category) const;
     Emoji getByCode(uint emojiCode) const;
@@ -58,20 +62,23 @@ public:
 
 private:
 
-    void loadData(const QString &jsonPath);
+    void loadData(const QString &jsonPath, const QStringList &recents); // running in a worker thread
+    void waitForData() const; // the emojis are loaded in parallel with the other startup tasks
+
+    mutable QFuture<void> dataLoading;
 
     QMap<QString, QList<Emoji>> categorizedMap; // the category as key
     QMap<uint, Emoji> generalMap; // the emoji unicode as key
 
     static const QStringList categories;
 
-    static const QMap<QString, QString> combinationsMap;
+    static const KeywordMatcher combinationsMatcher; // built once, shared by all instances
 
     QString iconsPath;
 
     QStringList recents;
 
-    static QMap<QString, QString> getCombinationsMap();
+    static KeywordMatcher createCombinationsMatcher();
 
 };
 
@@ -0,0 +1,91 @@
+#include "KeywordMatcher.h"
+
+KeywordMatcher::Node::Node() :
+    value(0),
+    isKeyword(false),
+    wholeWord(false)
+{
+
+}
+
+KeywordMatcher::KeywordMatcher() :
+    nodes(1) // root
+{
+
+}
+
+void KeywordMatcher::addKeyword(const QString &keyword, int value, bool wholeWord)
+{
+    if (keyword.isEmpty())
+        return;
+
+    int nodeIndex = 0;
+    for (const QChar &c : keyword) {
+        int child = nodes[nodeIndex].children.value(c, -1);
+        if (child < 0) {
+            child = nodes.size();
+            nodes.append(Node()); // 'nodes' can be reallocated, the node is accessed by index
+            nodes[nodeIndex].children.insert(c, child);
+        }
+        nodeIndex = child;
+    }
+
+    Node &node = nodes[nodeIndex];
+    node.value = value;
+    node.isKeyword = true;
+    node.wholeWord = wholeWord;
+}
+
+KeywordMatcher::Match KeywordMatcher::matchAt(const QString &text, int position) const
+{
+    Match match = { position, 0, 0 };
+
+    if (position < 0)
+        return match;
+
+    const int textSize = text.size();
+    const QChar *chars = text.constData();
+
+    int nodeIndex = 0;
+    for (int i = position; i < textSize; ++i) {
+        nodeIndex = nodes[nodeIndex].children.value(chars[i], -1);
+        if (nodeIndex < 0)
+            break;
+
+        const Node &node = nodes[nodeIndex];
+        if (!node.isKeyword)
+            continue;
+
+        if (node.wholeWord && (isWordCharacter(text, position - 1) || isWordCharacter(text, i + 1)))
+            continue;
+
+        match.length = i - position + 1;
+        match.value = node.value;
+    }
+
+    return match;
+}
+
+KeywordMatcher::Match KeywordMatcher::findNext(const QString &text, int from) const
+{
+    const QHash<QChar, int> &firstChars = nodes.first().children;
+
+    for (int position = qMax(0, from); position < text.size(); ++position) {
+        if (!firstChars.contains(text.at(position)))
+            continue;
+
+        Match match = matchAt(text, position);
+        if (match.isValid())
+            return match;
+    }
+
+    return { text.size(), 0, 0 };
+}
+
+bool KeywordMatcher::isWordCharacter(const QString &text, int position)
+{
+    if (position < 0 || position >= text.size()) // text limits
+        return false;
+
+    return text.at(position).isLetterOrNumber();
+}
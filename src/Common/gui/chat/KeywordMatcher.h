@@ -0,0 +1,63 @@
+#ifndef KEYWORD_MATCHER_H
+#define KEYWORD_MATCHER_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+/**
+ * Literal keywords (emoji shortcodes, chat commands, chord tokens, etc.) compiled in a trie. The
+ * matcher is built once and the chat messages are scanned in a single pass, the longest keyword
+ * starting in each position is matched without regular expressions.
+ */
+
+class KeywordMatcher
+{
+public:
+    struct Match
+    {
+        int position;
+        int length;
+        int value;
+
+        inline bool isValid() const { return length > 0; }
+    };
+
+    KeywordMatcher();
+
+    // whole word keywords are not matched inside words ('+1' is matched in 'nice +1' but not in 'bpm+1')
+    void addKeyword(const QString &keyword, int value, bool wholeWord = false);
+
+    Match matchAt(const QString &text, int position) const; // the longest keyword starting in 'position'
+    Match findNext(const QString &text, int from = 0) const;
+
+    bool startsWithKeyword(const QString &text) const;
+    bool isEmpty() const;
+
+private:
+    struct Node
+    {
+        Node();
+
+        QHash<QChar, int> children; // node indexes
+        int value;
+        bool isKeyword;
+        bool wholeWord;
+    };
+
+    static bool isWordCharacter(const QString &text, int position);
+
+    QVector<Node> nodes; // the first node is the root
+};
+
+inline bool KeywordMatcher::startsWithKeyword(const QString &text) const
+{
+    return matchAt(text, 0).isValid();
+}
+
+inline bool KeywordMatcher::isEmpty() const
+{
+    return nodes.size() <= 1;
+}
+
+#endif
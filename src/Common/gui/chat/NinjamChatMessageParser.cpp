@@ -1,4 +1,5 @@
 #include "NinjamChatMessageParser.h"
+#include "KeywordMatcher.h"
 #include <QRegularExpression>
 #include <QDebug>
 
@@ -10,9 +11,40 @@ const QRegularExpression gui::chat::SYSTEM_VOTING_REGEX("\\[voting system\\] lea
 /** Local user voting format is: !vote bpi/bpm 120, always in lower case */
 const QRegularExpression gui::chat::LOCAL_USER_VOTING_REGEX("!vote (\\bbpi|\\bbpm) \\d{1,3}");
 
-const QRegularExpression gui::chat::ADMIN_COMMAND_REGEX("^/bpi|^/bpm|^/kick|^/topic");
+namespace {
 
-const QRegularExpression gui::chat::PRIVATE_MESSAGE_REGEX("^/msg");
+    enum MessagePrefix
+    {
+        ADMIN_COMMAND = 1,
+        PRIVATE_MESSAGE,
+        SERVER_INVITATION
+    };
+
+    // the chat messages prefixes are checked without regular expressions, most messages are discarded in the first character
+    KeywordMatcher createPrefixesMatcher()
+    {
+        KeywordMatcher matcher;
+
+        matcher.addKeyword("/bpi", ADMIN_COMMAND);
+        matcher.addKeyword("/bpm", ADMIN_COMMAND);
+        matcher.addKeyword("/kick", ADMIN_COMMAND);
+        matcher.addKeyword("/topic", ADMIN_COMMAND);
+
+        matcher.addKeyword("/msg", PRIVATE_MESSAGE);
+
+        matcher.addKeyword("Let's play in ", SERVER_INVITATION);
+
+        return matcher;
+    }
+
+    const KeywordMatcher PREFIXES_MATCHER = createPrefixesMatcher();
+
+    bool startsWith(const QString &message, MessagePrefix prefix)
+    {
+        return PREFIXES_MATCHER.matchAt(message, 0).value == prefix;
+    }
+
+} // namespace
 
 const QRegularExpression gui::chat::PUBLIC_SERVER_INVITE_REGEX("^(Let's play in ([A-Za-z\\.0-9]+) \\: ([0-9]{4}) \\?)");
 const QRegularExpression gui::chat::PRIVATE_SERVER_INVITE_REGEX("^(Let's play in my private server\\?)\\n\\n IP\\: ([A-Za-z\\.0-9]+) \\n\\n PORT\\: ([0-9]{4}) \\n");
@@ -66,6 +98,9 @@ bool gui::chat::isServerInvitation(const QString &message)
         \n\n IP: %1 \n\n PORT: %2 \n
     */
 
+    if (!startsWith(message, SERVER_INVITATION))
+        return false;
+
     return PUBLIC_SERVER_INVITE_REGEX.match(message).hasMatch()
             || PRIVATE_SERVER_INVITE_REGEX.match(message).hasMatch();
 }
@@ -95,12 +130,12 @@ gui::chat::ServerInviteMessage gui::chat::parseServerInviteMessage(const QString
 
 bool gui::chat::isPrivateMessage(const QString &message)
 {
-    return PRIVATE_MESSAGE_REGEX.match(message).hasMatch();
+    return startsWith(message, PRIVATE_MESSAGE);
 }
 
 bool gui::chat::isAdminCommand(const QString &message)
 {
-    return ADMIN_COMMAND_REGEX.match(message).hasMatch();
+    return startsWith(message, ADMIN_COMMAND);
 }
 
 bool gui::chat::isLocalUserVotingMessage(const QString &message)
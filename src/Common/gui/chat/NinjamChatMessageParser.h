@@ -11,8 +11,6 @@ namespace gui
 
         extern const QRegularExpression SYSTEM_VOTING_REGEX;
         extern const QRegularExpression LOCAL_USER_VOTING_REGEX;
-        extern const QRegularExpression ADMIN_COMMAND_REGEX;
-        extern const QRegularExpression PRIVATE_MESSAGE_REGEX;
         extern const QRegularExpression PUBLIC_SERVER_INVITE_REGEX;
         extern const QRegularExpression PRIVATE_SERVER_INVITE_REGEX;
 
@@ -1,6 +1,7 @@
 #include "ChatChordsProgressionParser.h"
 
 #include <QString>
+#include <QStringList>
 #include <QRegularExpression>
 
 const QString ChatChordsProgressionParser::CHORDS_EXTENSIONS = "(M|Major|major|maj|m|minor|min|add|sus|aug|dim|M7|7M)";
@@ -13,15 +14,52 @@ const QString ChatChordsProgressionParser::CHORD_REGEX
 
 const QString ChatChordsProgressionParser::MEASURE_SEPARATORS_REGEX = "\\||!|I|l";
 
+const KeywordMatcher ChatChordsProgressionParser::tokensMatcher = ChatChordsProgressionParser::createTokensMatcher();
+
+KeywordMatcher ChatChordsProgressionParser::createTokensMatcher()
+{
+    KeywordMatcher matcher;
+
+    for (const QString &separator : QStringList({ "|", "!", "I", "l" }))
+        matcher.addKeyword(separator, MEASURE_SEPARATOR);
+
+    for (const QString &root : QStringList({ "A", "B", "C", "D", "E", "F", "G" })) {
+        matcher.addKeyword(root, CHORD_ROOT);
+        matcher.addKeyword(root + "b", CHORD_ROOT);
+        matcher.addKeyword(root + "#", CHORD_ROOT);
+    }
+
+    return matcher;
+}
+
 bool ChatChordsProgressionParser::isValidChord(const QString &chordString)
 {
-    QRegularExpression regex("^" + CHORD_REGEX + "$");
+    static const QRegularExpression regex("^" + CHORD_REGEX + "$");
     return regex.match(chordString).hasMatch();
 }
 
+bool ChatChordsProgressionParser::startsWithMeasure(const QString &string)
+{
+    // a progression starts with a measure separator, 2 blank spaces (max) and a chord root
+    auto separator = tokensMatcher.matchAt(string, 0);
+    if (!separator.isValid() || separator.value != MEASURE_SEPARATOR)
+        return false;
+
+    int position = separator.length;
+    for (int spaces = 0; spaces < 2 && position < string.size() && string.at(position) == QChar(' '); ++spaces)
+        position++;
+
+    auto root = tokensMatcher.matchAt(string, position);
+    return root.isValid() && root.value == CHORD_ROOT;
+}
+
 bool ChatChordsProgressionParser::containsProgression(const QString &string)
 {
-    QRegularExpression regex(
+    // most chat messages are discarded by the tokens matcher, the regex is used only to validate a possible progression
+    if (!startsWithMeasure(string))
+        return false;
+
+    static const QRegularExpression regex(
         "^([" + MEASURE_SEPARATORS_REGEX + "][ ]{0,2}" + CHORD_REGEX + "{1,4}){2,}");
     QString cleanedString = getSanitizedString(string);
     QRegularExpressionMatch match = regex.match(cleanedString);
@@ -34,10 +72,11 @@ ChordProgression ChatChordsProgressionParser::parse(const QString &string)
     QString cleanedString = getSanitizedString(string);
 
     if (containsProgression(cleanedString)) {
+        static const QRegularExpression separatorsRegex(MEASURE_SEPARATORS_REGEX);
+        static const QRegularExpression matcher(CHORD_REGEX);
+
         ChordProgression progression;
-        QStringList measuresStrings
-            = cleanedString.split(QRegularExpression(MEASURE_SEPARATORS_REGEX));
-        QRegularExpression matcher(CHORD_REGEX);
+        QStringList measuresStrings = cleanedString.split(separatorsRegex);
         int beatsPerMeasure = 4;// using 4 beats as default TODO: try guess a good value based in current ninjam server BPI
         for (const QString &measureString : measuresStrings) {
             ChordProgressionMeasure measure(beatsPerMeasure);
@@ -59,8 +98,7 @@ QString ChatChordsProgressionParser::getSanitizedString(const QString &string)
 {
     // check if user type a measure separator or blank space in the end of string
     int index = string.size() - 1;
-    QRegularExpression matcher(MEASURE_SEPARATORS_REGEX + "| ");// including blanck space in regex
-    while (matcher.match(string.mid(index, 1)).hasMatch())
+    while (index >= 0 && (string.at(index) == QChar(' ') || tokensMatcher.matchAt(string, index).value == MEASURE_SEPARATOR))
         index--;
     return string.left(index + 1);
 }
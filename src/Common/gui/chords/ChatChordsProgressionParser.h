@@ -3,6 +3,7 @@
 
 #include "ChordsProgressionParser.h"
 #include "ChordProgression.h"
+#include "gui/chat/KeywordMatcher.h"
 
 class QString;
 
@@ -15,6 +16,16 @@ public:
     static bool isValidChord(const QString &chordString);
 private:
     QString getSanitizedString(const QString &string);
+    static bool startsWithMeasure(const QString &string);
+
+    enum Token
+    {
+        MEASURE_SEPARATOR = 1,
+        CHORD_ROOT
+    };
+
+    static const KeywordMatcher tokensMatcher; // measure separators and chord roots
+    static KeywordMatcher createTokensMatcher();
 
     static const QString CHORD_REGEX;
     static const QString CHORDS_EXTENSIONS;
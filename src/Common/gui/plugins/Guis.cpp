@@ -2,11 +2,12 @@
 #include <QGridLayout>
 #include <QSlider>
 #include <QLabel>
-#include <QLineEdit>
+#include <QComboBox>
 #include <cmath>
 #include <QDebug>
 #include <QObject>
 #include "audio/core/Plugins.h"
+#include "audio/core/NativePlugins.h"
 
 PluginGui::PluginGui(audio::Plugin *plugin) :
     QWidget(0),
@@ -27,66 +28,91 @@ audio::Plugin *PluginGui::getPlugin() const
 
 // ++++++++++++++++++++++++++++++++++++++++++++++
 
-DelayGui::DelayGui(audio::JamtabaDelay *delayPlugin) :
-    PluginGui(delayPlugin)
+const int NativePluginGui::SLIDER_STEPS = 1000;
+
+NativePluginGui::NativePluginGui(audio::NativePlugin *nativePlugin) :
+    PluginGui(nativePlugin),
+    nativePlugin(nativePlugin)
 {
     QGridLayout *mainLayout = new QGridLayout(this);
 
-    // delay time
-    sliderDelayTime = new QSlider(Qt::Horizontal, this);
-    sliderDelayTime->setMinimum(1);
-    sliderDelayTime->setMaximum(2000); // 2 seconds
-    lineEditDelayTime = new QLineEdit(this);
-    mainLayout->addWidget(new QLabel(tr("Delay Time (ms):"), this), 0, 0, Qt::AlignRight);
-    mainLayout->addWidget(sliderDelayTime, 0, 1);
-    mainLayout->addWidget(lineEditDelayTime, 0, 2);
-    QObject::connect(sliderDelayTime, &QSlider::sliderReleased, this, &DelayGui::on_sliderDelayReleased);
-
-    // feedback
-    sliderFeedback = new QSlider(Qt::Horizontal, this);
-    lineEditFeedback = new QLineEdit(this);
-    mainLayout->addWidget(new QLabel(tr("Feedback (db):"), this), 1, 0, Qt::AlignRight);
-    mainLayout->addWidget(sliderFeedback, 1, 1);
-    mainLayout->addWidget(lineEditFeedback, 1, 2);
-    QObject::connect(sliderFeedback, &QSlider::sliderReleased, this, &DelayGui::on_sliderFeedbackReleased);
-
-    // level
-    sliderLevel = new QSlider(Qt::Horizontal, this); // wet gain
-    sliderLevel->setMaximum(100);
-    lineEditLevel = new QLineEdit(this);
-    mainLayout->addWidget(new QLabel(tr("Level:"), this), 2, 0, Qt::AlignRight);
-    mainLayout->addWidget(sliderLevel, 2, 1);
-    mainLayout->addWidget(lineEditLevel, 2, 2);
-    QObject::connect(sliderLevel, &QSlider::sliderReleased, this, &DelayGui::on_sliderLevelReleased);
-
-    // initial values
-    sliderDelayTime->setValue(sliderDelayTime->maximum() * 0.25);
-    sliderFeedback->setValue(sliderFeedback->maximum() * 0.25);
-    sliderLevel->setValue(sliderLevel->maximum() * 0.5);
+    for (int i = 0; i < nativePlugin->getParametersCount(); ++i) {
+        const audio::NativePlugin::Parameter &parameter = nativePlugin->getParameter(i);
+        const float value = nativePlugin->getParameterValue(i);
+
+        mainLayout->addWidget(new QLabel(parameter.name + ":", this), i, 0, Qt::AlignRight);
+
+        if (!parameter.valueNames.isEmpty()) {
+            QComboBox *comboBox = new QComboBox(this);
+            comboBox->addItems(parameter.valueNames);
+            comboBox->setCurrentIndex(static_cast<int>(value));
+            comboBox->setProperty("parameterIndex", i);
+            mainLayout->addWidget(comboBox, i, 1, 1, 2);
+            connect(comboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(setParameterValueFromComboBox(int)));
+            valueLabels.append(nullptr);
+            continue;
+        }
+
+        // the parameters are smoothed in the audio thread, the slider is changing the value while dragging
+        QSlider *slider = new QSlider(Qt::Horizontal, this);
+        slider->setRange(0, SLIDER_STEPS);
+        slider->setValue(valueToSliderPosition(i, value));
+        slider->setMinimumWidth(200);
+        slider->setProperty("parameterIndex", i);
+        mainLayout->addWidget(slider, i, 1);
+        connect(slider, &QSlider::valueChanged, this, &NativePluginGui::setParameterValueFromSlider);
+
+        QLabel *valueLabel = new QLabel(this);
+        valueLabel->setMinimumWidth(60);
+        mainLayout->addWidget(valueLabel, i, 2);
+        valueLabels.append(valueLabel);
+
+        updateValueLabel(i);
+    }
 }
 
-void DelayGui::on_sliderDelayReleased()
+void NativePluginGui::setParameterValueFromSlider(int sliderValue)
 {
-    dynamic_cast<audio::JamtabaDelay *>(plugin)->setDelayTime(sliderDelayTime->value());
-    lineEditDelayTime->setText(QString::number(sliderDelayTime->value()));
+    const int parameterIndex = sender()->property("parameterIndex").toInt();
+
+    nativePlugin->setParameterValue(parameterIndex, sliderPositionToValue(parameterIndex, sliderValue));
+    updateValueLabel(parameterIndex);
 }
 
-void DelayGui::on_sliderFeedbackReleased()
+void NativePluginGui::setParameterValueFromComboBox(int comboIndex)
 {
-    int value = sliderFeedback->value();
-    dynamic_cast<audio::JamtabaDelay *>(plugin)->setFeedback(value/100.0);
-    float db = 20 * std::log10(value/100.0);
-    lineEditFeedback->setText(QString::number(db, 'f', 1));
+    const int parameterIndex = sender()->property("parameterIndex").toInt();
+
+    nativePlugin->setParameterValue(parameterIndex, comboIndex);
 }
 
-void DelayGui::on_sliderLevelReleased()
+int NativePluginGui::valueToSliderPosition(int parameterIndex, float value) const
 {
-    int value = sliderLevel->value();
-    dynamic_cast<audio::JamtabaDelay *>(plugin)->setLevel(value/100.0);
-    lineEditLevel->setText(QString::number(value/100.0, 'f', 1));
+    const audio::NativePlugin::Parameter &parameter = nativePlugin->getParameter(parameterIndex);
+
+    float position;
+    if (parameter.logarithmic)
+        position = std::log(value / parameter.minValue) / std::log(parameter.maxValue / parameter.minValue);
+    else
+        position = (value - parameter.minValue) / (parameter.maxValue - parameter.minValue);
+
+    return qRound(position * SLIDER_STEPS);
+}
+
+float NativePluginGui::sliderPositionToValue(int parameterIndex, int position) const
+{
+    const audio::NativePlugin::Parameter &parameter = nativePlugin->getParameter(parameterIndex);
+    const float normalizedPosition = static_cast<float>(position) / SLIDER_STEPS;
+
+    if (parameter.logarithmic)
+        return parameter.minValue * std::pow(parameter.maxValue / parameter.minValue, normalizedPosition);
+
+    return parameter.minValue + (parameter.maxValue - parameter.minValue) * normalizedPosition;
 }
 
-DelayGui::~DelayGui()
+void NativePluginGui::updateValueLabel(int parameterIndex)
 {
-    qDebug() << "detrutor delay GUI";
+    QLabel *valueLabel = valueLabels.at(parameterIndex);
+    if (valueLabel)
+        valueLabel->setText(nativePlugin->getParameterText(parameterIndex));
 }
@@ -3,11 +3,10 @@
 
 #include <QWidget>
 
-class QSlider;
-class QLineEdit;
+class QLabel;
 
 namespace audio {
-class JamtabaDelay;
+class NativePlugin;
 class Plugin;
 }
 
@@ -28,28 +27,27 @@ protected:
 };
 
 
-class DelayGui : public PluginGui
+// generic editor for the native plugins, a slider (or a combo box for discrete values) per parameter
+class NativePluginGui : public PluginGui
 {
     Q_OBJECT
 
 public:
-    explicit DelayGui(audio::JamtabaDelay *delayPlugin);
-    ~DelayGui();
+    explicit NativePluginGui(audio::NativePlugin *nativePlugin);
 
 private slots:
-    void on_sliderDelayReleased();
-    void on_sliderFeedbackReleased();
-    void on_sliderLevelReleased();
+    void setParameterValueFromSlider(int sliderValue);
+    void setParameterValueFromComboBox(int comboIndex);
 
 private:
-    QSlider *sliderDelayTime;
-    QLineEdit *lineEditDelayTime;
+    static const int SLIDER_STEPS;
 
-    QSlider *sliderFeedback;
-    QLineEdit *lineEditFeedback;
+    audio::NativePlugin *nativePlugin;
+    QList<QLabel *> valueLabels;
 
-    QSlider *sliderLevel;
-    QLineEdit *lineEditLevel;
+    int valueToSliderPosition(int parameterIndex, float value) const;
+    float sliderPositionToValue(int parameterIndex, int position) const;
+    void updateValueLabel(int parameterIndex);
 };
 
 #endif // DELAY_H
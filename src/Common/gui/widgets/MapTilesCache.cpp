@@ -0,0 +1,96 @@
+#include "MapTilesCache.h"
+
+#include <QCoreApplication>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QFile>
+#include <QDebug>
+
+const int MapTilesCache::MAX_CACHE_SIZE = 8 * 1024; // 8 MB, 32 tiles with 256 x 256 pixels
+
+MapTilesCache *MapTilesCache::instance = nullptr;
+
+MapTilesCache *MapTilesCache::getInstance()
+{
+    if (!instance)
+        instance = new MapTilesCache(QCoreApplication::instance()); // the pixmaps are released before the application is destroyed
+
+    return instance;
+}
+
+MapTilesCache::MapTilesCache(QObject *parent) :
+    QObject(parent),
+    tiles(MAX_CACHE_SIZE),
+    generation(0)
+{
+
+}
+
+QPixmap MapTilesCache::getTile(const QString &tilesDir, int zoomLevel, int x, int y, int tileSize)
+{
+    const QString tilePath = QString("%1%2/%3/%4.png").arg(tilesDir).arg(zoomLevel).arg(x).arg(y);
+    const QString key = QString("%1@%2").arg(tilePath).arg(tileSize); // tiles are cached per displayed size
+
+    QPixmap *tile = tiles.object(key); // moving the tile to the front of LRU list
+    if (tile)
+        return *tile;
+
+    if (!pendingTiles.contains(key) && !missingTiles.contains(key))
+        decodeTile(tilePath, key, tileSize);
+
+    return QPixmap();
+}
+
+void MapTilesCache::decodeTile(const QString &tilePath, const QString &key, int tileSize)
+{
+    pendingTiles.insert(key);
+
+    const quint32 requestGeneration = generation;
+
+    auto watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [=]() {
+        QImage image = watcher->result();
+        watcher->deleteLater();
+
+        if (requestGeneration != generation) // cache cleared while decoding
+            return;
+
+        pendingTiles.remove(key);
+
+        if (image.isNull()) {
+            qCritical() << "Tile not found:" << tilePath;
+            missingTiles.insert(key);
+            return;
+        }
+
+        // QPixmap can't be created outside the GUI thread
+        QPixmap *pixmap = new QPixmap(QPixmap::fromImage(image));
+        const int cost = qMax(1, pixmap->width() * pixmap->height() * pixmap->depth() / 8 / 1024);
+        tiles.insert(key, pixmap, cost);
+
+        emit tileLoaded();
+    });
+
+    watcher->setFuture(QtConcurrent::run(&MapTilesCache::loadTileImage, tilePath, tileSize));
+}
+
+QImage MapTilesCache::loadTileImage(const QString &tilePath, int tileSize)
+{
+    if (!QFile::exists(tilePath))
+        return QImage();
+
+    QImage image(tilePath);
+    if (image.isNull() || image.size() == QSize(tileSize, tileSize))
+        return image;
+
+    // pre-scaled, the tile is not scaled in each paint
+    return image.scaled(tileSize, tileSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+void MapTilesCache::clear()
+{
+    tiles.clear();
+    pendingTiles.clear();
+    missingTiles.clear();
+    generation++;
+}
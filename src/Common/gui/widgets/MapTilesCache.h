@@ -0,0 +1,49 @@
+#ifndef MAP_TILES_CACHE_H
+#define MAP_TILES_CACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QPixmap>
+#include <QImage>
+#include <QSet>
+
+/**
+ * Map tiles shared by all MapWidgets. The tiles are decoded (and scaled to the displayed tile size)
+ * in a worker thread when they are requested by the first time, so only the visible tiles are loaded.
+ * The decoded tiles are kept in a size bounded LRU cache.
+ */
+
+class MapTilesCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static MapTilesCache *getInstance();
+
+    // return a null pixmap and start the decoding if the tile is not cached. The signal 'tileLoaded' is emitted when the tile is ready
+    QPixmap getTile(const QString &tilesDir, int zoomLevel, int x, int y, int tileSize);
+
+    void clear();
+
+    static const int MAX_CACHE_SIZE; // in KB
+
+signals:
+    void tileLoaded();
+
+private:
+    explicit MapTilesCache(QObject *parent);
+
+    void decodeTile(const QString &tilePath, const QString &key, int tileSize);
+
+    static QImage loadTileImage(const QString &tilePath, int tileSize); // running in a worker thread
+
+    QCache<QString, QPixmap> tiles; // tile path + size as key, the cost is the pixmap size in KB
+    QSet<QString> pendingTiles;
+    QSet<QString> missingTiles; // not founded tiles are not requested again
+
+    quint32 generation; // incremented when the cache is cleared, the old decoded tiles are discarded
+
+    static MapTilesCache *instance;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "MapWidget.h"
+#include "MapTilesCache.h"
 #include <QtCore>
 #include <QtWidgets>
 #include <QDebug>
@@ -17,13 +18,6 @@ const int MapWidget::MARKER_POSITIONS = 8;
 bool MapWidget::usingNightMode = false;
 const int MapWidget::ZOOM = 1; // fixed zoom level
 
-QHash<QPoint, QPixmap> MapWidget::tilePixmaps;
-
-uint qHash(const QPoint& p)
-{
-    return p.x() * 17 ^ p.y();
-}
-
 QPointF tileForCoordinate(qreal lat, qreal lng, int zoom)
 {
     qreal zn = static_cast<qreal>(1 << zoom);
@@ -58,7 +52,8 @@ MapWidget::MapWidget(QWidget *parent) :
     markerTextColor(Qt::white),
     markerLineConnectorColor(QColor(0, 0, 0, 180))
 {
-    loadTiles();
+    connect(MapTilesCache::getInstance(), &MapTilesCache::tileLoaded, this, static_cast<void (QWidget::*)()>(&QWidget::update));
+
     setCenter(QPointF(0, 0));
     installEventFilter(this);
     initializeCountryFont();
@@ -111,7 +106,10 @@ void MapWidget::initializeCountryFont()
 
 void MapWidget::setTilesDir(const QString &newDir)
 {
-    MapWidget::TILES_DIR = newDir;
+    if (newDir != MapWidget::TILES_DIR) {
+        MapWidget::TILES_DIR = newDir;
+        MapTilesCache::getInstance()->clear();
+    }
 }
 
 QPointF MapWidget::getCenterLatLong() const
@@ -268,19 +266,6 @@ void MapWidget::invalidate()
     update();
 }
 
-void MapWidget::loadTiles()
-{
-    int totalTiles = std::pow(2, ZOOM);
-    for (int x = 0; x < totalTiles; ++x) {
-        for (int y = 0; y < totalTiles; ++y) {
-            QPoint tp(x, y);
-            if (!tilePixmaps.contains(tp)) {
-                tilePixmaps.insert(tp, loadTile(ZOOM, x, y));
-            }
-        }
-    }
-}
-
 void MapWidget::updateMapPositionsCache()
 {
     static const int markersHeight = fontMetrics().height() * 2;
@@ -302,21 +287,10 @@ void MapWidget::resizeEvent(QResizeEvent *)
     setCenter(getCenterLatLong());
 }
 
-QPixmap MapWidget::loadTile(int zoomLevel, int x, int y)
-{
-    QString path(MapWidget::TILES_DIR + "%1/%2/%3.png");
-    path = path.arg(zoomLevel).arg(x).arg(y);
-    QFile imageFile(path);
-    if (!imageFile.exists()) {
-        qCritical() << "Tile not found to zoom:" << zoomLevel << " x:" << x << " y:" << y;
-        return QPixmap();
-    }
-
-    return QPixmap(path);
-}
-
 void MapWidget::drawMapTiles(QPainter &p, const QRect &rect)
 {
+    // only the visible tiles are requested, the not loaded tiles are painted when the 'tileLoaded' signal is received
+    auto tilesCache = MapTilesCache::getInstance();
     int tiles = std::pow(2, ZOOM);
     for (int x = 0; x <= tilesRect.width(); ++x) {
         for (int y = 0; y <= tilesRect.height(); ++y) {
@@ -325,9 +299,9 @@ void MapWidget::drawMapTiles(QPainter &p, const QRect &rect)
             if (rect.intersects(box)) {
                 tp.setX((tp.x() + tiles) % tiles);
                 tp.setY((tp.y() + tiles) % tiles);
-                if (tilePixmaps.contains(tp)) {
-                    p.drawPixmap(box, tilePixmaps.value(tp));
-                }
+                QPixmap tile = tilesCache->getTile(TILES_DIR, ZOOM, tp.x(), tp.y(), TILES_SIZE);
+                if (!tile.isNull())
+                    p.drawPixmap(box.topLeft(), tile);
             }
         }
     }
@@ -40,8 +40,6 @@ protected:
     bool eventFilter(QObject *, QEvent *) override;
 
     void changeEvent(QEvent *) override;
-private slots:
-    void loadTiles();
 
 private:
     static const int ZOOM;
@@ -50,7 +48,6 @@ private:
 
     QPoint offset;
     QRect tilesRect;
-    static QHash<QPoint, QPixmap> tilePixmaps; // tiles cache
 
     static bool usingNightMode;
 
@@ -74,8 +71,6 @@ private:
 
     void setCenter(QPointF latLong);
 
-    QPixmap loadTile(int zoomLevel, int x, int y);
-
     QPointF getCenterLatLong() const;
 
     QRectF computeMinimumRect(int ZOOM) const;
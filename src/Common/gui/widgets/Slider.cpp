@@ -5,6 +5,7 @@
 #include <QStyleOptionSlider>
 #include <QToolTip>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QDebug>
 #include <QObjectData>
 
@@ -23,6 +24,12 @@ bool AudioSlider::paintingMaxPeakMarker = true;
 bool AudioSlider::paintingPeaks = true;
 bool AudioSlider::paintingRMS = true;
 
+QList<AudioSlider *> AudioSlider::instances; // static instances list
+
+bool AudioSlider::measuringPaintTime = false;
+qint64 AudioSlider::paintTime = 0;
+uint AudioSlider::repaintedMeters = 0;
+
 AudioSlider::AudioSlider(QWidget *parent) :
     QSlider(parent),
     lastUpdate(QDateTime::currentMSecsSinceEpoch()),
@@ -31,19 +38,170 @@ AudioSlider::AudioSlider(QWidget *parent) :
     peakStartColor(Qt::darkGreen),
     peakEndColor(Qt::red),
     maxPeakColor(QColor(0, 0, 0, 80)),
+    clipColor(Qt::red),
     dBMarksColor(Qt::lightGray),
     stereo(true),
+    clipping(false),
+    lastClipTime(0),
     paintingDbMarkers(true),
     drawSegments(true),
     showMeterOnly(false),
-    showSliderOnly(false)
+    showSliderOnly(false),
+    meterPixmapParallelSegments(0)
 {
     setMaximum(129); // up to +6dB
 
     connect(this, &AudioSlider::valueChanged, this, &AudioSlider::showToolTip);
 
-    currentPeak[0] = currentPeak[1] = 0;
-    currentRms[0] = currentRms[1] = 0;
+    for (int i = 0; i < 2; ++i) {
+        currentPeak[i] = maxPeak[i] = currentRms[i] = 0;
+        lastMaxPeakTime[i] = 0;
+    }
+
+    meterState = computeMeterState();
+
+    instances.append(this);
+}
+
+AudioSlider::~AudioSlider()
+{
+    instances.removeOne(this);
+}
+
+void AudioSlider::updateAllMeters()
+{
+    for (AudioSlider *slider : instances) {
+        if (slider->isVisible())
+            slider->updateMeter();
+    }
+}
+
+void AudioSlider::setMeasuringPaintTime(bool measuring)
+{
+    measuringPaintTime = measuring;
+    paintTime = 0;
+    repaintedMeters = 0;
+}
+
+qint64 AudioSlider::takePaintTime()
+{
+    qint64 time = paintTime;
+    paintTime = 0;
+    return time;
+}
+
+uint AudioSlider::takeRepaintedMeters()
+{
+    uint meters = repaintedMeters;
+    repaintedMeters = 0;
+    return meters;
+}
+
+bool AudioSlider::MeterState::operator==(const MeterState &other) const
+{
+    for (int i = 0; i < 2; ++i) {
+        if (peakSegments[i] != other.peakSegments[i] || rmsSegments[i] != other.rmsSegments[i] || maxPeakPosition[i] != other.maxPeakPosition[i])
+            return false;
+    }
+
+    return parallelSegments == other.parallelSegments && clipping == other.clipping;
+}
+
+AudioSlider::MeterState AudioSlider::computeMeterState() const
+{
+    MeterState state;
+    state.parallelSegments = getParallelSegments();
+
+    const bool paintingMeter = isEnabled() && !showSliderOnly;
+    state.clipping = paintingMeter && paintingMaxPeakMarker && clipping;
+    const qreal rectSize = isVertical() ? height() : width();
+
+    for (uint i = 0; i < 2; ++i) {
+        const bool paintingChannel = paintingMeter && (stereo || i == 0);
+
+        state.peakSegments[i] = (paintingChannel && paintingPeaks && currentPeak[i]) ? static_cast<quint32>(getPeakPosition(currentPeak[i], rectSize))/SEGMENTS_SIZE : 0;
+        state.rmsSegments[i] = (paintingChannel && paintingRMS && currentRms[i]) ? static_cast<quint32>(getPeakPosition(currentRms[i], rectSize))/SEGMENTS_SIZE : 0;
+        state.maxPeakPosition[i] = (paintingChannel && paintingMaxPeakMarker && maxPeak[i]) ? qRound(getPeakPosition(maxPeak[i], rectSize)) : 0;
+    }
+
+    return state;
+}
+
+void AudioSlider::updateMeter()
+{
+    if (!showSliderOnly)
+        updateInternalValues(); // compute decay and max peak
+
+    const MeterState newState = computeMeterState();
+    if (newState == meterState)
+        return;
+
+    if (newState.parallelSegments != meterState.parallelSegments) { // meters layout changed
+        meterState = newState;
+        update();
+        return;
+    }
+
+    // repainting only the pixels changed since the last painting
+    QRectF dirtyRect;
+    for (uint i = 0; i < 2; ++i) {
+        const quint32 oldPeak = meterState.peakSegments[i];
+        const quint32 newPeak = newState.peakSegments[i];
+        if (oldPeak != newPeak)
+            dirtyRect |= getSegmentsRect(getBarRect(i), qMin(oldPeak, newPeak), qMax(oldPeak, newPeak));
+
+        const quint32 oldRms = meterState.rmsSegments[i];
+        const quint32 newRms = newState.rmsSegments[i];
+        if (oldRms != newRms)
+            dirtyRect |= getSegmentsRect(getBarRect(getRmsColumn(i)), qMin(oldRms, newRms), qMax(oldRms, newRms));
+
+        if (meterState.maxPeakPosition[i] != newState.maxPeakPosition[i] || meterState.clipping != newState.clipping) {
+            const QRectF barRect = getBarRect(i);
+            if (meterState.maxPeakPosition[i])
+                dirtyRect |= getMaxPeakMarkerRect(meterState.maxPeakPosition[i], barRect);
+            if (newState.maxPeakPosition[i])
+                dirtyRect |= getMaxPeakMarkerRect(newState.maxPeakPosition[i], barRect);
+        }
+    }
+
+    meterState = newState;
+
+    if (!dirtyRect.isEmpty())
+        update(dirtyRect.toAlignedRect().adjusted(-1, -1, 1, 1));
+}
+
+QRectF AudioSlider::getBarRect(uint column) const
+{
+    QRectF barRect(getGrooveRect());
+
+    const qreal parallelSegments = qMax(getParallelSegments(), 1u);
+
+    if (isVertical()) {
+        barRect.setWidth(barRect.width()/parallelSegments);
+        barRect.translate(column * barRect.width(), 0.0);
+    }
+    else {
+        barRect.setHeight(barRect.height()/parallelSegments);
+        barRect.translate(0.0, column * barRect.height());
+    }
+
+    return barRect;
+}
+
+uint AudioSlider::getRmsColumn(uint channel) const
+{
+    // RMS bars are painted after all peak bars
+    return paintingPeaks ? (stereo ? 2 : 1) + channel : channel;
+}
+
+QRectF AudioSlider::getSegmentsRect(const QRectF &barRect, quint32 firstSegment, quint32 lastSegment) const
+{
+    const qreal segmentsSize = (lastSegment - firstSegment) * SEGMENTS_SIZE;
+
+    if (isVertical())
+        return QRectF(barRect.left(), barRect.height() - lastSegment * SEGMENTS_SIZE, barRect.width(), segmentsSize);
+
+    return QRectF(barRect.left() + firstSegment * SEGMENTS_SIZE, barRect.top(), segmentsSize, barRect.height());
 }
 
 void AudioSlider::setShowMeterOnly(bool showMeterOnly)
@@ -65,20 +223,33 @@ void AudioSlider::toggleShowMeterOnly()
 
 void AudioSlider::paintRmsOnly()
 {
-    paintingRMS = true;
-    paintingPeaks = false;
+    setPaintingMode(false, true);
 }
 
 void AudioSlider::paintPeaksOnly()
 {
-    paintingRMS = false;
-    paintingPeaks = true;
+    setPaintingMode(true, false);
 }
 
 void AudioSlider::paintPeaksAndRms()
 {
-    paintingRMS = true;
-    paintingPeaks = true;
+    setPaintingMode(true, true);
+}
+
+void AudioSlider::setPaintingMode(bool peaks, bool rms)
+{
+    if (paintingPeaks == peaks && paintingRMS == rms)
+        return;
+
+    paintingPeaks = peaks;
+    paintingRMS = rms;
+
+    // the cached pixmap columns are using the peak or rms colors, peaks only and rms only have the same columns count
+    for (AudioSlider *slider : instances) {
+        slider->invalidateMeterPixmap();
+        slider->meterState = slider->computeMeterState();
+        slider->update();
+    }
 }
 
 bool AudioSlider::isPaintingPeaksOnly()
@@ -109,10 +280,18 @@ void AudioSlider::setPeak(float peak, float rms)
     if (rms > currentRms[0] || rms > currentRms[1])
         currentRms[0] = currentRms[1] = rms;
 
-    update();
+    // the meter is repainted in updateAllMeters()
 }
 
 
+void AudioSlider::setClipping()
+{
+    clipping = true;
+    lastClipTime = QDateTime::currentMSecsSinceEpoch();
+
+    // the meter is repainted in updateAllMeters()
+}
+
 void AudioSlider::setPeak(float leftPeak, float rightPeak, float leftRms, float rightRms)
 {
     auto maxLinearValue = Utils::linearGainToPower(getMaxLinearValue());
@@ -145,7 +324,7 @@ void AudioSlider::setPeak(float leftPeak, float rightPeak, float leftRms, float
             currentRms[i] = rms[i];
     }
 
-    update();
+    // the meter is repainted in updateAllMeters()
 }
 
 
@@ -231,11 +410,17 @@ void AudioSlider::setSliderOnly(bool showSliderOnly)
 {
     this->showSliderOnly = showSliderOnly;
 
+    meterState = computeMeterState();
+
     update();
 }
 
 void AudioSlider::paintEvent(QPaintEvent *)
 {
+    QElapsedTimer paintTimer;
+    if (measuringPaintTime)
+        paintTimer.start();
+
     QPainter painter(this);
 
     if (!painter.isActive())
@@ -246,41 +431,25 @@ void AudioSlider::paintEvent(QPaintEvent *)
 
     if (isEnabled() && !showSliderOnly) {
 
-        const uint channels = stereo ? 2 : 1;
-        const qreal rectSize = isVertical() ? height() : width();
-
-        QRectF drawRect(getGrooveRect());
-
-        const int parallelSegments = getParallelSegments();
+        // the meter is painted using the state computed in updateMeter(), so the areas outside the dirty region are always consistent
+        const qreal pixelRatio = devicePixelRatioF(); // the widget can be moved to a screen using another ratio
+        if (meterPixmap.isNull() || meterPixmap.devicePixelRatioF() != pixelRatio || meterPixmap.size() != size() * pixelRatio
+                || meterPixmapParallelSegments != getParallelSegments())
+            rebuildMeterPixmap();
 
-        if (isVertical())
-            drawRect.setWidth(drawRect.width()/static_cast<qreal>(parallelSegments));
-        else
-            drawRect.setHeight(drawRect.height()/static_cast<qreal>(parallelSegments));
+        const uint channels = stereo ? 2 : 1;
 
         for (uint i = 0; i < channels; ++i) {
-            if (paintingPeaks && currentPeak[i]) {
-                qreal peakPosition = getPeakPosition(currentPeak[i], rectSize);
-                paintSegments(painter, drawRect, peakPosition, peakColors, drawSegments);
-            }
-
-            if (paintingMaxPeakMarker && maxPeak[i]) {
-                qreal maxPeakPosition = getPeakPosition(maxPeak[i], rectSize);
-                paintMaxPeakMarker(painter, maxPeakPosition, drawRect);
-            }
+            const QRectF barRect = getBarRect(i);
 
-            if (paintingRMS && currentRms[i]) {
-                qreal rmsPosition = getPeakPosition(currentRms[i], rectSize);
+            if (meterState.peakSegments[i])
+                paintLitSegments(painter, barRect, meterState.peakSegments[i]);
 
-                qreal rmsXOffset = (paintingPeaks && isVertical()) ? channels * drawRect.width() : 0;
-                qreal rmsYOffset = (paintingPeaks && !isVertical()) ? channels * drawRect.height() : 0;
-                paintSegments(painter, drawRect.translated(rmsXOffset, rmsYOffset), rmsPosition, rmsColors, drawSegments);
-            }
+            if (meterState.maxPeakPosition[i])
+                painter.fillRect(getMaxPeakMarkerRect(meterState.maxPeakPosition[i], barRect), meterState.clipping ? clipColor : maxPeakColor);
 
-            if (isVertical())
-                drawRect.translate(drawRect.width(), 0.0);
-            else
-                drawRect.translate(0.0, drawRect.height());
+            if (meterState.rmsSegments[i])
+                paintLitSegments(painter, getBarRect(getRmsColumn(i)), meterState.rmsSegments[i]);
         }
     }
 
@@ -295,25 +464,64 @@ void AudioSlider::paintEvent(QPaintEvent *)
         paintSliderHandler(painter);
     }
 
-    if (!showSliderOnly)
-        updateInternalValues(); // compute decay and max peak
+    if (measuringPaintTime) {
+        paintTime += paintTimer.nsecsElapsed();
+        repaintedMeters++;
+    }
+}
+
+void AudioSlider::paintLitSegments(QPainter &painter, const QRectF &barRect, quint32 segments)
+{
+    // copying the lit segments from the cached pixmap instead of fill each segment
+    // the pixmap is in device pixels, so the source rect is scaled
+    const QRect segmentsRect = getSegmentsRect(barRect, 0, segments).toAlignedRect().intersected(rect());
+    const qreal pixelRatio = meterPixmap.devicePixelRatioF();
+    const QRectF sourceRect(QPointF(segmentsRect.topLeft()) * pixelRatio, QSizeF(segmentsRect.size()) * pixelRatio);
+    painter.drawPixmap(QRectF(segmentsRect), meterPixmap, sourceRect);
+}
+
+void AudioSlider::rebuildMeterPixmap()
+{
+    // HiDPI screens: the pixmap is painted in logical coordinates and copied without scaling
+    const qreal pixelRatio = devicePixelRatioF();
+    meterPixmap = QPixmap(size() * pixelRatio);
+    meterPixmap.setDevicePixelRatio(pixelRatio);
+    meterPixmap.fill(Qt::transparent);
+
+    meterPixmapParallelSegments = getParallelSegments();
+
+    if (peakColors.empty() || rmsColors.empty())
+        return;
+
+    QPainter painter(&meterPixmap);
+
+    const qreal rectSize = isVertical() ? height() : width();
+    const uint channels = stereo ? 2 : 1;
+    for (uint column = 0; column < meterPixmapParallelSegments; ++column) {
+        const bool rmsColumn = paintingRMS && (!paintingPeaks || column >= channels);
+        paintSegments(painter, getBarRect(column), rectSize, rmsColumn ? rmsColors : peakColors, drawSegments);
+    }
 }
 
-void AudioSlider::paintMaxPeakMarker(QPainter &painter, qreal maxPeakPosition, const QRectF &rect)
+void AudioSlider::invalidateMeterPixmap()
+{
+    meterPixmap = QPixmap();
+}
+
+QRectF AudioSlider::getMaxPeakMarkerRect(qreal maxPeakPosition, const QRectF &rect) const
 {
     const bool isVerticalMeter = isVertical();
-    QRectF maxPeakRect(isVerticalMeter ? rect.left() : (rect.left() + maxPeakPosition - MAX_PEAK_MARKER_SIZE),
+    return QRectF(isVerticalMeter ? rect.left() : (rect.left() + maxPeakPosition - MAX_PEAK_MARKER_SIZE),
                    isVerticalMeter ? (height() - maxPeakPosition) : rect.top(),
                    isVerticalMeter ? rect.width() - 1 : MAX_PEAK_MARKER_SIZE,
                    isVerticalMeter ? MAX_PEAK_MARKER_SIZE : rect.height() - 1);
-
-    painter.fillRect(maxPeakRect, maxPeakColor);
 }
 
 void AudioSlider::setStereo(bool stereo)
 {
     if (this->stereo != stereo) {
         this->stereo = stereo;
+        meterState = computeMeterState();
         update();
     }
 }
@@ -360,6 +568,9 @@ void AudioSlider::updateInternalValues()
         if (ellapsedTimeFromLastMaxPeak >= MAX_PEAK_SHOW_TIME)
             maxPeak[i] = 0;
     }
+
+    if (clipping && now - lastClipTime >= MAX_PEAK_SHOW_TIME)
+        clipping = false;
 }
 
 void AudioSlider::recreateInterpolatedColors()
@@ -367,6 +578,8 @@ void AudioSlider::recreateInterpolatedColors()
     if (maximum() < 100)
         return;
 
+    invalidateMeterPixmap();
+
     // rebuild the peak and RMS colors vector
     peakColors.clear();
     rmsColors.clear();
@@ -431,6 +644,8 @@ void AudioSlider::resizeEvent(QResizeEvent *event)
 
     recreateInterpolatedColors();
 
+    meterState = computeMeterState();
+
     update();
 }
 
@@ -613,6 +828,12 @@ void AudioSlider::setMaxPeakColor(const QColor &newColor)
     update();
 }
 
+void AudioSlider::setClipColor(const QColor &newColor)
+{
+    this->clipColor = newColor;
+    update();
+}
+
 void AudioSlider::setPeaksStartColor(const QColor &newColor)
 {
     this->peakStartColor = newColor;
@@ -631,6 +852,7 @@ void AudioSlider::setDrawSegments(bool drawSegments)
 {
     this->drawSegments = drawSegments;
 
+    invalidateMeterPixmap();
     update();
 }
 
@@ -650,6 +872,7 @@ void AudioSlider::setPaintingDbMarkers(bool paintDbMarkers)
 void AudioSlider::updateStyleSheet()
 {
     rebuildDbMarkersPixmap();
+    invalidateMeterPixmap();
     update();
     //BaseMeter::updateStyleSheet();
 }
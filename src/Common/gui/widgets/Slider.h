@@ -12,6 +12,7 @@ class AudioSlider : public QSlider
     // custom properties defined in CSS files
     Q_PROPERTY(QColor rmsColor MEMBER rmsColor WRITE setRmsColor)
     Q_PROPERTY(QColor maxPeakColor MEMBER maxPeakColor WRITE setMaxPeakColor)
+    Q_PROPERTY(QColor clipColor MEMBER clipColor WRITE setClipColor)
     Q_PROPERTY(QColor peakStartColor MEMBER peakStartColor WRITE setPeaksStartColor)
     Q_PROPERTY(QColor peakEndColor MEMBER peakEndColor WRITE setPeaksEndColor)
     Q_PROPERTY(QColor dBMarksColor MEMBER dBMarksColor WRITE setDbMarksColor)
@@ -19,6 +20,7 @@ class AudioSlider : public QSlider
 
 public:
     explicit AudioSlider(QWidget *parent = nullptr);
+    ~AudioSlider();
 
     void setMeterDecayTime(quint32 decayTimeInMiliseconds);
 
@@ -36,11 +38,21 @@ public:
 
     inline bool isStereo() const { return stereo; }
 
+    // called periodically from MainWindow timer. The decay is computed and only the changed meters areas are repainted
+    static void updateAllMeters();
+
+    // meters painting time measurement, used in MainWindow frame time overlay
+    static void setMeasuringPaintTime(bool measuring);
+    static qint64 takePaintTime(); // nanoseconds spent painting meters since last call
+    static uint takeRepaintedMeters(); // meters repainted since last call
+
     void setPeak(float peak, float rms);
     void setPeak(float leftPeak, float rightPeak, float leftRms, float rightRms);
+    void setClipping(); // the audio is clipping, the max peak marker is painted using the clip color for a while
 
     void setRmsColor(const QColor &newColor);
     void setMaxPeakColor(const QColor &newColor);
+    void setClipColor(const QColor &newColor);
     void setPeaksStartColor(const QColor &newColor);
     void setPeaksEndColor(const QColor &newColor);
     void setDbMarksColor(const QColor &newColor);
@@ -67,9 +79,32 @@ private slots:
     void updateToolTipValue();
 
 private:
+    struct MeterState // the painted meter in pixels, compared to repaint only the changed areas
+    {
+        quint32 peakSegments[2];
+        quint32 rmsSegments[2];
+        int maxPeakPosition[2]; // zero when max peak marker is not painted
+        uint parallelSegments;
+        bool clipping; // max peak marker painted using the clip color
+
+        bool operator==(const MeterState &other) const;
+    };
+
     void drawMarker(QPainter &painter);
     qreal getMarkerPosition() const;
 
+    void updateMeter();
+    MeterState computeMeterState() const;
+
+    QRectF getBarRect(uint column) const;
+    uint getRmsColumn(uint channel) const;
+    QRectF getSegmentsRect(const QRectF &barRect, quint32 firstSegment, quint32 lastSegment) const;
+    QRectF getMaxPeakMarkerRect(qreal maxPeakPosition, const QRectF &barRect) const;
+
+    void paintLitSegments(QPainter &painter, const QRectF &barRect, quint32 segments);
+    void rebuildMeterPixmap();
+    void invalidateMeterPixmap();
+
     void recreateInterpolatedColors();
     QColor interpolateColor(const QColor &start, const QColor &end, float ratio);
 
@@ -87,9 +122,10 @@ private:
 
     uint getParallelSegments() const;
 
-    qreal getPeakPosition(qreal linearPeak, qreal rectSize);
+    static void setPaintingMode(bool peaks, bool rms); // invalidate the meters of all sliders
+
+    qreal getPeakPosition(qreal linearPeak, qreal rectSize) const;
 
-    void paintMaxPeakMarker(QPainter &painter, qreal maxPeakPosition, const QRectF &rect);
 
     void paintSliderHandler(QPainter &painter);
     void paintSliderGroove(QPainter &painter);
@@ -103,6 +139,7 @@ private:
 
     QColor rmsColor;
     QColor maxPeakColor;
+    QColor clipColor;
     QColor peakStartColor;  // start gradient color
     QColor peakEndColor;    // end gradient color
     QColor dBMarksColor;
@@ -123,11 +160,19 @@ private:
 
     qint64 lastMaxPeakTime[2];
 
+    bool clipping;
+    qint64 lastClipTime;
+
     bool stereo; // draw 2 meters?
 
     QPixmap dbMarkersPixmap;
     bool paintingDbMarkers;
 
+    QPixmap meterPixmap; // all meter segments lit (in device pixels), the painted segments are copied from this pixmap
+    uint meterPixmapParallelSegments;
+
+    MeterState meterState;
+
     qint64 lastUpdate;
 
     int decayTime;
@@ -136,6 +181,12 @@ private:
 
     bool showSliderOnly; // slider only, no meters
 
+    static QList<AudioSlider *> instances;
+
+    static bool measuringPaintTime;
+    static qint64 paintTime;
+    static uint repaintedMeters;
+
     static const quint8 SEGMENTS_SIZE;
 
     static const uint LINES_MARGIN;
@@ -149,7 +200,7 @@ private:
     static const int MIN_SIZE;
 };
 
-inline qreal AudioSlider::getPeakPosition(qreal linearPeak, qreal rectSize)
+inline qreal AudioSlider::getPeakPosition(qreal linearPeak, qreal rectSize) const
 {
     qreal db = Utils::linearToDb(linearPeak) - getMaxDbValue();
     return Utils::poweredGainToLinear(Utils::dbToLinear(db)) * rectSize;
@@ -29,6 +29,8 @@ Q_DECLARE_LOGGING_CATEGORY(jtMidi)
 Q_DECLARE_LOGGING_CATEGORY(jtConfigurator)
 Q_DECLARE_LOGGING_CATEGORY(jtMetronome)
 Q_DECLARE_LOGGING_CATEGORY(jtSettings)
+Q_DECLARE_LOGGING_CATEGORY(jtStartup)
+Q_DECLARE_LOGGING_CATEGORY(jtVideo)
 
 void jamtabaLogHandler(QtMsgType, const QMessageLogContext &, const QString &);
 
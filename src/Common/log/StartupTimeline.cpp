@@ -0,0 +1,84 @@
+#include "StartupTimeline.h"
+#include "Logging.h"
+
+#include <QMutexLocker>
+#include <QThread>
+#include <QCoreApplication>
+
+QElapsedTimer StartupTimeline::timer;
+QList<StartupTimeline::Phase> StartupTimeline::phases;
+bool StartupTimeline::finished = false;
+QMutex StartupTimeline::mutex;
+
+void StartupTimeline::start()
+{
+    QMutexLocker locker(&mutex);
+    if (!timer.isValid())
+        timer.start();
+}
+
+qint64 StartupTimeline::elapsed()
+{
+    QMutexLocker locker(&mutex);
+    if (!timer.isValid()) // start() was not called, the timeline starts in the first phase
+        timer.start();
+
+    return timer.elapsed();
+}
+
+void StartupTimeline::record(const QString &phase, qint64 startTime)
+{
+    const qint64 now = elapsed();
+    const bool inGuiThread = QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread();
+
+    QMutexLocker locker(&mutex);
+
+    if (finished) {
+        qCInfo(jtStartup) << "Deferred initialization:" << phase << (now - startTime) << "ms";
+        return;
+    }
+
+    Phase newPhase;
+    newPhase.name = phase;
+    newPhase.startTime = startTime;
+    newPhase.duration = now - startTime;
+    newPhase.inGuiThread = inGuiThread;
+    phases.append(newPhase);
+}
+
+void StartupTimeline::finish()
+{
+    const qint64 now = elapsed();
+
+    QMutexLocker locker(&mutex);
+
+    if (finished)
+        return;
+
+    finished = true;
+
+    qCInfo(jtStartup) << "Startup timeline, main window visible after" << now << "ms";
+    for (const Phase &phase : phases) {
+        qCInfo(jtStartup).noquote() << QString("  %1 ms  %2 ms  %3  %4")
+                                       .arg(phase.startTime, 6)
+                                       .arg(phase.duration, 6)
+                                       .arg(phase.inGuiThread ? "GUI   " : "worker")
+                                       .arg(phase.name);
+    }
+
+    phases.clear();
+}
+
+// ++++++++++++++++++++++++++
+
+StartupPhase::StartupPhase(const QString &name) :
+    name(name),
+    startTime(StartupTimeline::elapsed())
+{
+
+}
+
+StartupPhase::~StartupPhase()
+{
+    StartupTimeline::record(name, startTime);
+}
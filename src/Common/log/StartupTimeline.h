@@ -0,0 +1,54 @@
+#ifndef STARTUP_TIMELINE_H
+#define STARTUP_TIMELINE_H
+
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <QElapsedTimer>
+
+/**
+ * Records how long each startup phase takes. The phases are recorded in any thread (the heavy
+ * initializers are running in parallel) and the whole timeline is logged once when the main window
+ * is visible. Phases finished after that (deferred initializers) are logged individually.
+ */
+
+class StartupTimeline
+{
+public:
+    static void start(); // called as early as possible in main()
+    static qint64 elapsed(); // milliseconds since start()
+
+    static void record(const QString &phase, qint64 startTime);
+    static void finish(); // log the timeline
+
+private:
+    struct Phase
+    {
+        QString name;
+        qint64 startTime;
+        qint64 duration;
+        bool inGuiThread;
+    };
+
+    static QElapsedTimer timer;
+    static QList<Phase> phases;
+    static bool finished;
+    static QMutex mutex;
+};
+
+/**
+ * Scoped phase, recorded in the timeline when destroyed.
+ */
+
+class StartupPhase
+{
+public:
+    explicit StartupPhase(const QString &name);
+    ~StartupPhase();
+
+private:
+    const QString name;
+    const qint64 startTime;
+};
+
+#endif
@@ -21,3 +21,5 @@ Q_LOGGING_CATEGORY(jtMidi,                  "jt.Midi")
 Q_LOGGING_CATEGORY(jtConfigurator,          "jt.Configurator")
 Q_LOGGING_CATEGORY(jtMetronome,             "jt.Metronome")
 Q_LOGGING_CATEGORY(jtSettings,              "jt.Settings")
+Q_LOGGING_CATEGORY(jtStartup,               "jt.Startup")
+Q_LOGGING_CATEGORY(jtVideo,                 "jt.Video")
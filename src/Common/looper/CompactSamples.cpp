@@ -0,0 +1,94 @@
+#include "CompactSamples.h"
+
+#include <cmath>
+
+using audio::CompactSamples;
+
+CompactSamples::CompactSamples() :
+    totalSamples(0)
+{
+
+}
+
+void CompactSamples::reset(uint totalSamples)
+{
+    const uint blocks = (totalSamples + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    for (int c = 0; c < 2; ++c) {
+        mantissas[c].assign(totalSamples, 0);
+        scales[c].assign(blocks, 0.0f);
+    }
+
+    this->totalSamples = totalSamples;
+}
+
+void CompactSamples::clear()
+{
+    for (int c = 0; c < 2; ++c) {
+        std::vector<qint16>().swap(mantissas[c]); // swap is releasing the memory, clear() is not
+        std::vector<float>().swap(scales[c]);
+    }
+
+    totalSamples = 0;
+}
+
+void CompactSamples::encode(const float *left, const float *right, uint from, uint samples)
+{
+    Q_ASSERT(from % BLOCK_SIZE == 0);
+
+    const uint end = qMin(from + samples, totalSamples);
+    const float *channels[] = {left, right};
+
+    for (uint blockStart = from; blockStart < end; blockStart += BLOCK_SIZE) {
+        const uint blockEnd = qMin(blockStart + BLOCK_SIZE, end);
+        const uint block = blockStart / BLOCK_SIZE;
+
+        for (int c = 0; c < 2; ++c) {
+            const float *in = channels[c];
+
+            float maxPeak = 0;
+            for (uint s = blockStart; s < blockEnd; ++s)
+                maxPeak = qMax(maxPeak, qAbs(in[s]));
+
+            scales[c][block] = maxPeak / 32767.0f;
+
+            qint16 *out = mantissas[c].data();
+            const float inverseScale = maxPeak > 0 ? 32767.0f / maxPeak : 0.0f;
+            for (uint s = blockStart; s < blockEnd; ++s)
+                out[s] = static_cast<qint16>(std::lrint(in[s] * inverseScale));
+        }
+    }
+}
+
+void CompactSamples::decode(uint from, uint samples, float *left, float *right) const
+{
+    const uint end = qMin(from + samples, totalSamples);
+    float *channels[] = {left, right};
+
+    for (int c = 0; c < 2; ++c) {
+        const qint16 *in = mantissas[c].data();
+        float *out = channels[c];
+
+        uint position = from;
+        while (position < end) {
+            const uint block = position / BLOCK_SIZE;
+            const uint blockEnd = qMin((block + 1) * BLOCK_SIZE, end);
+            const float scale = scales[c][block];
+            for (uint s = position; s < blockEnd; ++s)
+                out[s - from] = in[s] * scale;
+
+            position = blockEnd;
+        }
+
+        for (uint s = qMax(position, from); s < from + samples; ++s) // samples after the end are silent
+            out[s - from] = 0;
+    }
+}
+
+quint64 CompactSamples::getMemoryUsage() const
+{
+    quint64 bytes = 0;
+    for (int c = 0; c < 2; ++c)
+        bytes += mantissas[c].capacity() * sizeof(qint16) + scales[c].capacity() * sizeof(float);
+
+    return bytes;
+}
@@ -0,0 +1,47 @@
+#ifndef _AUDIO_COMPACT_SAMPLES_
+#define _AUDIO_COMPACT_SAMPLES_
+
+#include <vector>
+#include <QtGlobal>
+
+namespace audio {
+
+/**
+ * Stereo samples stored in 16 bits 'block floating point' format: each block of BLOCK_SIZE
+ * samples has a float scale (the block max peak) and 16 bits mantissas. Used to keep locked
+ * looper layers using ~50% of the memory used by float samples. The quantization noise is
+ * relative to each block peak, so quiet passages are not losing resolution.
+ */
+
+class CompactSamples
+{
+public:
+    CompactSamples();
+
+    void reset(uint totalSamples); // allocate space to encode 'totalSamples'
+    void clear(); // release all memory
+
+    // encode samples in range [from, from + samples). 'from' need be aligned to BLOCK_SIZE
+    void encode(const float *left, const float *right, uint from, uint samples);
+
+    void decode(uint from, uint samples, float *left, float *right) const;
+
+    uint getSamples() const;
+    quint64 getMemoryUsage() const; // in bytes
+
+    static const uint BLOCK_SIZE = 256;
+
+private:
+    std::vector<qint16> mantissas[2];
+    std::vector<float> scales[2];
+    uint totalSamples;
+};
+
+inline uint CompactSamples::getSamples() const
+{
+    return totalSamples;
+}
+
+} // namespace
+
+#endif
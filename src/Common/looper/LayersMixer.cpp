@@ -0,0 +1,51 @@
+#include "LayersMixer.h"
+
+using audio::LayersMixer;
+
+void LayersMixer::mix(const Layer *layers, uint totalLayers, float *outLeft, float *outRight, uint samples)
+{
+    if (!totalLayers || !samples)
+        return;
+
+    mixChannel(layers, totalLayers, 0, outLeft, samples);
+
+    if (outRight) // mono output buffers are using only the left channel
+        mixChannel(layers, totalLayers, 1, outRight, samples);
+}
+
+void LayersMixer::mixChannel(const Layer *layers, uint totalLayers, uint channel, float *out, uint samples)
+{
+    float accumulator[CHUNK_SIZE];
+
+    for (uint chunkStart = 0; chunkStart < samples; chunkStart += CHUNK_SIZE) {
+        const uint chunkSize = qMin(static_cast<uint>(CHUNK_SIZE), samples - chunkStart);
+
+        for (uint s = 0; s < chunkSize; ++s)
+            accumulator[s] = out[chunkStart + s];
+
+        for (uint l = 0; l < totalLayers; ++l) {
+            const Layer &layer = layers[l];
+            if (chunkStart >= layer.samples)
+                continue;
+
+            const uint toMix = qMin(chunkSize, layer.samples - chunkStart);
+            const float *in = layer.channels[channel] + chunkStart;
+            const float startGain = layer.startGains[channel];
+            const float endGain = layer.endGains[channel];
+
+            if (startGain == endGain) { // no ramp, the common case
+                for (uint s = 0; s < toMix; ++s)
+                    accumulator[s] += in[s] * startGain;
+            }
+            else {
+                const float step = (endGain - startGain) / layer.samples;
+                const float chunkGain = startGain + step * chunkStart;
+                for (uint s = 0; s < toMix; ++s)
+                    accumulator[s] += in[s] * (chunkGain + step * s);
+            }
+        }
+
+        for (uint s = 0; s < chunkSize; ++s)
+            out[chunkStart + s] = accumulator[s];
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef _AUDIO_LAYERS_MIXER_
+#define _AUDIO_LAYERS_MIXER_
+
+#include <QtGlobal>
+
+namespace audio {
+
+/**
+ * Block mixing kernel used by the Looper. All active layers are summed in one pass over
+ * the output buffer, working in small chunks that stay in cache. Layer gains are linearly
+ * ramped from 'startGains' to 'endGains' along the block to avoid clicks when gain, pan or
+ * mute state change. The inner loops are plain float loops without branches or aliasing
+ * between layers, so the compilers can vectorize them (SSE/NEON) in release builds.
+ */
+
+class LayersMixer
+{
+public:
+
+    struct Layer
+    {
+        const float *channels[2]; // left and right samples, already offset to interval position
+        uint samples; // can be less than the block size if layer is shorter than interval
+        float startGains[2];
+        float endGains[2];
+    };
+
+    static void mix(const Layer *layers, uint totalLayers, float *outLeft, float *outRight, uint samples);
+
+private:
+    static const uint CHUNK_SIZE = 64; // samples mixed in each chunk (stack accumulator size)
+
+    static void mixChannel(const Layer *layers, uint totalLayers, uint channel, float *out, uint samples);
+};
+
+} // namespace
+
+#endif
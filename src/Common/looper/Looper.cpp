@@ -2,17 +2,86 @@
 #include "LooperStates.h"
 #include "LooperLayer.h"
 #include "Utils.h"
+#include "audio/core/PeaksTelemetry.h"
 
 #include <QDebug>
 
 #include <cstring>
 #include <vector>
 #include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
 
 using audio::Looper;
 using audio::AudioPeak;
+using audio::PeaksTelemetry;
 using audio::SamplesBuffer;
 using audio::LooperState;
+using audio::LayersCompactionThread;
+
+namespace audio {
+
+/**
+ * Compact and expand the looper layers (requested in the audio thread) and release the replaced layers
+ * samples storage, so the audio thread is not allocating or releasing memory. The audio thread is not
+ * waking up this thread (no locks in audio thread), the layers are polled. The thread is started only when
+ * the compaction is enabled, the storages replaced in the loopers never compacting are released with the layers.
+ */
+
+class LayersCompactionThread : public QThread
+{
+public:
+    explicit LayersCompactionThread(LooperLayer * const *layers);
+
+    void stop();
+
+protected:
+    void run() override;
+
+private:
+    static const ulong POLLING_INTERVAL = 20; // in milliseconds
+
+    LooperLayer * const *layers;
+    QMutex mutex;
+    QWaitCondition stopCondition;
+    bool stopRequested;
+};
+
+} // namespace
+
+LayersCompactionThread::LayersCompactionThread(LooperLayer * const *layers) :
+    layers(layers),
+    stopRequested(false)
+{
+
+}
+
+void LayersCompactionThread::stop()
+{
+    QMutexLocker locker(&mutex);
+    stopRequested = true;
+    stopCondition.wakeAll();
+}
+
+void LayersCompactionThread::run()
+{
+    QMutexLocker locker(&mutex);
+
+    while (!stopRequested) {
+        locker.unlock();
+
+        for (int l = 0; l < MAX_LOOP_LAYERS; ++l) {
+            layers[l]->processCompactionJob();
+            layers[l]->releaseRetiredStorages();
+        }
+
+        locker.relock();
+
+        if (!stopRequested)
+            stopCondition.wait(&mutex, POLLING_INTERVAL);
+    }
+}
 
 Looper::Looper()
     : Looper(Mode::Sequence, 4) // calling overloaded constructor
@@ -27,12 +96,16 @@ Looper::Looper(Looper::Mode initialMode, quint8 maxLayers) :
     loading(false),
     waitingToStop(false),
     activated(true),
+    compactingLockedLayers(false),
+    compactionThread(nullptr),
     currentLayerIndex(0),
     focusedLayerIndex(0),
     maxLayers(maxLayers),
     mainGain(1.0),
     resetRequested(false),
     newMaxLayersRequested(0),
+    peaksTelemetry(nullptr),
+    peaksTelemetrySlot(-1),
     state(new StoppedState()),
     mode(initialMode)
 {
@@ -48,6 +121,16 @@ Looper::Looper(Looper::Mode initialMode, quint8 maxLayers) :
     }
 }
 
+void Looper::setCompactingLockedLayers(bool compacting)
+{
+    if (compacting && !compactionThread) { // started once, the compacted layers are expanded in this thread when the compaction is disabled
+        compactionThread = new LayersCompactionThread(layers);
+        compactionThread->start(QThread::LowPriority);
+    }
+
+    compactingLockedLayers = compacting; // the layers will be compacted/expanded in next audio callback
+}
+
 void Looper::waitToStopInNextInterval()
 {
     if (isPlaying()) {
@@ -104,9 +187,10 @@ float Looper::getLayerPan(quint8 layer) const
 }
 
 
-AudioPeak Looper::getLastPeak() const
+void Looper::setPeaksTelemetry(PeaksTelemetry *telemetry, int slotID)
 {
-    return lastPeak;
+    peaksTelemetry = telemetry;
+    peaksTelemetrySlot = slotID;
 }
 
 bool Looper::isFull() const
@@ -139,11 +223,18 @@ void Looper::resetLayersContent()
     resetRequested = true;
     setChanged(false);
 
-    lastPeak.zero();
+    if (peaksTelemetry)
+        peaksTelemetry->reset(peaksTelemetrySlot);
 }
 
 Looper::~Looper()
 {
+    if (compactionThread) {
+        compactionThread->stop();
+        compactionThread->wait();
+        delete compactionThread;
+    }
+
     for (int l = 0; l < MAX_LOOP_LAYERS; ++l) {
         if (layers[l])
             delete layers[l];
@@ -494,6 +585,9 @@ void Looper::mixToBuffer(SamplesBuffer &samples)
     AudioPeak peakBeforeMix = samples.computePeak();
     state->mixTo(samples, samplesToProcess);
 
+    for (quint8 l = 0; l < MAX_LOOP_LAYERS; ++l)
+        layers[l]->finishMixBlock();
+
     AudioPeak peakAfterMix = samples.computePeak();
 
     // always update intervalPosition to keep the execution in sync when 'play' is pressed
@@ -502,7 +596,10 @@ void Looper::mixToBuffer(SamplesBuffer &samples)
 
     processChangeRequests();
 
-    lastPeak = peakAfterMix - peakBeforeMix; // minus operator is overloaded in AudioPeak class
+    processLayersCompaction();
+
+    if (peaksTelemetry)
+        peaksTelemetry->publish(peaksTelemetrySlot, peakAfterMix - peakBeforeMix); // minus operator is overloaded in AudioPeak class
 }
 
 void Looper::processChangeRequests()
@@ -539,6 +636,44 @@ void Looper::processChangeRequests()
     }
 }
 
+void Looper::processLayersCompaction()
+{
+    // the compaction and the expansion (unlocked layers need float samples to record) are done in compactionThread
+    for (quint8 l = 0; l < MAX_LOOP_LAYERS; ++l) {
+        LooperLayer *layer = layers[l];
+        layer->updateCompaction(compactingLockedLayers && l < maxLayers && layer->isLocked() && layer->isValid());
+    }
+}
+
+quint64 Looper::getMemoryUsage() const
+{
+    quint64 bytes = 0;
+    for (int l = 0; l < MAX_LOOP_LAYERS; ++l)
+        bytes += layers[l]->getMemoryUsage();
+
+    return bytes;
+}
+
+quint64 Looper::getUncompactedMemoryUsage() const
+{
+    quint64 bytes = 0;
+    for (int l = 0; l < MAX_LOOP_LAYERS; ++l)
+        bytes += layers[l]->getUncompactedMemoryUsage();
+
+    return bytes;
+}
+
+quint8 Looper::getCompactedLayers() const
+{
+    quint8 compactedLayers = 0;
+    for (int l = 0; l < MAX_LOOP_LAYERS; ++l) {
+        if (layers[l]->isCompacted())
+            compactedLayers++;
+    }
+
+    return compactedLayers;
+}
+
 void Looper::startNewCycle(uint samplesInCycle)
 {
     if (samplesInCycle != intervalLenght)
@@ -621,19 +756,42 @@ void Looper::mixLayer(quint8 layerIndex, SamplesBuffer &samples, uint samplesToM
     }
 }
 
+void Looper::mixLayers(SamplesBuffer &samples, uint samplesToMix, bool lockedLayersOnly)
+{
+    LayersMixer::Layer mixerLayers[MAX_LOOP_LAYERS];
+
+    float *leftChannel = samples.getSamplesArray(0);
+    float *rightChannel = samples.isMono() ? nullptr : samples.getSamplesArray(1);
+
+    // the compacted layers are decoded in chunks, so big audio blocks are mixed in pieces
+    for (uint offset = 0; offset < samplesToMix; offset += LooperLayer::MAX_DECODED_SAMPLES) {
+        const uint chunkSamples = qMin(samplesToMix - offset, LooperLayer::MAX_DECODED_SAMPLES);
+        uint totalLayers = 0;
+
+        for (uint layer = 0; layer < maxLayers; ++layer) {
+            if (lockedLayersOnly && !layerIsLocked(layer))
+                continue;
+
+            LooperLayer *loopLayer = layers[layer];
+            const uint layerSamples = qMin(samplesToMix, loopLayer->getAvailableSamples());
+            const uint chunkLayerSamples = layerSamples > offset ? qMin(chunkSamples, layerSamples - offset) : 0;
+            if (loopLayer->prepareToMix(mixerLayers[totalLayers], chunkLayerSamples, intervalPosition + offset, mainGain))
+                totalLayers++;
+        }
+
+        if (totalLayers)
+            LayersMixer::mix(mixerLayers, totalLayers, leftChannel + offset, rightChannel ? rightChannel + offset : nullptr, chunkSamples);
+    }
+}
+
 void Looper::mixAllLayers(SamplesBuffer &samples, uint samplesToMix)
 {
-    for (uint layer = 0; layer < maxLayers; ++layer)
-        mixLayer(layer, samples, samplesToMix);
+    mixLayers(samples, samplesToMix, false);
 }
 
 void Looper::mixLockedLayers(SamplesBuffer &samples, uint samplesToMix)
 {
-    for (uint layer = 0; layer < maxLayers; ++layer) {
-        if (layerIsLocked(layer)) {
-            mixLayer(layer, samples, samplesToMix);
-        }
-    }
+    mixLayers(samples, samplesToMix, true);
 }
 
 void Looper::processBufferUsingCurrentLayerSettings(SamplesBuffer &buffer)
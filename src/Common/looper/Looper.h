@@ -17,6 +17,8 @@
 namespace audio {
 
 class LooperState;
+class LayersCompactionThread;
+class PeaksTelemetry;
 class PlayingState;
 class RecordingState;
 class WaitingToRecordState;
@@ -50,7 +52,9 @@ public:
     void setMainGain(float gain);
     float getMainGain() const;
 
-    AudioPeak getLastPeak() const;
+    // the looper mixed peaks are published in a telemetry slot, read by GUI without locks
+    void setPeaksTelemetry(PeaksTelemetry *telemetry, int slotID);
+    int getPeaksTelemetrySlot() const;
 
     void setLayerSamples(quint8 layer, const SamplesBuffer &samples);
 
@@ -149,6 +153,14 @@ public:
 
     void setActivated(bool activated);
 
+    // locked layers can be stored in 16 bits to save memory, the compaction is done in a background thread
+    void setCompactingLockedLayers(bool compacting);
+    bool isCompactingLockedLayers() const;
+
+    quint64 getMemoryUsage() const; // in bytes
+    quint64 getUncompactedMemoryUsage() const; // bytes used if all layers are stored in float format
+    quint8 getCompactedLayers() const;
+
 public slots:
     void resetLayersContent(); // clear all
 
@@ -172,6 +184,10 @@ private:
 
     bool activated;
 
+    bool compactingLockedLayers;
+    LayersCompactionThread *compactionThread;
+    void processLayersCompaction();
+
     LooperLayer *layers[MAX_LOOP_LAYERS];
     quint8 currentLayerIndex; // current played layer
     int focusedLayerIndex; // layer clicked by user, used to choose recording layer. Sometimes focused layer will be equal to currentLayerIndex.
@@ -185,7 +201,8 @@ private:
 
     void setCurrentLayer(quint8 newLayer);
 
-    AudioPeak lastPeak;
+    PeaksTelemetry *peaksTelemetry;
+    int peaksTelemetrySlot;
 
     QSharedPointer<LooperState> state;
 
@@ -203,6 +220,7 @@ private:
 
     void mixLayer(quint8 layerIndex, SamplesBuffer &samples, uint samplesToMix);
     void mixAllLayers(SamplesBuffer &samples, uint samplesToMix);
+    void mixLayers(SamplesBuffer &samples, uint samplesToMix, bool lockedLayersOnly); // all layers summed in one pass
     void mixLockedLayers(SamplesBuffer &samples, uint samplesToMix);
 
     void setState(LooperState *state);
@@ -236,6 +254,16 @@ inline float Looper::getMainGain() const
     return mainGain;
 }
 
+inline int Looper::getPeaksTelemetrySlot() const
+{
+    return peaksTelemetrySlot;
+}
+
+inline bool Looper::isCompactingLockedLayers() const
+{
+    return compactingLockedLayers;
+}
+
 inline QString Looper::getLoopName() const
 {
     return loopName;
@@ -5,29 +5,54 @@
 #include <cmath>
 #include <QDebug>
 
-#include <QDebug>
-
 using audio::LooperLayer;
 using audio::SamplesBuffer;
 
 LooperLayer::LooperLayer() :
-    lastSamplesPerPeak(0),
+    storage(new Storage()),
+    retiredStorages(nullptr),
+    readers(0),
+    requestedJob(NoJob),
+    jobSource(nullptr),
+    jobSamples(0),
+    jobContentVersion(0),
+    jobResult(nullptr),
+    jobInProgress(false),
+    contentVersion(0),
     availableSamples(0),
-    lastCacheComputationSample(0),
     lastCycleLenght(0),
     locked(false),
     gain(1.0),
     pan(0),
     leftGain(1),
     rightGain(1),
-    muteState(MuteState::Unmuted)
+    muteState(MuteState::Unmuted),
+    mixGainsInitialized(false),
+    mixedInCurrentBlock(false)
 {
+    lastMixGains[0] = lastMixGains[1] = 0;
+
     setPan(0); // center
 }
 
 LooperLayer::~LooperLayer()
 {
+    // the compaction thread is stopped before the layers are deleted
+    delete storage.loadAcquire();
+    delete jobResult.loadAcquire();
+    deleteStorages(retiredStorages.fetchAndStoreOrdered(nullptr));
+}
 
+LooperLayer::Reader::Reader(const LooperLayer &layer) :
+    layer(layer)
+{
+    layer.readers.fetchAndAddOrdered(1);
+    storage = layer.storage.loadAcquire();
+}
+
+LooperLayer::Reader::~Reader()
+{
+    layer.readers.fetchAndAddOrdered(-1);
 }
 
 void LooperLayer::reset()
@@ -44,13 +69,15 @@ void LooperLayer::reset()
 
 void LooperLayer::zero()
 {
-    std::fill(leftChannel.begin(), leftChannel.end(), static_cast<float>(0));
-    std::fill(rightChannel.begin(), rightChannel.end(), static_cast<float>(0));
+    Storage *current = getWritableStorage();
+
+    for (auto &channel : current->channels)
+        std::fill(channel.begin(), channel.end(), static_cast<float>(0));
 
     availableSamples = 0;
-    lastSamplesPerPeak = 0;
-    lastCacheComputationSample = 0;
-    peaksCache.clear();
+    peaks.clear();
+
+    mixGainsInitialized = false; // no content, no ramp
 }
 
 void LooperLayer::setSamples(const SamplesBuffer &samples)
@@ -64,8 +91,12 @@ void LooperLayer::setSamples(const SamplesBuffer &samples)
 
     uint bytesToCopy =  samplesToCopy * sizeof(float);
 
-    Q_ASSERT(leftChannel.capacity() >= samplesToCopy);
-    Q_ASSERT(rightChannel.capacity() >= samplesToCopy);
+    Storage *current = storage.loadAcquire();
+    std::vector<float> &leftChannel = current->channels[0];
+    std::vector<float> &rightChannel = current->channels[1];
+
+    Q_ASSERT(leftChannel.size() >= samplesToCopy);
+    Q_ASSERT(rightChannel.size() >= samplesToCopy);
 
     std::memcpy(&(leftChannel[0]), samples.getSamplesArray(0), bytesToCopy);
     if (samples.isMono())
@@ -75,18 +106,7 @@ void LooperLayer::setSamples(const SamplesBuffer &samples)
 
     availableSamples = samplesToCopy;
 
-
-    // rebuild peaks cache
-    lastCacheComputationSample = 0;
-    peaksCache.clear();
-
-    if (lastSamplesPerPeak) {
-        while (availableSamples - lastCacheComputationSample >= lastSamplesPerPeak) { // enough samples to cache a new max peak?
-            peaksCache.push_back(computeMaxPeak(lastCacheComputationSample, lastSamplesPerPeak));
-            lastCacheComputationSample += lastSamplesPerPeak;
-        }
-    }
-
+    peaks.update(&(leftChannel[0]), &(rightChannel[0]), 0, availableSamples, availableSamples);
 }
 
 void LooperLayer::setPan(float pan)
@@ -115,17 +135,20 @@ void LooperLayer::setGain(float gain)
 
 void LooperLayer::prepareForNewCycle(uint samplesInNewCycle, bool isOverdubbing)
 {
+    Q_UNUSED(isOverdubbing) // peaks are updated in the overdubbed range only, no need to reset anything
+
     if (samplesInNewCycle > lastCycleLenght)
         resize(samplesInNewCycle);
 
-    if (isOverdubbing)
-        lastCacheComputationSample = 0; // reset max peak cache position to compute overdub peaks correctly
-
     lastCycleLenght = samplesInNewCycle;
 }
 
 void LooperLayer::overdub(const SamplesBuffer &samples, uint samplesToMix, uint startPosition)
 {
+    Storage *current = getWritableStorage();
+    std::vector<float> &leftChannel = current->channels[0];
+    std::vector<float> &rightChannel = current->channels[1];
+
     if (!samples.isMono()) {
         float *internalChannels[] = {&(leftChannel[startPosition]), &(rightChannel[startPosition])};
         float *samplesArray[] = {samples.getSamplesArray(0), samples.getSamplesArray(1)};
@@ -145,47 +168,92 @@ void LooperLayer::overdub(const SamplesBuffer &samples, uint samplesToMix, uint
     if (availableSamples < startPosition + samplesToMix)
         availableSamples = startPosition + samplesToMix;
 
-    // build peaks cache when overdubbing
-    if (lastSamplesPerPeak) {
-        const uint position = startPosition + samplesToMix;
-        while (position - lastCacheComputationSample >= lastSamplesPerPeak) { // enough samples to cache a new max peak?
-            const int peakIndex = (position/lastSamplesPerPeak) - 1;
-            float lastPeak = computeMaxPeak(lastCacheComputationSample, lastSamplesPerPeak);
-            if (peakIndex >= 0 && static_cast<uint>(peakIndex) < peaksCache.size())
-                peaksCache[peakIndex] = lastPeak;
-            else
-                peaksCache.push_back(lastPeak);
-
-            lastCacheComputationSample += lastSamplesPerPeak;
-        }
-    }
+    peaks.update(&(leftChannel[0]), &(rightChannel[0]), startPosition, samplesToMix, availableSamples);
 }
 
 void LooperLayer::mixTo(SamplesBuffer &outBuffer, uint samplesToMix, uint intervalPosition, float looperMainGain)
 {
-    bool canMix = samplesToMix > 0 && (muteState == LooperLayer::Unmuted || muteState == LooperLayer::WaitingToMute);
-    if (canMix) {
-        float *internalChannels[] = {&(leftChannel[0]), &(rightChannel[0])};
-        const uint secondChannelIndex = (outBuffer.isMono()) ? 0 : 1;
-        float *bufferChannels[] = {outBuffer.getSamplesArray(0), outBuffer.getSamplesArray(secondChannelIndex)};
-        uint channels = outBuffer.getChannels();
+    float *leftChannel = outBuffer.getSamplesArray(0);
+    float *rightChannel = outBuffer.isMono() ? nullptr : outBuffer.getSamplesArray(1);
+
+    for (uint offset = 0; offset < samplesToMix; offset += MAX_DECODED_SAMPLES) {
+        const uint chunkSamples = qMin(samplesToMix - offset, MAX_DECODED_SAMPLES);
+
+        LayersMixer::Layer mixerLayer;
+        if (prepareToMix(mixerLayer, chunkSamples, intervalPosition + offset, looperMainGain))
+            LayersMixer::mix(&mixerLayer, 1, leftChannel + offset, rightChannel ? rightChannel + offset : nullptr, chunkSamples);
+    }
+}
+
+bool LooperLayer::prepareToMix(LayersMixer::Layer &mixerLayer, uint samplesToMix, uint intervalPosition, float looperMainGain)
+{
+    if (!samplesToMix)
+        return false;
+
+    const bool canMix = muteState == LooperLayer::Unmuted || muteState == LooperLayer::WaitingToMute;
 
+    float targetGains[2] = {0, 0}; // muted layers are faded out
+    if (canMix) {
         const float mainGain = looperMainGain * gain;
-        const float finalLeftGain = mainGain * leftGain;
-        const float finalRightGain = mainGain * rightGain;
-        float gains[] = {finalLeftGain, finalRightGain};
-        for (uint c = 0; c < channels; ++c) {
-            for (uint s = 0; s < samplesToMix; ++s) {
-                const uint offset = s + intervalPosition;
-                bufferChannels[c][s] += internalChannels[c][offset] * gains[c];
-            }
-        }
+        targetGains[0] = mainGain * leftGain;
+        targetGains[1] = mainGain * rightGain;
+    }
+
+    if (!mixGainsInitialized) {
+        if (!canMix)
+            return false;
+
+        lastMixGains[0] = targetGains[0];
+        lastMixGains[1] = targetGains[1];
+        mixGainsInitialized = true;
+    }
+
+    mixedInCurrentBlock = true;
+
+    const bool silent = lastMixGains[0] == 0 && lastMixGains[1] == 0 && targetGains[0] == 0 && targetGains[1] == 0;
+    if (silent)
+        return false;
+
+    Storage *current = storage.loadAcquire();
+    if (current->compacted) { // decoding only the samples used in this block, in the preallocated decoding buffers
+        Q_ASSERT(samplesToMix <= MAX_DECODED_SAMPLES); // the callers are mixing big blocks in chunks
+        samplesToMix = qMin(samplesToMix, MAX_DECODED_SAMPLES);
+
+        std::vector<float> *decodedChannels = current->decodedChannels;
+        current->compactSamples.decode(intervalPosition, samplesToMix, &(decodedChannels[0][0]), &(decodedChannels[1][0]));
+        mixerLayer.channels[0] = &(decodedChannels[0][0]);
+        mixerLayer.channels[1] = &(decodedChannels[1][0]);
+    }
+    else {
+        mixerLayer.channels[0] = &(current->channels[0][intervalPosition]);
+        mixerLayer.channels[1] = &(current->channels[1][intervalPosition]);
     }
+
+    mixerLayer.samples = samplesToMix;
+    for (int c = 0; c < 2; ++c) {
+        mixerLayer.startGains[c] = lastMixGains[c];
+        mixerLayer.endGains[c] = targetGains[c];
+        lastMixGains[c] = targetGains[c];
+    }
+
+    return true;
+}
+
+void LooperLayer::finishMixBlock()
+{
+    if (!mixedInCurrentBlock)
+        mixGainsInitialized = false; // the layer is not playing, next time we can start with target gains
+
+    mixedInCurrentBlock = false;
 }
 
 void LooperLayer::append(const SamplesBuffer &samples, uint samplesToAppend, uint startPosition)
 {
-    int toAppend = qMin(static_cast<uint>(leftChannel.capacity() - startPosition), samplesToAppend);
+    Storage *current = getWritableStorage();
+    std::vector<float> &leftChannel = current->channels[0];
+    std::vector<float> &rightChannel = current->channels[1];
+
+    int toAppend = qMin(static_cast<uint>(leftChannel.size() - startPosition), samplesToAppend);
 
     if (!toAppend) {
         qCritical() << "toAppend:" << toAppend;
@@ -200,22 +268,22 @@ void LooperLayer::append(const SamplesBuffer &samples, uint samplesToAppend, uin
 
     availableSamples += toAppend;
 
-    //Q_ASSERT(availableSamples <= leftChannel.capacity());
+    //Q_ASSERT(availableSamples <= leftChannel.size());
 
-    // build peaks cache
-    if (lastSamplesPerPeak) {
-        if (lastCacheComputationSample < startPosition - lastSamplesPerPeak)
-            lastCacheComputationSample = startPosition;
-
-        while ((startPosition + samplesToAppend) - lastCacheComputationSample >= lastSamplesPerPeak && lastCacheComputationSample  < leftChannel.size()) { // enough samples to cache a new max peak?
-            peaksCache.push_back(computeMaxPeak(lastCacheComputationSample, lastSamplesPerPeak));
-            lastCacheComputationSample += lastSamplesPerPeak;
-        }
-    }
+    peaks.update(&(leftChannel[0]), &(rightChannel[0]), startPosition, toAppend, availableSamples);
 }
 
 float LooperLayer::computeMaxPeak(uint from, uint samplesPerPeak) const
 {
+    Reader reader(*this);
+    const Storage *current = reader.get();
+
+    if (current->compacted) // float samples are not available, using the peaks pyramid resolution
+        return peaks.getMaxPeak(from, qMin(samplesPerPeak, availableSamples - from));
+
+    const std::vector<float> &leftChannel = current->channels[0];
+    const std::vector<float> &rightChannel = current->channels[1];
+
     float maxPeak = 0;
     uint limit = qMin(samplesPerPeak, availableSamples - from);
     for (uint i = 0; i < limit; ++i) {
@@ -231,32 +299,42 @@ float LooperLayer::computeMaxPeak(uint from, uint samplesPerPeak) const
     return maxPeak;
 }
 
-std::vector<float> LooperLayer::getSamplesPeaks(uint samplesPerPeak)
+std::vector<float> LooperLayer::getSamplesPeaks(uint samplesPerPeak) const
 {
-    if (lastSamplesPerPeak == samplesPerPeak && !peaksCache.empty()) { // cache hit?
-        return peaksCache;
-    }
+    std::vector<float> samplesPeaks;
 
-    // compute all peaks
-    peaksCache.clear();
-    if (samplesPerPeak) {
-        for (uint i = 0; i < availableSamples; i += samplesPerPeak) {
-            float maxPeak = computeMaxPeak(i, samplesPerPeak);
-            peaksCache.push_back(maxPeak);
-        }
-        lastSamplesPerPeak = samplesPerPeak;
+    if (samplesPerPeak >= PeaksPyramid::BASE_BLOCK_SIZE) {
+        peaks.getPeaks(samplesPerPeak, availableSamples, samplesPeaks); // O(pixels), samples are not touched
+    }
+    else if (samplesPerPeak) { // zoom level finer than pyramid resolution, computing from samples
+        for (uint i = 0; i < availableSamples; i += samplesPerPeak)
+            samplesPeaks.push_back(computeMaxPeak(i, samplesPerPeak));
     }
 
-    return peaksCache;
+    return samplesPeaks;
 }
 
 void LooperLayer::resize(quint32 samplesPerCycle)
 {
-    if (samplesPerCycle > leftChannel.capacity())
-        leftChannel.resize(samplesPerCycle);
+    Storage *current = getWritableStorage();
+
+    if (samplesPerCycle > current->channels[0].size()) {
+        // the GUI can be reading the current samples, copying to a new storage instead of resize the vectors
+        Storage *resized = createFloatStorage(samplesPerCycle);
+        const uint bytesToCopy = availableSamples * sizeof(float);
+        for (int c = 0; c < 2; ++c) {
+            if (bytesToCopy)
+                std::memcpy(&(resized->channels[c][0]), &(current->channels[c][0]), bytesToCopy);
+        }
+
+        replaceStorage(resized);
+        current = resized;
+    }
 
-    if (samplesPerCycle > rightChannel.capacity())
-        rightChannel.resize(samplesPerCycle);
+    std::vector<float> &leftChannel = current->channels[0];
+    std::vector<float> &rightChannel = current->channels[1];
+
+    peaks.resize(leftChannel.size());
 
     if (availableSamples && samplesPerCycle > availableSamples) { // need copy samples?
         uint initialAvailableSamples = availableSamples;
@@ -271,18 +349,185 @@ void LooperLayer::resize(quint32 samplesPerCycle)
         }
 
         Q_ASSERT(availableSamples == samplesPerCycle);
-
-        peaksCache.clear(); // invalidate peaks cache
     }
+
+    if (availableSamples) // rebuild all peaks, the layer content was changed or the pyramid was resized
+        peaks.update(&(leftChannel[0]), &(rightChannel[0]), 0, availableSamples, availableSamples);
 }
 
 SamplesBuffer LooperLayer::getAllSamples() const
 {
-    SamplesBuffer buffer(2, availableSamples);
-    uint bytesToCopy = availableSamples * sizeof(float);
-    std::memcpy(buffer.getSamplesArray(0), &(leftChannel[0]), bytesToCopy);
-    std::memcpy(buffer.getSamplesArray(1), &(rightChannel[0]), bytesToCopy);
+    Reader reader(*this);
+    const Storage *current = reader.get();
+
+    // the audio thread can be resizing the layer, using only the samples available in this storage
+    const uint samples = qMin(availableSamples, current->compacted ? current->compactSamples.getSamples() : static_cast<uint>(current->channels[0].size()));
+
+    SamplesBuffer buffer(2, samples);
+
+    if (current->compacted) {
+        current->compactSamples.decode(0, samples, buffer.getSamplesArray(0), buffer.getSamplesArray(1));
+        return buffer;
+    }
+
+    uint bytesToCopy = samples * sizeof(float);
+    if (bytesToCopy) {
+        std::memcpy(buffer.getSamplesArray(0), &(current->channels[0][0]), bytesToCopy);
+        std::memcpy(buffer.getSamplesArray(1), &(current->channels[1][0]), bytesToCopy);
+    }
 
     return buffer;
 }
 
+LooperLayer::Storage *LooperLayer::createFloatStorage(uint samples)
+{
+    Storage *floatStorage = new Storage();
+    for (auto &channel : floatStorage->channels)
+        channel.assign(samples, 0.0f);
+
+    return floatStorage;
+}
+
+LooperLayer::Storage *LooperLayer::getWritableStorage()
+{
+    contentVersion++; // a running compaction job is discarded
+
+    Storage *current = storage.loadAcquire();
+    if (!current->compacted)
+        return current;
+
+    // the layer is changed before the compaction thread expand it (recording just after unlock the layer), expanding here
+    const CompactSamples &compactSamples = current->compactSamples;
+    Storage *expanded = createFloatStorage(qMax(lastCycleLenght, compactSamples.getSamples()));
+    compactSamples.decode(0, compactSamples.getSamples(), &(expanded->channels[0][0]), &(expanded->channels[1][0]));
+
+    replaceStorage(expanded);
+
+    return expanded;
+}
+
+void LooperLayer::replaceStorage(Storage *newStorage)
+{
+    retire(storage.fetchAndStoreOrdered(newStorage)); // GUI readers can be using the old storage
+}
+
+void LooperLayer::retire(Storage *oldStorage)
+{
+    Storage *head;
+    do {
+        head = retiredStorages.loadAcquire();
+        oldStorage->nextRetired = head;
+    } while (!retiredStorages.testAndSetOrdered(head, oldStorage));
+}
+
+void LooperLayer::deleteStorages(Storage *storages)
+{
+    while (storages) {
+        Storage *next = storages->nextRetired;
+        delete storages;
+        storages = next;
+    }
+}
+
+void LooperLayer::updateCompaction(bool compacting)
+{
+    if (jobInProgress) {
+        Storage *result = jobResult.fetchAndStoreOrdered(nullptr);
+        if (!result)
+            return; // the compaction thread is working
+
+        jobInProgress = false;
+
+        // the result is discarded if the layer was changed while the compaction thread was working
+        if (result->contentVersion == contentVersion && result->compacted == compacting)
+            replaceStorage(result);
+        else
+            retire(result);
+    }
+
+    Storage *current = storage.loadAcquire();
+    if (current->compacted == compacting || (compacting && !availableSamples))
+        return;
+
+    jobSource = current;
+    jobSamples = compacting ? availableSamples : qMax(lastCycleLenght, current->compactSamples.getSamples());
+    jobContentVersion = contentVersion;
+    jobInProgress = true;
+
+    requestedJob.storeRelease(compacting ? CompactJob : ExpandJob);
+}
+
+void LooperLayer::processCompactionJob()
+{
+    const int job = requestedJob.fetchAndStoreOrdered(NoJob);
+    if (job == NoJob)
+        return;
+
+    // the source storage is retired (not released) if the audio thread replace it while this job is running
+    Storage *result;
+    if (job == CompactJob) {
+        result = new Storage();
+        result->compacted = true;
+        result->compactSamples.reset(jobSamples);
+        result->compactSamples.encode(&(jobSource->channels[0][0]), &(jobSource->channels[1][0]), 0, jobSamples);
+        for (auto &channel : result->decodedChannels)
+            channel.resize(MAX_DECODED_SAMPLES);
+    }
+    else {
+        const CompactSamples &compactSamples = jobSource->compactSamples;
+        result = createFloatStorage(jobSamples);
+        compactSamples.decode(0, compactSamples.getSamples(), &(result->channels[0][0]), &(result->channels[1][0]));
+    }
+
+    result->contentVersion = jobContentVersion;
+
+    jobResult.storeRelease(result);
+}
+
+void LooperLayer::releaseRetiredStorages()
+{
+    Storage *retired = retiredStorages.fetchAndStoreOrdered(nullptr);
+    if (!retired)
+        return;
+
+    // a GUI reader or a requested job (not started yet) can be using a retired storage, trying again later
+    if (readers.loadAcquire() > 0 || requestedJob.loadAcquire() != NoJob) {
+        while (retired) {
+            Storage *next = retired->nextRetired;
+            retire(retired);
+            retired = next;
+        }
+        return;
+    }
+
+    deleteStorages(retired);
+}
+
+bool LooperLayer::isCompacted() const
+{
+    Reader reader(*this);
+    return reader.get()->compacted;
+}
+
+quint64 LooperLayer::getMemoryUsage() const
+{
+    Reader reader(*this);
+    const Storage *current = reader.get();
+
+    quint64 floats = 0;
+    for (int c = 0; c < 2; ++c)
+        floats += current->channels[c].capacity() + current->decodedChannels[c].capacity();
+
+    return floats * sizeof(float) + current->compactSamples.getMemoryUsage();
+}
+
+quint64 LooperLayer::getUncompactedMemoryUsage() const
+{
+    Reader reader(*this);
+    const Storage *current = reader.get();
+
+    if (current->compacted)
+        return static_cast<quint64>(qMax(lastCycleLenght, current->compactSamples.getSamples())) * 2 * sizeof(float);
+
+    return static_cast<quint64>(current->channels[0].capacity() + current->channels[1].capacity()) * sizeof(float);
+}
@@ -3,6 +3,12 @@
 
 #include <vector>
 #include <QtGlobal>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+
+#include "PeaksPyramid.h"
+#include "LayersMixer.h"
+#include "CompactSamples.h"
 
 namespace audio {
 
@@ -37,12 +43,20 @@ public:
 
     float computeMaxPeak(uint from, uint samplesPerPeak) const;
 
-    std::vector<float> getSamplesPeaks(uint samplesPerPeak);
+    std::vector<float> getSamplesPeaks(uint samplesPerPeak) const;
 
     SamplesBuffer getAllSamples() const;
 
     void mixTo(SamplesBuffer &outBuffer, uint samplesToMix, uint intervalPosition, float looperMainGain);
 
+    // fill the mixer input and advance the gain ramp. Return false if the layer is silent in this block.
+    // Bigger audio blocks are mixed in MAX_DECODED_SAMPLES chunks, the compacted samples are decoded per chunk
+    bool prepareToMix(LayersMixer::Layer &mixerLayer, uint samplesToMix, uint intervalPosition, float looperMainGain);
+
+    void finishMixBlock(); // called after each processed block, reset the gain ramp in not mixed layers
+
+    static const uint MAX_DECODED_SAMPLES = 8192; // the biggest chunk mixed from compacted samples
+
     void setLocked(bool locked);
     bool isLocked() const;
     bool isValid() const;
@@ -61,14 +75,65 @@ public:
 
     uint getAvailableSamples() const;
 
+    // 16 bits storage used to save memory in locked layers. The compaction and the expansion are done in the
+    // compaction thread: the audio thread requests them and adopts the new samples storage when it is ready.
+    void updateCompaction(bool compacting); // audio thread
+    void processCompactionJob(); // compaction thread
+    void releaseRetiredStorages(); // compaction thread, the replaced storages are never released in the audio thread
+    bool isCompacted() const;
+    bool isCompacting() const; // a compaction or expansion is running
+
+    quint64 getMemoryUsage() const; // in bytes
+    quint64 getUncompactedMemoryUsage() const; // bytes used by this layer when not compacted
+
 private:
-    std::vector<float> leftChannel;
-    std::vector<float> rightChannel;
+    // the layer samples, in float or 16 bits format. The storage is replaced by pointer swap when the layer is
+    // compacted, expanded or resized, and the replaced storage is retired until nobody is using it
+    struct Storage
+    {
+        std::vector<float> channels[2]; // float samples, empty when compacted
+        CompactSamples compactSamples;
+        std::vector<float> decodedChannels[2]; // compacted samples decoded just ahead of the playhead
+        bool compacted = false;
+        uint contentVersion = 0; // the layer content used to create this storage
+        Storage *nextRetired = nullptr;
+    };
+
+    enum CompactionJob {
+        NoJob,
+        CompactJob,
+        ExpandJob
+    };
 
-    std::vector<float> peaksCache;
-    uint lastSamplesPerPeak;
+    QAtomicPointer<Storage> storage; // replaced only by the thread changing the layer content (audio thread)
+    QAtomicPointer<Storage> retiredStorages;
+    mutable QAtomicInt readers; // GUI readers, the retired storages are not released while a reader exists
+
+    // RAII reader used in the GUI thread
+    class Reader
+    {
+    public:
+        explicit Reader(const LooperLayer &layer);
+        ~Reader();
+        const Storage *get() const;
+
+    private:
+        const LooperLayer &layer;
+        const Storage *storage;
+    };
+
+    // compaction job, the parameters are written before 'requestedJob' in audio thread
+    QAtomicInt requestedJob;
+    const Storage *jobSource;
+    uint jobSamples;
+    uint jobContentVersion;
+    QAtomicPointer<Storage> jobResult; // set in the compaction thread
+    bool jobInProgress; // audio thread
+
+    uint contentVersion; // incremented in each content change, the running compaction jobs are discarded
+
+    PeaksPyramid peaks; // incrementally updated when recording/overdubbing, used to draw the layer in any zoom level
     uint availableSamples;
-    uint lastCacheComputationSample;
     uint lastCycleLenght;
     bool locked;
 
@@ -80,8 +145,22 @@ private:
 
     MuteState muteState;
 
+    // gains applied in the end of last mixed block, used as start point in the next gain ramp
+    float lastMixGains[2];
+    bool mixGainsInitialized; // when false the next mix will use the target gains without ramp
+    bool mixedInCurrentBlock;
+
+    Storage *getWritableStorage(); // must be called before any change in layer content
+    void replaceStorage(Storage *newStorage);
+    void retire(Storage *oldStorage);
+    static Storage *createFloatStorage(uint samples);
+    static void deleteStorages(Storage *storages);
+
     void resize(quint32 samplesPerCycle);
 
+    LooperLayer(const LooperLayer &) = delete;
+    LooperLayer &operator=(const LooperLayer &) = delete;
+
 };
 
 inline float LooperLayer::getLeftGain() const
@@ -124,6 +203,16 @@ inline uint LooperLayer::getAvailableSamples() const
     return availableSamples;
 }
 
+inline bool LooperLayer::isCompacting() const
+{
+    return jobInProgress;
+}
+
+inline const LooperLayer::Storage *LooperLayer::Reader::get() const
+{
+    return storage;
+}
+
 inline bool LooperLayer::isValid() const
 {
     return availableSamples > 0;
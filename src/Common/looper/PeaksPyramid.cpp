@@ -0,0 +1,205 @@
+#include "PeaksPyramid.h"
+
+#include <algorithm>
+
+using audio::PeaksPyramid;
+
+PeaksPyramid::PeaksPyramid() :
+    levels(new Levels()),
+    retiredLevels(nullptr),
+    readers(0)
+{
+
+}
+
+PeaksPyramid::~PeaksPyramid()
+{
+    delete levels.loadAcquire();
+
+    Levels *retired = retiredLevels.fetchAndStoreOrdered(nullptr);
+    while (retired) {
+        Levels *next = retired->nextRetired;
+        delete retired;
+        retired = next;
+    }
+}
+
+PeaksPyramid::Reader::Reader(const PeaksPyramid &pyramid) :
+    pyramid(pyramid)
+{
+    pyramid.readers.fetchAndAddOrdered(1);
+    levels = pyramid.levels.loadAcquire();
+}
+
+PeaksPyramid::Reader::~Reader()
+{
+    if (pyramid.readers.fetchAndAddOrdered(-1) == 1)
+        pyramid.releaseRetiredLevels();
+}
+
+void PeaksPyramid::retire(Levels *oldLevels) const
+{
+    Levels *head;
+    do {
+        head = retiredLevels.loadAcquire();
+        oldLevels->nextRetired = head;
+    } while (!retiredLevels.testAndSetOrdered(head, oldLevels));
+}
+
+void PeaksPyramid::releaseRetiredLevels() const
+{
+    Levels *retired = retiredLevels.fetchAndStoreOrdered(nullptr);
+    if (!retired)
+        return;
+
+    if (readers.loadAcquire() > 0) {
+        // a new reader can be using one of the retired levels, they will be released by the next last reader
+        while (retired) {
+            Levels *next = retired->nextRetired;
+            retire(retired);
+            retired = next;
+        }
+        return;
+    }
+
+    while (retired) {
+        Levels *next = retired->nextRetired;
+        delete retired;
+        retired = next;
+    }
+}
+
+void PeaksPyramid::resize(uint maxSamples)
+{
+    uint blocks = (maxSamples + BASE_BLOCK_SIZE - 1) / BASE_BLOCK_SIZE;
+
+    const Levels *currentLevels = levels.loadAcquire();
+    if (!currentLevels->blocks.empty() && currentLevels->blocks[0].size() >= blocks)
+        return; // pyramid is big enough
+
+    // the old content is discarded, the owner is responsible to call update() after resizing
+    Levels *newLevels = new Levels();
+    while (blocks > 0) {
+        newLevels->blocks.push_back(std::vector<float>(blocks, 0.0f));
+
+        if (blocks == 1)
+            break;
+
+        blocks = (blocks + 1) / 2;
+    }
+
+    // GUI readers can be using the old levels, they are released by the last reader
+    retire(levels.fetchAndStoreOrdered(newLevels));
+}
+
+void PeaksPyramid::clear()
+{
+    for (auto &level : levels.loadAcquire()->blocks)
+        std::fill(level.begin(), level.end(), 0.0f);
+}
+
+float PeaksPyramid::computeBlockPeak(const float *left, const float *right, uint from, uint to)
+{
+    float maxPeak = 0;
+    for (uint i = from; i < to; ++i) {
+        const float peak = qMax(qAbs(left[i]), qAbs(right[i]));
+        if (peak > maxPeak)
+            maxPeak = peak;
+    }
+
+    return maxPeak;
+}
+
+void PeaksPyramid::update(const float *left, const float *right, uint from, uint samples, uint availableSamples)
+{
+    std::vector<std::vector<float>> &levels = this->levels.loadAcquire()->blocks; // levels are replaced only in this thread
+
+    if (levels.empty() || !samples)
+        return;
+
+    const uint totalBlocks = levels[0].size();
+    uint firstBlock = from / BASE_BLOCK_SIZE;
+    uint lastBlock = (from + samples - 1) / BASE_BLOCK_SIZE;
+
+    if (firstBlock >= totalBlocks)
+        return;
+
+    if (lastBlock >= totalBlocks)
+        lastBlock = totalBlocks - 1;
+
+    // level 0 is computed from samples, only in the touched blocks
+    std::vector<float> &baseLevel = levels[0];
+    for (uint block = firstBlock; block <= lastBlock; ++block) {
+        const uint blockStart = block * BASE_BLOCK_SIZE;
+        const uint blockEnd = qMin(blockStart + BASE_BLOCK_SIZE, availableSamples);
+        baseLevel[block] = (blockStart < blockEnd) ? computeBlockPeak(left, right, blockStart, blockEnd) : 0.0f;
+    }
+
+    // propagating the changes to upper levels, only the parents of touched blocks are recomputed
+    for (uint l = 1; l < levels.size(); ++l) {
+        const std::vector<float> &children = levels[l - 1];
+        std::vector<float> &level = levels[l];
+
+        firstBlock /= 2;
+        lastBlock /= 2;
+
+        for (uint block = firstBlock; block <= lastBlock; ++block) {
+            const uint firstChild = block * 2;
+            const uint secondChild = firstChild + 1;
+            if (secondChild < children.size())
+                level[block] = qMax(children[firstChild], children[secondChild]);
+            else
+                level[block] = children[firstChild];
+        }
+    }
+}
+
+float PeaksPyramid::getMaxPeak(uint from, uint samples) const
+{
+    Reader reader(*this);
+    return getMaxPeak(reader.get()->blocks, from, samples);
+}
+
+float PeaksPyramid::getMaxPeak(const std::vector<std::vector<float>> &levels, uint from, uint samples)
+{
+    if (levels.empty() || !samples)
+        return 0.0f;
+
+    uint block = from / BASE_BLOCK_SIZE;
+    uint endBlock = qMin(static_cast<uint>((from + samples + BASE_BLOCK_SIZE - 1) / BASE_BLOCK_SIZE), static_cast<uint>(levels[0].size()));
+
+    // greedy decomposition of [block, endBlock) in the biggest aligned nodes available
+    float maxPeak = 0.0f;
+    while (block < endBlock) {
+        uint level = 0;
+        while (level + 1 < levels.size()) {
+            const uint nodeSize = 1u << (level + 1);
+            if ((block & (nodeSize - 1)) != 0 || block + nodeSize > endBlock)
+                break;
+
+            level++;
+        }
+
+        maxPeak = qMax(maxPeak, levels[level][block >> level]);
+        block += 1u << level;
+    }
+
+    return maxPeak;
+}
+
+void PeaksPyramid::getPeaks(uint samplesPerPeak, uint availableSamples, std::vector<float> &peaks) const
+{
+    peaks.clear();
+
+    if (!samplesPerPeak)
+        return;
+
+    peaks.reserve((availableSamples + samplesPerPeak - 1) / samplesPerPeak);
+
+    Reader reader(*this); // the same levels are used in all peaks
+    const std::vector<std::vector<float>> &levels = reader.get()->blocks;
+    for (uint i = 0; i < availableSamples; i += samplesPerPeak) {
+        const uint samples = qMin(samplesPerPeak, availableSamples - i);
+        peaks.push_back(getMaxPeak(levels, i, samples));
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef _AUDIO_PEAKS_PYRAMID_
+#define _AUDIO_PEAKS_PYRAMID_
+
+#include <vector>
+#include <QtGlobal>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+
+namespace audio {
+
+/**
+ * Multi-resolution (mip-map style) cache of max peaks used to draw looper layers.
+ *
+ * Level 0 stores the max absolute value (left and right channels) of each block of
+ * BASE_BLOCK_SIZE samples, level 1 stores the max of each pair of level 0 blocks, and so on.
+ * The pyramid is updated incrementally while recording/overdubbing (only the touched blocks
+ * and their parents are recomputed), so any zoom level can be served in O(pixels * log(levels))
+ * without touching the samples again.
+ *
+ * resize(), clear() and update() are called in the audio thread, getPeaks() and getMaxPeak() in
+ * the GUI thread. The resized levels are published atomically and the replaced levels are released
+ * by the last GUI reader, never in the audio thread or while a reader is using them.
+ */
+
+class PeaksPyramid
+{
+public:
+    PeaksPyramid();
+    ~PeaksPyramid();
+
+    void resize(uint maxSamples);
+    void clear();
+
+    // recompute the blocks touching samples in range [from, from + samples). Only the first 'availableSamples' are valid.
+    void update(const float *left, const float *right, uint from, uint samples, uint availableSamples);
+
+    void getPeaks(uint samplesPerPeak, uint availableSamples, std::vector<float> &peaks) const;
+
+    float getMaxPeak(uint from, uint samples) const; // 'from' and 'samples' are rounded to BASE_BLOCK_SIZE
+
+    static const uint BASE_BLOCK_SIZE = 64; // samples in each level 0 block, must be power of 2
+
+private:
+    struct Levels
+    {
+        std::vector<std::vector<float>> blocks; // blocks[0] is the base level
+        Levels *nextRetired = nullptr;
+    };
+
+    QAtomicPointer<Levels> levels;
+    mutable QAtomicPointer<Levels> retiredLevels; // replaced levels waiting until no reader is using them
+    mutable QAtomicInt readers;
+
+    void retire(Levels *oldLevels) const;
+    void releaseRetiredLevels() const; // called by the last reader
+
+    // RAII reader, the levels are not released while a reader exists
+    class Reader
+    {
+    public:
+        explicit Reader(const PeaksPyramid &pyramid);
+        ~Reader();
+        const Levels *get() const;
+
+    private:
+        const PeaksPyramid &pyramid;
+        const Levels *levels;
+    };
+
+    static float getMaxPeak(const std::vector<std::vector<float>> &levels, uint from, uint samples);
+
+    PeaksPyramid(const PeaksPyramid &) = delete;
+    PeaksPyramid &operator=(const PeaksPyramid &) = delete;
+
+    static float computeBlockPeak(const float *left, const float *right, uint from, uint to);
+};
+
+inline const PeaksPyramid::Levels *PeaksPyramid::Reader::get() const
+{
+    return levels;
+}
+
+} // namespace
+
+#endif
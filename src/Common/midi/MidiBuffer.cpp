@@ -0,0 +1,93 @@
+#include "MidiBuffer.h"
+
+#include <QtGlobal>
+
+using midi::MidiBuffer;
+using midi::MidiMessage;
+
+MidiBuffer::MidiBuffer() :
+    count(0)
+{
+
+}
+
+MidiBuffer::MidiBuffer(const MidiBuffer &other) :
+    count(0)
+{
+    append(other);
+}
+
+MidiBuffer &MidiBuffer::operator=(const MidiBuffer &other)
+{
+    if (this != &other) {
+        count = 0;
+        append(other);
+    }
+
+    return *this;
+}
+
+void MidiBuffer::append(const MidiBuffer &other)
+{
+    const int messagesToCopy = qMin(other.count, CAPACITY - count);
+    for (int i = 0; i < messagesToCopy; ++i)
+        messages[count + i] = other.messages[i];
+
+    count += messagesToCopy;
+}
+
+void MidiBuffer::copyRange(MidiBuffer &outBuffer, int firstFrame, int frames) const
+{
+    for (int i = 0; i < count; ++i) {
+        const int deltaFrames = messages[i].getDeltaFrames() - firstFrame;
+        if (deltaFrames >= 0 && deltaFrames < frames) {
+            if (!outBuffer.push_back(messages[i]))
+                return;
+
+            outBuffer.messages[outBuffer.count - 1].setDeltaFrames(deltaFrames);
+        }
+    }
+}
+
+void MidiBuffer::computeDeltaFrames(qint64 blockTimestamp, int frames, int sampleRate)
+{
+    /**
+        The messages captured while the previous block was playing are scheduled in this block, in the
+        same relative position. This is adding a constant latency of one block, but the notes are not
+        jittering anymore (all notes landing in the first frame) when using large buffer sizes.
+    */
+
+    if (frames <= 0 || sampleRate <= 0)
+        return;
+
+    const qint64 blockDuration = static_cast<qint64>(frames) * 1000000 / sampleRate; // microseconds
+
+    for (int i = 0; i < count; ++i) {
+        MidiMessage &message = messages[i];
+        if (message.getTimestamp() <= 0) { // not timestamped, processed in the first frame
+            message.setDeltaFrames(0);
+            continue;
+        }
+
+        const qint64 age = blockTimestamp - message.getTimestamp();
+        const qint64 position = (blockDuration - age) * sampleRate / 1000000;
+        message.setDeltaFrames(static_cast<int>(qBound(static_cast<qint64>(0), position, static_cast<qint64>(frames - 1))));
+    }
+
+    // messages from different devices are interleaved, the plugins are expecting the events in time order
+    sortByDeltaFrames();
+}
+
+void MidiBuffer::sortByDeltaFrames()
+{
+    // insertion sort: stable, no allocations (std::stable_sort can allocate) and fast for few and almost sorted messages
+    for (int i = 1; i < count; ++i) {
+        const MidiMessage message = messages[i];
+        int j = i - 1;
+        while (j >= 0 && messages[j].getDeltaFrames() > message.getDeltaFrames()) {
+            messages[j + 1] = messages[j];
+            --j;
+        }
+        messages[j + 1] = message;
+    }
+}
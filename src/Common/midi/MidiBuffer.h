@@ -0,0 +1,135 @@
+#ifndef MIDI_BUFFER_H
+#define MIDI_BUFFER_H
+
+#include "MidiMessage.h"
+
+namespace midi {
+
+/**
+ * Fixed capacity MIDI messages buffer used in the audio thread. The messages are stored inline, so
+ * the buffers are allocated only once (as members of the audio nodes, drivers and hosts) and never
+ * allocating memory when processing audio. When the buffer is full the new messages are discarded.
+ */
+
+class MidiBuffer
+{
+public:
+    static const int CAPACITY = 256;
+
+    MidiBuffer();
+    MidiBuffer(const MidiBuffer &other);
+    MidiBuffer &operator=(const MidiBuffer &other); // copying only the used messages
+
+    int size() const;
+    bool empty() const;
+    bool isFull() const;
+
+    bool push_back(const MidiMessage &message); // return false if the buffer is full (message discarded)
+    void append(const MidiBuffer &other);
+    void clear();
+
+    MidiMessage &operator[](int index);
+    const MidiMessage &operator[](int index) const;
+
+    // range based for
+    MidiMessage *begin();
+    MidiMessage *end();
+    const MidiMessage *begin() const;
+    const MidiMessage *end() const;
+
+    /**
+     * Moving the messages accepted by 'predicate' to 'outBuffer' and compacting the remaining
+     * messages in place. Single pass, the messages order is preserved in both buffers. The
+     * predicate receives a non const message and can change the moved messages (transposing, etc.).
+     */
+    template<typename Predicate>
+    void moveTo(MidiBuffer &outBuffer, Predicate predicate);
+
+    // copy the messages scheduled in [firstFrame, firstFrame + frames) rebasing the deltaFrames to the range start
+    void copyRange(MidiBuffer &outBuffer, int firstFrame, int frames) const;
+
+    // convert the capture timestamps in frame offsets (deltaFrames) inside a block started at 'blockTimestamp'
+    void computeDeltaFrames(qint64 blockTimestamp, int frames, int sampleRate);
+
+private:
+    void sortByDeltaFrames(); // stable, no allocations
+
+    MidiMessage messages[CAPACITY];
+    int count;
+};
+
+inline int MidiBuffer::size() const
+{
+    return count;
+}
+
+inline bool MidiBuffer::empty() const
+{
+    return count == 0;
+}
+
+inline bool MidiBuffer::isFull() const
+{
+    return count >= CAPACITY;
+}
+
+inline void MidiBuffer::clear()
+{
+    count = 0;
+}
+
+inline bool MidiBuffer::push_back(const MidiMessage &message)
+{
+    if (count >= CAPACITY)
+        return false;
+
+    messages[count++] = message;
+    return true;
+}
+
+inline MidiMessage &MidiBuffer::operator[](int index)
+{
+    return messages[index];
+}
+
+inline const MidiMessage &MidiBuffer::operator[](int index) const
+{
+    return messages[index];
+}
+
+inline MidiMessage *MidiBuffer::begin()
+{
+    return messages;
+}
+
+inline MidiMessage *MidiBuffer::end()
+{
+    return messages + count;
+}
+
+inline const MidiMessage *MidiBuffer::begin() const
+{
+    return messages;
+}
+
+inline const MidiMessage *MidiBuffer::end() const
+{
+    return messages + count;
+}
+
+template<typename Predicate>
+void MidiBuffer::moveTo(MidiBuffer &outBuffer, Predicate predicate)
+{
+    int remaining = 0;
+    for (int i = 0; i < count; ++i) {
+        if (predicate(messages[i]))
+            outBuffer.push_back(messages[i]);
+        else
+            messages[remaining++] = messages[i];
+    }
+    count = remaining;
+}
+
+} // namespace
+
+#endif
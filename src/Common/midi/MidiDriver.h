@@ -5,6 +5,7 @@
 #include <QMap>
 
 #include "MidiMessage.h"
+#include "MidiBuffer.h"
 
 #include <vector>
 
@@ -27,7 +28,7 @@ public:
     virtual int getMaxInputDevices() const = 0;
 
     virtual QString getInputDeviceName(uint index) const = 0;
-    virtual std::vector<MidiMessage> getBuffer() = 0;
+    virtual void getBuffer(MidiBuffer &outBuffer) = 0; // append the received messages in outBuffer
 
     virtual bool deviceIsGloballyEnabled(int deviceIndex) const;
     int getFirstGloballyEnableInputDevice() const;
@@ -68,9 +69,9 @@ class NullMidiDriver : public MidiDriver
         return "";
     }
 
-    inline std::vector<MidiMessage> getBuffer() override
+    inline void getBuffer(MidiBuffer &outBuffer) override
     {
-        return std::vector<MidiMessage>();
+        Q_UNUSED(outBuffer)
     }
 };
 
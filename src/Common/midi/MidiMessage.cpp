@@ -1,12 +1,15 @@
 #include "MidiMessage.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
 
 using midi::MidiMessage;
 
-MidiMessage::MidiMessage(qint32 data, int sourceID) :
+MidiMessage::MidiMessage(qint32 data, int sourceID, qint64 timestamp) :
     data(data),
-    sourceID(sourceID)
+    sourceID(sourceID),
+    timestamp(timestamp),
+    deltaFrames(0)
 {
 
 }
@@ -17,13 +20,13 @@ MidiMessage::MidiMessage() :
 
 }
 
-MidiMessage MidiMessage::fromVector(std::vector<unsigned char> vector, qint32 deviceIndex)
+MidiMessage MidiMessage::fromVector(const std::vector<unsigned char> &vector, qint32 deviceIndex, qint64 timestamp)
 {
     int msgData = 0;
     msgData |= vector.at(0);
     msgData |= vector.at(1) << 8;
     msgData |= vector.at(2) << 16;
-    return MidiMessage(msgData, deviceIndex);
+    return MidiMessage(msgData, deviceIndex, timestamp);
 }
 
 MidiMessage MidiMessage::fromArray(const char array[4], qint32 deviceIndex)
@@ -76,3 +79,12 @@ bool MidiMessage::isNoteOff() const
     int status = getStatus();
     return status >= 0x80 && status <= 0x8F;
 }
+
+qint64 MidiMessage::currentTimestamp()
+{
+    static QElapsedTimer clock; // monotonic, shared by the MIDI input threads and the audio thread
+    static bool clockStarted = (clock.start(), true);
+    Q_UNUSED(clockStarted)
+
+    return clock.nsecsElapsed() / 1000;
+}
@@ -10,10 +10,10 @@ class MidiMessage
 {
 
 public:
-    MidiMessage(qint32 data, int sourceID);
+    MidiMessage(qint32 data, int sourceID, qint64 timestamp = 0);
     MidiMessage();
 
-    static MidiMessage fromVector(std::vector<unsigned char> vector, qint32 sourceID);
+    static MidiMessage fromVector(const std::vector<unsigned char> &vector, qint32 sourceID, qint64 timestamp = 0);
     static MidiMessage fromArray(const char array[4], qint32 sourceID=-1);
 
     int getChannel() const;
@@ -36,9 +36,18 @@ public:
 
     bool isControl() const;
 
+    qint64 getTimestamp() const;
+
+    int getDeltaFrames() const;
+    void setDeltaFrames(int deltaFrames);
+
+    static qint64 currentTimestamp(); // microseconds in a monotonic clock, used to timestamp the messages when captured
+
 private:
     qint32 data;
     int sourceID; // the id of the midi device generating the message.
+    qint64 timestamp; // when the message was captured, see currentTimestamp()
+    int deltaFrames; // sample offset inside the processed block
 };
 
 inline int MidiMessage::getChannel() const
@@ -71,6 +80,21 @@ inline bool MidiMessage::isControl() const
     return getStatus() == 0xB0;
 }
 
+inline qint64 MidiMessage::getTimestamp() const
+{
+    return timestamp;
+}
+
+inline int MidiMessage::getDeltaFrames() const
+{
+    return deltaFrames;
+}
+
+inline void MidiMessage::setDeltaFrames(int deltaFrames)
+{
+    this->deltaFrames = deltaFrames;
+}
+
 } // namespace
 
 #endif
@@ -6,6 +6,7 @@
 
 using midi::RtMidiDriver;
 using midi::MidiMessage;
+using midi::MidiBuffer;
 
 RtMidiDriver::RtMidiDriver(const QList<bool> &deviceStatuses){
 
@@ -45,6 +46,7 @@ void RtMidiDriver::setInputDevicesStatus(const QList<bool> &statuses){
     MidiDriver::setInputDevicesStatus(validStatuses);
     for (int s = 0; s < validStatuses.size(); ++s) {
         midiStreams.append(new RtMidiIn());
+        inputQueues.append(new InputQueue(s));
     }
 }
 
@@ -66,6 +68,7 @@ void RtMidiDriver::start(const QList<bool> &deviceStatuses){
                     try{
                         qCInfo(jtMidi) << "Starting MIDI in " << QString::fromStdString(stream->getPortName(deviceIndex));
                         stream->ignoreTypes();// ignoring sysex, miditime and midi sense messages
+                        stream->setCallback(&RtMidiDriver::receiveMessage, inputQueues.at(deviceIndex)); // timestamping the messages when received
                         stream->openPort(deviceIndex);
                     }
                     catch(RtMidiError &e){
@@ -106,6 +109,9 @@ void RtMidiDriver::release(){
         }
     }
     midiStreams.clear();
+
+    qDeleteAll(inputQueues); // the streams are deleted, the callbacks are not called anymore
+    inputQueues.clear();
 }
 
 QString RtMidiDriver::getInputDeviceName(uint index) const{
@@ -115,33 +121,64 @@ QString RtMidiDriver::getInputDeviceName(uint index) const{
     return "";
 }
 
-void RtMidiDriver::consumeMessagesFromStream(RtMidiIn *stream, int deviceIndex, std::vector<midi::MidiMessage> &outBuffer)
+void RtMidiDriver::receiveMessage(double deltaTime, std::vector<unsigned char> *messageBytes, void *userData)
 {
-    //qCDebug(jtMidi) << "consuming messages from stream - RtMidiDriver";
-    std::vector<unsigned char> messageBytes;
-    do{
-        messageBytes.clear();
-        stream->getMessage(&messageBytes);
-        if (messageBytes.size() == 3) { // Jamtaba is handling only the 3 bytes common midi messages. Uncommon midi messages will be ignored.
-            outBuffer.push_back(midi::MidiMessage::fromVector(messageBytes, deviceIndex));
-        }
-        else{
-            if (!messageBytes.empty())
-                qWarning() << "A midi message containing " << messageBytes.size() << " bytes was received!";
-        }
+    Q_UNUSED(deltaTime) // relative to the previous message, a monotonic timestamp is used instead
+
+    auto queue = static_cast<InputQueue *>(userData);
+    if (!queue || !messageBytes)
+        return;
+
+    if (messageBytes->size() == 3) { // Jamtaba is handling only the 3 bytes common midi messages. Uncommon midi messages will be ignored.
+        auto message = midi::MidiMessage::fromVector(*messageBytes, queue->getDeviceIndex(), MidiMessage::currentTimestamp());
+        if (!queue->push(message))
+            qWarning() << "MIDI input queue is full, discarding messages!";
+    }
+    else {
+        if (!messageBytes->empty())
+            qWarning() << "A midi message containing " << messageBytes->size() << " bytes was received!";
     }
-    while(!messageBytes.empty());
 }
 
-std::vector<MidiMessage> RtMidiDriver::getBuffer()
+void RtMidiDriver::getBuffer(MidiBuffer &outBuffer)
+{
+    for (auto queue : inputQueues)
+        queue->popAll(outBuffer);
+}
+
+// +++++++++++++++++++++++++++++++++++++++++++
+
+RtMidiDriver::InputQueue::InputQueue(int deviceIndex) :
+    writePosition(0),
+    readPosition(0),
+    deviceIndex(deviceIndex)
 {
-    std::vector<midi::MidiMessage> buffer;
-    int deviceIndex = 0;
-    for (auto stream : midiStreams) {
-        consumeMessagesFromStream(stream, deviceIndex, buffer);
-        deviceIndex++;
+
+}
+
+bool RtMidiDriver::InputQueue::push(const MidiMessage &message)
+{
+    const int write = writePosition.loadAcquire();
+    const int next = (write + 1) % CAPACITY;
+    if (next == readPosition.loadAcquire())
+        return false; // full
+
+    messages[write] = message;
+    writePosition.storeRelease(next);
+
+    return true;
+}
+
+void RtMidiDriver::InputQueue::popAll(MidiBuffer &outBuffer)
+{
+    int read = readPosition.loadAcquire();
+    const int write = writePosition.loadAcquire();
+    while (read != write && !outBuffer.isFull()) { // the remaining messages are consumed in the next audio callback
+        outBuffer.push_back(messages[read]);
+        read = (read + 1) % CAPACITY;
     }
-    return buffer;
+
+    readPosition.storeRelease(read);
 }
 
 bool RtMidiDriver::hasInputDevices() const{
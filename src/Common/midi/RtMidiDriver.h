@@ -4,6 +4,8 @@
 #include "MidiDriver.h"
 #include "RtMidi.h"
 
+#include <QAtomicInt>
+
 namespace midi {
 
 class RtMidiDriver : public MidiDriver
@@ -21,13 +23,44 @@ public:
     bool hasInputDevices() const override;
     int getMaxInputDevices() const override;
     QString getInputDeviceName(uint index) const override;
-    std::vector<midi::MidiMessage> getBuffer() override;
+    void getBuffer(MidiBuffer &outBuffer) override;
 
 private:
+
+    /**
+     * The messages are timestamped in the RtMidi callback (MIDI input thread) and consumed in the
+     * audio thread. Lock free, single producer and single consumer.
+     */
+    class InputQueue
+    {
+    public:
+        explicit InputQueue(int deviceIndex);
+
+        bool push(const MidiMessage &message); // MIDI input thread
+        void popAll(MidiBuffer &outBuffer); // audio thread
+
+        int getDeviceIndex() const;
+
+    private:
+        static const int CAPACITY = 256;
+
+        MidiMessage messages[CAPACITY];
+        QAtomicInt writePosition;
+        QAtomicInt readPosition;
+        int deviceIndex;
+    };
+
     QList<RtMidiIn *> midiStreams;
+    QList<InputQueue *> inputQueues; // one queue per stream
 
-    void consumeMessagesFromStream(RtMidiIn *stream, int deviceIndex, std::vector<MidiMessage> &outBuffer);
+    static void receiveMessage(double deltaTime, std::vector<unsigned char> *messageBytes, void *userData);
 
 };
+
+inline int RtMidiDriver::InputQueue::getDeviceIndex() const
+{
+    return deviceIndex;
+}
+
 }
 #endif // RTMIDIDRIVER_H
@@ -1,5 +1,7 @@
 #include "PerformanceMonitor.h"
 
+#include <QFile>
+#include <QDebug>
 
 PerformanceMonitor::PerformanceMonitor(){
 
@@ -11,5 +13,25 @@ PerformanceMonitor::~PerformanceMonitor(){
 
 int PerformanceMonitor::getMemmoryUsed(){
 
+    // the same value computed in Windows: the percentage of the physical memory not available
+    QFile memInfo("/proc/meminfo");
+    if (!memInfo.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Can't get total memory available! /proc/meminfo can't be opened!";
+        return 0;
+    }
+
+    qint64 total = 0;
+    qint64 available = 0;
+    while (!memInfo.atEnd() && (total == 0 || available == 0)) {
+        const QByteArray line = memInfo.readLine().simplified(); // MemTotal: 16314576 kB
+        if (line.startsWith("MemTotal:"))
+            total = line.split(' ').value(1).toLongLong();
+        else if (line.startsWith("MemAvailable:"))
+            available = line.split(' ').value(1).toLongLong();
+    }
+
+    if (total > 0)
+        return 100 - (available * 100 / total);
+
     return 0;
 }
@@ -98,7 +98,9 @@ LooperSettings::LooperSettings() :
     preferredMode(0),
     loopsFolder(""),
     encodingAudioWhenSaving(false),
-    waveFilesBitDepth(16) // 16 bits
+    waveFilesBitDepth(16), // 16 bits
+    compactingLockedLayers(false),
+    memoryBudget(512) // 512 MB
 {
     qCDebug(jtSettings) << "LooperSettings ctor";
     setDefaultLooperFilesPath();
@@ -111,6 +113,8 @@ void LooperSettings::read(const QJsonObject &in)
     loopsFolder = getValueFromJson(in, "loopsFolder", QString());
     encodingAudioWhenSaving = getValueFromJson(in, "encodeAudio", false);
     waveFilesBitDepth = getValueFromJson(in, "bitDepth", quint8(16)); // 16 bit as default value
+    compactingLockedLayers = getValueFromJson(in, "compactLockedLayers", false);
+    memoryBudget = getValueFromJson(in, "memoryBudget", 512); // 512 MB as default value
 
     if (!(waveFilesBitDepth == 16 || waveFilesBitDepth == 32)) {
         qWarning() << "Invalid bit depth " << waveFilesBitDepth << ", using 16 bits as default value";
@@ -143,7 +147,9 @@ void LooperSettings::read(const QJsonObject &in)
                     << "; loopsFolder " << loopsFolder
                     << " (useDefaultSavePath " << useDefaultSavePath << ")"
                     << "; encodingAudioWhenSaving " << encodingAudioWhenSaving
-                    << "; waveFilesBitDepth " << waveFilesBitDepth;
+                    << "; waveFilesBitDepth " << waveFilesBitDepth
+                    << "; compactingLockedLayers " << compactingLockedLayers
+                    << "; memoryBudget " << memoryBudget;
 
 }
 
@@ -172,6 +178,9 @@ void LooperSettings::write(QJsonObject &out) const
 
     if (!encodingAudioWhenSaving)
         out["bitDepth"] = waveFilesBitDepth;
+
+    out["compactLockedLayers"] = compactingLockedLayers;
+    out["memoryBudget"] = static_cast<int>(memoryBudget);
 }
 
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -245,7 +254,8 @@ AudioSettings::AudioSettings() :
     lastIn(-1),
     lastOut(-1),
     audioInputDevice(-1),
-    audioOutputDevice(-1)
+    audioOutputDevice(-1),
+    useJack(true)
 {
     qCDebug(jtSettings) << "AudioSettings ctor";
 }
@@ -260,6 +270,7 @@ void AudioSettings::read(const QJsonObject &in)
     lastOut = getValueFromJson(in, "lastOut", 0);
     audioInputDevice = getValueFromJson(in, "audioInputDevice", -1);
     audioOutputDevice = getValueFromJson(in, "audioOutputDevice", -1);
+    useJack = getValueFromJson(in, "useJack", true);
 
     encodingQuality = getValueFromJson(in, "encodingQuality", vorbis::EncoderQualityNormal); // using normal quality as fallback value.
 
@@ -277,7 +288,8 @@ void AudioSettings::read(const QJsonObject &in)
                         << "; lastOut " << lastOut
                         << "; audioInputDevice " << audioInputDevice
                         << "; audioOutputDevice " << audioOutputDevice
-                        << "; encodingQuality " << encodingQuality;
+                        << "; encodingQuality " << encodingQuality
+                        << "; useJack " << useJack;
 }
 
 void AudioSettings::write(QJsonObject &out) const
@@ -297,6 +309,7 @@ void AudioSettings::write(QJsonObject &out) const
     out["audioOutputDevice"] = audioOutputDevice;
 
     out["encodingQuality"] = encodingQuality;
+    out["useJack"] = useJack;
 }
 
 // +++++++++++++++++++++++++++++
@@ -569,6 +582,12 @@ void VstSettings::write(QJsonObject &out) const
         BlackedArray.append(blackVst);
 
     out["BlackListPlugins"] = BlackedArray;
+
+    QJsonArray sandboxedArray;
+    for (const QString &sandboxedVst: sandboxedPlugins)
+        sandboxedArray.append(sandboxedVst);
+
+    out["SandboxedPlugins"] = sandboxedArray;
 }
 
 void VstSettings::read(const QJsonObject &in)
@@ -595,10 +614,17 @@ void VstSettings::read(const QJsonObject &in)
         for (int x = 0; x < cacheArray.size(); ++x)
             blackedPlugins.append(cacheArray.at(x).toString());
     }
+    sandboxedPlugins.clear();
+    if (in.contains("SandboxedPlugins")) {
+        QJsonArray sandboxedArray = in["SandboxedPlugins"].toArray();
+        for (int x = 0; x < sandboxedArray.size(); ++x)
+            sandboxedPlugins.append(sandboxedArray.at(x).toString());
+    }
 
     qCDebug(jtSettings) << "VstSettings: foldersToScan " << foldersToScan
                         << "; cachedPlugins " << cachedPlugins
-                        << "; blackedPlugins " << blackedPlugins;
+                        << "; blackedPlugins " << blackedPlugins
+                        << "; sandboxedPlugins " << sandboxedPlugins;
 }
 
 // +++++++++++++++++++++++++++++++++++++++
@@ -902,6 +928,23 @@ void Settings::clearBlackBox()
     vstSettings.blackedPlugins.clear();
 }
 
+void Settings::setVstSandboxed(const QString &pluginPath, bool sandboxed)
+{
+    qCDebug(jtSettings) << "Settings setVstSandboxed: " << pluginPath << sandboxed;
+    if (sandboxed) {
+        if (!vstSettings.sandboxedPlugins.contains(pluginPath))
+            vstSettings.sandboxedPlugins.append(pluginPath);
+    }
+    else {
+        vstSettings.sandboxedPlugins.removeOne(pluginPath);
+    }
+}
+
+bool Settings::isSandboxedVst(const QString &pluginPath) const
+{
+    return vstSettings.sandboxedPlugins.contains(pluginPath);
+}
+
 // VST paths to scan
 void Settings::addVstScanPath(const QString &path)
 {
@@ -1112,6 +1155,10 @@ bool Settings::readFile(const QList<SettingsObject *> &sections)
             chatFontSizeOffset = root["chatFontSizeOffset"].toInt();
         }
 
+        if (root.contains("chatHistoryLimit")) {
+            chatHistoryLimit = static_cast<uint>(qMax(root["chatHistoryLimit"].toInt(), 1));
+        }
+
         return true;
     }
     else {
@@ -1158,6 +1205,7 @@ bool Settings::writeFile(const QList<SettingsObject *> &sections) // io ops ...
         root["masterGain"] = masterFaderGain;
         root["intervalsBeforeInactivityWarning"] = static_cast<int>(intervalsBeforeInactivityWarning);
         root["chatFontSizeOffset"] = static_cast<int>(chatFontSizeOffset);
+        root["chatHistoryLimit"] = static_cast<int>(chatHistoryLimit);
         root["publicChatActivated"] = publicChatIsActivated();
 
         if (!recentEmojis.isEmpty()) {
@@ -1268,6 +1316,7 @@ Settings::Settings() :
     usingNarrowedTracks(false),
     intervalsBeforeInactivityWarning(5), // 5 intervals by default,
     chatFontSizeOffset(0),
+    chatHistoryLimit(500),
     publicChatActivated(true)
 {
     qCDebug(jtSettings) << "Settings ctor";
@@ -59,6 +59,7 @@ public:
     int audioInputDevice;
     int audioOutputDevice;
     float encodingQuality;
+    bool useJack; // Linux only, using the JACK audio driver when a JACK server is running
 };
 
 // +++++++++++++++++++++++++++++++++++++
@@ -145,6 +146,7 @@ public:
     QStringList cachedPlugins;
     QStringList foldersToScan;
     QStringList blackedPlugins; // vst in blackbox....
+    QStringList sandboxedPlugins; // vst running out of Jamtaba process
 };
 
 class AudioUnitSettings  : public SettingsObject
@@ -216,6 +218,8 @@ public:
     QString loopsFolder; // where looper audio files will be saved
     bool encodingAudioWhenSaving;
     quint8 waveFilesBitDepth;
+    bool compactingLockedLayers; // store locked layers in 16 bits when memory budget is reached
+    quint32 memoryBudget; // in MB, memory used by all loopers before start compacting locked layers
 
 private:
     void setDefaultLooperFilesPath();
@@ -424,6 +428,7 @@ private:
     uint intervalsBeforeInactivityWarning;
 
     qint8 chatFontSizeOffset;
+    uint chatHistoryLimit; // messages kept in each chat
 
     bool readFile(const QList<SettingsObject *> &sections);
     bool writeFile(const QList<SettingsObject *> &sections);
@@ -503,6 +508,8 @@ public:
     QStringList getBlackListedPlugins() const;
     void clearVstCache();
     void clearBlackBox();
+    void setVstSandboxed(const QString &pluginPath, bool sandboxed);
+    bool isSandboxedVst(const QString &pluginPath) const;
 
     // VST paths
     void addVstScanPath(const QString &path);
@@ -537,6 +544,8 @@ public:
     void setAudioSettings(int firstIn, int lastIn, int firstOut, int lastOut, int audioInputDevice, int audioOutputDevice);
     void setSampleRate(int newSampleRate);
     void setBufferSize(int bufferSize);
+    bool isUsingJack() const;
+    void setUsingJack(bool useJack);
 
     int getFirstGlobalAudioInput() const;
     int getLastGlobalAudioInput() const;
@@ -552,6 +561,8 @@ public:
     qint8 getChatFontSizeOffset() const;
     void storeChatFontSizeOffset(qint8 sizeOffset);
 
+    uint getChatHistoryLimit() const;
+
     // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
     // TRANSLATION
@@ -575,12 +586,16 @@ public:
     bool getLooperAudioEncodingFlag() const;
     QString getLooperFolder() const;
     quint8 getLooperBitDepth() const;
+    bool isCompactingLooperLockedLayers() const;
+    quint32 getLooperMemoryBudget() const;
 
     void setLooperPreferredLayersCount(quint8 layersCount);
     void setLooperPreferredMode(quint8 looperMode);
     void setLooperAudioEncodingFlag(bool encodeAudioWhenSaving);
     void setLooperFolder(const QString &folder);
     void setLooperBitDepth(quint8 bitDepth);
+    void setCompactingLooperLockedLayers(bool compacting);
+    void setLooperMemoryBudget(quint32 budgetInMB);
 
     // Remember settings
     void setRemoteUserRememberingSettings(bool boost, bool level, bool pan, bool mute, bool lowCut);
@@ -659,6 +674,11 @@ inline qint8 Settings::getChatFontSizeOffset() const
     return chatFontSizeOffset;
 }
 
+inline uint Settings::getChatHistoryLimit() const
+{
+    return chatHistoryLimit;
+}
+
 inline QStringList Settings::getRecentEmojis() const
 {
     return recentEmojis;
@@ -726,6 +746,26 @@ inline quint8 Settings::getLooperBitDepth() const
     return looperSettings.waveFilesBitDepth;
 }
 
+inline bool Settings::isCompactingLooperLockedLayers() const
+{
+    return looperSettings.compactingLockedLayers;
+}
+
+inline void Settings::setCompactingLooperLockedLayers(bool compacting)
+{
+    looperSettings.compactingLockedLayers = compacting;
+}
+
+inline quint32 Settings::getLooperMemoryBudget() const
+{
+    return looperSettings.memoryBudget;
+}
+
+inline void Settings::setLooperMemoryBudget(quint32 budgetInMB)
+{
+    looperSettings.memoryBudget = budgetInMB;
+}
+
 inline QString Settings::getLooperFolder() const
 {
     return looperSettings.loopsFolder;
@@ -940,6 +980,16 @@ inline int Settings::getLastBufferSize() const
     return audioSettings.bufferSize;
 }
 
+inline bool Settings::isUsingJack() const
+{
+    return audioSettings.useJack;
+}
+
+inline void Settings::setUsingJack(bool useJack)
+{
+    audioSettings.useJack = useJack;
+}
+
 inline QList<QString> Settings::getLastPrivateServers() const
 {
     return privateServerSettings.getLastServers();
@@ -4,6 +4,8 @@
 #include <QFile>
 #include <QStandardPaths>
 #include <QDataStream>
+#include <cstring>
+#include <algorithm>
 #include "Configurator.h"
 #include "CacheHeader.h"
 
@@ -31,20 +33,6 @@ const qint8 CacheEntry::DEFAULT_INSTRUMENT_INDEX = -1;
 QRegExp CacheEntry::ipPattern("(?:\\d{1,3}\\.){3}(\\d{1,3}|x)");
 
 
-QDataStream &operator<<(QDataStream &stream, const CacheEntry &entry)
-{
-    return stream
-           << entry.getUserIP()
-           << entry.getUserName()
-           << entry.getChannelID()
-           << entry.isMuted()
-           << entry.getGain()
-           << entry.getPan()
-           << entry.getBoost()
-           << entry.getLowCutState()
-           << entry.getInstrumentIndex();
-}
-
 QDataStream &operator>>(QDataStream &stream, CacheEntry &entry)
 {
     QString userIp, userName;
@@ -140,9 +128,64 @@ void CacheEntry::setGain(float gain)
     this->gain = gain;
 }
 
-UsersDataCache::UsersDataCache(const QDir &cacheDir) :
+struct UsersDataCache::StoreHeader
+{
+    quint32 signature;
+    quint32 revision;
+    quint32 capacity;
+    quint32 maxEntries;
+    quint32 entries;
+    quint32 lruClock;
+};
+
+struct UsersDataCache::StoredEntry
+{
+    static const int IP_SIZE = 16;
+    static const int NAME_SIZE = 64;
+
+    quint64 keyHash; // ZERO in empty slots
+    quint32 lastUse; // LRU clock in the last access
+    float gain;
+    float pan;
+    float boost;
+    quint8 channelID;
+    quint8 muted;
+    quint8 lowCutState;
+    qint8 instrumentIndex;
+    char userIp[IP_SIZE]; // zero terminated UTF-8, truncated if necessary
+    char userName[NAME_SIZE];
+    quint32 reserved;
+};
+
+const quint32 UsersDataCache::DEFAULT_MAX_ENTRIES = 3072;
+const quint32 UsersDataCache::STORE_SIGNATURE = 0x4a544233; // "JTB3"
+const quint32 UsersDataCache::STORE_REVISION = 1;
+const int UsersDataCache::STORE_LOCK_TIMEOUT = 200; // ms
+
+namespace {
+
+void copyString(char *dest, int destSize, const QByteArray &source)
+{
+    const int size = qMin(source.size(), destSize - 1);
+    std::memcpy(dest, source.constData(), size);
+    std::memset(dest + size, 0, destSize - size);
+}
+
+bool sameString(const char *stored, int storedSize, const QByteArray &value)
+{
+    return std::strncmp(stored, value.constData(), storedSize - 1) == 0;
+}
+
+} // namespace
+
+UsersDataCache::UsersDataCache(const QDir &cacheDir, quint32 maxEntries) :
+    cacheDir(cacheDir),
+    storeLock(cacheDir.absoluteFilePath("tracks_cache.lock")),
+    store(nullptr),
+    maxEntries(qMax(maxEntries, 8u)),
+    capacity(computeCapacity(this->maxEntries)),
     CACHE_FILE_NAME("tracks_cache.bin"),
-    cacheDir(cacheDir)
+    STORE_FILE_NAME("tracks_cache.db")
 {
     // check if the tracks_cache_bin file is in the old dir and copy the file to the 'cache' dir.
     // This piece of code will be deleted in future versions.
@@ -155,76 +198,353 @@ UsersDataCache::UsersDataCache(const QDir &cacheDir) :
             qDebug() << "Error when copying " << CACHE_FILE_NAME << " to the new cache folder!";
     }
 
-    loadCacheEntriesFromFile();
+    openStore();
+
+    importOldCacheFile();
 }
 
 UsersDataCache::~UsersDataCache()
 {
-    if (!cacheEntries.isEmpty())
-        writeCacheEntriesToFile();
+    if (store && memoryStore.isEmpty()) {
+        storeFile.unmap(store); // the changed pages are written by the OS
+        storeFile.close();
+    }
 }
 
-CacheEntry UsersDataCache::getUserCacheEntry(const QString &userIp, const QString &userName,
-                                             quint8 channelID)
+quint32 UsersDataCache::computeCapacity(quint32 maxEntries)
 {
-    QString userUniqueKey = getUserUniqueKey(userIp, userName, channelID);
-    if (cacheEntries.contains(userUniqueKey))
-        return cacheEntries[userUniqueKey];
+    // power of 2 slots, the table is never more than 75% full
+    quint32 capacity = 16;
+    while (capacity < maxEntries + maxEntries / 3)
+        capacity *= 2;
 
-    return CacheEntry(userIp, userName, channelID); // return a entry using default values for pan, gain, mute, etc.
+    return capacity;
 }
 
-void UsersDataCache::updateUserCacheEntry(CacheEntry entry)
+UsersDataCache::StoreHeader *UsersDataCache::getHeader() const
 {
-    QString userKey = getUserUniqueKey(entry.getUserIP(), entry.getUserName(), entry.getChannelID());
-    cacheEntries.insert(userKey, entry); // replace the last value or insert
+    return reinterpret_cast<StoreHeader *>(store);
 }
 
-QString UsersDataCache::getUserUniqueKey(const QString &userIp, const QString &userName,
-                                         quint8 channelID)
+UsersDataCache::StoredEntry *UsersDataCache::getEntries() const
 {
-    // the unique key is just a string...
-    return userIp + userName + QString::number(channelID);
+    return reinterpret_cast<StoredEntry *>(store + sizeof(StoreHeader));
 }
 
-void UsersDataCache::loadCacheEntriesFromFile()
+quint32 UsersDataCache::getEntriesCount() const
 {
-    // load tracks cache content from file
-    QFile cacheFile(cacheDir.absoluteFilePath(CACHE_FILE_NAME));
-    if (cacheFile.open(QFile::ReadOnly)) {
-        QDataStream stream(&cacheFile);
-
-        CacheHeader cacheHeader;
-        stream >> cacheHeader;
-        quint32 expectedHeaderRevision = UsersDataCacheHeader::REVISION;
-        if (cacheHeader.isValid(expectedHeaderRevision))
-            stream >> cacheEntries;
-        else
-            qCritical() << "Invalid cache header when loading users data cache.";
+    return getHeader()->entries;
+}
 
-        qCDebug(jtCache) << "Tracks cache items loaded from file: " << cacheEntries.size();
+bool UsersDataCache::isValidStore(const uchar *data, qint64 size, QVector<StoredEntry> &oldEntries) const
+{
+    // return false when the store can't be used as is, the entries of a resized store are appended in 'oldEntries'
+    if (size < static_cast<qint64>(sizeof(StoreHeader)))
+        return false;
+
+    const StoreHeader *header = reinterpret_cast<const StoreHeader *>(data);
+    const bool validStore = header->signature == STORE_SIGNATURE && header->revision == STORE_REVISION
+            && size == static_cast<qint64>(sizeof(StoreHeader) + static_cast<qint64>(header->capacity) * sizeof(StoredEntry));
+
+    if (validStore && header->capacity == capacity && header->maxEntries == maxEntries)
+        return true;
+
+    if (validStore) { // resized store, the entries are reinserted
+        const StoredEntry *entries = reinterpret_cast<const StoredEntry *>(data + sizeof(StoreHeader));
+        for (quint32 i = 0; i < header->capacity; ++i) {
+            if (entries[i].keyHash)
+                oldEntries.append(entries[i]);
+        }
+    }
+    else {
+        qCritical() << "Invalid tracks cache store, creating a new store.";
     }
+
+    return false;
 }
 
-void UsersDataCache::writeCacheEntriesToFile()
+void UsersDataCache::openStore()
 {
-    qCDebug(jtCache) << "Saving cache file";
+    // the store layout can't change without a new STORE_REVISION
+    Q_STATIC_ASSERT(sizeof(StoreHeader) == 24);
+    Q_STATIC_ASSERT(sizeof(StoredEntry) == 112);
 
-    QFile cacheFile(cacheDir.absoluteFilePath(CACHE_FILE_NAME));
-    if (cacheFile.open(QFile::WriteOnly)) {
-        qCDebug(jtCache) << "Tracks cache file opened to write.";
-        QDataStream stream(&cacheFile);
+    const qint64 storeSize = sizeof(StoreHeader) + static_cast<qint64>(capacity) * sizeof(StoredEntry);
+
+    QVector<StoredEntry> oldEntries;
+
+    storeFile.setFileName(cacheDir.absoluteFilePath(STORE_FILE_NAME));
+
+    // the lock is held while the store is mapped, only the lock of a crashed process is stale
+    storeLock.setStaleLockTime(0);
+    if (!storeLock.tryLock(STORE_LOCK_TIMEOUT)) {
+        openStoreCopy();
+        return;
+    }
+
+    if (storeFile.open(QFile::ReadWrite)) {
+        const qint64 fileSize = storeFile.size();
+        if (fileSize >= static_cast<qint64>(sizeof(StoreHeader)))
+            store = storeFile.map(0, fileSize);
+
+        if (store) {
+            if (isValidStore(store, fileSize, oldEntries)) {
+                qCDebug(jtCache) << "Tracks cache entries in store:" << getHeader()->entries;
+                return; // using the mapped store, nothing is loaded
+            }
+
+            storeFile.unmap(store);
+            store = nullptr;
+        }
+
+        if (storeFile.resize(storeSize))
+            store = storeFile.map(0, storeSize);
+    }
+
+    if (!store) {
+        qCritical() << "Can't map the tracks cache file in" << QFileInfo(storeFile).absoluteFilePath();
+        storeFile.close();
+        memoryStore = QByteArray(static_cast<int>(storeSize), 0);
+        store = reinterpret_cast<uchar *>(memoryStore.data());
+    }
+
+    initializeStore(oldEntries);
+}
+
+void UsersDataCache::openStoreCopy()
+{
+    // another Jamtaba process or plugin instance is writing in the store, the entries are copied in memory
+    qCWarning(jtCache) << "Tracks cache is in use by another Jamtaba instance, the changes will not be saved.";
+
+    QByteArray storeCopy;
+    if (storeFile.open(QFile::ReadOnly)) {
+        storeCopy = storeFile.readAll();
+        storeFile.close();
+    }
+
+    QVector<StoredEntry> oldEntries;
+    if (isValidStore(reinterpret_cast<const uchar *>(storeCopy.constData()), storeCopy.size(), oldEntries)) {
+        memoryStore = storeCopy;
+        store = reinterpret_cast<uchar *>(memoryStore.data());
+        return;
+    }
+
+    const qint64 storeSize = sizeof(StoreHeader) + static_cast<qint64>(capacity) * sizeof(StoredEntry);
+    memoryStore = QByteArray(static_cast<int>(storeSize), 0);
+    store = reinterpret_cast<uchar *>(memoryStore.data());
+
+    initializeStore(oldEntries);
+}
+
+void UsersDataCache::initializeStore(const QVector<StoredEntry> &entries)
+{
+    StoreHeader *header = getHeader();
+    header->signature = STORE_SIGNATURE;
+    header->revision = STORE_REVISION;
+    header->capacity = capacity;
+    header->maxEntries = maxEntries;
+    header->lruClock = 0;
+
+    rebuild(entries);
+}
 
-        CacheHeader cacheHeader(UsersDataCacheHeader::REVISION);
-        stream << cacheHeader;
+void UsersDataCache::rebuild(const QVector<StoredEntry> &entries)
+{
+    std::memset(getEntries(), 0, capacity * sizeof(StoredEntry));
+    getHeader()->entries = 0;
+
+    // keeping the most recently used entries if the store was resized to a smaller size
+    QVector<StoredEntry> sortedEntries(entries);
+    std::sort(sortedEntries.begin(), sortedEntries.end(), [](const StoredEntry &e1, const StoredEntry &e2) {
+        return e1.lastUse > e2.lastUse;
+    });
+
+    const int entriesToInsert = qMin(sortedEntries.size(), static_cast<int>(maxEntries));
+    for (int i = 0; i < entriesToInsert; ++i)
+        insertEntry(sortedEntries.at(i));
+}
 
-        stream << cacheEntries;
+QVector<UsersDataCache::StoredEntry> UsersDataCache::getUsedEntries() const
+{
+    QVector<StoredEntry> usedEntries;
+    usedEntries.reserve(getHeader()->entries);
 
-        qCDebug(jtCache) << cacheEntries.size() << " items stored in tracks cache file!";
-    } else {
-        qCritical() << "Can't open the tracks cache file in"
-                            << QFileInfo(cacheFile).absoluteFilePath();
+    const StoredEntry *entries = getEntries();
+    for (quint32 i = 0; i < capacity; ++i) {
+        if (entries[i].keyHash)
+            usedEntries.append(entries[i]);
     }
+
+    return usedEntries;
+}
+
+void UsersDataCache::evictLeastRecentlyUsedEntries()
+{
+    // evicting 1/8 of entries at once, the table is rebuilt just a few times in a long running install
+    QVector<StoredEntry> entries = getUsedEntries();
+    std::sort(entries.begin(), entries.end(), [](const StoredEntry &e1, const StoredEntry &e2) {
+        return e1.lastUse > e2.lastUse;
+    });
+    entries.resize(maxEntries - maxEntries / 8);
+
+    qCDebug(jtCache) << "Evicting" << (getHeader()->entries - entries.size()) << "tracks cache entries";
+
+    rebuild(entries);
+}
+
+quint64 UsersDataCache::computeKeyHash(const QByteArray &userIp, const QByteArray &userName, quint8 channelID)
+{
+    // FNV-1a
+    quint64 hash = Q_UINT64_C(14695981039346656037);
+    auto addBytes = [&hash](const char *bytes, int size) {
+        for (int i = 0; i < size; ++i) {
+            hash ^= static_cast<quint8>(bytes[i]);
+            hash *= Q_UINT64_C(1099511628211);
+        }
+    };
+
+    const char separator = 0;
+    addBytes(userIp.constData(), userIp.size());
+    addBytes(&separator, 1);
+    addBytes(userName.constData(), userName.size());
+    addBytes(&separator, 1);
+    addBytes(reinterpret_cast<const char *>(&channelID), 1);
+
+    return hash ? hash : 1; // ZERO is used in empty slots
+}
+
+int UsersDataCache::findEntry(quint64 keyHash, const QByteArray &userIp, const QByteArray &userName, quint8 channelID, bool &found) const
+{
+    // linear probing, return the entry index or the empty slot where the entry can be inserted
+    const StoredEntry *entries = getEntries();
+    quint32 index = keyHash & (capacity - 1);
+    for (quint32 probe = 0; probe < capacity; ++probe) {
+        const StoredEntry &entry = entries[index];
+        if (!entry.keyHash) {
+            found = false;
+            return static_cast<int>(index);
+        }
+
+        if (entry.keyHash == keyHash && entry.channelID == channelID
+                && sameString(entry.userIp, StoredEntry::IP_SIZE, userIp)
+                && sameString(entry.userName, StoredEntry::NAME_SIZE, userName)) {
+            found = true;
+            return static_cast<int>(index);
+        }
+
+        index = (index + 1) & (capacity - 1);
+    }
+
+    found = false;
+    return -1; // never happens, the table is never full
+}
+
+void UsersDataCache::insertEntry(const StoredEntry &entry)
+{
+    StoredEntry *entries = getEntries();
+    quint32 index = entry.keyHash & (capacity - 1);
+    while (entries[index].keyHash)
+        index = (index + 1) & (capacity - 1);
+
+    entries[index] = entry;
+    getHeader()->entries++;
+}
+
+quint32 UsersDataCache::touch()
+{
+    return ++getHeader()->lruClock;
+}
+
+CacheEntry UsersDataCache::getUserCacheEntry(const QString &userIp, const QString &userName,
+                                             quint8 channelID)
+{
+    CacheEntry cacheEntry(userIp, userName, channelID); // using default values for pan, gain, mute, etc.
+
+    const QByteArray ip = cacheEntry.getUserIP().toUtf8();
+    const QByteArray name = userName.toUtf8();
+
+    bool found = false;
+    const int index = findEntry(computeKeyHash(ip, name, channelID), ip, name, channelID, found);
+    if (found) {
+        StoredEntry &entry = getEntries()[index];
+        entry.lastUse = touch();
+
+        cacheEntry.setMuted(entry.muted);
+        cacheEntry.setGain(entry.gain);
+        cacheEntry.setPan(entry.pan);
+        cacheEntry.setBoost(entry.boost);
+        cacheEntry.setLowCutState(entry.lowCutState);
+        cacheEntry.setInstrumentIndex(entry.instrumentIndex);
+    }
+
+    return cacheEntry;
+}
+
+void UsersDataCache::updateUserCacheEntry(CacheEntry cacheEntry)
+{
+    const QByteArray ip = cacheEntry.getUserIP().toUtf8();
+    const QByteArray name = cacheEntry.getUserName().toUtf8();
+    const quint8 channelID = cacheEntry.getChannelID();
+    const quint64 keyHash = computeKeyHash(ip, name, channelID);
+
+    bool found = false;
+    int index = findEntry(keyHash, ip, name, channelID, found);
+    if (!found && getHeader()->entries >= maxEntries) {
+        evictLeastRecentlyUsedEntries();
+        index = findEntry(keyHash, ip, name, channelID, found);
+    }
+
+    if (index < 0)
+        return;
+
+    // only this entry is changed in the mapped store
+    StoredEntry &entry = getEntries()[index];
+    if (!found) {
+        std::memset(&entry, 0, sizeof(StoredEntry));
+        entry.keyHash = keyHash;
+        entry.channelID = channelID;
+        copyString(entry.userIp, StoredEntry::IP_SIZE, ip);
+        copyString(entry.userName, StoredEntry::NAME_SIZE, name);
+        getHeader()->entries++;
+    }
+
+    entry.lastUse = touch();
+    entry.muted = cacheEntry.isMuted();
+    entry.gain = cacheEntry.getGain();
+    entry.pan = cacheEntry.getPan();
+    entry.boost = cacheEntry.getBoost();
+    entry.lowCutState = static_cast<quint8>(cacheEntry.getLowCutState());
+    entry.instrumentIndex = static_cast<qint8>(cacheEntry.getInstrumentIndex());
+}
+
+void UsersDataCache::importOldCacheFile()
+{
+    // the old cache file (all entries serialized with QDataStream) is imported in the store and deleted
+    if (!storeLock.isLocked())
+        return; // imported by the instance writing in the store
+
+    QFile cacheFile(cacheDir.absoluteFilePath(CACHE_FILE_NAME));
+    if (!cacheFile.open(QFile::ReadOnly))
+        return;
+
+    QMap<QString, CacheEntry> cacheEntries;
+    QDataStream stream(&cacheFile);
+
+    CacheHeader cacheHeader;
+    stream >> cacheHeader;
+    quint32 expectedHeaderRevision = UsersDataCacheHeader::REVISION;
+    if (cacheHeader.isValid(expectedHeaderRevision))
+        stream >> cacheEntries;
+    else
+        qCritical() << "Invalid cache header when loading users data cache.";
+
+    for (const CacheEntry &entry : cacheEntries)
+        updateUserCacheEntry(entry);
+
+    qCDebug(jtCache) << "Tracks cache items imported from old cache file: " << cacheEntries.size();
+
+    cacheFile.close();
+    cacheFile.remove();
 }
 
 // ++++++++++++++++++
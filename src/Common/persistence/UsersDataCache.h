@@ -5,6 +5,9 @@
 #include <QMap>
 #include <QRegExp>
 #include <QDir>
+#include <QFile>
+#include <QLockFile>
+#include <QVector>
 
 /**
 
@@ -111,25 +114,62 @@ private:
 class UsersDataCache
 {
 public:
-    explicit UsersDataCache(const QDir &cacheDir);
+    explicit UsersDataCache(const QDir &cacheDir, quint32 maxEntries = DEFAULT_MAX_ENTRIES);
     ~UsersDataCache();
 
     // return default values for pan, gain and mute if user is not cached yet
     CacheEntry getUserCacheEntry(const QString &userIp, const QString &userName, quint8 channelID);
 
     void updateUserCacheEntry(CacheEntry entry);
+
+    quint32 getEntriesCount() const;
+
+    static const quint32 DEFAULT_MAX_ENTRIES;
+
 private:
-    QMap<QString, CacheEntry> cacheEntries;
+    /**
+     * The entries are stored in a memory mapped file, a fixed size hash table (open addressing) indexed by
+     * the hash of (ip, user name, channel). Lookups and updates touch just one entry, and only the changed
+     * entries are written to disk by the OS. When the table is full the least recently used entries are evicted.
+     */
+    struct StoreHeader;
+    struct StoredEntry;
 
     QDir cacheDir;
+    QLockFile storeLock; // only one cache instance (in all Jamtaba processes and plugin instances) is writing in the store
+    QFile storeFile;
+    QByteArray memoryStore; // used when the store file can't be mapped, the entries are not persisted
+    uchar *store;
+
+    const quint32 maxEntries;
+    const quint32 capacity; // hash table slots
+
+    StoreHeader *getHeader() const;
+    StoredEntry *getEntries() const;
+
+    void openStore();
+    void openStoreCopy(); // the store is locked by another instance, the changes are not persisted
+    bool isValidStore(const uchar *data, qint64 size, QVector<StoredEntry> &oldEntries) const;
+    void initializeStore(const QVector<StoredEntry> &entries);
+    void rebuild(const QVector<StoredEntry> &entries);
+    QVector<StoredEntry> getUsedEntries() const;
+    void evictLeastRecentlyUsedEntries();
+
+    int findEntry(quint64 keyHash, const QByteArray &userIp, const QByteArray &userName, quint8 channelID, bool &found) const;
+    void insertEntry(const StoredEntry &entry);
+    quint32 touch(); // LRU clock
+
+    void importOldCacheFile();
 
-    static QString getUserUniqueKey(const QString &userIp, const QString &userName,
-                                    quint8 channelID);
+    static quint64 computeKeyHash(const QByteArray &userIp, const QByteArray &userName, quint8 channelID);
+    static quint32 computeCapacity(quint32 maxEntries);
 
-    void loadCacheEntriesFromFile();
-    void writeCacheEntriesToFile();
+    static const quint32 STORE_SIGNATURE;
+    static const quint32 STORE_REVISION;
+    static const int STORE_LOCK_TIMEOUT;
 
-    const QString CACHE_FILE_NAME;
+    const QString CACHE_FILE_NAME; // old QDataStream cache file, imported once
+    const QString STORE_FILE_NAME;
 };
 
 }// namespace
@@ -5,22 +5,19 @@
 #include <QFile>
 #include <QFileInfo>
 
-FFMpegDemuxer::FFMpegDemuxer(QObject *parent, const QByteArray &encodedData) :
-    QObject(parent),
+FFMpegDemuxer::FFMpegDemuxer(const QByteArray &encodedData) :
     formatContext(nullptr),
     avioContext(nullptr),
     //codecContext(nullptr),
     swsContext(nullptr),
     frame(nullptr),
-    frameRGB(nullptr),
-    rgbBuffer(nullptr),
     buffer(nullptr),
-    encodedData(encodedData)
+    encodedData(encodedData),
+    finished(false),
+    decodedFrames(0)
 {
     av_register_all();
     avcodec_register_all();
-
-    qRegisterMetaType<QList<QImage>>();
 }
 
 FFMpegDemuxer::~FFMpegDemuxer()
@@ -35,24 +32,18 @@ void FFMpegDemuxer::close()
         formatContext = nullptr;
         avioContext = nullptr;
         //codecContext = nullptr;
+    }
+
+    if (swsContext) {
+        sws_freeContext(swsContext);
         swsContext = nullptr;
     }
 
     if (frame) {
-        av_free(frame);
+        av_frame_free(&frame);
         frame = nullptr;
     }
 
-    if (frameRGB) {
-        av_free(frameRGB);
-        frameRGB = nullptr;
-    }
-
-    if (rgbBuffer) {
-        delete [] rgbBuffer;
-        rgbBuffer = nullptr;
-    }
-
     if (buffer) {
         //av_free(buffer);
         buffer = nullptr;
@@ -138,96 +129,88 @@ uint FFMpegDemuxer::getFrameRate() const
     return 0;
 }
 
-void FFMpegDemuxer::decode()
+bool FFMpegDemuxer::decodeNextFrame(QImage &image)
 {
-    QList<QImage> decodedImages;
+    if (finished)
+        return false;
 
-    if (!open()) {
+    if (!formatContext && !open()) {
         qCritical() << "Can't open the video decoder!";
-        emit imagesDecoded(decodedImages, getFrameRate());
-        return;
+        finished = true;
+        return false;
     }
 
-    if (!formatContext || formatContext->nb_streams <= 0)
-        return;
-
     auto codecContext = formatContext->streams[0]->codec;
 
-    /* initialize packet, set data to NULL, let the demuxer fill it */
-    AVPacket packet;
-    packet.data = nullptr;
-    packet.size = 0;
-
-    int ret = 0;
-
-    /* read frames */
-    while ((ret = av_read_frame(formatContext, &packet)) == 0)
-    {
-
-        int framesDecoded = 0;
+    while (true) {
+        int ret = avcodec_receive_frame(codecContext, frame);
+        if (ret == 0) { // got a frame?
+            if (!frame->width || !frame->height) // 0 size images are skipped
+                continue;
 
-        while (framesDecoded <= 0)
-        {
-            ret = avcodec_send_packet(codecContext, &packet);
-
-            if (ret != 0) { // error
-                if (ret != AVERROR(EAGAIN)) {
-                    qCritical() << "error decoding video frame" << av_error_to_qt_string(ret) << ret;
-                    emit imagesDecoded(decodedImages, getFrameRate());
-                }
-                return;
+            if (!convertFrame(codecContext, image)) {
+                finished = true;
+                return false;
             }
 
-            while((ret = avcodec_receive_frame(codecContext, frame)) == 0)  // got a frame?
-            {
-                int width = (codecContext->width > 0) ? codecContext->width : frame->width;
-                int height = (codecContext->height > 0) ? codecContext->height : frame->height;
-
-                if (!frameRGB) {
-                    frameRGB = av_frame_alloc();
+            decodedFrames++;
+            return true;
+        }
 
-                    // Determine required buffer size and allocate buffer
-                    int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, width, height, 1);
-                    rgbBuffer = new uint8_t[numBytes];
+        if (ret != AVERROR(EAGAIN)) { // all frames decoded (AVERROR_EOF) or error
+            if (ret != AVERROR_EOF)
+                qCritical() << "error decoding video frame in avcodec_receive_frame" << av_error_to_qt_string(ret) << ret;
+            finished = true;
+            return false;
+        }
 
-                    // Assign appropriate parts of buffer to image planes in pFrameRGB
-                    av_image_fill_arrays(frameRGB->data, frameRGB->linesize, rgbBuffer, AV_PIX_FMT_RGB24, width, height, 1);
-                }
+        // the decoder need more packets to produce a frame
+        AVPacket packet;
+        av_init_packet(&packet);
+        packet.data = nullptr;
+        packet.size = 0;
 
-                // Convert the image format (init the context the first time)
-                AVPixelFormat sourcePixelFormat = codecContext->pix_fmt;
-                AVPixelFormat destinationPixelFormat = AV_PIX_FMT_RGB24;
+        if (av_read_frame(formatContext, &packet) == 0) {
+            ret = avcodec_send_packet(codecContext, &packet);
+            av_packet_unref(&packet);
+        }
+        else {
+            ret = avcodec_send_packet(codecContext, nullptr); // no more packets, flushing the frames buffered in decoder
+        }
 
-                if (!frame->width || !frame->height) // 0 size images are skipped
-                    continue;
+        if (ret != 0 && ret != AVERROR(EAGAIN)) {
+            if (ret != AVERROR_EOF)
+                qCritical() << "error decoding video frame" << av_error_to_qt_string(ret) << ret;
+            finished = true;
+            return false;
+        }
+    }
+}
 
-                swsContext = sws_getCachedContext(swsContext, width, height, sourcePixelFormat, width, height, destinationPixelFormat, SWS_BICUBIC, nullptr, nullptr, nullptr);
+bool FFMpegDemuxer::convertFrame(AVCodecContext *codecContext, QImage &image)
+{
+    int width = (codecContext->width > 0) ? codecContext->width : frame->width;
+    int height = (codecContext->height > 0) ? codecContext->height : frame->height;
 
-                if(!swsContext){
-                    qCritical() << "Cannot initialize the conversion context!";
-                    emit imagesDecoded(decodedImages, getFrameRate());
-                    return;
-                }
-                sws_scale(swsContext, frame->data, frame->linesize, 0, height, frameRGB->data, frameRGB->linesize);
+    // Convert the image format (init the context the first time)
+    AVPixelFormat sourcePixelFormat = codecContext->pix_fmt;
+    AVPixelFormat destinationPixelFormat = AV_PIX_FMT_RGB24;
 
-                // Convert the frame to QImage
-                QImage img(width, height, QImage::Format_RGB888);
+    swsContext = sws_getCachedContext(swsContext, width, height, sourcePixelFormat, width, height, destinationPixelFormat, SWS_BICUBIC, nullptr, nullptr, nullptr);
 
-                for(int y=0; y < height; y++)
-                    memcpy(img.scanLine(y), frameRGB->data[0] + y * frameRGB->linesize[0], width * 3);
+    if(!swsContext){
+        qCritical() << "Cannot initialize the conversion context!";
+        return false;
+    }
 
-                decodedImages << img;
+    if (image.width() != width || image.height() != height || image.format() != QImage::Format_RGB888)
+        image = QImage(width, height, QImage::Format_RGB888); // the recycled image can't be reused
 
-                framesDecoded++;
-            }
+    // converting directly in the image memory
+    uint8_t *destination[] = { image.bits() };
+    int destinationLineSize[] = { image.bytesPerLine() };
 
-            if (ret != 0 && ret != AVERROR(EAGAIN)) {
-                qCritical() << "error decoding video frame in avcodec_receive_frame" << av_error_to_qt_string(ret) << ret;
-                emit imagesDecoded(decodedImages, getFrameRate());
-                return;
-            }
-        }
-    }
+    sws_scale(swsContext, frame->data, frame->linesize, 0, height, destination, destinationLineSize);
 
-    emit imagesDecoded(decodedImages, getFrameRate());
+    return true;
 }
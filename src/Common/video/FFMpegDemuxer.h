@@ -8,37 +8,55 @@
 #include <QBuffer>
 #include <QImage>
 
-class FFMpegDemuxer : public QObject
-{
+/**
+ * Decode the video frames of one ninjam interval on demand, one frame per decodeNextFrame()
+ * call. Only the frame being decoded is in memory, the caller is responsible to keep (or recycle)
+ * the decoded images.
+ */
 
-    Q_OBJECT
+class FFMpegDemuxer
+{
 
 public:
-    FFMpegDemuxer(QObject *parent, const QByteArray &encodedData);
+    explicit FFMpegDemuxer(const QByteArray &encodedData);
     ~FFMpegDemuxer();
 
-    void decode();
+    // decode the next frame in 'image'. The image memory is reused if the image size is the same of decoded frame. Return false after the last frame or in errors.
+    bool decodeNextFrame(QImage &image);
+
+    bool isFinished() const;
+    uint getFrameRate() const;
+    uint getDecodedFrames() const;
 
-signals:
-    void imagesDecoded(QList<QImage> images, uint frameRate);
 private:
     AVFormatContext *formatContext;
     AVIOContext *avioContext;
     SwsContext *swsContext;
     AVFrame *frame;
-    AVFrame *frameRGB;
-    uint8_t *rgbBuffer;
 
     unsigned char *buffer; // avio buffer used in callback
 
     QByteArray encodedData;
     QBuffer encodedBuffer;
 
+    bool finished;
+    uint decodedFrames;
+
     static int readCallback(void *stream, uint8_t *buffer, int bufferSize);
 
     void close();
     bool open();
-    uint getFrameRate() const;
+    bool convertFrame(AVCodecContext *codecContext, QImage &image);
 };
 
+inline bool FFMpegDemuxer::isFinished() const
+{
+    return finished;
+}
+
+inline uint FFMpegDemuxer::getDecodedFrames() const
+{
+    return decodedFrames;
+}
+
 #endif // FFMPEGDEMUXER_H
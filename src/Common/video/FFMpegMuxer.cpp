@@ -74,6 +74,108 @@ public:
 
 // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
+ImageToYuvConverter::ImageToYuvConverter(Mode mode) :
+    mode(mode),
+    swsContext(nullptr)
+{
+
+}
+
+ImageToYuvConverter::~ImageToYuvConverter()
+{
+    if (swsContext)
+        sws_freeContext(swsContext);
+}
+
+void ImageToYuvConverter::convert(const QImage &image, AVFrame *frame)
+{
+    if (image.isNull() || !frame)
+        return;
+
+    bool rgb32Image = image.format() == QImage::Format_RGB32 || image.format() == QImage::Format_ARGB32 || image.format() == QImage::Format_ARGB32_Premultiplied;
+    if (!rgb32Image) {
+        convert(image.convertToFormat(QImage::Format_RGB32), frame);
+        return;
+    }
+
+    if (mode == FastConversion && frame->format == AV_PIX_FMT_YUV420P)
+        fastConvert(image, frame);
+    else
+        swsScaleConvert(image, frame);
+}
+
+void ImageToYuvConverter::swsScaleConvert(const QImage &image, AVFrame *frame)
+{
+    auto destinationFormat = static_cast<AVPixelFormat>(frame->format);
+    swsContext = sws_getCachedContext(swsContext, image.width(), image.height(), AV_PIX_FMT_RGB32,
+                                      frame->width, frame->height, destinationFormat, SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+    if (!swsContext) {
+        qCritical() << "Could not initialize the conversion context";
+        return;
+    }
+
+    const uint8_t *source[] = { image.constBits() };
+    const int sourceLineSize[] = { image.bytesPerLine() };
+
+    sws_scale(swsContext, source, sourceLineSize, 0, image.height(), frame->data, frame->linesize);
+}
+
+// fixed point (8 bits) version of RGBtoYUV macro coefficients
+static inline uint8_t rgbToY(int r, int g, int b)
+{
+    return static_cast<uint8_t>((77 * r + 151 * g + 28 * b) >> 8);
+}
+
+static inline uint8_t rgbToU(int r, int g, int b)
+{
+    return static_cast<uint8_t>((-44 * r - 84 * g + 128 * b + 32768) >> 8);
+}
+
+static inline uint8_t rgbToV(int r, int g, int b)
+{
+    return static_cast<uint8_t>((128 * r - 107 * g - 21 * b + 32768) >> 8);
+}
+
+void ImageToYuvConverter::fastConvert(const QImage &image, AVFrame *frame)
+{
+    //avoiding crash when camera preview is resized
+    const int width = qMin(frame->width, image.width());
+    const int height = qMin(frame->height, image.height());
+    const int chromaWidth = (width + 1) / 2;
+
+    // the frame planes are written directly, respecting the planes strides
+    for (int y = 0; y < height; y += 2) {
+        const int nextY = qMin(y + 1, height - 1);
+        const QRgb *line0 = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        const QRgb *line1 = reinterpret_cast<const QRgb *>(image.constScanLine(nextY));
+
+        uint8_t *yLine0 = frame->data[0] + y * frame->linesize[0];
+        uint8_t *yLine1 = frame->data[0] + nextY * frame->linesize[0];
+        uint8_t *uLine = frame->data[1] + (y / 2) * frame->linesize[1];
+        uint8_t *vLine = frame->data[2] + (y / 2) * frame->linesize[2];
+
+        for (int x = 0; x < width; ++x) {
+            yLine0[x] = rgbToY(qRed(line0[x]), qGreen(line0[x]), qBlue(line0[x]));
+            yLine1[x] = rgbToY(qRed(line1[x]), qGreen(line1[x]), qBlue(line1[x]));
+        }
+
+        // chroma is computed using the 2x2 pixels average
+        for (int x = 0; x < chromaWidth; ++x) {
+            const int x0 = x * 2;
+            const int x1 = qMin(x0 + 1, width - 1);
+            const int r = (qRed(line0[x0]) + qRed(line0[x1]) + qRed(line1[x0]) + qRed(line1[x1])) >> 2;
+            const int g = (qGreen(line0[x0]) + qGreen(line0[x1]) + qGreen(line1[x0]) + qGreen(line1[x1])) >> 2;
+            const int b = (qBlue(line0[x0]) + qBlue(line0[x1]) + qBlue(line1[x0]) + qBlue(line1[x1])) >> 2;
+            uLine[x] = rgbToU(r, g, b);
+            vLine[x] = rgbToV(r, g, b);
+        }
+    }
+}
+
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+const int FFMpegMuxer::MAX_PENDING_IMAGES = 2;
+
 FFMpegMuxer::FFMpegMuxer(QObject *parent) :
       QObject(parent),
       encodeVideo(false),
@@ -81,11 +183,16 @@ FFMpegMuxer::FFMpegMuxer(QObject *parent) :
       videoPts(0),
       encodedFrames(0),
       audioStream(nullptr),
+      codec(nullptr),
+      codecContext(nullptr),
+      frame(nullptr),
+      colorConversionMode(ImageToYuvConverter::FastConversion),
       videoResolution(QSize(320, 240)),
       videoFrameRate(25),
       videoBitRate(static_cast<uint>(FFMpegMuxer::VideoQualityLow)),
       initialized(false),
-      startNewIntervalRequested(false)
+      startNewIntervalRequested(false),
+      pendingImages(0)
 {
     av_register_all();
 
@@ -108,6 +215,7 @@ void FFMpegMuxer::initialize()
 FFMpegMuxer::~FFMpegMuxer()
 {
     finish();
+    threadPool.waitForDone();
 }
 
 void FFMpegMuxer::finish()
@@ -116,25 +224,37 @@ void FFMpegMuxer::finish()
 
 }
 
-void FFMpegMuxer::encodeImage(const QImage &image, bool async)
+bool FFMpegMuxer::encodeImage(const QImage &image, bool async)
 {
     // encoding in a separated thread
 
     auto lambda = [=](){
 
-        if (startNewIntervalRequested) {
-            if (prepareToEncodeNewInterval())
-                startNewIntervalRequested = false;
+        if (startNewIntervalRequested.testAndSetOrdered(1, 0)) {
+            if (!prepareToEncodeNewInterval())
+                startNewIntervalRequested.testAndSetOrdered(0, 1); // trying again in the next image
         }
 
         if (encodeVideo && !image.isNull())
             encodeVideo = !doEncodeVideoFrame(image);
     };
 
-    if (async)
-        QtConcurrent::run(&threadPool, lambda);
-    else
+    if (!async) {
         lambda();
+        return true;
+    }
+
+    // the encoding queue is bounded, images are dropped when the encoder can't keep up
+    if (pendingImages.loadAcquire() >= MAX_PENDING_IMAGES)
+        return false;
+
+    pendingImages.ref();
+    QtConcurrent::run(&threadPool, [=]() {
+        lambda();
+        pendingImages.deref();
+    });
+
+    return true;
 }
 
 void FFMpegMuxer::encodeAudioFrame()
@@ -149,7 +269,7 @@ void FFMpegMuxer::encodeAudioFrame()
 
 void FFMpegMuxer::startNewInterval()
 {
-    startNewIntervalRequested = true;
+    startNewIntervalRequested.storeRelease(1);
 }
 
 bool FFMpegMuxer::prepareToEncodeNewInterval()
@@ -161,6 +281,8 @@ bool FFMpegMuxer::prepareToEncodeNewInterval()
 
     initialize();
 
+    colorConverter.setMode(colorConversionMode);
+
     // Add the audio and video streams using the default format codecs and initialize the codecs.
 
     AVDictionary * opts = nullptr;
@@ -210,9 +332,6 @@ void FFMpegMuxer::finishCurrentInterval()
     if (frame)
         av_frame_free(&frame);
 
-    if (tempFrame)
-        av_frame_free(&tempFrame);
-
     if (codecContext)
         avcodec_free_context(&codecContext);
 
@@ -439,77 +558,9 @@ bool FFMpegMuxer::openVideoCodec(AVCodec *codec, AVDictionary **opts)
         return false;
     }
 
-    /* If the output format is not YUV420P, then a temporary YUV420P picture is needed too. It is then converted to the required output format. */
-    tempFrame = NULL;
-    if (codecContext->pix_fmt != AV_PIX_FMT_YUV420P) {
-        tempFrame = allocPicture(AV_PIX_FMT_YUV420P, codecContext->width, codecContext->height);
-        if (!tempFrame) {
-            qCritical() << "Could not allocate temporary picture";
-            return false;
-        }
-    }
-
     return true;
 }
 
-void FFMpegMuxer::imageToYuvPicture(const QImage &image, AVFrame *picture, int width, int height)
-{
-
-    //avoiding crash when camera preview is resized
-    width = qMin(width, image.width());
-    height = qMin(height, image.height());
-
-    // Preparing the buffer to get YUV420P data
-    int size = av_image_get_buffer_size(AV_PIX_FMT_YUV420P, width, height, 1);
-    uint8_t *pic_dat = (uint8_t *) av_malloc(size);
-
-    // Transforming data from RGB to YUV420P
-    RGBtoYUV420P(image.bits(), pic_dat, image.depth()/8, true, width, height);
-
-    picture->quality = 0;
-
-    // Filling AVFrame with YUV420P data
-    av_image_fill_arrays(picture->data, picture->linesize, pic_dat, AV_PIX_FMT_YUV420P, width, height, 1);
-}
-
-void FFMpegMuxer::RGBtoYUV420P(const uint8_t *bufferRGB, uint8_t *bufferYUV, uint rgbIncrement, bool swapRGB, int width, int height)
-{
-    const unsigned iPlaneSize = width * height;
-    const unsigned iHalfWidth = width >> 1;
-
-    // get pointers to the data
-    uint8_t *yplane  = bufferYUV;
-    uint8_t *uplane  = bufferYUV + iPlaneSize;
-    uint8_t *vplane  = bufferYUV + iPlaneSize + (iPlaneSize >> 2);
-    const uint8_t *bufferRGBIndex = bufferRGB;
-
-    int iRGBIdx[3];
-    iRGBIdx[0] = 0;
-    iRGBIdx[1] = 1;
-    iRGBIdx[2] = 2;
-    if (swapRGB)  {
-        iRGBIdx[0] = 2;
-        iRGBIdx[2] = 0;
-    }
-
-    for (int y = 0; y < (int) height; y++) {
-         uint8_t *yline  = yplane + (y * width);
-         uint8_t *uline  = uplane + ((y >> 1) * iHalfWidth);
-         uint8_t *vline  = vplane + ((y >> 1) * iHalfWidth);
-
-         for (int x=0; x<width; x+=2) {
-              RGBtoYUV(bufferRGBIndex[iRGBIdx[0]], bufferRGBIndex[iRGBIdx[1]], bufferRGBIndex[iRGBIdx[2]], *yline, *uline, *vline);
-              bufferRGBIndex += rgbIncrement;
-              yline++;
-              RGBtoYUV(bufferRGBIndex[iRGBIdx[0]], bufferRGBIndex[iRGBIdx[1]], bufferRGBIndex[iRGBIdx[2]], *yline, *uline, *vline);
-              bufferRGBIndex += rgbIncrement;
-              yline++;
-              uline++;
-              vline++;
-         }
-    }
-}
-
 void FFMpegMuxer::fillFrameWithImageData(const QImage &image)
 {
     /* when we pass a frame to the encoder, it may keep a reference to it internally; make sure we do not overwrite it here */
@@ -518,19 +569,8 @@ void FFMpegMuxer::fillFrameWithImageData(const QImage &image)
         return;
     }
 
-    if (codecContext->pix_fmt != AV_PIX_FMT_YUV420P) { /* need image convertion? as we only generate a YUV420P picture, we must convert it to the codec pixel format if needed */
-        if (!swsContext) {
-            swsContext = sws_getContext(image.width(), image.height(), AV_PIX_FMT_YUV420P, codecContext->width, codecContext->height, codecContext->pix_fmt, SWS_BICUBIC, NULL, NULL, NULL);
-            if (!swsContext) {
-                qCritical() << "Could not initialize the conversion context";
-                return;
-            }
-        }
-        imageToYuvPicture(image, tempFrame, codecContext->width, codecContext->height);
-        sws_scale(swsContext, (const uint8_t * const *)tempFrame->data, tempFrame->linesize, 0, codecContext->height, frame->data, frame->linesize);
-    } else {
-        imageToYuvPicture(image, frame, codecContext->width, codecContext->height);
-    }
+    // the image is converted directly in the frame planes, no memory is allocated per frame
+    colorConverter.convert(image, frame);
 
     frame->pts = videoPts++;
 }
@@ -562,9 +602,6 @@ bool FFMpegMuxer::doEncodeVideoFrame(const QImage &image)
     int ret = avcodec_send_frame(codecContext, (!image.isNull()) ? frame : nullptr);
 
     if (!image.isNull()) {
-        // releasing the allocated memory - fix https://github.com/elieserdejesus/JamTaba/issues/951
-        av_freep(frame);
-
         if (ret != 0 && ret != AVERROR_EOF) {
             qCritical() << "Error encoding video frame: " << av_error_to_qt_string(ret) << ret;
             return false;
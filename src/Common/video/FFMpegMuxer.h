@@ -7,11 +7,54 @@
 #include <QFile>
 #include <QDebug>
 #include <QThreadPool>
+#include <QAtomicInt>
 
 #include "FFMpegCommon.h"
 
 #include <memory>
 
+/**
+ * Convert the captured images (RGB32) to the encoder frame format. The 'Fast' mode is
+ * writing YUV420P directly in the frame planes using fixed point math in loops friendly
+ * to compiler auto-vectorization. The 'SwsScale' mode is using libswscale, supporting
+ * any frame format and rescaling images when the image and frame sizes are different.
+ */
+
+class ImageToYuvConverter
+{
+public:
+    enum Mode
+    {
+        FastConversion,
+        SwsScaleConversion
+    };
+
+    explicit ImageToYuvConverter(Mode mode = FastConversion);
+    ~ImageToYuvConverter();
+
+    void setMode(Mode mode);
+    Mode getMode() const;
+
+    void convert(const QImage &image, AVFrame *frame);
+
+private:
+    Mode mode;
+    SwsContext *swsContext;
+
+    void fastConvert(const QImage &image, AVFrame *frame);
+    void swsScaleConvert(const QImage &image, AVFrame *frame);
+};
+
+inline void ImageToYuvConverter::setMode(Mode mode)
+{
+    this->mode = mode;
+}
+
+inline ImageToYuvConverter::Mode ImageToYuvConverter::getMode() const
+{
+    return mode;
+}
+
 // adapted from FFMpeg muxing.c example
 
 class FFMpegMuxer : public QObject
@@ -24,7 +67,7 @@ public:
 
     void finish();
 
-    void encodeImage(const QImage &image, bool async = true);
+    bool encodeImage(const QImage &image, bool async = true); // return false if the image is dropped because the encoder is busy
     void encodeAudioFrame();
 
     void setVideoResolution(const QSize &resolution);
@@ -32,6 +75,8 @@ public:
 
     void setVideoFrameRate(qreal frameRate);
 
+    void setColorConversionMode(ImageToYuvConverter::Mode mode); // used in the next interval
+
     enum VideoQuality
     {
         VideoQualityLow    = 64000,     // 64 kbps
@@ -71,9 +116,7 @@ private:
 
     AVFrame *allocAudioFrame(enum AVSampleFormat sampleFormat, uint64_t channelLayout, int sampleRate, int nbSamples);
     AVFrame *allocPicture(enum AVPixelFormat pixelFormat, int width, int height);
-    void imageToYuvPicture(const QImage &image, AVFrame *picture, int width, int height);
     void fillFrameWithImageData(const QImage &image);
-    void RGBtoYUV420P(const uint8_t *bufferRGB, uint8_t *bufferYUV, uint rgbIncrement, bool swapRGB, int width, int height);
 
     void initialize();
 
@@ -92,18 +135,22 @@ private:
 
     AVCodec *codec;
     AVCodecContext *codecContext;
-    AVFrame *frame;
-    AVFrame *tempFrame;
-    SwsContext *swsContext;
+    AVFrame *frame; // allocated when the interval is started and reused in all interval frames
+
+    ImageToYuvConverter colorConverter;
+    ImageToYuvConverter::Mode colorConversionMode;
 
     QSize videoResolution;
     qreal videoFrameRate;
     uint videoBitRate;
 
     bool initialized;
-    bool startNewIntervalRequested;
+    QAtomicInt startNewIntervalRequested; // set in any thread, the new interval is prepared in the encoding thread
 
     QThreadPool threadPool;
+
+    QAtomicInt pendingImages; // images waiting in the encoding thread queue
+    static const int MAX_PENDING_IMAGES;
 };
 
 inline void FFMpegMuxer::setVideoQuality(VideoQuality quality)
@@ -116,6 +163,11 @@ inline void FFMpegMuxer::setVideoFrameRate(qreal frameRate)
     this->videoFrameRate = frameRate;
 }
 
+inline void FFMpegMuxer::setColorConversionMode(ImageToYuvConverter::Mode mode)
+{
+    this->colorConversionMode = mode;
+}
+
 inline int64_t FFMpegMuxer::getCurrentVideoPresentationTimeStamp() const
 {
     return videoPts;
@@ -0,0 +1,176 @@
+#include "RemoteVideoStream.h"
+#include "FFMpegDemuxer.h"
+
+#include <QMutexLocker>
+#include <QtConcurrent>
+
+const int RemoteVideoStream::MAX_DECODED_FRAMES = 3;
+const uint RemoteVideoStream::DEFAULT_FRAME_RATE = 10;
+
+RemoteVideoStream::RemoteVideoStream() :
+    intervalChanged(false),
+    intervalDecoded(false),
+    playing(false),
+    frameRate(DEFAULT_FRAME_RATE),
+    decoding(false),
+    stopRequested(false)
+{
+
+}
+
+RemoteVideoStream::~RemoteVideoStream()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopRequested = true;
+    }
+
+    decodingFuture.waitForFinished();
+}
+
+void RemoteVideoStream::addInterval(const QByteArray &encodedVideoData)
+{
+    QMutexLocker locker(&mutex);
+
+    pendingInterval = encodedVideoData; // keep just the last received interval
+
+    if (!playing)
+        playPendingInterval();
+}
+
+bool RemoteVideoStream::startNewInterval()
+{
+    QMutexLocker locker(&mutex);
+
+    if (!pendingInterval.isEmpty())
+        playPendingInterval();
+
+    return playing;
+}
+
+void RemoteVideoStream::playPendingInterval()
+{
+    currentInterval = pendingInterval;
+    pendingInterval.clear();
+
+    intervalChanged = true;
+    intervalDecoded = false;
+    playing = true;
+
+    // discarding the non displayed frames of the previous interval
+    for (const auto &decodedFrame : decodedFrames)
+        recycleFrame(decodedFrame.image);
+    decodedFrames.clear();
+
+    intervalTimer.start();
+
+    startDecoding();
+}
+
+bool RemoteVideoStream::getNextFrame(QImage &frame)
+{
+    QMutexLocker locker(&mutex);
+
+    recycleDisplayedFrames();
+
+    if (!playing)
+        return false;
+
+    const uint currentFrame = static_cast<uint>(intervalTimer.elapsed() * frameRate / 1000);
+
+    // skipping late frames when the decoding is slower than the frame rate
+    while (decodedFrames.size() > 1 && decodedFrames.at(1).index <= currentFrame)
+        recycleFrame(decodedFrames.takeFirst().image);
+
+    bool hasNewFrame = false;
+    if (!decodedFrames.isEmpty() && decodedFrames.first().index <= currentFrame) {
+        frame = decodedFrames.takeFirst().image;
+        displayedFrames.append(frame);
+        hasNewFrame = true;
+    }
+
+    if (intervalDecoded && decodedFrames.isEmpty()) { // all interval frames were displayed
+        playing = false;
+        if (!pendingInterval.isEmpty())
+            playPendingInterval();
+    }
+    else {
+        startDecoding(); // decoding the next frames while the current frame is displayed
+    }
+
+    return hasNewFrame;
+}
+
+void RemoteVideoStream::recycleFrame(const QImage &frame)
+{
+    if (!frame.isNull() && framesPool.size() < MAX_DECODED_FRAMES)
+        framesPool.append(frame);
+}
+
+void RemoteVideoStream::recycleDisplayedFrames()
+{
+    // the displayed frames are recycled only when GUI is not using them anymore
+    for (int i = displayedFrames.size() - 1; i >= 0; --i) {
+        if (displayedFrames.at(i).isDetached())
+            recycleFrame(displayedFrames.takeAt(i));
+    }
+
+    while (displayedFrames.size() > MAX_DECODED_FRAMES) // GUI is holding the frames, just forget them
+        displayedFrames.removeFirst();
+}
+
+void RemoteVideoStream::startDecoding()
+{
+    const bool needDecoding = intervalChanged || (!intervalDecoded && decodedFrames.size() < MAX_DECODED_FRAMES);
+
+    if (needDecoding && !decoding && !stopRequested) {
+        decoding = true;
+        decodingFuture = QtConcurrent::run(this, &RemoteVideoStream::decode);
+    }
+}
+
+void RemoteVideoStream::decode()
+{
+    QMutexLocker locker(&mutex);
+
+    while (!stopRequested) {
+        if (intervalChanged) {
+            intervalChanged = false;
+            QByteArray encodedVideoData = currentInterval;
+
+            locker.unlock();
+            demuxer.reset(new FFMpegDemuxer(encodedVideoData)); // the old demuxer is destroyed out of the lock
+            locker.relock();
+            continue;
+        }
+
+        if (!demuxer || intervalDecoded || decodedFrames.size() >= MAX_DECODED_FRAMES)
+            break;
+
+        QImage image = framesPool.isEmpty() ? QImage() : framesPool.takeLast();
+
+        locker.unlock();
+        bool frameDecoded = demuxer->decodeNextFrame(image);
+        locker.relock();
+
+        if (intervalChanged) { // the frame is from the previous interval
+            recycleFrame(image);
+            continue;
+        }
+
+        if (frameDecoded) {
+            DecodedFrame decodedFrame;
+            decodedFrame.image = image;
+            decodedFrame.index = demuxer->getDecodedFrames() - 1;
+            decodedFrames.append(decodedFrame);
+
+            uint demuxerFrameRate = demuxer->getFrameRate();
+            frameRate = demuxerFrameRate > 0 ? demuxerFrameRate : DEFAULT_FRAME_RATE;
+        }
+        else {
+            intervalDecoded = true;
+        }
+    }
+
+    decoding = false;
+}
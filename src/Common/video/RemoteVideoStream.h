@@ -0,0 +1,75 @@
+#ifndef REMOTE_VIDEO_STREAM_H
+#define REMOTE_VIDEO_STREAM_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QFuture>
+#include <QElapsedTimer>
+#include <QScopedPointer>
+
+class FFMpegDemuxer;
+
+/**
+ * Play the video intervals received from a remote user. The frames are decoded in a
+ * background thread just a few frames ahead of the displayed frame, and the decoded images
+ * are recycled, so just a handful of frames are in memory for each remote video. The
+ * frames are paced using the time elapsed since the interval playback started.
+ */
+
+class RemoteVideoStream
+{
+public:
+    RemoteVideoStream();
+    ~RemoteVideoStream();
+
+    void addInterval(const QByteArray &encodedVideoData);
+
+    // called when a new ninjam interval is started. Return false if there is no video to play.
+    bool startNewInterval();
+
+    // return true and the frame in 'frame' if is time to show a new frame
+    bool getNextFrame(QImage &frame);
+
+    static const int MAX_DECODED_FRAMES;
+    static const uint DEFAULT_FRAME_RATE;
+
+private:
+    struct DecodedFrame
+    {
+        QImage image;
+        uint index; // frame index in the interval
+    };
+
+    void decode(); // called in a background thread
+
+    void startDecoding();
+    void playPendingInterval();
+
+    void recycleFrame(const QImage &frame);
+    void recycleDisplayedFrames();
+
+    QMutex mutex; // protecting all members, except the demuxer (used only in decoding thread)
+
+    QScopedPointer<FFMpegDemuxer> demuxer;
+
+    QByteArray pendingInterval; // received interval waiting the current interval finish
+    QByteArray currentInterval;
+    bool intervalChanged; // decoding thread need create a new demuxer
+    bool intervalDecoded; // all frames of the current interval are decoded
+    bool playing;
+
+    QList<DecodedFrame> decodedFrames;
+    QList<QImage> framesPool; // recycled images
+    QList<QImage> displayedFrames; // images still used by GUI, recycled when GUI release them
+
+    uint frameRate;
+    QElapsedTimer intervalTimer;
+
+    bool decoding;
+    bool stopRequested;
+    QFuture<void> decodingFuture;
+};
+
+#endif
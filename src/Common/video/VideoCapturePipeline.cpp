@@ -0,0 +1,112 @@
+#include "VideoCapturePipeline.h"
+#include "FFMpegMuxer.h"
+#include "log/Logging.h"
+
+#include <QMutexLocker>
+#include <QDateTime>
+
+VideoCapturePipeline::VideoCapturePipeline(FFMpegMuxer *encoder, quint8 frameRate) :
+    encoder(encoder),
+    timeBetweenFrames(1000 / qMax(frameRate, static_cast<quint8>(1))),
+    lastFrameTimeStamp(0),
+    droppedFrames(0),
+    encoding(false),
+    newIntervalStarted(false),
+    stopRequested(false)
+{
+    start();
+}
+
+VideoCapturePipeline::~VideoCapturePipeline()
+{
+    stop();
+    wait();
+}
+
+void VideoCapturePipeline::stop()
+{
+    QMutexLocker locker(&mutex);
+    stopRequested = true;
+    hasFrameToProcess.wakeAll();
+}
+
+void VideoCapturePipeline::setEncoding(bool encoding)
+{
+    QMutexLocker locker(&mutex);
+    if (this->encoding != encoding) {
+        this->encoding = encoding;
+        if (!encoding) {
+            pendingFrame = QImage();
+
+            if (droppedFrames > 0)
+                qCWarning(jtVideo) << "Video encoding stopped," << droppedFrames << "frames dropped because the encoder was busy";
+        }
+        droppedFrames = 0; // counting the dropped frames in each encoding session
+    }
+}
+
+void VideoCapturePipeline::startNewInterval()
+{
+    QMutexLocker locker(&mutex);
+    newIntervalStarted = true;
+    encoder->startNewInterval();
+    hasFrameToProcess.wakeAll();
+}
+
+void VideoCapturePipeline::pushFrame(const QImage &frame)
+{
+    QMutexLocker locker(&mutex);
+    if (!encoding || frame.isNull())
+        return;
+
+    pendingFrame = frame; // a pending frame is just replaced, the camera frame rate is higher than the video frame rate
+    hasFrameToProcess.wakeAll();
+}
+
+QImage VideoCapturePipeline::prepareFrame(const QImage &frame) const
+{
+    // scale the grabed frame if is bigger than video resolution. This is necessary because some cameras
+    // have only big resolutions, and we have problems sending big resolution videos to ninjam servers.
+
+    const QSize videoResolution = encoder->getVideoResolution();
+    if (frame.width() > videoResolution.width())
+        return frame.scaled(videoResolution, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    return frame;
+}
+
+void VideoCapturePipeline::run()
+{
+    QMutexLocker locker(&mutex);
+
+    while (!stopRequested) {
+        if (pendingFrame.isNull()) {
+            hasFrameToProcess.wait(&mutex);
+            continue;
+        }
+
+        // waiting the video frame rate time, a newer frame can replace the pending frame while waiting
+        const quint64 now = QDateTime::currentMSecsSinceEpoch();
+        const quint64 elapsedTime = now - lastFrameTimeStamp;
+        if (!newIntervalStarted && elapsedTime < timeBetweenFrames) {
+            hasFrameToProcess.wait(&mutex, timeBetweenFrames - elapsedTime);
+            continue;
+        }
+
+        QImage frame = pendingFrame;
+        pendingFrame = QImage();
+        newIntervalStarted = false;
+        lastFrameTimeStamp = now;
+
+        locker.unlock();
+
+        bool accepted = encoder->encodeImage(prepareFrame(frame)); // encoded in the encoder thread
+
+        locker.relock();
+
+        if (!accepted)
+            droppedFrames++;
+    }
+
+    qCDebug(jtVideo) << "Video capture pipeline stopped";
+}
@@ -0,0 +1,55 @@
+#ifndef VIDEO_CAPTURE_PIPELINE_H
+#define VIDEO_CAPTURE_PIPELINE_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QImage>
+
+class FFMpegMuxer;
+
+/**
+ * Camera frames pipeline: capture -> prepare (scale) -> encode. The camera frames are pushed
+ * in any thread, the frames are prepared in this thread and encoded in the FFMpegMuxer thread.
+ * Each stage holds at most a few frames, the old frames are dropped when the next stage is busy,
+ * so a busy GUI thread is not delaying the video and the encoder is not stalling the GUI.
+ */
+
+class VideoCapturePipeline : public QThread
+{
+    Q_OBJECT
+
+public:
+    VideoCapturePipeline(FFMpegMuxer *encoder, quint8 frameRate);
+    ~VideoCapturePipeline();
+
+    void setEncoding(bool encoding);
+    void startNewInterval(); // the next frame is encoded without wait the frame rate time
+
+    void stop();
+
+public slots:
+    void pushFrame(const QImage &frame); // thread safe, a non processed frame is replaced by the new frame
+
+protected:
+    void run() override;
+
+private:
+    QImage prepareFrame(const QImage &frame) const;
+
+    FFMpegMuxer *encoder;
+    const quint64 timeBetweenFrames; // in milliseconds
+
+    QMutex mutex;
+    QWaitCondition hasFrameToProcess;
+
+    QImage pendingFrame;
+    quint64 lastFrameTimeStamp;
+    quint64 droppedFrames; // logged when the encoding is stopped
+
+    bool encoding;
+    bool newIntervalStarted;
+    bool stopRequested;
+};
+
+#endif
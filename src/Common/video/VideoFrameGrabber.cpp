@@ -19,11 +19,13 @@ bool CameraFrameGrabber::present(const QVideoFrame& frame)
 
             QImage::Format imageFormat = QVideoFrame::imageFormatFromPixelFormat(cloneFrame.pixelFormat());
             if (imageFormat != QImage::Format_Invalid) {
-                lastImage = QImage(cloneFrame.bits(), cloneFrame.width(), cloneFrame.height(), imageFormat)
-                        .copy(); // necessary
+                QImage mappedImage(cloneFrame.bits(), cloneFrame.width(), cloneFrame.height(), cloneFrame.bytesPerLine(), imageFormat);
 
+                // the frame memory is copied just one time, mirrored() is creating a new image
 #ifdef Q_OS_WIN
-                lastImage = lastImage.mirrored(false, true);
+                lastImage = mappedImage.mirrored(false, true);
+#else
+                lastImage = mappedImage.copy(); // necessary, the mapped memory is released in unmap()
 #endif
 
                 emit frameAvailable(lastImage);
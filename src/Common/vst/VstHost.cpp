@@ -21,7 +21,8 @@ VstHost *VstHost::getInstance()
 }
 
 VstHost::VstHost() :
-    blockSize(0)
+    blockSize(0),
+    callbackDeadline(0)
 {
     clearVstTimeInfoFlags();
 }
@@ -56,14 +57,13 @@ void VstHost::setPlayingFlag(bool playing)
         clearVstTimeInfoFlags();
 }
 
-std::vector<midi::MidiMessage> VstHost::pullReceivedMidiMessages()
+void VstHost::pullReceivedMidiMessages(midi::MidiBuffer &outBuffer)
 {
-    std::vector<midi::MidiMessage> messages(receivedMidiMessages);
+    outBuffer.append(receivedMidiMessages);
     receivedMidiMessages.clear();
-    return messages;
 }
 
-void VstHost::setPositionInSamples(int intervalPosition)
+void VstHost::setPositionInSamples(qint64 intervalPosition)
 {
     vstTimeInfo.samplePos = intervalPosition;
 
@@ -197,6 +197,7 @@ long VSTCALLBACK VstHost::hostCallback(AEffect *effect, long opcode, long index,
                 if (vstEvents->events[i]->type == kVstMidiType) {
                     VstMidiEvent *vstMidiEvent = (VstMidiEvent *)vstEvents->events[i];
                     auto msg = midi::MidiMessage::fromArray(vstMidiEvent->midiData);
+                    msg.setDeltaFrames(vstMidiEvent->deltaFrames); // keeping the plugin timing when the messages are routed to other plugins
                     hostInstance->receivedMidiMessages.push_back(msg);
                 }
             }
@@ -30,13 +30,41 @@ public:
         return blockSize;
     }
 
-    std::vector<midi::MidiMessage> pullReceivedMidiMessages() override;
+    // transport state, sent to the plugins running in sandbox processes
+    inline int getTempo() const
+    {
+        return tempoIsValid() ? static_cast<int>(vstTimeInfo.tempo) : 0;
+    }
+
+    inline bool isPlaying() const
+    {
+        return vstTimeInfo.flags & kVstTransportPlaying;
+    }
+
+    inline qint64 getPositionInSamples() const
+    {
+        return static_cast<qint64>(vstTimeInfo.samplePos);
+    }
+
+    // the end of the current audio callback in AudioLoadMonitor::timestamp() nanoseconds (0 when unknown),
+    // the plugins running in sandbox processes are not waiting their responses beyond it. Audio thread only.
+    inline qint64 getCallbackDeadline() const
+    {
+        return callbackDeadline;
+    }
+
+    inline void setCallbackDeadline(qint64 deadline)
+    {
+        callbackDeadline = deadline;
+    }
+
+    void pullReceivedMidiMessages(midi::MidiBuffer &outBuffer) override;
 
     void setSampleRate(int sampleRate) override;
     void setBlockSize(int blockSize) override;
     void setTempo(int bpm) override;
     void setPlayingFlag(bool playing) override;
-    void setPositionInSamples(int intervalPosition) override;
+    void setPositionInSamples(qint64 intervalPosition) override;
 
 protected:
     static long VSTCALLBACK hostCallback(AEffect *effect, long opcode, long index, long value,
@@ -49,6 +77,7 @@ private:
     VstTimeInfo vstTimeInfo;
 
     int blockSize;
+    qint64 callbackDeadline;
 
     void clearVstTimeInfoFlags();
 
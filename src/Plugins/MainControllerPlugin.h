@@ -65,15 +65,15 @@ public:
 
     Preset loadPreset(const QString &name) override;
 
-    inline std::vector<midi::MidiMessage> pullMidiMessagesFromPlugins() override
+    inline void pullMidiMessagesFromPlugins(midi::MidiBuffer &outBuffer) override
     {
-        return std::vector<midi::MidiMessage>(); // empty buffer
+        Q_UNUSED(outBuffer) // no messages
     }
 
 protected:
-    inline std::vector<midi::MidiMessage> pullMidiMessagesFromDevices() override
+    inline void pullMidiMessagesFromDevices(midi::MidiBuffer &outBuffer) override
     {
-        return std::vector<midi::MidiMessage>(); // empty buffer
+        Q_UNUSED(outBuffer) // no messages
     }
 
     JamTabaPlugin *plugin;
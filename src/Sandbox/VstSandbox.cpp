@@ -0,0 +1,375 @@
+#include "VstSandbox.h"
+
+#include "vst/VstHost.h"
+#include "vst/VstLoader.h"
+#include "vst/Utils.h"
+#include "log/Logging.h"
+
+#include <QApplication>
+#include <QDesktopWidget>
+#include <QStringList>
+#include <QPoint>
+#include <QDebug>
+
+#include <iostream>
+#include <string>
+#include <cstring>
+
+using audio::PluginSandboxChannel;
+
+SandboxCommandsReader::SandboxCommandsReader(QObject *parent) :
+    QThread(parent)
+{
+
+}
+
+void SandboxCommandsReader::run()
+{
+    std::string line;
+    while (std::getline(std::cin, line))
+        emit commandReceived(QString::fromStdString(line).trimmed());
+
+    emit inputClosed();
+}
+
+// ++++++++++++++++++++++++++++++++++++++
+
+VstSandbox::ProcessingThread::ProcessingThread(VstSandbox *sandbox) :
+    sandbox(sandbox)
+{
+
+}
+
+void VstSandbox::ProcessingThread::run()
+{
+    auto channel = sandbox->channel.data();
+    while (sandbox->running.loadAcquire() && !channel->isShutdown()) {
+        auto block = channel->waitRequest(100000); // 100 ms, checking the shutdown flag when Jamtaba is not processing
+        if (!block)
+            continue;
+
+        {
+            QMutexLocker locker(&sandbox->processMutex);
+            sandbox->processBlock(block);
+        }
+
+        channel->finishRequest();
+    }
+}
+
+// ++++++++++++++++++++++++++++++++++++++
+
+VstSandbox::VstSandbox() :
+    effect(nullptr),
+    host(vst::VstHost::getInstance()),
+    commandsReader(nullptr),
+    running(0),
+    bypassed(0),
+    wantMidi(false)
+{
+    editorIdleTimer.setInterval(30);
+    connect(&editorIdleTimer, &QTimer::timeout, this, &VstSandbox::idleEditor);
+
+    connect(host, &vst::VstHost::pluginRequestingWindowResize, this, &VstSandbox::resizeEditor);
+}
+
+VstSandbox::~VstSandbox()
+{
+    running.storeRelease(0);
+    if (processingThread)
+        processingThread->wait();
+
+    if (commandsReader && commandsReader->isRunning()) { // blocked reading stdin
+        commandsReader->terminate();
+        commandsReader->wait(100);
+    }
+
+    if (effect) {
+        closeEditor();
+
+        effect->dispatcher(effect, effStopProcess, 0, 1, NULL, 0.0f);
+        effect->dispatcher(effect, effMainsChanged, 0, 0, NULL, 0.0f);
+
+        vst::VstLoader::unload(effect);
+        effect = nullptr;
+    }
+}
+
+bool VstSandbox::start(const QStringList &arguments)
+{
+    // the first argument is the executable path
+    if (arguments.size() < 5) {
+        writeToJamtaba("JT-Sandbox-Error: missing arguments");
+        return false;
+    }
+
+    pluginPath = arguments.at(1);
+    const QString channelKey = arguments.at(2);
+    const int sampleRate = arguments.at(3).toInt();
+    const int blockSize = arguments.at(4).toInt();
+
+    channel.reset(new PluginSandboxChannel(channelKey));
+    if (!channel->attach()) {
+        writeToJamtaba("JT-Sandbox-Error: can't attach the shared memory");
+        return false;
+    }
+
+    host->setSampleRate(sampleRate);
+    host->setBlockSize(blockSize);
+
+    effect = vst::VstLoader::load(pluginPath, host);
+    if (!effect) {
+        writeToJamtaba("JT-Sandbox-Error: can't load " + pluginPath);
+        return false;
+    }
+
+    // same initialization sequence used in vst::VstPlugin::start()
+    effect->dispatcher(effect, effSetSampleRate, 0, 0, NULL, sampleRate);
+    effect->dispatcher(effect, effSetBlockSize, 0, blockSize, NULL, 0.0f);
+    effect->dispatcher(effect, effOpen, 0, 0, NULL, 0.0f);
+    effect->dispatcher(effect, effSetSampleRate, 0, 0, NULL, sampleRate);
+    effect->dispatcher(effect, effSetBlockSize, 0, blockSize, NULL, 0.0f);
+
+    wantMidi = effect->dispatcher(effect, effCanDo, 0, 0, (void*)"receiveVstMidiEvent", 0) == 1;
+
+    // preallocating the processing buffers
+    const int maxChannels = PluginSandboxChannel::MAX_CHANNELS;
+    inputs.resize(effect->numInputs);
+    outputs.resize(effect->numOutputs);
+    const int extra = qMax(0, effect->numInputs - maxChannels) + qMax(0, effect->numOutputs - maxChannels);
+    extraChannels.resize(extra, std::vector<float>(PluginSandboxChannel::MAX_FRAMES));
+
+    midiEvents.resize(PluginSandboxChannel::MAX_MIDI_EVENTS);
+    vstEventsMemory.resize(sizeof(VstEvents) + PluginSandboxChannel::MAX_MIDI_EVENTS * sizeof(VstEvent *));
+
+    effect->dispatcher(effect, effMainsChanged, 0, 1, NULL, 0.0f);
+    effect->dispatcher(effect, effStartProcess, 0, 1, NULL, 0.0f);
+
+    running.storeRelease(1);
+    processingThread.reset(new ProcessingThread(this));
+    processingThread->start(QThread::TimeCriticalPriority);
+
+    commandsReader = new SandboxCommandsReader(this);
+    connect(commandsReader, &SandboxCommandsReader::commandReceived, this, &VstSandbox::executeCommand);
+    connect(commandsReader, &SandboxCommandsReader::inputClosed, this, &VstSandbox::quit);
+    commandsReader->start();
+
+    const auto descriptor = vst::utils::createDescriptor(effect, pluginPath);
+    const bool isSynth = effect->flags & effFlagsIsSynth;
+    const bool hasEditor = effect->flags & effFlagsHasEditor;
+
+    writeToJamtaba(QString("JT-Sandbox-Ready: %1 %2 %3 %4 %5")
+                   .arg(effect->numInputs)
+                   .arg(effect->numOutputs)
+                   .arg(isSynth ? 1 : 0)
+                   .arg(hasEditor ? 1 : 0)
+                   .arg(descriptor.getName()));
+
+    return true;
+}
+
+void VstSandbox::processBlock(PluginSandboxChannel::Block *block)
+{
+    const int frames = qBound(0, static_cast<int>(block->frames), PluginSandboxChannel::MAX_FRAMES);
+    const int maxChannels = PluginSandboxChannel::MAX_CHANNELS;
+
+    host->setPlayingFlag(block->playing != 0);
+    if (block->tempo > 0)
+        host->setTempo(block->tempo);
+    host->setPositionInSamples(block->positionInSamples);
+
+    int extraChannel = 0;
+    for (int c = 0; c < effect->numInputs; ++c) {
+        if (c < maxChannels) {
+            if (c >= block->inputChannels)
+                std::memset(block->input[c], 0, frames * sizeof(float));
+            inputs[c] = block->input[c];
+        }
+        else {
+            inputs[c] = extraChannels[extraChannel++].data();
+            std::memset(inputs[c], 0, frames * sizeof(float));
+        }
+    }
+
+    for (int c = 0; c < effect->numOutputs; ++c)
+        outputs[c] = c < maxChannels ? block->output[c] : extraChannels[extraChannel++].data();
+
+    block->outputChannels = qMin(effect->numOutputs, maxChannels);
+
+    if (bypassed.loadAcquire() || !(effect->flags & effFlagsCanReplacing)) {
+        block->outputChannels = 0; // Jamtaba keep the input samples
+        return;
+    }
+
+    if (wantMidi) {
+        fillVstEvents(block);
+        effect->dispatcher(effect, effProcessEvents, 0, 0, vstEventsMemory.data(), 0);
+    }
+
+    effect->processReplacing(effect, inputs.data(), outputs.data(), frames);
+}
+
+void VstSandbox::fillVstEvents(const PluginSandboxChannel::Block *block)
+{
+    auto events = reinterpret_cast<VstEvents *>(vstEventsMemory.data());
+    const int count = qBound(0, static_cast<int>(block->midiEventsCount), PluginSandboxChannel::MAX_MIDI_EVENTS);
+
+    events->numEvents = count;
+    events->reserved = 0;
+
+    for (int m = 0; m < count; ++m) {
+        const auto &message = block->midiEvents[m];
+        VstMidiEvent &vstEvent = midiEvents[m];
+        std::memset(&vstEvent, 0, sizeof(VstMidiEvent));
+        vstEvent.type = kVstMidiType;
+        vstEvent.byteSize = sizeof(VstMidiEvent);
+        vstEvent.deltaFrames = message.deltaFrames;
+        vstEvent.midiData[0] = message.data & 0xFF;
+        vstEvent.midiData[1] = (message.data >> 8) & 0xFF;
+        vstEvent.midiData[2] = (message.data >> 16) & 0xFF;
+        vstEvent.flags = kVstMidiEventIsRealtime;
+        events->events[m] = reinterpret_cast<VstEvent *>(&vstEvent);
+    }
+}
+
+void VstSandbox::executeCommand(const QString &command)
+{
+    if (command.isEmpty() || !effect)
+        return;
+
+    const QString name = command.section(' ', 0, 0);
+    const QString parameters = command.section(' ', 1);
+
+    if (name == "open-editor") {
+        openEditor(QPoint(parameters.section(' ', 0, 0).toInt(), parameters.section(' ', 1, 1).toInt()));
+    }
+    else if (name == "close-editor") {
+        closeEditor();
+    }
+    else if (name == "bypass") {
+        const bool state = parameters.toInt() != 0;
+        QMutexLocker locker(&processMutex);
+        bypassed.storeRelease(state ? 1 : 0);
+        effect->dispatcher(effect, effSetBypass, 0, state, NULL, 0);
+    }
+    else if (name == "sample-rate") {
+        const int sampleRate = parameters.toInt();
+        QMutexLocker locker(&processMutex);
+
+        // the sample rate is changed only in suspended plugins
+        effect->dispatcher(effect, effStopProcess, 0, 1, NULL, 0.0f);
+        effect->dispatcher(effect, effMainsChanged, 0, 0, NULL, 0.0f);
+
+        host->setSampleRate(sampleRate);
+        effect->dispatcher(effect, effSetSampleRate, 0, 0, NULL, sampleRate);
+
+        effect->dispatcher(effect, effMainsChanged, 0, 1, NULL, 0.0f);
+        effect->dispatcher(effect, effStartProcess, 0, 1, NULL, 0.0f);
+    }
+    else if (name == "get-state") {
+        QMutexLocker locker(&processMutex);
+        QByteArray state;
+        if (effect->flags & effFlagsProgramChunks) { // can serialize chunks?
+            char *chunk = nullptr;
+            long size = effect->dispatcher(effect, effGetChunk, false, 0, &chunk, 0);
+            if (size > 0 && chunk)
+                state = QByteArray(chunk, size);
+        }
+        writeToJamtaba("JT-Sandbox-State: " + QString::fromLatin1(state.toBase64()));
+    }
+    else if (name == "set-state") {
+        QByteArray state = QByteArray::fromBase64(parameters.toLatin1());
+        if (!state.isEmpty()) {
+            QMutexLocker locker(&processMutex);
+            effect->dispatcher(effect, effSetChunk, false, state.size(), (void *)state.data(), 0);
+        }
+        writeToJamtaba("JT-Sandbox-State-Restored");
+    }
+    else if (name == "quit") {
+        quit();
+    }
+    else {
+        qCritical() << "Unknown sandbox command:" << command;
+    }
+}
+
+void VstSandbox::openEditor(const QPoint &centerOfScreen)
+{
+    if (!(effect->flags & effFlagsHasEditor))
+        return;
+
+    if (editorWindow && editorWindow->isVisible()) {
+        editorWindow->raise();
+        editorWindow->activateWindow();
+        return;
+    }
+
+    if (!editorWindow) {
+        editorWindow = new QDialog(0, Qt::WindowTitleHint | Qt::WindowCloseButtonHint);
+        editorWindow->setWindowTitle(vst::utils::createDescriptor(effect, pluginPath).getName());
+        connect(editorWindow.data(), &QDialog::finished, this, &VstSandbox::closeEditor);
+    }
+
+    ERect *rect = nullptr;
+    effect->dispatcher(effect, effEditGetRect, 0, 0, (void*)&rect, 0);
+    if (rect)
+        editorWindow->setFixedSize(rect->right - rect->left, rect->bottom - rect->top);
+
+    editorWindow->show();
+
+    effect->dispatcher(effect, effEditOpen, 0, 0, (void*)(editorWindow->effectiveWinId()), 0);
+
+    // Some plugins don't return the real size until after effEditOpen
+    effect->dispatcher(effect, effEditGetRect, 0, 0, (void*)&rect, 0);
+    if (rect) {
+        const int width = rect->right - rect->left;
+        const int height = rect->bottom - rect->top;
+        editorWindow->setFixedSize(width, height);
+        editorWindow->move(centerOfScreen.x() - width / 2, centerOfScreen.y() - height / 2);
+    }
+
+    editorIdleTimer.start();
+}
+
+void VstSandbox::closeEditor()
+{
+    editorIdleTimer.stop();
+
+    if (!editorWindow)
+        return;
+
+    effect->dispatcher(effect, effEditClose, 0, 0, NULL, 0);
+
+    editorWindow->disconnect(this);
+    editorWindow->deleteLater();
+    editorWindow = nullptr;
+
+    writeToJamtaba("JT-Sandbox-Editor-Closed");
+}
+
+void VstSandbox::idleEditor()
+{
+    if (effect && editorWindow && editorWindow->isVisible())
+        effect->dispatcher(effect, effEditIdle, 0, 0, 0, 0);
+}
+
+void VstSandbox::resizeEditor(const QString &pluginName, int newWidth, int newHeight)
+{
+    Q_UNUSED(pluginName); // only one plugin per sandbox
+
+    if (editorWindow)
+        editorWindow->setFixedSize(newWidth, newHeight);
+}
+
+void VstSandbox::quit()
+{
+    running.storeRelease(0);
+    QApplication::quit();
+}
+
+void VstSandbox::writeToJamtaba(const QString &line)
+{
+    // using '\n' here because std::endl don't work well when reading the output from QProcess
+    std::cout << '\n' << line.toStdString() << '\n';
+    std::flush(std::cout);
+}
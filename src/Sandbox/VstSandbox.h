@@ -0,0 +1,109 @@
+#ifndef VST_SANDBOX_H
+#define VST_SANDBOX_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QScopedPointer>
+#include <QPointer>
+#include <QDialog>
+
+#include <vector>
+
+#include "aeffectx.h"
+#include "audio/PluginSandboxChannel.h"
+
+namespace vst {
+class VstHost;
+}
+
+/**
+ * Reading the Jamtaba commands from stdin without blocking the GUI thread.
+ */
+
+class SandboxCommandsReader : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit SandboxCommandsReader(QObject *parent);
+
+signals:
+    void commandReceived(const QString &command);
+    void inputClosed(); // Jamtaba closed the pipe (or crashed)
+
+protected:
+    void run() override;
+};
+
+/**
+ * Host process for a single VST plugin running out of the Jamtaba process. The audio blocks and
+ * MIDI events are received from Jamtaba in shared memory and processed in a time critical thread.
+ * The commands (editor, state, bypass, etc.) are received in stdin and answered in stdout, using
+ * the same line based protocol of the scanners.
+ */
+
+class VstSandbox : public QObject
+{
+    Q_OBJECT
+
+public:
+    VstSandbox();
+    ~VstSandbox();
+
+    bool start(const QStringList &arguments); // plugin path, channel key, sample rate, block size
+
+private slots:
+    void executeCommand(const QString &command);
+    void resizeEditor(const QString &pluginName, int newWidth, int newHeight);
+    void idleEditor();
+    void quit();
+
+private:
+    class ProcessingThread : public QThread
+    {
+    public:
+        explicit ProcessingThread(VstSandbox *sandbox);
+
+    protected:
+        void run() override;
+
+    private:
+        VstSandbox *sandbox;
+    };
+
+    void processBlock(audio::PluginSandboxChannel::Block *block); // processing thread
+    void fillVstEvents(const audio::PluginSandboxChannel::Block *block);
+
+    void openEditor(const QPoint &centerOfScreen);
+    void closeEditor();
+
+    void writeToJamtaba(const QString &line);
+
+    AEffect *effect;
+    vst::VstHost *host;
+    QScopedPointer<audio::PluginSandboxChannel> channel;
+    QScopedPointer<ProcessingThread> processingThread;
+    SandboxCommandsReader *commandsReader;
+
+    QPointer<QDialog> editorWindow;
+    QTimer editorIdleTimer;
+
+    QMutex processMutex; // the plugin is not processing a block while the state commands are dispatched in the GUI thread
+    QAtomicInt running;
+    QAtomicInt bypassed;
+    bool wantMidi;
+
+    // preallocated, the processing thread don't allocate memory
+    std::vector<float *> inputs;
+    std::vector<float *> outputs;
+    std::vector<std::vector<float>> extraChannels; // plugins with more channels than the shared memory block
+    std::vector<VstMidiEvent> midiEvents;
+    std::vector<char> vstEventsMemory; // VstEvents with a variable size array
+
+    QString pluginPath;
+};
+
+#endif
@@ -0,0 +1,15 @@
+#include "VstSandbox.h"
+
+#include <QApplication>
+
+int main(int argc, char *argv[])
+{
+    QApplication application(argc, argv);
+    application.setQuitOnLastWindowClosed(false); // closing the plugin editor don't finish the sandbox
+
+    VstSandbox sandbox;
+    if (!sandbox.start(application.arguments()))
+        return 1;
+
+    return application.exec();
+}
@@ -9,6 +9,7 @@
 #include <QDataStream>
 #include <QDirIterator>
 #include <QLibrary>
+#include <QFile>
 
 VstPluginScanner::VstPluginScanner()
     : BaseScanner()
@@ -43,6 +44,11 @@ audio::PluginDescriptor VstPluginScanner::getPluginDescriptor(const QFileInfo &p
 
 void VstPluginScanner::scan()
 {
+    if (!pluginsToScan.isEmpty()) {
+        scanPlugins();
+        return;
+    }
+
     if (foldersToScan.isEmpty()) {
         qCInfo(jtStandalonePluginFinder) << "Folders to scan is empty!";
         return;
@@ -73,14 +79,33 @@ void VstPluginScanner::scan()
     writeToProcessOutput("JT-Scanner-Finished");
 }
 
+void VstPluginScanner::scanPlugins()
+{
+    qCDebug(jtStandalonePluginFinder) << pluginsToScan.size() << "plugins to scan";
+
+    writeToProcessOutput("JT-Scanner-Starting");
+    for (const QString &pluginPath : pluginsToScan) {
+        QFileInfo pluginFileInfo(pluginPath);
+        writeToProcessOutput("JT-Scanner-Scanning: "+ pluginFileInfo.absoluteFilePath());
+        auto descriptor = getPluginDescriptor(pluginFileInfo);
+        if (descriptor.isValid())
+            writeToProcessOutput("JT-Scanner-Scan-Finished: " + descriptor.getPath());
+    }
+    writeToProcessOutput("JT-Scanner-Finished");
+}
+
 
 bool VstPluginScanner::canScan(const QFileInfo &pluginFileInfo) const
 {
     /**
-      In Mac VST plugins are bundles, in windows these plugins are DLLs.
+      In Mac VST plugins are bundles, in windows these plugins are DLLs and in Linux shared objects.
     */
 
+#ifdef Q_OS_LINUX
+    return pluginFileInfo.suffix() == "so";
+#else
     return pluginFileInfo.isBundle() || pluginFileInfo.suffix() == "dll";
+#endif
 }
 
 void VstPluginScanner::initialize(int argc, char *argv[])
@@ -97,6 +122,16 @@ void VstPluginScanner::initialize(int argc, char *argv[])
 
     QString foldersString = QString::fromUtf8(argv[1]);
 
+    if (foldersString == "--plugins") { // Jamtaba is scanning in parallel, the plugins paths (one per line) are received in stdin
+        QFile input;
+        if (input.open(stdin, QIODevice::ReadOnly)) {
+            const QStringList lines = QString::fromUtf8(input.readAll()).split('\n', QString::SkipEmptyParts);
+            for (const QString &line : lines)
+                pluginsToScan.append(line.trimmed());
+        }
+        return;
+    }
+
     if (!foldersString.isEmpty())
         this->foldersToScan = foldersString.split(";"); // the folders are separated using ';'
 
@@ -14,6 +14,9 @@ private:
 
     QStringList foldersToScan;
     QStringList skipList; // contain blackListed and cached plugins
+    QStringList pluginsToScan; // a partition of the plugins when Jamtaba is scanning in parallel
+
+    void scanPlugins();
 
     void initialize(int argc, char *argv[]) override;
 
@@ -27,9 +27,9 @@ AudioUnitHost::AudioUnitHost()
 
 }
 
-std::vector<midi::MidiMessage> AudioUnitHost::pullReceivedMidiMessages()
+void AudioUnitHost::pullReceivedMidiMessages(midi::MidiBuffer &outBuffer)
 {
-    return std::vector<midi::MidiMessage>();
+    Q_UNUSED(outBuffer)
 }
 
 void AudioUnitHost::setSampleRate(int sampleRate)
@@ -55,7 +55,7 @@ void AudioUnitHost::setPlayingFlag(bool playing)
 }
 
 
-void AudioUnitHost::setPositionInSamples(int intervalPosition)
+void AudioUnitHost::setPositionInSamples(qint64 intervalPosition)
 {
     this->position = intervalPosition;
 }
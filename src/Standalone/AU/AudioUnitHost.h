@@ -17,20 +17,20 @@ public:
     int getSampleRate() const override;
     int getBufferSize() const override;
 
-    std::vector<midi::MidiMessage> pullReceivedMidiMessages() override;
+    void pullReceivedMidiMessages(midi::MidiBuffer &outBuffer) override;
 
     void setSampleRate(int sampleRate) override;
     void setBlockSize(int blockSize) override;
     void setTempo(int bpm) override;
     void setPlayingFlag(bool playing) override;
-    void setPositionInSamples(int intervalPosition) override;
+    void setPositionInSamples(qint64 intervalPosition) override;
 
     int getBeat() const;
     int getTempo() const;
     int getTimeSignatureNumerator() const;
     int getTimeSignatureDenominator() const;
     bool isPlaying() const;
-    int getPosition() const;
+    qint64 getPosition() const;
 
 private:
 
@@ -45,10 +45,10 @@ private:
     int timeSignatureNumerator;
     int timeSignatureDenominator;
     bool playing;
-    int position;
+    qint64 position;
 };
 
-inline int AudioUnitHost::getPosition() const
+inline qint64 AudioUnitHost::getPosition() const
 {
     return position;
 }
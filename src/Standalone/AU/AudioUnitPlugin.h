@@ -33,7 +33,7 @@ namespace au {
         void setSampleRate(int newSampleRate) override;
 
         void process(const audio::SamplesBuffer &inBuffer, audio::SamplesBuffer &outBuffer,
-                             std::vector<midi::MidiMessage> &midiBuffer) override;
+                             midi::MidiBuffer &midiBuffer) override;
 
         void suspend() override;
         void resume() override;
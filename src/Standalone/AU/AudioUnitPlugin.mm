@@ -406,7 +406,7 @@ OSStatus AudioUnitPlugin::inputCallback (void* hostRef, AudioUnitRenderActionFla
 }
 
 void AudioUnitPlugin::process(const audio::SamplesBuffer &inBuffer, audio::SamplesBuffer &outBuffer,
-                     std::vector<midi::MidiMessage> &midiBuffer)
+                     midi::MidiBuffer &midiBuffer)
 {
 
     AudioUnitRenderActionFlags flags = 0;
@@ -429,8 +429,8 @@ void AudioUnitPlugin::process(const audio::SamplesBuffer &inBuffer, audio::Sampl
     }
 
     if (wantsMidiMessages && !midiBuffer.empty()) {
-        UInt32 midiEventPosition = 0; // in jamtaba all MIDI messages are real time
         for (const midi::MidiMessage &message : midiBuffer) {
+            UInt32 midiEventPosition = message.getDeltaFrames(); // sample offset inside the processed block
             MusicDeviceMIDIEvent(audioUnit, message.getStatus(), message.getData1(),
                                                             message.getData2(), midiEventPosition);
         }
@@ -5,9 +5,11 @@
 #include "audio/PortAudioDriver.h"
 #include "audio/core/LocalInputNode.h"
 #include "vst/VstPlugin.h"
+#include "vst/SandboxedVstPlugin.h"
 #include "vst/VstHost.h"
 #include "vst/VstPluginFinder.h"
 #include "audio/core/PluginDescriptor.h"
+#include "audio/core/NativePlugins.h"
 #include "NinjamController.h"
 #include "vst/VstPluginChecker.h"
 #include "gui/MainWindowStandalone.h"
@@ -25,6 +27,10 @@
     #include "AU/AudioUnitPlugin.h"
 #endif
 
+#ifdef JAMTABA_JACK
+    #include "audio/JackAudioDriver.h"
+#endif
+
 #include <QDataStream>
 #include <QFile>
 #include <QDirIterator>
@@ -85,7 +91,12 @@ QMap<QString, QList<audio::PluginDescriptor> > MainControllerStandalone::getPlug
 {
     QMap<QString, QList<audio::PluginDescriptor> > descriptors;
 
-    for (const auto &descriptor : pluginsDescriptors)
+    // native plugins are always available, they are not scanned
+    auto allDescriptors = pluginsDescriptors;
+    if (category == audio::PluginDescriptor::Native_Plugin)
+        allDescriptors.append(audio::NativePlugin::getDescriptors());
+
+    for (const auto &descriptor : allDescriptors)
     {
         if (descriptor.getCategory() == category)
         {
@@ -152,6 +163,9 @@ void MainControllerStandalone::clearPluginsCache()
 {
     settings.clearVstCache();
 
+    if (vstPluginFinder)
+        vstPluginFinder->clearScanDatabase(); // the plugins marked as invalid are scanned again
+
     #ifdef Q_OS_MAC
     settings.clearAudioUnitCache();
     #endif
@@ -168,6 +182,16 @@ void MainControllerStandalone::removeBlackVstFromSettings(const QString &pluginP
     settings.removeVstFromBlackList(pluginPath);
 }
 
+void MainControllerStandalone::setVstSandboxed(const QString &pluginPath, bool sandboxed)
+{
+    settings.setVstSandboxed(pluginPath, sandboxed);
+}
+
+bool MainControllerStandalone::isSandboxedVst(const QString &pluginPath) const
+{
+    return settings.isSandboxedVst(pluginPath);
+}
+
 bool MainControllerStandalone::inputIndexIsValid(int inputIndex)
 {
     return inputIndex >= 0 && inputIndex <= audioDriver->getInputsCount();
@@ -252,6 +276,9 @@ void MainControllerStandalone::updateBpm(int newBpm)
 
     for (Host *host : hosts)
         host->setTempo(newBpm);
+
+    for (auto inputNode : inputTracks)
+        inputNode->setProcessorsTempo(newBpm);
 }
 
 void MainControllerStandalone::connectInNinjamServer(const ServerInfo &server)
@@ -260,6 +287,9 @@ void MainControllerStandalone::connectInNinjamServer(const ServerInfo &server)
 
     for (auto host : hosts)
         host->setTempo(server.getBpm());
+
+    for (auto inputNode : inputTracks)
+        inputNode->setProcessorsTempo(server.getBpm());
 }
 
 void MainControllerStandalone::setSampleRate(int newSampleRate)
@@ -286,12 +316,16 @@ void MainControllerStandalone::setBufferSize(int newBufferSize)
 
 void MainControllerStandalone::on_audioDriverStarted()
 {
+    resetAudioLoadMonitor();
+
     for (auto inputTrack : inputTracks)
         inputTrack->resumeProcessors();
 }
 
 void MainControllerStandalone::on_audioDriverStopped()
 {
+    resetAudioLoadMonitor(); // the first callbacks can run before the 'started' signal is handled
+
     for (auto inputTrack : inputTracks)
         inputTrack->suspendProcessors();    // suspend plugins
 }
@@ -383,6 +417,24 @@ controller::NinjamController *MainControllerStandalone::createNinjamController()
 audio::AudioDriver *MainControllerStandalone::createAudioDriver(
     const persistence::Settings &settings)
 {
+#ifdef JAMTABA_JACK
+    if (settings.isUsingJack()) {
+        auto jackDriver = new audio::JackAudioDriver(
+            this,
+            settings.getFirstGlobalAudioInput(),
+            settings.getLastGlobalAudioInput(),
+            settings.getFirstGlobalAudioOutput(),
+            settings.getLastGlobalAudioOutput()
+            );
+
+        if (jackDriver->isConnected())
+            return jackDriver;
+
+        qCWarning(jtCore) << "JACK server is not running, using the ALSA (PortAudio) driver";
+        delete jackDriver;
+    }
+#endif
+
     return new audio::PortAudioDriver(
         this,
         settings.getLastAudioInputDevice(),
@@ -435,31 +487,7 @@ void MainControllerStandalone::start()
     }
 
     if (!audioDriver)
-    {
-        qCInfo(jtCore) << "Creating audio driver...";
-        audio::AudioDriver *driver = nullptr;
-        try
-        {
-            driver = createAudioDriver(settings);
-        }
-        catch (const std::runtime_error &error)
-        {
-            qCritical() << "Audio initialization fail: " << QString::fromUtf8(
-                error.what());
-            QMessageBox::warning(window, "Audio Initialization Problem!", error.what());
-        }
-        if (!driver)
-            driver = new audio::NullAudioDriver();
-
-        audioDriver.reset(driver);
-
-        QObject::connect(audioDriver.data(), SIGNAL(sampleRateChanged(int)), this,
-                         SLOT(setSampleRate(int)));
-        QObject::connect(audioDriver.data(), SIGNAL(stopped()), this,
-                         SLOT(on_audioDriverStopped()));
-        QObject::connect(audioDriver.data(), SIGNAL(started()), this,
-                         SLOT(on_audioDriverStarted()));
-    }
+        resetAudioDriver();
 
     // calling the base class
     MainController::start();
@@ -475,7 +503,7 @@ void MainControllerStandalone::start()
         midiDriver->start(settings.getMidiInputDevicesStatus());
 
     qCInfo(jtCore) << "Creating plugin finder...";
-    vstPluginFinder.reset(new audio::VSTPluginFinder());
+    vstPluginFinder.reset(new audio::VSTPluginFinder(Configurator::getInstance()->getCacheDir()));
 
 #ifdef Q_OS_MAC
 
@@ -499,6 +527,54 @@ void MainControllerStandalone::start()
     }
 }
 
+void MainControllerStandalone::resetAudioDriver()
+{
+    qCInfo(jtCore) << "Creating audio driver...";
+    audio::AudioDriver *driver = nullptr;
+    try
+    {
+        driver = createAudioDriver(settings);
+    }
+    catch (const std::runtime_error &error)
+    {
+        qCritical() << "Audio initialization fail: " << QString::fromUtf8(
+            error.what());
+        QMessageBox::warning(window, "Audio Initialization Problem!", error.what());
+    }
+    if (!driver)
+        driver = new audio::NullAudioDriver();
+
+    audioDriver.reset(driver);
+
+    QObject::connect(audioDriver.data(), SIGNAL(sampleRateChanged(int)), this,
+                     SLOT(setSampleRate(int)));
+    QObject::connect(audioDriver.data(), SIGNAL(bufferSizeChanged(int)), this,
+                     SLOT(setBufferSize(int)));
+    QObject::connect(audioDriver.data(), SIGNAL(stopped()), this,
+                     SLOT(on_audioDriverStopped()));
+    QObject::connect(audioDriver.data(), SIGNAL(started()), this,
+                     SLOT(on_audioDriverStarted()));
+}
+
+void MainControllerStandalone::setUsingJack(bool useJack)
+{
+    if (settings.isUsingJack() == useJack)
+        return;
+
+    settings.setUsingJack(useJack);
+
+    if (!audioDriver)
+        return; // the setting is used when the controller is started
+
+    // JACK and ALSA have different devices, sample rates and buffer sizes
+    audioDriver->stop();
+    audioDriver.reset(); // releasing the devices before opening the new driver
+    resetAudioDriver();
+
+    setSampleRate(audioDriver->getSampleRate());
+    setBufferSize(audioDriver->getBufferSize());
+}
+
 void MainControllerStandalone::cancelPluginFinders()
 {
     if (vstPluginFinder)
@@ -528,12 +604,24 @@ audio::Plugin *MainControllerStandalone::createPluginInstance(
 {
     if (descriptor.isNative())
     {
-        if (descriptor.getName() == "Delay")
-            return new audio::JamtabaDelay(audioDriver->getSampleRate());
+        auto nativePlugin = audio::NativePlugin::createPlugin(descriptor, audioDriver->getSampleRate());
+        if (nativePlugin && isPlayingInNinjamRoom())
+            nativePlugin->setTempo(ninjamController->getCurrentBpm());
+
+        return nativePlugin;
     }
     else if (descriptor.isVST())
     {
         auto host = vst::VstHost::getInstance();
+        if (settings.isSandboxedVst(descriptor.getPath())) { // running in a separated process, a crashing plugin is not crashing Jamtaba
+            auto sandboxedPlugin = new vst::SandboxedVstPlugin(host, descriptor.getPath());
+            if (sandboxedPlugin->load(descriptor.getPath()))
+                return sandboxedPlugin;
+
+            delete sandboxedPlugin;
+            return nullptr;
+        }
+
         auto vstPlugin = new vst::VstPlugin(host, descriptor.getPath());
         if (vstPlugin->load(descriptor.getPath()))
             return vstPlugin;
@@ -613,25 +701,9 @@ void MainControllerStandalone::addDefaultPluginsScanPath()
     }
 }
 
-/**
- * We need scan plugins when plugins cache is empty OR we have new plugins in scan folders
- * This code is executed whem Jamtaba is started.
-*/
-
-bool MainControllerStandalone::vstScanIsNeeded() const
+bool MainControllerStandalone::hasNewVstPlugins(const QStringList &scanFolders, const QStringList &skipList)
 {
-    bool vstCacheIsEmpty = settings.getVstPluginsPaths().isEmpty();
-    if (vstCacheIsEmpty)
-        return true;
-
-    // checking for new vst plugins in scan folders
-    QStringList foldersToScan = settings.getVstScanFolders();
-
-    QStringList skipList(settings.getBlackListedPlugins());
-    skipList.append(settings.getVstPluginsPaths());
-
-    bool newVstFounded = false;
-    for (const QString &scanFolder : foldersToScan)
+    for (const QString &scanFolder : scanFolders)
     {
         QDirIterator folderIterator(scanFolder, QDir::AllDirs | QDir::NoDotAndDotDot,
                                     QDirIterator::Subdirectories);
@@ -640,16 +712,11 @@ bool MainControllerStandalone::vstScanIsNeeded() const
             folderIterator.next(); // point to next file inside current folder
             QString filePath = folderIterator.filePath();
             if (!skipList.contains(filePath) && Vst::PluginChecker::isValidPluginFile(filePath))
-            {
-                newVstFounded = true;
-                break;
-            }
+                return true;
         }
-        if (newVstFounded)
-            break;
     }
 
-    return newVstFounded;
+    return false;
 }
 
 #ifdef Q_OS_MAC
@@ -740,26 +807,26 @@ void MainControllerStandalone::quit()
     application->quit();
 }
 
-std::vector<midi::MidiMessage> MainControllerStandalone::pullMidiMessagesFromPlugins()
+void MainControllerStandalone::pullMidiMessagesFromPlugins(midi::MidiBuffer &outBuffer)
 {
-    // return midi messages created by vst and AU plugins, not by midi controllers.
-    std::vector<midi::MidiMessage> receivedMidiMessages;
+    // append midi messages created by vst and AU plugins, not by midi controllers.
     for (auto host : hosts)
-    {
-        std::vector<midi::MidiMessage> pulledMessages = host->pullReceivedMidiMessages();
-        receivedMidiMessages.insert(receivedMidiMessages.end(),
-                                    pulledMessages.begin(), pulledMessages.end());
-    }
-
-    return receivedMidiMessages;
+        host->pullReceivedMidiMessages(outBuffer);
 }
 
-std::vector<midi::MidiMessage> MainControllerStandalone::pullMidiMessagesFromDevices()
+void MainControllerStandalone::process(const audio::SamplesBuffer &in, audio::SamplesBuffer &out, int sampleRate)
 {
-    if (!midiDriver)
-        return std::vector<midi::MidiMessage>();
+    // the sandboxed plugins can wait only the remaining time of this callback
+    const qint64 bufferPeriod = static_cast<qint64>(out.getFrameLenght()) * 1000000000 / qMax(sampleRate, 1);
+    vst::VstHost::getInstance()->setCallbackDeadline(audio::AudioLoadMonitor::timestamp() + bufferPeriod);
 
-    return midiDriver->getBuffer();
+    MainController::process(in, out, sampleRate);
+}
+
+void MainControllerStandalone::pullMidiMessagesFromDevices(midi::MidiBuffer &outBuffer)
+{
+    if (midiDriver)
+        midiDriver->getBuffer(outBuffer);
 }
 
 bool MainControllerStandalone::isUsingNullAudioDriver() const
@@ -62,7 +62,7 @@ namespace controller
 
         void clearPluginsCache();
         QStringList getSteinbergRecommendedPaths();
-        bool vstScanIsNeeded() const; // plugins cache is empty OR we have new plugins in scan folders?
+        static bool hasNewVstPlugins(const QStringList &scanFolders, const QStringList &skipList); // thread safe, walking the scan folders
 
         void quit();
 
@@ -113,11 +113,14 @@ namespace controller
         Plugin *addPlugin(quint32 inputTrackIndex, quint32 pluginSlotIndex,
                           const PluginDescriptor &descriptor);
 
-        std::vector<midi::MidiMessage> pullMidiMessagesFromPlugins() override;
+        void pullMidiMessagesFromPlugins(midi::MidiBuffer &outBuffer) override;
+
+        void process(const audio::SamplesBuffer &in, audio::SamplesBuffer &out, int sampleRate) override;
 
     public slots:
         void setSampleRate(int newSampleRate) override;
         void setBufferSize(int newBufferSize);
+        void setUsingJack(bool useJack); // Linux only, the audio driver is recreated (and not started)
 
         void removePluginsScanPath(const QString &path);
         void addPluginsScanPath(const QString &path);
@@ -125,6 +128,9 @@ namespace controller
         void addBlackVstToSettings(const QString &path);
         void removeBlackVstFromSettings(const QString &pluginPath);
 
+        void setVstSandboxed(const QString &pluginPath, bool sandboxed); // applied when the plugin is loaded again
+        bool isSandboxedVst(const QString &pluginPath) const;
+
         void scanAllVstPlugins();
         void scanOnlyNewVstPlugins();
 
@@ -137,6 +143,7 @@ namespace controller
 
         // TODO - Audio driver need just the audio settings to initialize, not the entire settings.
         AudioDriver *createAudioDriver(const persistence::Settings &settings);
+        void resetAudioDriver(); // create and connect the audio driver using the current settings
 
         controller::NinjamController *createNinjamController() override;
 
@@ -144,7 +151,7 @@ namespace controller
 
         void setupNinjamControllerSignals() override;
 
-        std::vector<midi::MidiMessage> pullMidiMessagesFromDevices() override;
+        void pullMidiMessagesFromDevices(midi::MidiBuffer &outBuffer) override;
 
     protected slots:
         void updateBpm(int newBpm) override;
@@ -2,7 +2,7 @@
 #define HOST_H
 
 #include <QList>
-#include "midi/MidiMessage.h"
+#include "midi/MidiBuffer.h"
 
 class Host
 {
@@ -13,16 +13,16 @@ public:
     virtual int getSampleRate() const = 0;
     virtual int getBufferSize() const = 0;
 
-    virtual std::vector<midi::MidiMessage> pullReceivedMidiMessages() = 0;
+    virtual void pullReceivedMidiMessages(midi::MidiBuffer &outBuffer) = 0; // append the received messages in outBuffer
 
     virtual void setSampleRate(int sampleRate) = 0;
     virtual void setBlockSize(int blockSize) = 0;
     virtual void setTempo(int bpm) = 0;
     virtual void setPlayingFlag(bool playing) = 0;
-    virtual void setPositionInSamples(int position) = 0;
+    virtual void setPositionInSamples(qint64 position) = 0;
 
 protected:
-    std::vector<midi::MidiMessage> receivedMidiMessages;
+    midi::MidiBuffer receivedMidiMessages;
 
 };
 
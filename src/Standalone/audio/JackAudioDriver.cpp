@@ -0,0 +1,385 @@
+#include "JackAudioDriver.h"
+#include "MainController.h"
+#include "log/Logging.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <cstring>
+
+using audio::JackAudioDriver;
+using controller::MainController;
+
+const char *JackAudioDriver::CLIENT_NAME = "Jamtaba";
+
+namespace {
+
+QStringList getPhysicalPorts(jack_client_t *client, unsigned long flags)
+{
+    QStringList ports;
+    const char **names = jack_get_ports(client, nullptr, JACK_DEFAULT_AUDIO_TYPE, JackPortIsPhysical | flags);
+    if (names) {
+        for (int i = 0; names[i]; ++i)
+            ports.append(QString::fromUtf8(names[i]));
+
+        jack_free(names);
+    }
+    return ports;
+}
+
+} // namespace
+
+JackAudioDriver::JackAudioDriver(MainController *mainController,
+                                 int firstInputIndex, int lastInputIndex,
+                                 int firstOutputIndex, int lastOutputIndex) :
+    AudioDriver(mainController),
+    client(nullptr),
+    activated(false),
+    xruns(0),
+    serverShutdown(0)
+{
+    jack_status_t status;
+    client = jack_client_open(CLIENT_NAME, JackNoStartServer, &status);
+    if (!client) {
+        qCInfo(jtAudio) << "JACK server is not running, status:" << status;
+        return;
+    }
+
+    if (status & JackNameNotUnique)
+        qCInfo(jtAudio) << "JACK client name in use, using" << jack_get_client_name(client);
+
+    jack_set_process_callback(client, &JackAudioDriver::processCallback, this);
+    jack_set_buffer_size_callback(client, &JackAudioDriver::bufferSizeCallback, this);
+    jack_set_sample_rate_callback(client, &JackAudioDriver::sampleRateCallback, this);
+    jack_set_xrun_callback(client, &JackAudioDriver::xrunCallback, this);
+    jack_on_shutdown(client, &JackAudioDriver::shutdownCallback, this);
+
+    sampleRate = jack_get_sample_rate(client); // sample rate and buffer size are defined by the JACK server
+    bufferSize = jack_get_buffer_size(client);
+
+    physicalInputs = getPhysicalPorts(client, JackPortIsOutput); // capture ports are JACK outputs
+    physicalOutputs = getPhysicalPorts(client, JackPortIsInput);
+
+    registerPorts();
+
+    globalInputRange = ChannelRange(firstInputIndex, (lastInputIndex - firstInputIndex) + 1);
+    globalOutputRange = ChannelRange(firstOutputIndex, (lastOutputIndex - firstOutputIndex) + 1);
+    ensureInputRangeIsValid();
+    ensureOutputRangeIsValid();
+
+    qCInfo(jtAudio) << "JACK client created, sample rate:" << sampleRate << "buffer size:" << bufferSize
+                    << "physical inputs:" << physicalInputs.size() << "physical outputs:" << physicalOutputs.size();
+}
+
+JackAudioDriver::~JackAudioDriver()
+{
+    qCDebug(jtAudio) << "JackAudioDriver destructor";
+    release();
+}
+
+void JackAudioDriver::registerPorts()
+{
+    // one JACK port per channel, at least a stereo output even without physical playback ports
+    const int inputs = physicalInputs.size();
+    const int outputs = std::max(physicalOutputs.size(), 2);
+
+    for (int i = 0; i < inputs; ++i) {
+        const QByteArray name = QString("in_%1").arg(i + 1).toUtf8();
+        jack_port_t *port = jack_port_register(client, name.constData(), JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+        if (!port) {
+            qCritical() << "Can't register the JACK port" << name;
+            break;
+        }
+        inputPorts.append(port);
+    }
+
+    for (int i = 0; i < outputs; ++i) {
+        const QByteArray name = QString("out_%1").arg(i + 1).toUtf8();
+        jack_port_t *port = jack_port_register(client, name.constData(), JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+        if (!port) {
+            qCritical() << "Can't register the JACK port" << name;
+            break;
+        }
+        outputPorts.append(port);
+    }
+}
+
+void JackAudioDriver::unregisterPorts()
+{
+    for (jack_port_t *port : inputPorts)
+        jack_port_unregister(client, port);
+
+    for (jack_port_t *port : outputPorts)
+        jack_port_unregister(client, port);
+
+    inputPorts.clear();
+    outputPorts.clear();
+}
+
+void JackAudioDriver::connectPhysicalPorts()
+{
+    // only the selected channels are connected, other applications (a DAW, etc.) can use the remaining channels
+    for (int c = 0; c < globalInputRange.getChannels(); ++c) {
+        const int index = globalInputRange.getFirstChannel() + c;
+        if (index < physicalInputs.size())
+            jack_connect(client, physicalInputs.at(index).toUtf8().constData(), jack_port_name(inputPorts.at(index)));
+    }
+
+    for (int c = 0; c < globalOutputRange.getChannels(); ++c) {
+        const int index = globalOutputRange.getFirstChannel() + c;
+        if (index < physicalOutputs.size())
+            jack_connect(client, jack_port_name(outputPorts.at(index)), physicalOutputs.at(index).toUtf8().constData());
+    }
+}
+
+void JackAudioDriver::ensureInputRangeIsValid()
+{
+    const int maxInputs = getMaxInputs();
+    const int inputsCount = globalInputRange.getChannels();
+    if (inputsCount > maxInputs || globalInputRange.getFirstChannel() + inputsCount > maxInputs || inputsCount <= 0)
+        globalInputRange = ChannelRange(0, std::min(maxInputs, 1));
+}
+
+void JackAudioDriver::ensureOutputRangeIsValid()
+{
+    const int maxOutputs = getMaxOutputs();
+    const int outputsCount = globalOutputRange.getChannels();
+    if (outputsCount > maxOutputs || globalOutputRange.getFirstChannel() + outputsCount > maxOutputs || outputsCount <= 0)
+        globalOutputRange = ChannelRange(0, std::min(maxOutputs, 2));
+}
+
+int JackAudioDriver::processCallback(jack_nframes_t frames, void *arg)
+{
+    static_cast<JackAudioDriver *>(arg)->process(frames);
+    return 0;
+}
+
+// running in the JACK realtime thread, the buffers are resized in bufferSizeCallback
+void JackAudioDriver::process(jack_nframes_t frames)
+{
+    const size_t bytesToProcess = frames * sizeof(float);
+
+    inputBuffer.setFrameLenght(frames);
+    outputBuffer.setFrameLenght(frames);
+
+    if (!globalInputRange.isEmpty()) {
+        const int firstInput = globalInputRange.getFirstChannel();
+        for (int c = 0; c < globalInputRange.getChannels(); ++c) {
+            const float *in = static_cast<const float *>(jack_port_get_buffer(inputPorts.at(firstInput + c), frames));
+            std::memcpy(inputBuffer.getSamplesArray(c), in, bytesToProcess);
+        }
+    }
+    else {
+        inputBuffer.zero();
+    }
+
+    outputBuffer.zero();
+
+    if (mainController)
+        mainController->process(inputBuffer, outputBuffer, sampleRate);
+
+    // the not selected output ports are silenced, JACK port buffers are not zeroed
+    const int firstOutput = globalOutputRange.getFirstChannel();
+    const int outputChannels = globalOutputRange.getChannels();
+    for (int p = 0; p < outputPorts.size(); ++p) {
+        float *out = static_cast<float *>(jack_port_get_buffer(outputPorts.at(p), frames));
+        const int channel = p - firstOutput;
+        if (channel >= 0 && channel < outputChannels)
+            std::memcpy(out, outputBuffer.getSamplesArray(channel), bytesToProcess);
+        else
+            std::memset(out, 0, bytesToProcess);
+    }
+}
+
+int JackAudioDriver::bufferSizeCallback(jack_nframes_t frames, void *arg)
+{
+    // not called in the realtime thread, JACK is not calling 'process' while the buffer size is changing
+    JackAudioDriver *driver = static_cast<JackAudioDriver *>(arg);
+    driver->inputBuffer.setFrameLenght(frames);
+    driver->outputBuffer.setFrameLenght(frames);
+
+    if (driver->bufferSize != static_cast<int>(frames)) {
+        qCInfo(jtAudio) << "JACK buffer size changed to" << frames;
+        driver->bufferSize = frames;
+        emit driver->bufferSizeChanged(frames);
+    }
+
+    return 0;
+}
+
+int JackAudioDriver::sampleRateCallback(jack_nframes_t sampleRate, void *arg)
+{
+    JackAudioDriver *driver = static_cast<JackAudioDriver *>(arg);
+    if (driver->sampleRate != static_cast<int>(sampleRate)) {
+        qCInfo(jtAudio) << "JACK sample rate changed to" << sampleRate;
+        driver->setSampleRate(sampleRate); // emitting sampleRateChanged
+    }
+
+    return 0;
+}
+
+int JackAudioDriver::xrunCallback(void *arg)
+{
+    JackAudioDriver *driver = static_cast<JackAudioDriver *>(arg);
+    const int count = driver->xruns.fetchAndAddOrdered(1) + 1;
+
+    // called in the JACK notification thread, not in the realtime thread
+    qCWarning(jtAudio) << "JACK xrun! Total xruns:" << count << "delay:" << jack_get_xrun_delayed_usecs(driver->client) << "us";
+
+    return 0;
+}
+
+void JackAudioDriver::shutdownCallback(void *arg)
+{
+    // JACK functions can't be called here
+    JackAudioDriver *driver = static_cast<JackAudioDriver *>(arg);
+    driver->serverShutdown.storeRelease(1);
+
+    qCritical() << "JACK server was shutdown!";
+
+    emit driver->stopped();
+}
+
+bool JackAudioDriver::start()
+{
+    if (!canBeStarted())
+        return false;
+
+    stop();
+
+    ensureInputRangeIsValid();
+    ensureOutputRangeIsValid();
+
+    if (globalOutputRange.isEmpty())
+        return false;
+
+    recreateBuffers(); // adjust the input and output buffers channels
+    inputBuffer.setFrameLenght(bufferSize);
+    outputBuffer.setFrameLenght(bufferSize);
+
+    qCDebug(jtAudio) << "Starting JACK driver using" << bufferSize << "as buffer size.";
+
+    if (jack_activate(client) != 0) {
+        qCritical() << "Can't activate the JACK client!";
+        return false;
+    }
+
+    activated = true;
+
+    connectPhysicalPorts();
+
+    qCDebug(jtAudio) << "JACK driver started ok!";
+    emit started();
+
+    return true;
+}
+
+void JackAudioDriver::stop(bool refreshDevicesList)
+{
+    Q_UNUSED(refreshDevicesList) // the JACK ports are not changing
+
+    if (client && activated) {
+        qCDebug(jtAudio) << "Stopping JACK driver ...";
+        activated = false;
+        if (!serverShutdown.loadAcquire()) { // stopped() was emitted in shutdownCallback
+            jack_deactivate(client); // waiting the current process callback and disconnecting all ports
+            emit stopped();
+        }
+        qCDebug(jtAudio) << "JACK driver stopped!";
+    }
+}
+
+void JackAudioDriver::release()
+{
+    if (!client)
+        return;
+
+    qCDebug(jtAudio) << "releasing JACK client...";
+    stop();
+
+    if (!serverShutdown.loadAcquire())
+        unregisterPorts();
+
+    jack_client_close(client);
+    client = nullptr;
+    qCDebug(jtAudio) << "JACK client closed!";
+}
+
+void JackAudioDriver::setBufferSize(int newBufferSize)
+{
+    if (!client || newBufferSize == bufferSize)
+        return;
+
+    // the buffer size is changed in the JACK server, affecting all JACK clients. The new size is received in bufferSizeCallback
+    if (jack_set_buffer_size(client, newBufferSize) != 0)
+        qCritical() << "Can't change the JACK buffer size to" << newBufferSize;
+}
+
+QList<int> JackAudioDriver::getValidSampleRates(int deviceIndex) const
+{
+    Q_UNUSED(deviceIndex)
+
+    return QList<int>() << sampleRate; // the sample rate is defined when the JACK server is started
+}
+
+QList<int> JackAudioDriver::getValidBufferSizes(int deviceIndex) const
+{
+    Q_UNUSED(deviceIndex)
+
+    int value = 16;
+    QList<int> bufferSizes;
+    while (value <= 4096) {
+        bufferSizes.append(value);
+        value *= 2;
+    }
+    return bufferSizes;
+}
+
+int JackAudioDriver::getMaxInputs() const
+{
+    return inputPorts.size();
+}
+
+int JackAudioDriver::getMaxOutputs() const
+{
+    return outputPorts.size();
+}
+
+QString JackAudioDriver::getInputChannelName(const unsigned int index) const
+{
+    if (index < static_cast<unsigned>(physicalInputs.size()))
+        return physicalInputs.at(index).section(':', -1); // system:capture_1 -> capture_1
+
+    return QString("in_%1").arg(index + 1);
+}
+
+QString JackAudioDriver::getOutputChannelName(const unsigned int index) const
+{
+    if (index < static_cast<unsigned>(physicalOutputs.size()))
+        return physicalOutputs.at(index).section(':', -1);
+
+    return QString("out_%1").arg(index + 1);
+}
+
+QString JackAudioDriver::getAudioInputDeviceName(int index) const
+{
+    Q_UNUSED(index)
+
+    return "JACK";
+}
+
+QString JackAudioDriver::getAudioOutputDeviceName(int index) const
+{
+    Q_UNUSED(index)
+
+    return "JACK";
+}
+
+QString JackAudioDriver::getAudioDeviceInfo(int index, unsigned &nIn, unsigned &nOut) const
+{
+    Q_UNUSED(index)
+
+    nIn = getMaxInputs();
+    nOut = getMaxOutputs();
+    return "JACK";
+}
@@ -0,0 +1,151 @@
+#ifndef JACK_AUDIO_DRIVER_H
+#define JACK_AUDIO_DRIVER_H
+
+#include "audio/core/AudioDriver.h"
+
+#include <QAtomicInt>
+#include <QStringList>
+
+#include <jack/jack.h>
+
+namespace audio {
+
+/**
+ * Linux native JACK audio driver. The MainController::process is called directly in the JACK
+ * process callback (no intermediate buffering), each audio channel is exposed as a JACK port
+ * and the buffer size and sample rate are following the JACK server. JACK is running a
+ * single 'device', the channel selection in preferences is selecting which physical ports
+ * are used.
+ */
+
+class JackAudioDriver : public AudioDriver
+{
+    Q_OBJECT
+
+public:
+    JackAudioDriver(controller::MainController *mainController,
+                    int firstInputIndex, int lastInputIndex,
+                    int firstOutputIndex, int lastOutputIndex);
+
+    ~JackAudioDriver();
+
+    bool start() override;
+    void stop(bool refreshDevicesList = false) override;
+    void release() override;
+
+    void setBufferSize(int newBufferSize) override;
+
+    QList<int> getValidSampleRates(int deviceIndex) const override;
+    QList<int> getValidBufferSizes(int deviceIndex) const override;
+
+    int getMaxInputs() const override;
+    int getMaxOutputs() const override;
+
+    QString getInputChannelName(unsigned const int index) const override;
+    QString getOutputChannelName(unsigned const int index) const override;
+
+    QString getAudioInputDeviceName(int index = CurrentAudioDeviceSelection) const override;
+    QString getAudioOutputDeviceName(int index = CurrentAudioDeviceSelection) const override;
+    QString getAudioDeviceInfo(int index, unsigned& nIn, unsigned& nOut) const override;
+
+    int getAudioInputDeviceIndex() const override;
+    int getAudioOutputDeviceIndex() const override;
+
+    void setAudioInputDeviceIndex(int index) override;
+    void setAudioOutputDeviceIndex(int index) override;
+
+    int getDevicesCount() const override;
+
+    bool canBeStarted() const override;
+
+    bool hasControlPanel() const override;
+    void openControlPanel(void *mainWindowHandle) override;
+
+    bool isConnected() const; // false when no JACK server is running
+    int getXruns() const;
+
+private:
+    // JACK callbacks, 'arg' is the driver instance
+    static int processCallback(jack_nframes_t frames, void *arg);
+    static int bufferSizeCallback(jack_nframes_t frames, void *arg);
+    static int sampleRateCallback(jack_nframes_t sampleRate, void *arg);
+    static int xrunCallback(void *arg);
+    static void shutdownCallback(void *arg);
+
+    void process(jack_nframes_t frames);
+
+    void registerPorts();
+    void unregisterPorts();
+    void connectPhysicalPorts();
+
+    void ensureInputRangeIsValid();
+    void ensureOutputRangeIsValid();
+
+    jack_client_t *client;
+
+    QStringList physicalInputs;  // capture ports, 'inputs' from Jamtaba point of view
+    QStringList physicalOutputs; // playback ports
+
+    QList<jack_port_t *> inputPorts;
+    QList<jack_port_t *> outputPorts;
+
+    bool activated;
+    QAtomicInt xruns;
+    QAtomicInt serverShutdown; // the JACK server was finished (or kicked Jamtaba out)
+
+    static const char *CLIENT_NAME;
+};
+
+inline bool JackAudioDriver::isConnected() const
+{
+    return client != nullptr;
+}
+
+inline int JackAudioDriver::getXruns() const
+{
+    return xruns.loadAcquire();
+}
+
+inline int JackAudioDriver::getAudioInputDeviceIndex() const
+{
+    return 0;
+}
+
+inline int JackAudioDriver::getAudioOutputDeviceIndex() const
+{
+    return 0;
+}
+
+inline void JackAudioDriver::setAudioInputDeviceIndex(int)
+{
+    // JACK is a single device
+}
+
+inline void JackAudioDriver::setAudioOutputDeviceIndex(int)
+{
+    // JACK is a single device
+}
+
+inline int JackAudioDriver::getDevicesCount() const
+{
+    return 1;
+}
+
+inline bool JackAudioDriver::canBeStarted() const
+{
+    return client != nullptr && !serverShutdown.loadAcquire();
+}
+
+inline bool JackAudioDriver::hasControlPanel() const
+{
+    return false; // buffer size and sample rate are configured in the JACK server (qjackctl, etc.)
+}
+
+inline void JackAudioDriver::openControlPanel(void *)
+{
+    //
+}
+
+} // namespace
+
+#endif
@@ -132,7 +132,7 @@ void FxPanelItem::showPluginsListMenu(const QPoint &p)
 #ifdef Q_OS_MAC
     categories << PluginDescriptor::AU_Plugin;
 #endif
-    //categories << PluginDescriptor::Native_Plugin; // native plugins are not implemented yet
+    categories << PluginDescriptor::Native_Plugin;
 
     for (PluginDescriptor::Category category : categories) { // category = VST, NATIVE, AU
 
@@ -174,6 +174,15 @@ void FxPanelItem::on_contextMenu(QPoint p)
         menu.connect(&menu, SIGNAL(triggered(QAction *)), this, SLOT(on_actionMenuTriggered(QAction *)));
         menu.addAction(tr("bypass"));
         menu.addAction(tr("remove"));
+
+        if (plugin->getDescriptor().isVST()) {
+            menu.addSeparator();
+            QAction *sandboxAction = menu.addAction(tr("run in sandbox"));
+            sandboxAction->setCheckable(true);
+            sandboxAction->setChecked(mainController->isSandboxedVst(plugin->getPath()));
+            sandboxAction->setToolTip(tr("Run the plugin in a separated process. Applied when the plugin is loaded again."));
+        }
+
         menu.move(mapToGlobal(p));
         menu.exec();
     }
@@ -220,6 +229,8 @@ void FxPanelItem::on_actionMenuTriggered(QAction *a)
             bypassButton->click(); // simulate a click in the bypass button
         else if (a->text() == tr("remove"))
             unsetPlugin(); // set this->plugin to nullptr AND remove from mainController
+        else if (a->text() == tr("run in sandbox"))
+            mainController->setVstSandboxed(plugin->getPath(), a->isChecked());
     }
 }
 
@@ -5,6 +5,7 @@
 #include "gui/CrashReportDialog.h"
 #include "gui/PluginScanDialog.h"
 #include "log/Logging.h"
+#include "log/StartupTimeline.h"
 #include "audio/core/PluginDescriptor.h"
 #include "vst/VstPluginFinder.h"
 #include "vst/VstPlugin.h"
@@ -14,6 +15,8 @@
 #include <QSharedPointer>
 #include <QShortcut>
 #include <QSettings>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 
 using persistence::SubChannel;
 using persistence::Channel;
@@ -423,6 +426,11 @@ PreferencesDialog *MainWindowStandalone::createPreferencesDialog()
     connect(dialog, &PreferencesDialogStandalone::openingExternalAudioControlPanel, controller,
             &MainControllerStandalone::openExternalAudioControlPanel);
 
+    connect(dialog, &PreferencesDialogStandalone::usingJackChanged, this, [=](bool useJack) {
+        controller->setUsingJack(useJack);
+        dialog->setAudioDriver(controller->getAudioDriver()); // the new driver is started when the dialog is closed
+    });
+
     preferencesDialog = dialog; // store the dialog instance to use when showing Vst Plugin Scan Dialog - issue #670
 
     return dialog;
@@ -457,11 +465,28 @@ void MainWindowStandalone::initializePluginFinder()
 #endif
 
     // checking for new plugins...
-    if (controller->vstScanIsNeeded()) { // no vsts in database cache or new plugins detected in scan folders?
+    if (settings.getVstPluginsPaths().isEmpty()) { // no vsts in database cache
         if (settings.getVstScanFolders().isEmpty())
             controller->addDefaultPluginsScanPath();
         controller->scanOnlyNewVstPlugins();
+        return;
     }
+
+    // walking the scan folders is slow, the new plugins are detected in a worker thread while the main window is showing
+    QStringList skipList(settings.getBlackListedPlugins());
+    skipList.append(settings.getVstPluginsPaths());
+
+    const qint64 startTime = StartupTimeline::elapsed();
+    auto watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [=]() {
+        StartupTimeline::record("Checking new VST plugins", startTime);
+        if (watcher->result())
+            controller->scanOnlyNewVstPlugins();
+
+        watcher->deleteLater();
+    });
+
+    watcher->setFuture(QtConcurrent::run(&MainControllerStandalone::hasNewVstPlugins, settings.getVstScanFolders(), skipList));
 }
 
 void MainWindowStandalone::setGlobalPreferences(const QList<bool> &midiInputsStatus, int audioInputDevice, int audioOutputDevice, int firstIn, int lastIn,
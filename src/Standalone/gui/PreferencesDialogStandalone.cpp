@@ -29,6 +29,20 @@ PreferencesDialogStandalone::PreferencesDialogStandalone(QWidget *parent, bool s
 
     connect(ui->comboSampleRate, SIGNAL(activated(int)), this, SLOT(notifySampleRateChanged()));
     connect(ui->comboBufferSize, SIGNAL(activated(int)), this, SLOT(notifyBufferSizeChanged()));
+
+#ifdef JAMTABA_JACK
+    connect(ui->checkBoxUseJack, &QCheckBox::clicked, this, &PreferencesDialogStandalone::usingJackChanged);
+#else
+    ui->checkBoxUseJack->setVisible(false);
+#endif
+}
+
+void PreferencesDialogStandalone::setAudioDriver(AudioDriver *audioDriver)
+{
+    this->audioDriver = audioDriver;
+    showAudioDriverControlPanelButton = audioDriver->hasControlPanel();
+
+    populateAudioTab();
 }
 
 void PreferencesDialogStandalone::notifyBufferSizeChanged()
@@ -268,6 +282,7 @@ void PreferencesDialogStandalone::populateAudioTab()
     populateBufferSizeCombo();
 
     ui->buttonControlPanel->setVisible(showAudioDriverControlPanelButton);
+    ui->checkBoxUseJack->setChecked(settings->isUsingJack());
 }
 
 void PreferencesDialogStandalone::populateAsioDriverCombo()
@@ -20,6 +20,8 @@ public:
     PreferencesDialogStandalone(QWidget *parent, bool showAudioControlPanelButton, audio::AudioDriver *audioDriver, midi::MidiDriver *midiDriver);
     void initialize(PreferencesTab initialTab, const persistence::Settings *settings, const QMap<QString, QString> &jamRecorders) override;
 
+    void setAudioDriver(audio::AudioDriver *audioDriver); // the audio driver is recreated when JACK is enabled or disabled
+
 public slots:
     void accept() override;
 
@@ -46,6 +48,7 @@ signals:
     void startingFullPluginsScan();
     void startingOnlyNewPluginsScan();
     void openingExternalAudioControlPanel(); // asio control panel in windows
+    void usingJackChanged(bool useJack); // Linux only
 
 private slots:
     void addBlackListedPlugins();
@@ -1,23 +1,30 @@
 #include <QApplication>
 #include <QMainWindow>
 #include <QDir>
+#include <QTimer>
 
 #include "MainControllerStandalone.h"
 #include "gui/MainWindowStandalone.h"
 #include "persistence/Settings.h"
 #include "log/Logging.h"
+#include "log/StartupTimeline.h"
 #include "SingleApplication/singleapplication.h"
 #include "Configurator.h"
 
 int main(int argc, char *args[])
 {
+    StartupTimeline::start();
+
     QApplication::setApplicationName("JamTaba 2");
     QApplication::setApplicationVersion(APP_VERSION);
 
+    qint64 phaseStart = StartupTimeline::elapsed();
     auto configurator = Configurator::getInstance();
     if (!configurator->setUp())
         qCritical() << "JTBConfig->setUp() FAILED !";
+    StartupTimeline::record("Configurator setup", phaseStart);
 
+    phaseStart = StartupTimeline::elapsed();
 // SingleApplication is not working in mac. Using a dirty ifdef until have time to solve the SingleApplication issue in Mac
 #ifdef Q_OS_WIN
     SingleApplication application(argc, args);
@@ -26,21 +33,37 @@ int main(int argc, char *args[])
 #endif
 
     application.setStyle("fusion"); // same visual in all platforms
+    StartupTimeline::record("Creating application", phaseStart);
 
+    // the settings are loaded after the QApplication creation, loading them uses Qt classes depending on the application instance
     persistence::Settings settings;
-    settings.load();
+    {
+        StartupPhase phase("Loading settings");
+        settings.load();
+    }
 
+    phaseStart = StartupTimeline::elapsed();
     controller::MainControllerStandalone mainController(settings, &application);
+    StartupTimeline::record("Creating main controller", phaseStart);
+
+    phaseStart = StartupTimeline::elapsed();
     mainController.start();
+    StartupTimeline::record("Starting audio and midi drivers", phaseStart);
 
     if (mainController.isUsingNullAudioDriver())
         QMessageBox::about(nullptr, "Fatal error!", "Jamtaba can't detect any audio device in your machine!");
 
+    phaseStart = StartupTimeline::elapsed();
     MainWindowStandalone mainWindow(&mainController);
     mainController.setMainWindow(&mainWindow);
+    StartupTimeline::record("Creating main window", phaseStart);
 
+    phaseStart = StartupTimeline::elapsed();
     mainWindow.initialize();
+    StartupTimeline::record("Initializing main window", phaseStart);
+
     mainWindow.show();
+    QTimer::singleShot(0, &StartupTimeline::finish); // the first event loop iteration, main window painted
 
     mainController.connectInJamtabaServer();
 
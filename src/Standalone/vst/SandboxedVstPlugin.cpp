@@ -0,0 +1,307 @@
+#include "SandboxedVstPlugin.h"
+
+#include "vst/VstHost.h"
+#include "vst/Utils.h"
+#include "audio/core/SamplesBuffer.h"
+#include "audio/core/AudioLoadMonitor.h"
+#include "midi/MidiMessage.h"
+#include "log/Logging.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QDebug>
+
+#include <cstring>
+#include <cassert>
+
+using vst::SandboxedVstPlugin;
+using audio::PluginSandboxChannel;
+
+const int SandboxedVstPlugin::LOAD_TIMEOUT = 30000; // the same timeout used when scanning plugins
+const int SandboxedVstPlugin::COMMAND_TIMEOUT = 5000;
+const int SandboxedVstPlugin::MAX_STALL_TIME = 2000;
+
+SandboxedVstPlugin::SandboxedVstPlugin(vst::VstHost *host, const QString &pluginPath) :
+    audio::Plugin(vst::utils::createDescriptor(nullptr, pluginPath)),
+    channel(PluginSandboxChannel::createKey()),
+    host(host),
+    virtualInstrument(false),
+    hasEditor(false),
+    loaded(false),
+    crashed(0),
+    stalledFrames(0)
+{
+    assert(host);
+
+    sandbox.setProcessChannelMode(QProcess::SeparateChannels);
+
+    QObject::connect(&sandbox, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, [=]() {
+        handleSandboxFinished();
+    });
+}
+
+SandboxedVstPlugin::~SandboxedVstPlugin()
+{
+    qCDebug(jtVstPlugin) << "destroying sandboxed plugin" << getName();
+
+    channel.shutdown();
+
+    if (sandbox.state() != QProcess::NotRunning) {
+        sandbox.disconnect();
+        sandbox.write("quit\n");
+        if (!sandbox.waitForFinished(COMMAND_TIMEOUT))
+            sandbox.kill();
+    }
+}
+
+QString SandboxedVstPlugin::getSandboxExecutablePath()
+{
+    // In the deployed and debug version the VstSandbox and Jamtaba2 executables are in the same folder.
+    QString sandboxExePath = QApplication::applicationDirPath() + "/VstSandbox";
+#ifdef Q_OS_WIN
+    sandboxExePath += ".exe";
+#endif
+    if (QFile(sandboxExePath).exists())
+        return sandboxExePath;
+
+    qCritical() << "Sandbox executable not founded in" << sandboxExePath;
+    return "";
+}
+
+bool SandboxedVstPlugin::load(const QString &path)
+{
+    loaded = false;
+
+    const QString sandboxExePath = getSandboxExecutablePath();
+    if (sandboxExePath.isEmpty())
+        return false;
+
+    if (!channel.create())
+        return false;
+
+    QStringList arguments;
+    arguments << path
+              << channel.getKey()
+              << QString::number(host->getSampleRate())
+              << QString::number(host->getBufferSize());
+
+    qCDebug(jtVstPlugin) << "starting sandbox for" << path;
+
+    sandbox.start(sandboxExePath, arguments);
+    if (!sandbox.waitForStarted(COMMAND_TIMEOUT)) {
+        qCritical() << "Can't start the plugin sandbox" << sandbox.errorString();
+        return false;
+    }
+
+    QString answer;
+    if (!sendCommand(QString(), "JT-Sandbox-Ready: ", &answer)) {
+        qCritical() << "The sandbox can't load" << path;
+        sandbox.kill();
+        return false;
+    }
+
+    // inputs outputs isSynth hasEditor name
+    virtualInstrument = answer.section(' ', 2, 2).toInt() != 0;
+    hasEditor = answer.section(' ', 3, 3).toInt() != 0;
+    name = answer.section(' ', 4);
+
+    descriptor = audio::PluginDescriptor(name, descriptor.getCategory(), descriptor.getManufacturer(), path);
+
+    this->path = path;
+    loaded = true;
+
+    qCDebug(jtVstPlugin) << name << "loaded in sandbox";
+
+    return true;
+}
+
+bool SandboxedVstPlugin::sendCommand(const QString &command, const QString &expectedAnswer, QString *answer) const
+{
+    if (sandbox.state() != QProcess::Running)
+        return false;
+
+    if (!command.isEmpty()) {
+        sandbox.write(command.toUtf8() + '\n');
+        sandbox.waitForBytesWritten(COMMAND_TIMEOUT);
+    }
+
+    if (expectedAnswer.isEmpty())
+        return true;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int timeout = command.isEmpty() ? LOAD_TIMEOUT : COMMAND_TIMEOUT;
+    while (timer.elapsed() < timeout) {
+        while (sandbox.canReadLine()) {
+            const QString line = QString::fromUtf8(sandbox.readLine()).trimmed();
+            if (line.startsWith("JT-Sandbox-Error: ")) {
+                qCritical() << line;
+                return false;
+            }
+
+            if (line.startsWith(expectedAnswer.trimmed())) { // trimmed, the answer can be empty
+                if (answer)
+                    *answer = line.mid(expectedAnswer.size());
+                return true;
+            }
+
+            if (!line.isEmpty())
+                qCDebug(jtVstPlugin) << "sandbox:" << line; // plugin output, editor closed notifications, etc.
+        }
+
+        if (sandbox.state() != QProcess::Running)
+            return false;
+
+        sandbox.waitForReadyRead(100);
+    }
+
+    qCritical() << "Timeout waiting the sandbox answer for" << command;
+
+    return false;
+}
+
+void SandboxedVstPlugin::handleSandboxFinished()
+{
+    if (crashed.testAndSetOrdered(0, 1))
+        qCritical() << "The sandbox running" << getName() << "finished! Exit code:" << sandbox.exitCode();
+
+    channel.shutdown();
+}
+
+qint64 SandboxedVstPlugin::getResponseTimeout(int frames) const
+{
+    const qint64 deadline = host->getCallbackDeadline();
+    if (deadline <= 0) // unknown callback start, half block period
+        return static_cast<qint64>(frames) * 500000 / qMax(host->getSampleRate(), 1);
+
+    // the other tracks and plugins are processed in the same callback, using at most half of the remaining time
+    return (deadline - audio::AudioLoadMonitor::timestamp()) / 2000;
+}
+
+void SandboxedVstPlugin::process(const audio::SamplesBuffer &in, audio::SamplesBuffer &outBuffer, midi::MidiBuffer &midiBuffer)
+{
+    if (isBypassed() || !loaded || crashed.loadAcquire())
+        return; // the input samples are passing through
+
+    const int frames = qMin(static_cast<int>(outBuffer.getFrameLenght()), PluginSandboxChannel::MAX_FRAMES);
+
+    if (channel.isWaitingResponse()) { // the sandbox is still processing a late block, passing through until it catch up
+        stalledFrames += frames;
+        if (stalledFrames * 1000 >= static_cast<qint64>(MAX_STALL_TIME) * host->getSampleRate() && crashed.testAndSetOrdered(0, 1))
+            qCritical() << "The sandbox running" << getName() << "is not responding!";
+        return;
+    }
+
+    stalledFrames = 0;
+
+    const qint64 timeoutUs = getResponseTimeout(frames);
+    if (timeoutUs <= 0)
+        return; // no time left in this callback
+
+    PluginSandboxChannel::Block *block = channel.getRequestBlock();
+    if (!block)
+        return;
+
+    block->frames = frames;
+    block->inputChannels = qMin(in.getChannels(), PluginSandboxChannel::MAX_CHANNELS);
+    for (int c = 0; c < block->inputChannels; ++c)
+        std::memcpy(block->input[c], in.getSamplesArray(c), frames * sizeof(float));
+
+    const int midiEvents = qMin(static_cast<int>(midiBuffer.size()), PluginSandboxChannel::MAX_MIDI_EVENTS);
+    block->midiEventsCount = midiEvents;
+    for (int m = 0; m < midiEvents; ++m) {
+        const midi::MidiMessage &message = midiBuffer[m];
+        block->midiEvents[m].data = message.getStatus() | (message.getData1() << 8) | (message.getData2() << 16);
+        block->midiEvents[m].deltaFrames = message.getDeltaFrames();
+    }
+
+    block->positionInSamples = host->getPositionInSamples();
+    block->tempo = host->getTempo();
+    block->playing = host->isPlaying() ? 1 : 0;
+
+    if (!channel.sendRequest(timeoutUs)) {
+        stalledFrames = frames;
+        return; // late block, the input samples are passing through
+    }
+
+    const int outChannels = qMin(static_cast<int>(block->outputChannels), outBuffer.getChannels());
+    for (int c = 0; c < outChannels; ++c) {
+        float *out = outBuffer.getSamplesArray(c);
+        const float *processed = block->output[c];
+        if (virtualInstrument) {
+            for (int s = 0; s < frames; ++s)
+                out[s] += processed[s]; // VSTis add and preserve the last generated output samples
+        }
+        else {
+            std::memcpy(out, processed, frames * sizeof(float)); // VSTs are replacing
+        }
+    }
+}
+
+void SandboxedVstPlugin::start()
+{
+    // the plugin is opened and resumed in the sandbox
+}
+
+void SandboxedVstPlugin::resume()
+{
+}
+
+void SandboxedVstPlugin::suspend()
+{
+}
+
+void SandboxedVstPlugin::updateGui()
+{
+    // the editor idle is done in the sandbox, here the stalled sandboxes are finished (in GUI thread)
+    if (crashed.loadAcquire() && sandbox.state() != QProcess::NotRunning) {
+        channel.shutdown();
+        sandbox.kill();
+    }
+}
+
+void SandboxedVstPlugin::setSampleRate(int newSampleRate)
+{
+    sendCommand(QString("sample-rate %1").arg(newSampleRate));
+}
+
+void SandboxedVstPlugin::setBypass(bool state)
+{
+    Plugin::setBypass(state);
+    sendCommand(QString("bypass %1").arg(state ? 1 : 0));
+}
+
+void SandboxedVstPlugin::openEditor(const QPoint &centerOfScreen)
+{
+    if (!hasEditor || isCrashed())
+        return;
+
+    sendCommand(QString("open-editor %1 %2").arg(centerOfScreen.x()).arg(centerOfScreen.y()));
+}
+
+void SandboxedVstPlugin::closeEditor()
+{
+    sendCommand("close-editor");
+}
+
+QByteArray SandboxedVstPlugin::getSerializedData() const
+{
+    QString answer;
+    if (!sendCommand("get-state", "JT-Sandbox-State: ", &answer))
+        return QByteArray();
+
+    qCDebug(jtVstPlugin) << "saving " << getName() << " state";
+
+    return QByteArray::fromBase64(answer.toLatin1());
+}
+
+void SandboxedVstPlugin::restoreFromSerializedData(const QByteArray &dataToRestore)
+{
+    if (dataToRestore.isEmpty())
+        return;
+
+    qCInfo(jtVstPlugin) << "\t\trestoring plugin data to" << getName();
+    sendCommand("set-state " + QString::fromLatin1(dataToRestore.toBase64()), "JT-Sandbox-State-Restored");
+}
@@ -0,0 +1,94 @@
+#ifndef SANDBOXED_VST_PLUGIN_H
+#define SANDBOXED_VST_PLUGIN_H
+
+#include "audio/core/Plugins.h"
+#include "audio/PluginSandboxChannel.h"
+
+#include <QProcess>
+#include <QAtomicInt>
+
+namespace vst {
+
+class VstHost;
+
+/**
+ * A VST plugin running in a VstSandbox process. A crashing or stalling plugin is not taking down
+ * Jamtaba: the audio blocks are exchanged with the sandbox in shared memory, waiting at most a fraction
+ * of the remaining audio callback time. After the first late block the plugin is passing the input
+ * samples through (like a bypassed plugin) until the sandbox catch up, and when the sandbox crash or
+ * stay stalled for MAX_STALL_TIME the plugin is bypassed until removed by the user.
+ */
+
+class SandboxedVstPlugin : public audio::Plugin
+{
+public:
+    SandboxedVstPlugin(vst::VstHost *host, const QString &pluginPath);
+    ~SandboxedVstPlugin();
+
+    bool load(const QString &path);
+
+    void process(const audio::SamplesBuffer &in, audio::SamplesBuffer &outBuffer, midi::MidiBuffer &midiBuffer) override;
+
+    void openEditor(const QPoint &centerOfScreen) override;
+    void closeEditor() override;
+
+    QString getPath() const override;
+
+    QByteArray getSerializedData() const override;
+    void restoreFromSerializedData(const QByteArray &dataToRestore) override;
+
+    void start() override;
+    void updateGui() override;
+    void setSampleRate(int newSampleRate) override;
+    void setBypass(bool state) override;
+
+    bool isVirtualInstrument() const override;
+
+    bool isCrashed() const;
+
+    static QString getSandboxExecutablePath();
+
+    static const int LOAD_TIMEOUT; // milliseconds
+    static const int COMMAND_TIMEOUT; // milliseconds
+    static const int MAX_STALL_TIME; // milliseconds of audio without the sandbox responding, the sandbox is stalled
+
+protected:
+    void resume() override;
+    void suspend() override;
+
+private:
+    bool sendCommand(const QString &command, const QString &expectedAnswer = QString(), QString *answer = nullptr) const;
+    void handleSandboxFinished();
+    qint64 getResponseTimeout(int frames) const; // microseconds, audio thread
+
+    mutable QProcess sandbox;
+    audio::PluginSandboxChannel channel;
+    vst::VstHost *host;
+
+    QString path;
+    bool virtualInstrument;
+    bool hasEditor;
+    bool loaded;
+
+    QAtomicInt crashed;
+    qint64 stalledFrames; // audio thread only, frames passed through since the last late block
+};
+
+inline QString SandboxedVstPlugin::getPath() const
+{
+    return path;
+}
+
+inline bool SandboxedVstPlugin::isVirtualInstrument() const
+{
+    return virtualInstrument;
+}
+
+inline bool SandboxedVstPlugin::isCrashed() const
+{
+    return crashed.loadAcquire() != 0;
+}
+
+} // namespace
+
+#endif
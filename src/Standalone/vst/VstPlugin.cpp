@@ -211,16 +211,17 @@ void VstPlugin::unload()
     }
 }
 
-void VstPlugin::fillVstEventsList(const std::vector<midi::MidiMessage> &midiBuffer)
+void VstPlugin::fillVstEventsList(const midi::MidiBuffer &midiBuffer)
 {
     int midiMessages = qMin((int)midiBuffer.size(), (int)MAX_MIDI_EVENTS);
     this->vstMidiEvents.numEvents = midiMessages;
     for (int m = 0; m < midiMessages; ++m) {
-        auto message = midiBuffer.at(m);
+        const auto &message = midiBuffer[m];
         VstMidiEvent* vstEvent = (VstMidiEvent*)vstMidiEvents.events[m];
         vstEvent->type = kVstMidiType;
         vstEvent->byteSize = sizeof(vstEvent);
-        vstEvent->deltaFrames = vstEvent->reserved1 = vstEvent->reserved2 = 0;
+        vstEvent->deltaFrames = message.getDeltaFrames(); // sample accurate, the offset inside the processed block
+        vstEvent->reserved1 = vstEvent->reserved2 = 0;
         vstEvent->midiData[0] = message.getStatus();
         vstEvent->midiData[1] = message.getData1();
         vstEvent->midiData[2] = message.getData2();
@@ -229,7 +230,7 @@ void VstPlugin::fillVstEventsList(const std::vector<midi::MidiMessage> &midiBuff
     }
 }
 
-void VstPlugin::process(const audio::SamplesBuffer &in, audio::SamplesBuffer &outBuffer, std::vector<midi::MidiMessage> &midiBuffer)
+void VstPlugin::process(const audio::SamplesBuffer &in, audio::SamplesBuffer &outBuffer, midi::MidiBuffer &midiBuffer)
 {
 
     Q_UNUSED(in)
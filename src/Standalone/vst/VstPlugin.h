@@ -25,7 +25,7 @@ public:
     explicit VstPlugin(vst::VstHost *host, const QString &pluginPath);
     ~VstPlugin();
 
-    void process(const audio::SamplesBuffer &vstInputArray, audio::SamplesBuffer &outBuffer, std::vector<midi::MidiMessage> &midiBuffer) override;
+    void process(const audio::SamplesBuffer &vstInputArray, audio::SamplesBuffer &outBuffer, midi::MidiBuffer &midiBuffer) override;
     void openEditor(const QPoint &centerOfScreen) override;
 
     void closeEditor() override;
@@ -81,7 +81,7 @@ private:
 
     bool loaded;
 
-    void fillVstEventsList(const std::vector<midi::MidiMessage> &midiBuffer);
+    void fillVstEventsList(const midi::MidiBuffer &midiBuffer);
 
     template<int N>
     struct VSTEventBlock
@@ -1,27 +1,310 @@
 #include "VstPluginFinder.h"
+#include "VstPluginChecker.h"
 
 #include <QApplication>
 #include <QLibraryInfo>
+#include <QDirIterator>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
+#include <QSet>
+#include <QThread>
 
 #include "log/Logging.h"
 
 using audio::VSTPluginFinder;
+using audio::VstScanDatabase;
 
-VSTPluginFinder::VSTPluginFinder()
+const int VSTPluginFinder::MAX_SCAN_PROCESSES = 4;
+const int VSTPluginFinder::PLUGIN_SCAN_TIMEOUT = 30000;
+
+VSTPluginFinder::VSTPluginFinder(const QDir &cacheDir) :
+    database(cacheDir),
+    scanning(false),
+    canceled(false),
+    badPluginsDetected(false)
 {
-    //
+    database.load();
+
+    watchdog.setInterval(1000);
+    connect(&watchdog, &QTimer::timeout, this, &VSTPluginFinder::killTimedOutJobs);
 }
 
 VSTPluginFinder::~VSTPluginFinder()
 {
-    //
+    watchdog.stop();
+
+    for (ScanJob *job : jobs) {
+        if (!job->process)
+            continue;
+
+        job->process->disconnect(this); // the 'finished' signal is not handled while destroying
+        job->process->kill();
+        job->process->waitForFinished(1000);
+        delete job->process;
+    }
+
+    qDeleteAll(jobs);
+    jobs.clear();
+
+    database.save();
+}
+
+void VSTPluginFinder::scan(const QStringList &foldersToScan, const QStringList &skipList)
+{
+    if (scanning) {
+        qCritical() << "VST scan is already running!";
+        return;
+    }
+
+    scannerExePath = getScannerExecutablePath();
+    if (scannerExePath.isEmpty())
+        return; // scanner executable not found!
+
+    scanning = true;
+    canceled = false;
+    badPluginsDetected = false;
+
+    emit scanStarted();
+
+    // walking the scan folders is slow, the candidate plugins are collected in a worker thread
+    auto watcher = new QFutureWatcher<QStringList>(this);
+    connect(watcher, &QFutureWatcher<QStringList>::finished, this, [=]() {
+        QStringList plugins = watcher->result();
+        watcher->deleteLater();
+
+        if (canceled) {
+            finishScanIfDone();
+            return;
+        }
+
+        startScanJobs(plugins);
+    });
+
+    watcher->setFuture(QtConcurrent::run(&VSTPluginFinder::collectPlugins, foldersToScan, skipList));
+}
+
+QStringList VSTPluginFinder::collectPlugins(const QStringList &foldersToScan, const QStringList &skipList)
+{
+    const QSet<QString> skipSet = skipList.toSet();
+
+    QStringList plugins;
+    for (const QString &scanFolder : foldersToScan) {
+        QDirIterator folderIterator(scanFolder, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDirIterator::Subdirectories);
+        while (folderIterator.hasNext()) {
+            folderIterator.next(); // point to next file inside current folder
+            QFileInfo pluginFileInfo(folderIterator.fileInfo());
+            const QString pluginPath = pluginFileInfo.absoluteFilePath();
+
+            if (skipSet.contains(pluginPath) || !isPluginCandidate(pluginFileInfo))
+                continue;
+
+            if (Vst::PluginChecker::isValidPluginFile(pluginPath))
+                plugins.append(pluginPath);
+        }
+    }
+
+    return plugins;
+}
+
+bool VSTPluginFinder::isPluginCandidate(const QFileInfo &fileInfo)
+{
+    // In Mac VST plugins are bundles, in windows these plugins are DLLs and in Linux shared objects.
+
+#ifdef Q_OS_LINUX
+    return fileInfo.suffix() == "so";
+#else
+    return fileInfo.isBundle() || fileInfo.suffix() == "dll";
+#endif
+}
+
+void VSTPluginFinder::startScanJobs(const QStringList &plugins)
+{
+    // unchanged plugins are recovered from the database, only new and updated plugins are loaded
+    QStringList pluginsToScan;
+    for (const QString &pluginPath : plugins) {
+        VstScanDatabase::ScanResult result;
+        QString pluginName;
+        if (database.getScanResult(QFileInfo(pluginPath), result, pluginName)) {
+            if (result == VstScanDatabase::VALID_PLUGIN)
+                emit pluginScanFinished(pluginName, pluginPath);
+        }
+        else {
+            pluginsToScan.append(pluginPath);
+        }
+    }
+
+    qCInfo(jtStandalonePluginFinder) << plugins.size() << "VST plugins found," << pluginsToScan.size() << "new or updated plugins to scan";
+
+    const int processes = qBound(1, qMin(QThread::idealThreadCount(), MAX_SCAN_PROCESSES), qMax(1, pluginsToScan.size()));
+
+    // interleaved partitions, plugins in the same folder (same vendor, similar load times) are scanned in parallel
+    for (int p = 0; p < processes && p < pluginsToScan.size(); ++p) {
+        ScanJob *job = new ScanJob();
+        job->process = nullptr;
+        job->timedOut = false;
+
+        for (int i = p; i < pluginsToScan.size(); i += processes)
+            job->pendingPlugins.append(pluginsToScan.at(i));
+
+        jobs.append(job);
+        startScanJob(job);
+    }
+
+    if (jobs.isEmpty()) {
+        finishScanIfDone();
+        return;
+    }
+
+    watchdog.start();
+}
+
+void VSTPluginFinder::startScanJob(ScanJob *job)
+{
+    job->process = new QProcess(this);
+    job->currentPlugin.clear();
+    job->timedOut = false;
+
+    connect(job->process, &QProcess::readyReadStandardOutput, this, [=]() {
+        consumeOutputFromScanJob(job);
+    });
+
+    connect(job->process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, [=](int exitCode, QProcess::ExitStatus exitStatus) {
+        Q_UNUSED(exitCode);
+        finishScanJob(job, !canceled && (exitStatus == QProcess::CrashExit || job->timedOut)); // canceled scanners are terminated, not crashed
+    });
+
+    connect(job->process, static_cast<void (QProcess::*)(QProcess::ProcessError)>(&QProcess::error), this, [=](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) { // 'finished' is not emitted
+            qCritical() << error << job->process->errorString();
+            job->pendingPlugins.clear();
+            finishScanJob(job, false);
+        }
+    });
+
+    // execute the scanner in another process to avoid crash Jamtaba process. The plugins paths are sent in stdin, avoiding the command line length limit
+    job->process->start(scannerExePath, QStringList() << "--plugins");
+    job->process->write(job->pendingPlugins.join('\n').toUtf8());
+    job->process->closeWriteChannel();
+
+    qCDebug(jtStandalonePluginFinder)
+            << "Scan process started with "
+            << scannerExePath
+            << " (PID: " << job->process->processId() << ")"
+            << job->pendingPlugins.size() << "plugins to scan";
+}
+
+void VSTPluginFinder::consumeOutputFromScanJob(ScanJob *job)
+{
+    while (job->process->canReadLine()) {
+        QString readedLine = QString::fromUtf8(job->process->readLine()).trimmed();
+        if (readedLine.isEmpty())
+            continue;
+
+        if (readedLine.startsWith("JT-Scanner-Scanning:")) {
+            if (!job->currentPlugin.isEmpty()) // the last plugin was not loaded by the scanner
+                finishCurrentPlugin(job, VstScanDatabase::INVALID_PLUGIN);
+
+            job->currentPlugin = extractPluginPath(readedLine);
+            job->currentPluginTimer.start();
+            job->pendingPlugins.removeOne(job->currentPlugin);
+
+            handleScanningStart(readedLine);
+        }
+        else if (readedLine.startsWith("JT-Scanner-Scan-Finished")) {
+            handleScanningFinished(readedLine);
+            job->currentPlugin.clear();
+        }
+    }
 }
 
-audio::PluginDescriptor VSTPluginFinder::getPluginDescriptor(const QFileInfo &f)
+void VSTPluginFinder::finishCurrentPlugin(ScanJob *job, VstScanDatabase::ScanResult result)
 {
-    QString name = audio::PluginDescriptor::getVstPluginNameFromPath(f.absoluteFilePath());
-    auto category = audio::PluginDescriptor::VST_Plugin;
-    return audio::PluginDescriptor(name, category, f.absoluteFilePath());
+    database.setScanResult(QFileInfo(job->currentPlugin), result);
+    job->currentPlugin.clear();
+}
+
+void VSTPluginFinder::finishScanJob(ScanJob *job, bool crashed)
+{
+    consumeOutputFromScanJob(job); // the last lines
+
+    QString lastScannedPlugin(job->currentPlugin);
+    job->currentPlugin.clear();
+
+    job->process->disconnect(this);
+    job->process->deleteLater();
+    job->process = nullptr;
+
+    if (!lastScannedPlugin.isEmpty() && !canceled) {
+        if (crashed) {
+            qCInfo(jtStandalonePluginFinder) << (job->timedOut ? "Plugin scan timed out:" : "Plugin crashed the scanner:") << lastScannedPlugin;
+            badPluginsDetected = true;
+            handleProcessError(lastScannedPlugin); // the bad plugin is black listed
+        }
+        else {
+            database.setScanResult(QFileInfo(lastScannedPlugin), VstScanDatabase::INVALID_PLUGIN);
+        }
+    }
+
+    if (crashed && !canceled && !job->pendingPlugins.isEmpty()) {
+        startScanJob(job); // scanning the remaining plugins in a new process
+        return;
+    }
+
+    jobs.removeOne(job);
+    delete job;
+
+    finishScanIfDone();
+}
+
+void VSTPluginFinder::killTimedOutJobs()
+{
+    for (ScanJob *job : jobs) {
+        if (!job->process || job->currentPlugin.isEmpty() || job->timedOut)
+            continue;
+
+        if (job->currentPluginTimer.elapsed() > PLUGIN_SCAN_TIMEOUT) {
+            job->timedOut = true;
+            job->process->kill(); // the plugin is handled as a crashed plugin when the process is finished
+        }
+    }
+}
+
+void VSTPluginFinder::finishScanIfDone()
+{
+    if (!scanning || !jobs.isEmpty())
+        return;
+
+    watchdog.stop();
+    scanning = false;
+
+    database.save();
+
+    qCDebug(jtStandalonePluginFinder) << "VST scan finished! canceled:" << canceled << "bad plugins detected:" << badPluginsDetected;
+
+    emit scanFinished(!canceled && !badPluginsDetected);
+}
+
+void VSTPluginFinder::cancel()
+{
+    if (!scanning)
+        return;
+
+    qCDebug(jtStandalonePluginFinder) << "Terminating scan processes!";
+
+    canceled = true;
+    for (ScanJob *job : jobs) {
+        job->pendingPlugins.clear();
+        if (job->process)
+            job->process->terminate();
+    }
+}
+
+void VSTPluginFinder::clearScanDatabase()
+{
+    qCDebug(jtStandalonePluginFinder) << "Clearing the VST scan database";
+
+    database.clear();
+    database.save();
 }
 
 QString VSTPluginFinder::getScannerExecutablePath() const
@@ -38,28 +321,32 @@ QString VSTPluginFinder::getScannerExecutablePath() const
     return "";
 }
 
-void VSTPluginFinder::handleScanningStart(const QString &scannedLine)
+QString VSTPluginFinder::extractPluginPath(const QString &scannedLine)
 {
-    QStringList parts = scannedLine.split(": ");
-    if (parts.size() < 2) {
+    int index = scannedLine.indexOf(": ");
+    if (index < 0) {
         qCritical() << "Missing parts in scanned line: " << scannedLine;
-        return;
+        return QString();
     }
 
-    QString pluginPath = parts.at(1);
-    lastScannedPlugin = pluginPath;// store the plugin path, if the scanner process crash we can add this bad plugin in the black list
-    emit pluginScanStarted(pluginPath);
+    return scannedLine.mid(index + 2);
+}
+
+void VSTPluginFinder::handleScanningStart(const QString &scannedLine)
+{
+    QString pluginPath = extractPluginPath(scannedLine);
+    if (!pluginPath.isEmpty())
+        emit pluginScanStarted(pluginPath);
 }
 
 void VSTPluginFinder::handleScanningFinished(const QString &scannedLine)
 {
-    QStringList parts = scannedLine.split(": ");
-    if (parts.size() < 2) {
-        qCritical() << "Missing parts in scanned line: " << scannedLine;
+    QString pluginPath = extractPluginPath(scannedLine);
+    if (pluginPath.isEmpty())
         return;
-    }
 
-    QString pluginPath = parts.at(1);
     QString pluginName = audio::PluginDescriptor::getVstPluginNameFromPath(pluginPath);
+    database.setScanResult(QFileInfo(pluginPath), VstScanDatabase::VALID_PLUGIN, pluginName);
+
     emit pluginScanFinished(pluginName, pluginPath);
 }
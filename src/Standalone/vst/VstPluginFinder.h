@@ -2,17 +2,38 @@
 #define VSTPLUGINFINDER_H
 
 #include "PluginFinder.h"
+#include "VstScanDatabase.h"
 #include "audio/core/PluginDescriptor.h"
 
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QList>
+
 namespace audio {
 
+/**
+ * The VST plugins are scanned by several scanner processes running in parallel, each process
+ * loading a partition of the candidate plugins. The unchanged plugins are not loaded again, the
+ * previous results are recovered from the scan database. A scanner process is killed when a plugin
+ * is taking too long to load, and a crashed (or killed) process is restarted to scan the remaining
+ * plugins of your partition. The crashed and timed out plugins are reported as bad plugins.
+ */
+
 class VSTPluginFinder : public PluginFinder
 {
 
 public:
-    VSTPluginFinder();
+    explicit VSTPluginFinder(const QDir &cacheDir);
     virtual ~VSTPluginFinder();
 
+    void scan(const QStringList &foldersToScan = QStringList(), const QStringList &skipList = QStringList()) override;
+    void cancel() override;
+
+    void clearScanDatabase(); // the invalid plugins are loaded again in the next scan
+
+    static const int MAX_SCAN_PROCESSES;
+    static const int PLUGIN_SCAN_TIMEOUT; // milliseconds
+
 protected:
     QString getScannerExecutablePath() const override;
 
@@ -20,11 +41,34 @@ protected:
     void handleScanningFinished(const QString &scannedLine) override;
 
 private:
-    QProcess scanProcess;
-    QString lastScannedPlugin; // used to recover the last plugin path when the scanner process crash
+    struct ScanJob
+    {
+        QProcess *process;
+        QStringList pendingPlugins; // not scanned yet, used to restart the job when the process crash
+        QString currentPlugin; // the plugin loaded by the scanner process right now
+        QElapsedTimer currentPluginTimer;
+        bool timedOut;
+    };
+
+    static QStringList collectPlugins(const QStringList &foldersToScan, const QStringList &skipList); // running in a worker thread
+    static bool isPluginCandidate(const QFileInfo &fileInfo);
+    static QString extractPluginPath(const QString &scannedLine);
 
-    audio::PluginDescriptor getPluginDescriptor(const QFileInfo &f);
+    void startScanJobs(const QStringList &plugins);
+    void startScanJob(ScanJob *job);
+    void consumeOutputFromScanJob(ScanJob *job);
+    void finishScanJob(ScanJob *job, bool crashed);
+    void finishCurrentPlugin(ScanJob *job, VstScanDatabase::ScanResult result);
+    void killTimedOutJobs();
+    void finishScanIfDone();
 
+    VstScanDatabase database;
+    QList<ScanJob *> jobs;
+    QTimer watchdog;
+    QString scannerExePath;
+    bool scanning;
+    bool canceled;
+    bool badPluginsDetected;
 };
 
 } // namespace
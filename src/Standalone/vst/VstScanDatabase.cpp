@@ -0,0 +1,180 @@
+#include "VstScanDatabase.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QXmlStreamReader>
+
+#include "log/Logging.h"
+
+using audio::VstScanDatabase;
+
+const QString VstScanDatabase::FILE_NAME("vst_scan.bin");
+const quint32 VstScanDatabase::SIGNATURE = 0x4A545653; // 'JTVS'
+const quint32 VstScanDatabase::REVISION = 1;
+
+VstScanDatabase::VstScanDatabase(const QDir &cacheDir) :
+    filePath(cacheDir.absoluteFilePath(FILE_NAME)),
+    modified(false)
+{
+
+}
+
+bool VstScanDatabase::load()
+{
+    entries.clear();
+    modified = false;
+
+    QFile file(filePath);
+    if (!file.exists())
+        return true; // first scan, nothing to load
+
+    if (!file.open(QFile::ReadOnly)) {
+        qCritical() << "Can't open the VST scan database" << filePath << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+
+    quint32 signature = 0;
+    quint32 revision = 0;
+    stream >> signature >> revision;
+    if (signature != SIGNATURE || revision != REVISION) {
+        qCWarning(jtStandalonePluginFinder) << "Discarding VST scan database with invalid revision" << revision;
+        return false; // all plugins will be scanned again
+    }
+
+    quint32 count = 0;
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Entry entry;
+        quint8 result = 0;
+        stream >> path >> entry.fileSize >> entry.lastModified >> result >> entry.name;
+        entry.result = result == VALID_PLUGIN ? VALID_PLUGIN : INVALID_PLUGIN;
+        entries.insert(path, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCritical() << "Error reading the VST scan database" << filePath;
+        entries.clear();
+        return false;
+    }
+
+    qCDebug(jtStandalonePluginFinder) << entries.size() << "plugins loaded from VST scan database";
+
+    return true;
+}
+
+bool VstScanDatabase::save() const
+{
+    if (!modified)
+        return true;
+
+    QSaveFile file(filePath); // the old database is not lost if Jamtaba crash while saving
+    if (!file.open(QFile::WriteOnly)) {
+        qCritical() << "Can't save the VST scan database" << filePath << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream << SIGNATURE << REVISION << static_cast<quint32>(entries.size());
+    for (auto i = entries.constBegin(); i != entries.constEnd(); ++i) {
+        const Entry &entry = i.value();
+        stream << i.key() << entry.fileSize << entry.lastModified << static_cast<quint8>(entry.result) << entry.name;
+    }
+
+    if (!file.commit()) {
+        qCritical() << "Error saving the VST scan database" << filePath << file.errorString();
+        return false;
+    }
+
+    modified = false;
+
+    return true;
+}
+
+bool VstScanDatabase::getScanResult(const QFileInfo &pluginFile, ScanResult &result, QString &pluginName) const
+{
+    auto i = entries.constFind(pluginFile.absoluteFilePath());
+    if (i == entries.constEnd())
+        return false;
+
+    const Entry &entry = i.value();
+    const QFileInfo pluginBinary = getPluginBinary(pluginFile);
+    if (entry.fileSize != pluginBinary.size() || entry.lastModified != pluginBinary.lastModified().toMSecsSinceEpoch())
+        return false; // plugin updated
+
+    result = entry.result;
+    pluginName = entry.name;
+
+    return true;
+}
+
+void VstScanDatabase::setScanResult(const QFileInfo &pluginFile, ScanResult result, const QString &pluginName)
+{
+    const QFileInfo pluginBinary = getPluginBinary(pluginFile);
+
+    Entry entry;
+    entry.fileSize = pluginBinary.size();
+    entry.lastModified = pluginBinary.lastModified().toMSecsSinceEpoch();
+    entry.result = result;
+    entry.name = pluginName;
+
+    entries.insert(pluginFile.absoluteFilePath(), entry);
+    modified = true;
+}
+
+void VstScanDatabase::clear()
+{
+    if (entries.isEmpty())
+        return;
+
+    entries.clear();
+    modified = true;
+}
+
+QFileInfo VstScanDatabase::getPluginBinary(const QFileInfo &pluginFile)
+{
+    if (!pluginFile.isDir())
+        return pluginFile;
+
+    // the bundle directory is not changed when the plugin is updated, using 'Contents/MacOS/<CFBundleExecutable>'
+    const QDir contentsDir(pluginFile.absoluteFilePath() + "/Contents");
+    QString executableName = getBundleExecutableName(contentsDir.absoluteFilePath("Info.plist"));
+    if (executableName.isEmpty())
+        executableName = pluginFile.completeBaseName();
+
+    const QFileInfo executable(contentsDir.absoluteFilePath("MacOS/" + executableName));
+    if (!executable.exists()) {
+        qCWarning(jtStandalonePluginFinder) << "Bundle executable not found in" << pluginFile.absoluteFilePath();
+        return pluginFile;
+    }
+
+    return executable;
+}
+
+QString VstScanDatabase::getBundleExecutableName(const QString &infoPlistPath)
+{
+    QFile file(infoPlistPath);
+    if (!file.open(QFile::ReadOnly))
+        return QString();
+
+    // XML property list, '<key>CFBundleExecutable</key>' followed by '<string>executable name</string>'
+    QXmlStreamReader xml(&file);
+    bool executableKey = false;
+    while (!xml.atEnd()) { // binary property lists are invalid XML, ending here
+        if (xml.readNext() != QXmlStreamReader::StartElement)
+            continue;
+
+        if (xml.name() == QLatin1String("key")) {
+            executableKey = xml.readElementText() == QLatin1String("CFBundleExecutable");
+        }
+        else if (executableKey) {
+            return xml.name() == QLatin1String("string") ? xml.readElementText().trimmed() : QString();
+        }
+    }
+
+    return QString(); // using the bundle name
+}
@@ -0,0 +1,68 @@
+#ifndef VST_SCAN_DATABASE_H
+#define VST_SCAN_DATABASE_H
+
+#include <QString>
+#include <QHash>
+#include <QDir>
+#include <QFileInfo>
+
+namespace audio {
+
+/**
+ * Persistent results of the VST scanning, keyed by the plugin path. The plugin file size and
+ * modification time are stored with the scan result, so only new or changed plugins are loaded again
+ * by the scanner processes. Crashed plugins are not stored here, they are black listed.
+ * The Mac plugins are bundles (directories), the bundle executable size and modification time are used.
+ */
+
+class VstScanDatabase
+{
+public:
+    enum ScanResult : quint8
+    {
+        VALID_PLUGIN,
+        INVALID_PLUGIN // not loaded by the scanner, or not a VST
+    };
+
+    explicit VstScanDatabase(const QDir &cacheDir);
+
+    bool load();
+    bool save() const;
+
+    // return false when the plugin was not scanned yet or the file changed after the last scan
+    bool getScanResult(const QFileInfo &pluginFile, ScanResult &result, QString &pluginName) const;
+
+    void setScanResult(const QFileInfo &pluginFile, ScanResult result, const QString &pluginName = QString());
+    void clear(); // all plugins are loaded again in the next scan
+
+    int size() const;
+
+private:
+    struct Entry
+    {
+        qint64 fileSize;
+        qint64 lastModified; // msecs since epoch
+        ScanResult result;
+        QString name;
+    };
+
+    static QFileInfo getPluginBinary(const QFileInfo &pluginFile);
+    static QString getBundleExecutableName(const QString &infoPlistPath);
+
+    QHash<QString, Entry> entries;
+    QString filePath;
+    mutable bool modified; // saving only when the scan changed something
+
+    static const QString FILE_NAME;
+    static const quint32 SIGNATURE;
+    static const quint32 REVISION;
+};
+
+inline int VstScanDatabase::size() const
+{
+    return entries.size();
+}
+
+} // namespace
+
+#endif
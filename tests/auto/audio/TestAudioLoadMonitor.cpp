@@ -0,0 +1,139 @@
+#include "TestAudioLoadMonitor.h"
+#include "audio/core/AudioLoadMonitor.h"
+
+#include <QtTest/QtTest>
+
+using audio::AudioLoadMonitor;
+using audio::ProcessingTime;
+
+namespace {
+
+const int FRAMES = 128;
+const int SAMPLE_RATE = 48000;
+const qint64 DEADLINE = static_cast<qint64>(FRAMES) * 1000000000 / SAMPLE_RATE; // 2.666 ms
+
+// callbacks in time, each one processed in 'durations[i]' nanoseconds
+qint64 addCallbacks(AudioLoadMonitor &monitor, const QList<qint64> &durations, qint64 start = 1000)
+{
+    for (qint64 duration : durations) {
+        monitor.addCallback(start, start + duration, FRAMES, SAMPLE_RATE);
+        start += DEADLINE;
+    }
+    return start;
+}
+
+} // namespace
+
+void TestAudioLoadMonitor::stats()
+{
+    AudioLoadMonitor monitor(DEADLINE * 100); // publishing each 100 callbacks
+
+    QList<qint64> durations;
+    for (int i = 0; i < 98; ++i)
+        durations << 500000; // 0.5 ms
+
+    durations << 2000000; // 2 ms
+    qint64 start = addCallbacks(monitor, durations);
+
+    AudioLoadMonitor::Stats stats;
+    QVERIFY(!monitor.takeStats(stats)); // the window is not complete
+
+    addCallbacks(monitor, QList<qint64>() << 3000000, start); // 3 ms, missing the deadline
+
+    QVERIFY(monitor.takeStats(stats));
+    QCOMPARE(stats.callbacks, 100);
+    QCOMPARE(stats.minNs, static_cast<qint64>(500000));
+    QCOMPARE(stats.maxNs, static_cast<qint64>(3000000));
+    QCOMPARE(stats.averageNs, static_cast<qint64>((98 * 500000LL + 2000000 + 3000000) / 100));
+    QCOMPARE(stats.p99Ns, static_cast<qint64>(2000000 + AudioLoadMonitor::HISTOGRAM_BIN_WIDTH)); // the bin upper limit
+    QCOMPARE(stats.deadlineNs, DEADLINE);
+    QCOMPARE(stats.totalDeadlineNs, DEADLINE * 100);
+    QCOMPARE(stats.deadlineMisses, 1);
+    QCOMPARE(stats.lateCallbacks, 0);
+    QCOMPARE(monitor.getTotalDeadlineMisses(), 1);
+
+    QVERIFY(qAbs(stats.getLoad(stats.maxNs) - 3000000 * 100.0f / DEADLINE) < 0.01f);
+
+    QVERIFY(!monitor.takeStats(stats)); // already taken
+}
+
+void TestAudioLoadMonitor::lateCallbacks()
+{
+    AudioLoadMonitor monitor(DEADLINE * 3);
+
+    monitor.addCallback(DEADLINE, DEADLINE + 1000, FRAMES, SAMPLE_RATE);
+    monitor.addCallback(DEADLINE * 3, DEADLINE * 3 + 1000, FRAMES, SAMPLE_RATE); // one callback was lost (dropout)
+    monitor.addCallback(DEADLINE * 4, DEADLINE * 4 + 1000, FRAMES, SAMPLE_RATE);
+
+    AudioLoadMonitor::Stats stats;
+    QVERIFY(monitor.takeStats(stats));
+    QCOMPARE(stats.callbacks, 3);
+    QCOMPARE(stats.lateCallbacks, 1);
+    QCOMPARE(stats.deadlineMisses, 0);
+    QCOMPARE(monitor.getTotalLateCallbacks(), 1);
+    QCOMPARE(monitor.getTotalDeadlineMisses(), 0);
+}
+
+void TestAudioLoadMonitor::driverRestartIsNotLateCallback()
+{
+    AudioLoadMonitor monitor(DEADLINE * 3);
+
+    monitor.addCallback(DEADLINE, DEADLINE + 1000, FRAMES, SAMPLE_RATE);
+
+    monitor.reset(); // the driver was stopped and started again some seconds later
+    const qint64 restart = DEADLINE * 1000;
+    monitor.addCallback(restart, restart + 1000, FRAMES, SAMPLE_RATE);
+    monitor.addCallback(restart + DEADLINE * 3, restart + DEADLINE * 3 + 1000, FRAMES, SAMPLE_RATE); // the late callbacks are counted again
+
+    AudioLoadMonitor::Stats stats;
+    QVERIFY(monitor.takeStats(stats));
+    QCOMPARE(stats.callbacks, 3);
+    QCOMPARE(stats.lateCallbacks, 1);
+    QCOMPARE(monitor.getTotalLateCallbacks(), 1);
+}
+
+void TestAudioLoadMonitor::noCallbacks()
+{
+    AudioLoadMonitor monitor;
+    AudioLoadMonitor::Stats stats;
+    QVERIFY(!monitor.takeStats(stats));
+}
+
+void TestAudioLoadMonitor::windowIsExtendedUntilTaken()
+{
+    AudioLoadMonitor monitor(DEADLINE * 2);
+    qint64 start = addCallbacks(monitor, QList<qint64>() << 3000000 << 1000); // published
+    start = addCallbacks(monitor, QList<qint64>() << 1000 << 2000, start); // the reader is late, the next window is extended
+
+    AudioLoadMonitor::Stats stats;
+    QVERIFY(monitor.takeStats(stats));
+    QCOMPARE(stats.callbacks, 2);
+    QCOMPARE(stats.deadlineMisses, 1);
+
+    QVERIFY(!monitor.takeStats(stats));
+
+    addCallbacks(monitor, QList<qint64>() << 1000, start);
+    QVERIFY(monitor.takeStats(stats));
+    QCOMPARE(stats.callbacks, 3);
+    QCOMPARE(stats.deadlineMisses, 0); // the deadline miss was in the previous window
+    QCOMPARE(stats.maxNs, static_cast<qint64>(2000));
+    QCOMPARE(monitor.getTotalDeadlineMisses(), 1);
+}
+
+void TestAudioLoadMonitor::processingTimeIsWrapping()
+{
+    ProcessingTime time;
+    time.add(1000);
+    QCOMPARE(time.takeElapsed(), 1000u);
+    QCOMPARE(time.takeElapsed(), 0u);
+
+    // more than 4.29 seconds of accumulated processing, the elapsed time between two reads is still correct
+    for (int i = 0; i < 5; ++i) {
+        time.add(1000000000);
+        QCOMPARE(time.takeElapsed(), 1000000000u);
+    }
+
+    time.add(1500000000);
+    time.add(1500000000);
+    QCOMPARE(time.takeElapsed(), 3000000000u);
+}
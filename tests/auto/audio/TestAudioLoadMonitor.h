@@ -0,0 +1,19 @@
+#ifndef TEST_AUDIO_LOAD_MONITOR_H
+#define TEST_AUDIO_LOAD_MONITOR_H
+
+#include <QObject>
+
+class TestAudioLoadMonitor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void stats(); // min/avg/p99/max and the deadline misses of a window
+    void lateCallbacks();
+    void driverRestartIsNotLateCallback();
+    void noCallbacks(); // the audio thread is not running, no stats to take
+    void windowIsExtendedUntilTaken();
+    void processingTimeIsWrapping();
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "TestFilters.h"
+#include "audio/core/Filters.h"
+
+#include <QtTest/QtTest>
+#include <QVector>
+
+#include <cmath>
+
+using audio::Filter;
+using audio::FilterBank;
+
+namespace {
+
+const int SAMPLE_RATE = 48000;
+const int BUFFER_SIZE = 256;
+const int BUFFERS = 40;
+const float TOLERANCE = 1e-3f; // the filter bank is using float coefficients
+
+QVector<float> createNoise(int samples, quint32 seed)
+{
+    QVector<float> noise(samples);
+    for (float &sample : noise) {
+        seed = seed * 1664525 + 1013904223;
+        sample = (seed >> 8) / 16777216.0f - 0.5f;
+    }
+    return noise;
+}
+
+// process the lanes in BUFFER_SIZE chunks
+void processBank(FilterBank &bank, QVector<QVector<float>> &lanes)
+{
+    QVector<float *> pointers(lanes.size());
+    for (int offset = 0; offset < lanes.first().size(); offset += BUFFER_SIZE) {
+        for (int l = 0; l < lanes.size(); ++l)
+            pointers[l] = lanes[l].data() + offset;
+
+        bank.process(pointers.data(), lanes.size(), BUFFER_SIZE);
+    }
+}
+
+float getMaxDifference(const QVector<float> &a, const QVector<float> &b)
+{
+    float maxDifference = 0;
+    for (int s = 0; s < a.size(); ++s)
+        maxDifference = qMax(maxDifference, std::fabs(a[s] - b[s]));
+    return maxDifference;
+}
+
+} // namespace
+
+void TestFilters::filterBankMatchesFilter_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<int>("lanesCount");
+
+    QTest::newRow("High pass, 1 lane") << static_cast<int>(Filter::HighPass) << 1;
+    QTest::newRow("High pass, stereo") << static_cast<int>(Filter::HighPass) << 2;
+    QTest::newRow("Peaking, 5 lanes") << static_cast<int>(Filter::Peaking) << 5;
+    QTest::newRow("Low shelf, 16 lanes") << static_cast<int>(Filter::LowShelf) << static_cast<int>(FilterBank::MAX_LANES);
+}
+
+void TestFilters::filterBankMatchesFilter()
+{
+    QFETCH(int, type);
+    QFETCH(int, lanesCount);
+
+    const Filter::FilterType filterType = static_cast<Filter::FilterType>(type);
+    const double frequency = 1000;
+    const double Q = 0.7;
+    const double gain = 2.0;
+
+    FilterBank bank(filterType, SAMPLE_RATE, frequency, Q, gain);
+
+    QVector<QVector<float>> lanes;
+    for (int l = 0; l < lanesCount; ++l)
+        lanes.append(createNoise(BUFFER_SIZE * BUFFERS, l + 1));
+
+    QVector<QVector<float>> expected = lanes;
+    for (QVector<float> &lane : expected) {
+        Filter filter(filterType, SAMPLE_RATE, frequency, Q, gain);
+        for (int offset = 0; offset < lane.size(); offset += BUFFER_SIZE)
+            filter.process(lane.data() + offset, BUFFER_SIZE);
+    }
+
+    processBank(bank, lanes);
+
+    for (int l = 0; l < lanesCount; ++l)
+        QVERIFY(getMaxDifference(lanes[l], expected[l]) < TOLERANCE);
+}
+
+void TestFilters::lanesAreIndependent()
+{
+    // an impulse in the second lane only
+    QVector<QVector<float>> lanes(3, QVector<float>(BUFFER_SIZE * BUFFERS, 0.0f));
+    lanes[1][0] = 1.0f;
+
+    FilterBank bank(Filter::LowPass, SAMPLE_RATE, 500);
+    processBank(bank, lanes);
+
+    for (float sample : lanes[0])
+        QCOMPARE(sample, 0.0f);
+
+    for (float sample : lanes[2])
+        QCOMPARE(sample, 0.0f);
+
+    QVERIFY(lanes[1][10] != 0.0f);
+}
+
+void TestFilters::interpolationReachesTarget()
+{
+    const int interpolationFrames = BUFFER_SIZE * 4 + 10; // ending inside a buffer
+
+    FilterBank bank(Filter::HighPass, SAMPLE_RATE, 120);
+    bank.setFrequency(220, interpolationFrames);
+    QVERIFY(bank.isInterpolating());
+    QCOMPARE(bank.getFrequency(), 220.0);
+
+    QVector<QVector<float>> lanes(2, QVector<float>(BUFFER_SIZE * 8, 0.0f));
+    processBank(bank, lanes);
+    QVERIFY(!bank.isInterpolating());
+
+    // the interpolated bank and a bank created with the target frequency have the same response
+    FilterBank targetBank(Filter::HighPass, SAMPLE_RATE, 220);
+    bank.reset();
+
+    QVector<QVector<float>> interpolated;
+    interpolated.append(createNoise(BUFFER_SIZE * BUFFERS, 7));
+    interpolated.append(createNoise(BUFFER_SIZE * BUFFERS, 8));
+    QVector<QVector<float>> expected = interpolated;
+
+    processBank(bank, interpolated);
+    processBank(targetBank, expected);
+
+    for (int l = 0; l < interpolated.size(); ++l)
+        QVERIFY(getMaxDifference(interpolated[l], expected[l]) < TOLERANCE);
+}
@@ -0,0 +1,17 @@
+#ifndef TEST_FILTERS_H
+#define TEST_FILTERS_H
+
+#include <QObject>
+
+class TestFilters : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void filterBankMatchesFilter();
+    void filterBankMatchesFilter_data();
+    void lanesAreIndependent();
+    void interpolationReachesTarget();
+};
+
+#endif
@@ -4,11 +4,218 @@
 #include "audio/core/SamplesBuffer.h"
 #include <QTest>
 #include <QtGlobal>
+#include <QThread>
+#include <cmath>
 
 #include "looper/Looper.h"
+#include "looper/LooperLayer.h"
 
 using namespace audio;
 
+void TestLooper::layerCompaction()
+{
+    const uint bufferSize = 256;
+    const uint cycleLenght = bufferSize * 800;
+    const uint quietSamples = CompactSamples::BLOCK_SIZE * 20; // quiet section aligned with compact blocks
+
+    SamplesBuffer samples(2, cycleLenght);
+    for (uint s = 0; s < cycleLenght; ++s) {
+        samples.set(0, s, std::sin(s * 0.01f) * (s < quietSamples ? 0.001f : 0.9f)); // quiet and loud sections
+        samples.set(1, s, std::cos(s * 0.02f) * 0.5f);
+    }
+
+    LooperLayer layer;
+    layer.prepareForNewCycle(cycleLenght, false);
+    layer.setSamples(samples);
+    layer.setPan(-1); // avoiding pan law in expected values
+
+    const quint64 uncompactedMemory = layer.getMemoryUsage();
+
+    // the compaction is requested in the audio thread and done in the compaction thread
+    layer.updateCompaction(true);
+    QVERIFY(layer.isCompacting());
+    QVERIFY(!layer.isCompacted());
+
+    layer.processCompactionJob(); // compaction thread
+    QVERIFY(!layer.isCompacted()); // the compacted samples are used only in the next audio callback
+
+    layer.updateCompaction(true);
+    QVERIFY(layer.isCompacted());
+    QVERIFY(!layer.isCompacting());
+
+    layer.releaseRetiredStorages(); // compaction thread, releasing the float samples
+    QVERIFY(layer.getMemoryUsage() < uncompactedMemory * 0.6);
+    QCOMPARE(layer.getUncompactedMemoryUsage(), uncompactedMemory);
+
+    // compacted samples are decoded when mixing
+    SamplesBuffer out(2, bufferSize);
+    for (uint position = 0; position < cycleLenght; position += bufferSize) {
+        out.zero();
+        layer.mixTo(out, bufferSize, position, 1.0f);
+        for (uint s = 0; s < bufferSize; ++s) {
+            const float tolerance = position + s < quietSamples ? 0.001f / 32767 : 0.9f / 32767;
+            QVERIFY(qAbs(out.get(0, s) - samples.get(0, position + s)) <= tolerance);
+        }
+    }
+
+    // audio blocks bigger than the decoding buffers are mixed in chunks, without gaps
+    const uint bigBufferSize = LooperLayer::MAX_DECODED_SAMPLES * 2 + bufferSize;
+    SamplesBuffer bigOut(2, bigBufferSize);
+    layer.mixTo(bigOut, bigBufferSize, quietSamples, 1.0f);
+    for (uint s = 0; s < bigBufferSize; ++s)
+        QVERIFY(qAbs(bigOut.get(0, s) - samples.get(0, quietSamples + s)) <= 0.9f / 32767);
+
+    // a layer changed while the compaction thread is working is not replaced by the compaction result
+    layer.updateCompaction(false);
+    layer.processCompactionJob();
+    layer.updateCompaction(false);
+    QVERIFY(!layer.isCompacted());
+    QCOMPARE(layer.getAvailableSamples(), cycleLenght);
+
+    layer.updateCompaction(true);
+    SamplesBuffer overdub(2, 1);
+    layer.overdub(overdub, 1, 0);
+    layer.processCompactionJob();
+    layer.updateCompaction(true);
+    QVERIFY(!layer.isCompacted());
+    QVERIFY(layer.isCompacting()); // compacting the new layer content
+
+    // overdubbing a compacted layer before the compaction thread expand it
+    layer.processCompactionJob();
+    layer.updateCompaction(true);
+    QVERIFY(layer.isCompacted());
+    layer.overdub(overdub, 1, 0);
+    QVERIFY(!layer.isCompacted());
+    QCOMPARE(layer.getAvailableSamples(), cycleLenght);
+}
+
+void TestLooper::lockedLayersCompaction()
+{
+    const uint cycleLenght = 4096;
+
+    Looper looper;
+    looper.setLayers(1, true);
+    looper.setMode(Looper::AllLayers);
+
+    SamplesBuffer samples(2, cycleLenght);
+    for (uint s = 0; s < cycleLenght; ++s) {
+        samples.set(0, s, 0.5f);
+        samples.set(1, s, 0.5f);
+    }
+
+    looper.startNewCycle(cycleLenght);
+    looper.setLayerSamples(0, samples);
+    looper.setLayerLockedState(0, true);
+    looper.setCompactingLockedLayers(true);
+    looper.play();
+
+    // the compaction thread is working while the audio callbacks are processed
+    SamplesBuffer out(2, 256);
+    for (int i = 0; i < 200 && looper.getCompactedLayers() == 0; ++i) {
+        looper.mixToBuffer(out);
+        QThread::msleep(10);
+    }
+
+    QCOMPARE(looper.getCompactedLayers(), static_cast<quint8>(1));
+
+    looper.setCompactingLockedLayers(false);
+    for (int i = 0; i < 200 && looper.getCompactedLayers() > 0; ++i) {
+        looper.mixToBuffer(out);
+        QThread::msleep(10);
+    }
+
+    QCOMPARE(looper.getCompactedLayers(), static_cast<quint8>(0));
+}
+
+void TestLooper::layerGainRamp()
+{
+    const uint cycleLenght = 4;
+
+    Looper looper;
+    looper.setLayers(1, true);
+    looper.setMode(Looper::AllLayers);
+
+    looper.startNewCycle(cycleLenght);
+    looper.setLayerSamples(0, createBuffer("1, 1, 1, 1"));
+    looper.setLayerPan(0, -1); // avoiding pan law in expected values
+    looper.play();
+
+    SamplesBuffer out(1, 2);
+    looper.mixToBuffer(out);
+    checkExpectedValues("1, 1", out); // first block is using the layer gain without ramp
+
+    looper.setLayerGain(0, 0);
+
+    out.zero();
+    looper.mixToBuffer(out);
+    checkExpectedValues("1, 0.5", out); // gain change is ramped along the block, no clicks
+
+    looper.startNewCycle(cycleLenght);
+
+    out.zero();
+    looper.mixToBuffer(out);
+    checkExpectedValues("0, 0", out);
+}
+
+void TestLooper::layerPeaks_data()
+{
+    QTest::addColumn<uint>("cycleLenght");
+    QTest::addColumn<uint>("samplesPerPeak");
+    QTest::addColumn<uint>("recordingChunkSize");
+
+    QTest::newRow("Aligned peaks, aligned chunks") << 4096u << 256u << 128u;
+    QTest::newRow("Aligned peaks, small chunks") << 4096u << 128u << 100u;
+    QTest::newRow("Big peaks, odd cycle") << 5000u << 1024u << 333u;
+    QTest::newRow("Peaks smaller than pyramid block") << 1000u << 10u << 64u;
+}
+
+void TestLooper::layerPeaks()
+{
+    QFETCH(uint, cycleLenght);
+    QFETCH(uint, samplesPerPeak);
+    QFETCH(uint, recordingChunkSize);
+
+    LooperLayer layer;
+    layer.prepareForNewCycle(cycleLenght, false);
+
+    // recording in chunks, like the audio callback
+    uint position = 0;
+    while (position < cycleLenght) {
+        const uint samples = qMin(recordingChunkSize, cycleLenght - position);
+        SamplesBuffer chunk(2, samples);
+        for (uint s = 0; s < samples; ++s) {
+            const uint index = position + s;
+            chunk.set(0, s, ((index * 7919) % 1000) / 1000.0f);
+            chunk.set(1, s, -((index * 104729) % 1000) / 1000.0f);
+        }
+        layer.append(chunk, samples, position);
+        position += samples;
+    }
+
+    // overdubbing a loud sample in the middle of the layer
+    SamplesBuffer overdub(2, 1);
+    overdub.set(0, 0, 2.0f);
+    overdub.set(1, 0, 0.0f);
+    layer.overdub(overdub, 1, cycleLenght/2);
+
+    const SamplesBuffer samples = layer.getAllSamples();
+    const std::vector<float> peaks = layer.getSamplesPeaks(samplesPerPeak);
+
+    QCOMPARE(peaks.size(), static_cast<size_t>((cycleLenght + samplesPerPeak - 1) / samplesPerPeak));
+
+    // brute force peaks, using the block resolution when the pyramid is used
+    const uint resolution = samplesPerPeak >= PeaksPyramid::BASE_BLOCK_SIZE ? PeaksPyramid::BASE_BLOCK_SIZE : 1;
+    for (uint p = 0; p < peaks.size(); ++p) {
+        const uint from = (p * samplesPerPeak) / resolution * resolution;
+        const uint to = qMin(((p + 1) * samplesPerPeak + resolution - 1) / resolution * resolution, cycleLenght);
+        float expectedPeak = 0;
+        for (uint s = from; s < to; ++s)
+            expectedPeak = qMax(expectedPeak, qMax(qAbs(samples.get(0, s)), qAbs(samples.get(1, s))));
+
+        QCOMPARE(peaks[p], expectedPeak);
+    }
+}
+
 void TestLooper::monitoringWhenPlayLockedAndHearAllAreChecked() // testing second problem described in #823
 {
     const uint cycleLenght = 2;
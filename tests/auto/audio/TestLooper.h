@@ -43,6 +43,14 @@ private slots:
     void playing();
     void playing_data();
 
+    void layerGainRamp();
+
+    void layerCompaction();
+    void lockedLayersCompaction();
+
+    void layerPeaks();
+    void layerPeaks_data();
+
     void hearLockedLayersOnlyAfterRecord(); // first problem in issue #823
     void monitoringWhenPlayLockedAndHearAllAreChecked(); // second problem in issue #823
 
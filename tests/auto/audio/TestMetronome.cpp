@@ -0,0 +1,311 @@
+#include "TestMetronome.h"
+#include "audio/MetronomeTrackNode.h"
+#include "audio/core/PeaksTelemetry.h"
+#include "MetronomeUtils.h"
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+using audio::MetronomeTrackNode;
+using audio::MetronomeSoundBank;
+using audio::MetronomeSounds;
+using audio::MetronomeSoundsPtr;
+using audio::SamplesBuffer;
+using audio::PeaksTelemetry;
+using audio::AudioPeak;
+using audio::metronomeUtils;
+
+namespace {
+
+const int SAMPLE_RATE = 44100;
+
+} // namespace
+
+float TestMetronome::clickSample(float value, uint s, int channel)
+{
+    const float sample = value * (s + 1);
+    return channel == 0 ? sample : -sample;
+}
+
+MetronomeSoundsPtr TestMetronome::createSounds(uint clickFrames, float firstBeat, float offBeat, float accentBeat)
+{
+    QSharedPointer<MetronomeSounds> sounds(new MetronomeSounds());
+
+    SamplesBuffer *clicks[] = { &sounds->firstBeat, &sounds->offBeat, &sounds->accentBeat };
+    const float values[] = { firstBeat, offBeat, accentBeat };
+    for (int i = 0; i < 3; ++i) {
+        clicks[i]->setFrameLenght(clickFrames);
+        for (uint s = 0; s < clickFrames; ++s) {
+            for (int c = 0; c < 2; ++c)
+                clicks[i]->set(c, s, clickSample(values[i], s, c));
+        }
+    }
+
+    return sounds;
+}
+
+void TestMetronome::compareSounds(const MetronomeSounds &sounds, const MetronomeSounds &expected)
+{
+    const SamplesBuffer *clicks[] = { &sounds.firstBeat, &sounds.offBeat, &sounds.accentBeat };
+    const SamplesBuffer *expectedClicks[] = { &expected.firstBeat, &expected.offBeat, &expected.accentBeat };
+    for (int i = 0; i < 3; ++i) {
+        QCOMPARE(clicks[i]->getChannels(), expectedClicks[i]->getChannels());
+        QCOMPARE(clicks[i]->getFrameLenght(), expectedClicks[i]->getFrameLenght());
+        for (int c = 0; c < clicks[i]->getChannels(); ++c) {
+            for (uint s = 0; s < clicks[i]->getFrameLenght(); ++s)
+                QCOMPARE(clicks[i]->get(c, s), expectedClicks[i]->get(c, s));
+        }
+    }
+}
+
+void TestMetronome::multipleBeatsInOneBuffer()
+{
+    const float beatValues[] = { 0.01f, 0.02f, 0.03f }; // first beat, off beat, accent
+    const uint clickFrames = 10;
+    const uint samplesPerBeat = 100;
+
+    MetronomeTrackNode metronome(createSounds(clickFrames, beatValues[0], beatValues[1], beatValues[2]));
+    metronome.setSamplesPerBeat(samplesPerBeat);
+    metronome.setAccentBeats(QList<int>() << 2);
+    metronome.setIntervalPosition(0);
+
+    SamplesBuffer in(2, 256);
+    SamplesBuffer out(2, 256);
+    midi::MidiBuffer midiBuffer;
+    metronome.processReplacing(in, out, SAMPLE_RATE, midiBuffer);
+
+    // beats 0, 1 and 2 in the same buffer
+    for (uint s = 0; s < out.getFrameLenght(); ++s) {
+        const uint beat = s / samplesPerBeat;
+        const uint positionInBeat = s % samplesPerBeat;
+        for (int c = 0; c < 2; ++c) {
+            const float expected = positionInBeat < clickFrames ? clickSample(beatValues[beat], positionInBeat, c) : 0.0f;
+            QCOMPARE(out.get(c, s), expected);
+        }
+    }
+}
+
+void TestMetronome::clickCrossingBufferBoundary()
+{
+    const float offBeat = 0.02f;
+    const uint clickFrames = 50;
+
+    MetronomeTrackNode metronome(createSounds(clickFrames, 0.01f, offBeat, 0.03f));
+    metronome.setSamplesPerBeat(1000);
+
+    SamplesBuffer in(2, 64);
+    SamplesBuffer out(2, 64);
+    midi::MidiBuffer midiBuffer;
+
+    // the second beat starts in the sample 20, only the first 44 click samples are played
+    metronome.setIntervalPosition(980);
+    metronome.processReplacing(in, out, SAMPLE_RATE, midiBuffer);
+    for (uint s = 0; s < out.getFrameLenght(); ++s) {
+        for (int c = 0; c < 2; ++c)
+            QCOMPARE(out.get(c, s), s < 20 ? 0.0f : clickSample(offBeat, s - 20, c));
+    }
+
+    // the click tail in the next audio callback
+    out.zero();
+    metronome.setIntervalPosition(1044);
+    metronome.processReplacing(in, out, SAMPLE_RATE, midiBuffer);
+    for (uint s = 0; s < out.getFrameLenght(); ++s) {
+        for (int c = 0; c < 2; ++c)
+            QCOMPARE(out.get(c, s), s < 6 ? clickSample(offBeat, 44 + s, c) : 0.0f);
+    }
+}
+
+void TestMetronome::monoOutput()
+{
+    const float firstBeat = 0.01f;
+    const uint clickFrames = 10;
+
+    PeaksTelemetry telemetry;
+    const int slotID = telemetry.acquireSlot();
+
+    MetronomeTrackNode metronome(createSounds(clickFrames, firstBeat, 0.02f, 0.03f));
+    metronome.setPeaksTelemetry(&telemetry, slotID);
+    metronome.setSamplesPerBeat(1000);
+    metronome.setIntervalPosition(0);
+    metronome.setGain(0.5f);
+    metronome.setPan(-1.0f); // pan is ignored in mono
+
+    SamplesBuffer in(1, 64);
+    SamplesBuffer out(1, 64);
+    midi::MidiBuffer midiBuffer;
+    metronome.processReplacing(in, out, SAMPLE_RATE, midiBuffer);
+
+    // only the left channel of the stereo click is played
+    for (uint s = 0; s < out.getFrameLenght(); ++s)
+        QCOMPARE(out.get(0, s), s < clickFrames ? clickSample(firstBeat, s, 0) * 0.5f : 0.0f);
+
+    telemetry.readAll();
+    const AudioPeak peak = telemetry.getPeak(slotID);
+    QCOMPARE(peak.getLeftPeak(), clickSample(firstBeat, clickFrames - 1, 0) * 0.5f);
+    QCOMPARE(peak.getRightPeak(), peak.getLeftPeak());
+}
+
+void TestMetronome::swapSoundsWhilePlaying()
+{
+    MetronomeSoundsPtr firstSounds = createSounds(10, 0.01f, 0.02f, 0.03f);
+    QWeakPointer<const MetronomeSounds> firstSoundsRef = firstSounds;
+
+    MetronomeTrackNode metronome(firstSounds);
+    metronome.setSamplesPerBeat(1000);
+    firstSounds.clear();
+
+    SamplesBuffer in(2, 64);
+    SamplesBuffer out(2, 64);
+    midi::MidiBuffer midiBuffer;
+
+    metronome.setIntervalPosition(0);
+    metronome.processReplacing(in, out, SAMPLE_RATE, midiBuffer);
+    QCOMPARE(out.get(0, 0), clickSample(0.01f, 0, 0));
+
+    metronome.setSounds(createSounds(10, 0.04f, 0.05f, 0.06f));
+    QVERIFY(!firstSoundsRef.isNull()); // used in the last audio callback, not released yet
+
+    out.zero();
+    metronome.setIntervalPosition(0);
+    metronome.processReplacing(in, out, SAMPLE_RATE, midiBuffer);
+    QCOMPARE(out.get(0, 0), clickSample(0.04f, 0, 0));
+
+    metronome.setSounds(MetronomeSoundsPtr()); // ignored
+    metronome.setSounds(createSounds(10, 0.07f, 0.08f, 0.09f));
+    QVERIFY(firstSoundsRef.isNull()); // the audio thread is not using the first sounds anymore
+
+    out.zero();
+    metronome.setIntervalPosition(0);
+    metronome.processReplacing(in, out, SAMPLE_RATE, midiBuffer);
+    QCOMPARE(out.get(0, 0), clickSample(0.07f, 0, 0));
+}
+
+void TestMetronome::rmsUsesTheNodeWindow()
+{
+    const int rmsWindowSize = 256; // the stereo window is filled in 2 audio callbacks
+
+    PeaksTelemetry telemetry;
+    const int slotID = telemetry.acquireSlot();
+
+    MetronomeTrackNode metronome(createSounds(100, 0.001f, 0.002f, 0.003f));
+    metronome.setPeaksTelemetry(&telemetry, slotID);
+    metronome.setSamplesPerBeat(200);
+    metronome.setRmsWindowSize(rmsWindowSize);
+
+    SamplesBuffer in(2, 64);
+    SamplesBuffer out(2, 64);
+    midi::MidiBuffer midiBuffer;
+
+    // a track playing the same samples
+    SamplesBuffer reference(2, 64);
+    reference.setRmsWindowSize(rmsWindowSize);
+
+    bool rmsComputed = false;
+    for (int callback = 0; callback < 8; ++callback) {
+        out.zero();
+        metronome.setIntervalPosition(callback * out.getFrameLenght());
+        metronome.processReplacing(in, out, SAMPLE_RATE, midiBuffer);
+
+        reference.set(out);
+        const AudioPeak expected = reference.computePeak();
+
+        telemetry.readAll();
+        const AudioPeak peak = telemetry.getPeak(slotID);
+        QCOMPARE(peak.getLeftPeak(), expected.getLeftPeak());
+        QCOMPARE(peak.getRightPeak(), expected.getRightPeak());
+        QCOMPARE(peak.getLeftRMS(), expected.getLeftRMS());
+        QCOMPARE(peak.getRightRMS(), expected.getRightRMS());
+
+        if (callback == 0)
+            QCOMPARE(peak.getLeftRMS(), 0.0f); // the window is not filled yet
+
+        rmsComputed |= peak.getLeftRMS() > 0;
+    }
+
+    QVERIFY(rmsComputed);
+}
+
+void TestMetronome::soundBankDiskCache()
+{
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+
+    metronomeUtils::createdSounds() = 0;
+
+    MetronomeSoundBank bank(QDir(cacheDir.path()));
+    const MetronomeSoundsPtr sounds = bank.getBuiltInSounds("Default", SAMPLE_RATE);
+    QVERIFY(sounds);
+    QCOMPARE(metronomeUtils::createdSounds(), 1);
+
+    QVERIFY(bank.getBuiltInSounds("Default", SAMPLE_RATE) == sounds); // cached in memory
+    QCOMPARE(metronomeUtils::createdSounds(), 1);
+
+    const QDir metronomeCacheDir(QDir(cacheDir.path()).absoluteFilePath("metronome"));
+    QCOMPARE(metronomeCacheDir.entryList(QDir::Files).size(), 1);
+
+    // next session, the sounds are loaded from disk
+    MetronomeSoundBank newSessionBank(QDir(cacheDir.path()));
+    const MetronomeSoundsPtr cachedSounds = newSessionBank.getBuiltInSounds("Default", SAMPLE_RATE);
+    QCOMPARE(metronomeUtils::createdSounds(), 1);
+    QVERIFY(cachedSounds != sounds);
+    compareSounds(*cachedSounds, *sounds);
+    QCOMPARE(cachedSounds->accentBeat.getChannels(), 1); // mono clicks are preserved
+
+    // each sample rate and sound set has your own cache file
+    newSessionBank.getBuiltInSounds("Default", 48000);
+    newSessionBank.getBuiltInSounds("Other", SAMPLE_RATE);
+    QCOMPARE(metronomeUtils::createdSounds(), 3);
+    QCOMPARE(metronomeCacheDir.entryList(QDir::Files).size(), 3);
+
+    bank.clear();
+    bank.getBuiltInSounds("Default", 48000);
+    QCOMPARE(metronomeUtils::createdSounds(), 3);
+
+    // invalid cache files are ignored and overwritten
+    for (const QString &fileName : metronomeCacheDir.entryList(QDir::Files)) {
+        QFile file(metronomeCacheDir.absoluteFilePath(fileName));
+        QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+        file.write("invalid");
+    }
+
+    MetronomeSoundBank corruptedCacheBank(QDir(cacheDir.path()));
+    compareSounds(*corruptedCacheBank.getBuiltInSounds("Default", SAMPLE_RATE), *sounds);
+    QCOMPARE(metronomeUtils::createdSounds(), 4);
+
+    MetronomeSoundBank rewrittenCacheBank(QDir(cacheDir.path()));
+    rewrittenCacheBank.getBuiltInSounds("Default", SAMPLE_RATE);
+    QCOMPARE(metronomeUtils::createdSounds(), 4);
+}
+
+void TestMetronome::customSoundsCacheIsInvalidated()
+{
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+
+    QStringList files;
+    for (const QString &fileName : QStringList() << "first.wav" << "off.wav" << "accent.wav") {
+        QFile file(QDir(cacheDir.path()).absoluteFilePath(fileName));
+        QVERIFY(file.open(QFile::WriteOnly));
+        file.write("RIFF");
+        files << file.fileName();
+    }
+
+    metronomeUtils::createdSounds() = 0;
+
+    MetronomeSoundBank bank(QDir(cacheDir.path()));
+    bank.getCustomSounds(files.at(0), files.at(1), files.at(2), SAMPLE_RATE);
+    QCOMPARE(metronomeUtils::createdSounds(), 1);
+
+    bank.clear();
+    bank.getCustomSounds(files.at(0), files.at(1), files.at(2), SAMPLE_RATE);
+    QCOMPARE(metronomeUtils::createdSounds(), 1); // loaded from disk
+
+    // the user edited the off beat sound
+    QFile offBeatFile(files.at(1));
+    QVERIFY(offBeatFile.open(QFile::Append));
+    offBeatFile.write("WAVE");
+    offBeatFile.close();
+
+    bank.getCustomSounds(files.at(0), files.at(1), files.at(2), SAMPLE_RATE);
+    QCOMPARE(metronomeUtils::createdSounds(), 2);
+}
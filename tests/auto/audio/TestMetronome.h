@@ -0,0 +1,31 @@
+#ifndef TEST_METRONOME_H
+#define TEST_METRONOME_H
+
+#include <QObject>
+
+#include "audio/MetronomeSoundBank.h"
+
+class TestMetronome : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void multipleBeatsInOneBuffer(); // short beats, more than one click in the same audio callback
+    void clickCrossingBufferBoundary(); // the click tail is played in the next audio callback
+    void monoOutput();
+    void swapSoundsWhilePlaying(); // the replaced sounds are released only when not used by the audio thread
+    void rmsUsesTheNodeWindow(); // the meters are computed like the other tracks, in the RMS window
+
+    void soundBankDiskCache(); // the sounds are created once and loaded from disk in the next sessions
+    void customSoundsCacheIsInvalidated(); // editing a custom sound file is creating the sounds again
+
+private:
+    static audio::MetronomeSoundsPtr createSounds(uint clickFrames, float firstBeat, float offBeat, float accentBeat);
+
+    // the click samples are 'value * (s + 1)' in left channel and the negative values in right channel
+    static float clickSample(float value, uint s, int channel);
+
+    static void compareSounds(const audio::MetronomeSounds &sounds, const audio::MetronomeSounds &expected);
+};
+
+#endif
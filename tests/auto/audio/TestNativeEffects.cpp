@@ -0,0 +1,213 @@
+#include "TestNativeEffects.h"
+#include "audio/core/NativeEffects.h"
+
+#include <QtTest/QtTest>
+
+#include <cmath>
+
+using audio::SmoothedValue;
+using audio::DelayEffect;
+using audio::EqualizerEffect;
+using audio::CompressorEffect;
+using audio::SamplesBuffer;
+
+namespace {
+
+const int SAMPLE_RATE = 48000;
+const int BUFFER_SIZE = 256;
+
+// process a sine and return the output/input gain (in dB) measured in the last processed buffers
+template <class Effect>
+float getSineGain(Effect &effect, float frequency, float amplitude)
+{
+    SamplesBuffer buffer(2, BUFFER_SIZE);
+    double phase = 0;
+    float peak = 0;
+
+    for (int b = 0; b < 400; ++b) {
+        for (int s = 0; s < BUFFER_SIZE; ++s) {
+            const float sample = amplitude * std::sin(phase);
+            phase += 2 * M_PI * frequency / SAMPLE_RATE;
+            buffer.set(0, s, sample);
+            buffer.set(1, s, sample);
+        }
+
+        effect.process(buffer);
+
+        if (b >= 300) { // ramps and envelopes are stable
+            for (int s = 0; s < BUFFER_SIZE; ++s)
+                peak = qMax(peak, std::fabs(buffer.get(1, s)));
+        }
+    }
+
+    return 20 * std::log10(peak / amplitude);
+}
+
+// the first non zero sample after the impulse
+int findEcho(DelayEffect &delay, float &echoAmplitude)
+{
+    SamplesBuffer buffer(2, BUFFER_SIZE);
+    const int maxBuffers = DelayEffect::MAX_DELAY_IN_SECONDS * SAMPLE_RATE / BUFFER_SIZE + 1;
+    for (int b = 0; b <= maxBuffers; ++b) {
+        buffer.zero();
+        if (b == 0) {
+            buffer.set(0, 0, 1);
+            buffer.set(1, 0, 1);
+        }
+
+        delay.process(buffer);
+
+        for (int s = (b == 0 ? 1 : 0); s < BUFFER_SIZE; ++s) {
+            if (buffer.get(0, s) != 0) {
+                echoAmplitude = buffer.get(0, s);
+                return b * BUFFER_SIZE + s;
+            }
+        }
+    }
+
+    return -1;
+}
+
+} // namespace
+
+void TestNativeEffects::smoothedValue()
+{
+    SmoothedValue value(0);
+    value.setRampLength(100);
+    value.setTarget(1);
+    QVERIFY(value.isSmoothing());
+
+    float start, step;
+    value.nextRamp(50, start, step);
+    QCOMPARE(start, 0.0f);
+    QCOMPARE(step, 0.01f);
+    QVERIFY(qAbs(value.getCurrent() - 0.5f) < 0.0001f);
+
+    value.nextRamp(64, start, step); // the ramp is ending inside the block
+    QVERIFY(qAbs(start + step * 64 - 1.0f) < 0.0001f);
+    QCOMPARE(value.getCurrent(), 1.0f);
+    QVERIFY(!value.isSmoothing());
+
+    value.nextRamp(64, start, step);
+    QCOMPARE(step, 0.0f);
+}
+
+void TestNativeEffects::delayImpulse_data()
+{
+    QTest::addColumn<float>("delayTime");
+    QTest::addColumn<float>("level");
+    QTest::addColumn<int>("expectedPosition");
+
+    QTest::newRow("500 ms") << 500.0f << 0.5f << 24000;
+    QTest::newRow("Shorter than buffer") << 2.0f << 1.0f << 96;
+    QTest::newRow("Max delay") << 3000.0f << 0.25f << 144000;
+}
+
+void TestNativeEffects::delayImpulse()
+{
+    QFETCH(float, delayTime);
+    QFETCH(float, level);
+    QFETCH(int, expectedPosition);
+
+    DelayEffect delay(SAMPLE_RATE);
+    delay.setDelayTime(delayTime);
+    delay.setLevel(level);
+    delay.setFeedback(0);
+
+    SamplesBuffer silence(2, BUFFER_SIZE);
+    for (int b = 0; b < 100; ++b) { // waiting the parameters ramps
+        silence.zero();
+        delay.process(silence);
+    }
+
+    float echoAmplitude = 0;
+    QCOMPARE(findEcho(delay, echoAmplitude), expectedPosition);
+    QCOMPARE(echoAmplitude, level);
+}
+
+void TestNativeEffects::tempoSyncedDelay()
+{
+    DelayEffect delay(SAMPLE_RATE);
+    delay.setSyncDivision(DelayEffect::Quarter);
+    delay.setTempo(120);
+    QCOMPARE(delay.getDelayTimeInSamples(), 24000.0f);
+
+    delay.setSyncDivision(DelayEffect::DottedEighth);
+    delay.setTempo(90);
+    QCOMPARE(delay.getDelayTimeInSamples(), 24000.0f); // 0.75 beats in 90 BPM
+
+    delay.setSyncDivision(DelayEffect::NoSync);
+    delay.setDelayTime(250);
+    QCOMPARE(delay.getDelayTimeInSamples(), 12000.0f);
+}
+
+void TestNativeEffects::delayTimeChangeIsFinite()
+{
+    DelayEffect delay(SAMPLE_RATE);
+    delay.setFeedback(DelayEffect::MAX_FEEDBACK);
+    delay.setLevel(1);
+
+    SamplesBuffer buffer(2, BUFFER_SIZE);
+    for (int b = 0; b < 2000; ++b) {
+        if (b % 200 == 0)
+            delay.setDelayTime(b % 400 == 0 ? 10 : 700);
+
+        for (int s = 0; s < BUFFER_SIZE; ++s) {
+            buffer.set(0, s, std::sin(s * 0.05f));
+            buffer.set(1, s, std::cos(s * 0.05f));
+        }
+
+        delay.process(buffer);
+
+        for (int s = 0; s < BUFFER_SIZE; ++s)
+            QVERIFY(std::isfinite(buffer.get(0, s)) && std::fabs(buffer.get(0, s)) < 100);
+    }
+}
+
+void TestNativeEffects::flatEqualizerIsTransparent()
+{
+    EqualizerEffect equalizer(SAMPLE_RATE);
+
+    QVERIFY(qAbs(getSineGain(equalizer, 100, 0.5f)) < 0.01f);
+    QVERIFY(qAbs(getSineGain(equalizer, 1000, 0.5f)) < 0.01f);
+    QVERIFY(qAbs(getSineGain(equalizer, 10000, 0.5f)) < 0.01f);
+}
+
+void TestNativeEffects::equalizerBandGain()
+{
+    EqualizerEffect equalizer(SAMPLE_RATE);
+    equalizer.setBandFrequency(EqualizerEffect::LowMid, 1000);
+    equalizer.setBandGain(EqualizerEffect::LowMid, 6);
+
+    QVERIFY(qAbs(getSineGain(equalizer, 1000, 0.5f) - 6) < 0.1f);
+    QVERIFY(qAbs(getSineGain(equalizer, 15000, 0.5f)) < 0.2f); // far from the band
+
+    equalizer.setBandGain(EqualizerEffect::HighShelf, -12);
+    QVERIFY(getSineGain(equalizer, 18000, 0.5f) < -11);
+
+    equalizer.setSampleRate(44100); // the filters are recreated keeping the parameters
+    QVERIFY(getSineGain(equalizer, 1000 * 48000.0f / 44100, 0.5f) > 5.5f);
+}
+
+void TestNativeEffects::compressorGainReduction()
+{
+    CompressorEffect compressor(SAMPLE_RATE);
+    compressor.setThreshold(-18);
+    compressor.setRatio(4);
+
+    // -6 dB is 12 dB over the threshold, the expected reduction is 9 dB
+    const float gain = getSineGain(compressor, 200, 0.5f);
+    QVERIFY(gain < -8 && gain > -10);
+    QVERIFY(compressor.getGainReduction() > 8 && compressor.getGainReduction() < 10);
+
+    QVERIFY(qAbs(getSineGain(compressor, 200, 0.05f)) < 0.01f); // below the threshold
+}
+
+void TestNativeEffects::compressorMakeupGain()
+{
+    CompressorEffect compressor(SAMPLE_RATE);
+    compressor.setThreshold(-18);
+    compressor.setMakeupGain(6);
+
+    QVERIFY(qAbs(getSineGain(compressor, 200, 0.05f) - 6) < 0.01f);
+}
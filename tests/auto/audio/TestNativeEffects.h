@@ -0,0 +1,22 @@
+#ifndef TEST_NATIVE_EFFECTS_H
+#define TEST_NATIVE_EFFECTS_H
+
+#include <QObject>
+
+class TestNativeEffects : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void smoothedValue();
+    void delayImpulse();
+    void delayImpulse_data();
+    void tempoSyncedDelay();
+    void delayTimeChangeIsFinite(); // high feedback while the delay time is ramping
+    void flatEqualizerIsTransparent();
+    void equalizerBandGain();
+    void compressorGainReduction();
+    void compressorMakeupGain();
+};
+
+#endif
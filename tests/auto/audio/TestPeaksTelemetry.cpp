@@ -0,0 +1,198 @@
+#include "TestPeaksTelemetry.h"
+#include "audio/core/PeaksTelemetry.h"
+
+#include <QtTest/QtTest>
+#include <QThread>
+
+using audio::PeaksTelemetry;
+using audio::AudioPeak;
+
+namespace {
+
+// audio thread publishing increasing values, the 4 values of each published peak are equal
+class PeaksWriter : public QThread
+{
+public:
+    PeaksWriter(PeaksTelemetry &telemetry, int slotID, int peaks) :
+        telemetry(telemetry),
+        slotID(slotID),
+        peaks(peaks)
+    {
+    }
+
+protected:
+    void run() override
+    {
+        for (int i = 1; i <= peaks; ++i) {
+            const float value = static_cast<float>(i);
+            telemetry.publish(slotID, AudioPeak(value, value, value, value));
+        }
+    }
+
+private:
+    PeaksTelemetry &telemetry;
+    const int slotID;
+    const int peaks;
+};
+
+} // namespace
+
+void TestPeaksTelemetry::publishAndRead()
+{
+    PeaksTelemetry telemetry;
+    const int slotID = telemetry.acquireSlot();
+    QVERIFY(slotID >= 0);
+
+    QCOMPARE(telemetry.getPeak(slotID).getMaxPeak(), 0.0f); // nothing published yet
+
+    telemetry.publish(slotID, AudioPeak(0.5f, 0.25f, 0.2f, 0.1f));
+    QCOMPARE(telemetry.getPeak(slotID).getMaxPeak(), 0.0f); // not read yet
+
+    telemetry.readAll();
+    const AudioPeak peak = telemetry.getPeak(slotID);
+    QCOMPARE(peak.getLeftPeak(), 0.5f);
+    QCOMPARE(peak.getRightPeak(), 0.25f);
+    QCOMPARE(peak.getLeftRMS(), 0.2f);
+    QCOMPARE(peak.getRightRMS(), 0.1f);
+
+    telemetry.readAll(); // no new values, the node is not processing audio
+    QCOMPARE(telemetry.getPeak(slotID).getMaxPeak(), 0.0f);
+}
+
+void TestPeaksTelemetry::peaksAreAccumulatedBetweenReads()
+{
+    PeaksTelemetry telemetry;
+    const int slotID = telemetry.acquireSlot();
+
+    telemetry.publish(slotID, AudioPeak(0.3f, 0.1f, 0.1f, 0.05f));
+    telemetry.publish(slotID, AudioPeak(0.9f, 0.2f, 0.3f, 0.1f));
+    telemetry.publish(slotID, AudioPeak(0.4f, 0.6f, 0.2f, 0.2f));
+
+    telemetry.readAll();
+    AudioPeak peak = telemetry.getPeak(slotID);
+    QCOMPARE(peak.getLeftPeak(), 0.9f);
+    QCOMPARE(peak.getRightPeak(), 0.6f);
+    QCOMPARE(peak.getLeftRMS(), 0.3f);
+    QCOMPARE(peak.getRightRMS(), 0.2f);
+
+    // a new accumulation is started after each read
+    telemetry.publish(slotID, AudioPeak(0.1f, 0.1f, 0.05f, 0.05f));
+    telemetry.readAll();
+    peak = telemetry.getPeak(slotID);
+    QCOMPARE(peak.getLeftPeak(), 0.1f);
+    QCOMPARE(peak.getRightRMS(), 0.05f);
+}
+
+void TestPeaksTelemetry::clipsAreCounted()
+{
+    PeaksTelemetry telemetry;
+    const int slotID = telemetry.acquireSlot();
+
+    telemetry.publish(slotID, AudioPeak(0.5f, 0.5f, 0.1f, 0.1f));
+    telemetry.publish(slotID, AudioPeak(1.5f, 0.5f, 0.1f, 0.1f)); // clipping
+    telemetry.publish(slotID, AudioPeak(0.5f, 1.2f, 0.1f, 0.1f)); // clipping
+    telemetry.readAll();
+    QCOMPARE(telemetry.getClips(slotID), 2u);
+
+    telemetry.publish(slotID, AudioPeak(1.0f, 1.0f, 0.1f, 0.1f)); // 0 dB is not clipping
+    telemetry.readAll();
+    QCOMPARE(telemetry.getClips(slotID), 2u);
+
+    // a reused slot is not counting the clips of the previous node
+    telemetry.releaseSlot(slotID);
+    const int newSlotID = telemetry.acquireSlot();
+    telemetry.readAll();
+    QCOMPARE(telemetry.getClips(newSlotID), 0u);
+    QCOMPARE(telemetry.getClips(slotID), 0u);
+}
+
+void TestPeaksTelemetry::releasedSlotIsInvalid()
+{
+    PeaksTelemetry telemetry;
+    const int oldSlotID = telemetry.acquireSlot();
+    telemetry.publish(oldSlotID, AudioPeak(0.5f, 0.5f, 0.1f, 0.1f));
+    telemetry.readAll();
+
+    telemetry.releaseSlot(oldSlotID);
+
+    AudioPeak peak;
+    QVERIFY(!telemetry.getPeak(oldSlotID, peak));
+    QCOMPARE(peak.getMaxPeak(), 0.0f);
+
+    // the same slot is reused by another node, the old ID is still invalid and the new node is not reading the old peaks
+    const int newSlotID = telemetry.acquireSlot();
+    QVERIFY(newSlotID != oldSlotID);
+    QCOMPARE(newSlotID % PeaksTelemetry::MAX_SLOTS, oldSlotID % PeaksTelemetry::MAX_SLOTS);
+    QVERIFY(!telemetry.getPeak(oldSlotID, peak));
+
+    telemetry.readAll();
+    QVERIFY(telemetry.getPeak(newSlotID, peak));
+    QCOMPARE(peak.getMaxPeak(), 0.0f);
+}
+
+void TestPeaksTelemetry::slotsBlockAllocatedWhenSlotsAreUsed()
+{
+    PeaksTelemetry telemetry;
+    int slotID = -1;
+    for (int i = 0; i <= PeaksTelemetry::SLOTS_PER_BLOCK; ++i)
+        slotID = telemetry.acquireSlot();
+
+    QCOMPARE(slotID, PeaksTelemetry::SLOTS_PER_BLOCK); // first slot in the second block
+
+    telemetry.publish(slotID, AudioPeak(0.5f, 0.25f, 0.1f, 0.05f));
+    telemetry.readAll();
+
+    AudioPeak peak;
+    QVERIFY(telemetry.getPeak(slotID, peak));
+    QCOMPARE(peak.getLeftPeak(), 0.5f);
+    QCOMPARE(peak.getRightPeak(), 0.25f);
+}
+
+void TestPeaksTelemetry::allSlotsUsed()
+{
+    PeaksTelemetry telemetry;
+    for (int i = 0; i < PeaksTelemetry::MAX_SLOTS; ++i)
+        QVERIFY(telemetry.acquireSlot() >= 0);
+
+    QCOMPARE(telemetry.acquireSlot(), -1);
+
+    telemetry.publish(-1, AudioPeak(1.0f, 1.0f, 1.0f, 1.0f)); // nodes without slot are ignored
+}
+
+void TestPeaksTelemetry::concurrentWriterAndReader()
+{
+    PeaksTelemetry telemetry;
+    const int slotID = telemetry.acquireSlot();
+
+    const int peaks = 500000;
+    PeaksWriter writer(telemetry, slotID, peaks);
+    writer.start();
+
+    float lastValue = 0.0f;
+    int reads = 0;
+    forever {
+        const bool writerFinished = writer.isFinished(); // reading one more time after the writer finish
+
+        telemetry.readAll();
+        const AudioPeak peak = telemetry.getPeak(slotID);
+
+        // a torn read is mixing values from different publish calls
+        QCOMPARE(peak.getRightPeak(), peak.getLeftPeak());
+        QCOMPARE(peak.getLeftRMS(), peak.getLeftPeak());
+        QCOMPARE(peak.getRightRMS(), peak.getLeftPeak());
+
+        if (peak.getLeftPeak() > 0) { // the accumulated values are never decreasing
+            QVERIFY(peak.getLeftPeak() >= lastValue); // the last values are kept when the writer is always busy
+            lastValue = peak.getLeftPeak();
+            reads++;
+        }
+
+        if (writerFinished)
+            break;
+    }
+
+    writer.wait();
+
+    QCOMPARE(lastValue, static_cast<float>(peaks)); // the last published peak is not lost
+    QVERIFY(reads > 0);
+}
@@ -0,0 +1,20 @@
+#ifndef TEST_PEAKS_TELEMETRY_H
+#define TEST_PEAKS_TELEMETRY_H
+
+#include <QObject>
+
+class TestPeaksTelemetry : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void publishAndRead();
+    void peaksAreAccumulatedBetweenReads(); // short peaks are not lost when the GUI is slower than the audio thread
+    void clipsAreCounted();
+    void releasedSlotIsInvalid();
+    void slotsBlockAllocatedWhenSlotsAreUsed();
+    void allSlotsUsed();
+    void concurrentWriterAndReader(); // the GUI never reads a half written slot
+};
+
+#endif
@@ -0,0 +1,178 @@
+#include "TestPluginSandboxChannel.h"
+#include "audio/PluginSandboxChannel.h"
+
+#include <QtTest/QtTest>
+#include <QThread>
+#include <QElapsedTimer>
+
+using audio::PluginSandboxChannel;
+
+namespace {
+
+// simulating the sandbox process: attaching to the same shared memory and processing the blocks in another thread
+class EchoSandbox : public QThread
+{
+public:
+    explicit EchoSandbox(const QString &key) :
+        key(key),
+        attached(false)
+    {
+    }
+
+    bool waitAttach()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (!attached.loadAcquire() && timer.elapsed() < 5000)
+            QThread::msleep(1);
+
+        return attached.loadAcquire();
+    }
+
+protected:
+    void run() override
+    {
+        PluginSandboxChannel channel(key);
+        if (!channel.attach())
+            return;
+
+        attached.storeRelease(1);
+
+        while (!channel.isShutdown()) {
+            auto block = channel.waitRequest(100000);
+            if (!block)
+                continue;
+
+            // output = input * 0.5, the MIDI events count in the first sample of the last channel
+            block->outputChannels = block->inputChannels;
+            for (int c = 0; c < block->inputChannels; ++c) {
+                for (int s = 0; s < block->frames; ++s)
+                    block->output[c][s] = block->input[c][s] * 0.5f;
+            }
+
+            if (block->midiEventsCount > 0)
+                block->output[block->inputChannels - 1][0] = block->midiEvents[block->midiEventsCount - 1].deltaFrames;
+
+            channel.finishRequest();
+        }
+    }
+
+private:
+    QString key;
+    QAtomicInt attached;
+};
+
+} // namespace
+
+void TestPluginSandboxChannel::roundTrip()
+{
+    PluginSandboxChannel channel(PluginSandboxChannel::createKey());
+    QVERIFY(channel.create());
+
+    EchoSandbox sandbox(channel.getKey());
+    sandbox.start();
+    QVERIFY(sandbox.waitAttach());
+
+    for (int request = 0; request < 100; ++request) { // more requests than slots, the positions are advancing
+        auto block = channel.getRequestBlock();
+        QVERIFY(block != nullptr);
+
+        block->frames = 128;
+        block->inputChannels = 2;
+        for (int c = 0; c < 2; ++c) {
+            for (int s = 0; s < block->frames; ++s)
+                block->input[c][s] = request + s;
+        }
+
+        block->midiEventsCount = 1;
+        block->midiEvents[0].data = 0x7F3C90; // note on
+        block->midiEvents[0].deltaFrames = request % 128;
+
+        QVERIFY(channel.sendRequest(1000000));
+
+        QCOMPARE(block->outputChannels, 2);
+        QCOMPARE(block->output[0][10], (request + 10) * 0.5f);
+        QCOMPARE(static_cast<int>(block->output[1][0]), request % 128);
+    }
+
+    channel.shutdown();
+    QVERIFY(sandbox.wait(5000));
+}
+
+void TestPluginSandboxChannel::timeout()
+{
+    PluginSandboxChannel channel(PluginSandboxChannel::createKey());
+    QVERIFY(channel.create());
+
+    auto block = channel.getRequestBlock();
+    block->frames = 256;
+    block->inputChannels = 2;
+    block->midiEventsCount = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QVERIFY(!channel.sendRequest(10000)); // 10 ms
+    QVERIFY(timer.elapsed() < 1000);
+}
+
+void TestPluginSandboxChannel::slotsAreOwnedUntilAcknowledged()
+{
+    PluginSandboxChannel channel(PluginSandboxChannel::createKey());
+    QVERIFY(channel.create());
+
+    for (int slot = 0; slot < PluginSandboxChannel::SLOTS; ++slot) {
+        auto block = channel.getRequestBlock();
+        QVERIFY(block != nullptr);
+        block->frames = 64;
+        block->inputChannels = 2;
+        block->midiEventsCount = 0;
+        QVERIFY(!channel.sendRequest(0)); // not waiting, nobody is processing the requests
+        QVERIFY(channel.isWaitingResponse());
+    }
+
+    QVERIFY(channel.getRequestBlock() == nullptr); // all slots are still owned by the sandbox side
+
+    PluginSandboxChannel sandboxSide(channel.getKey());
+    QVERIFY(sandboxSide.attach());
+
+    // the late sandbox is processing only the last request, the skipped requests are acknowledged too
+    QVERIFY(sandboxSide.waitRequest(0) != nullptr);
+    QVERIFY(channel.getRequestBlock() == nullptr);
+    sandboxSide.finishRequest();
+
+    QVERIFY(!channel.isWaitingResponse());
+    QVERIFY(channel.getRequestBlock() != nullptr);
+}
+
+void TestPluginSandboxChannel::roundTripLatency_data()
+{
+    QTest::addColumn<int>("frames");
+
+    QTest::newRow("64 frames") << 64;
+    QTest::newRow("128 frames") << 128;
+    QTest::newRow("256 frames") << 256;
+}
+
+void TestPluginSandboxChannel::roundTripLatency()
+{
+    QFETCH(int, frames);
+
+    PluginSandboxChannel channel(PluginSandboxChannel::createKey());
+    QVERIFY(channel.create());
+
+    EchoSandbox sandbox(channel.getKey());
+    sandbox.start();
+    QVERIFY(sandbox.waitAttach());
+
+    QBENCHMARK {
+        auto block = channel.getRequestBlock();
+        block->frames = frames;
+        block->inputChannels = 2;
+        block->midiEventsCount = 0;
+        QVERIFY(channel.sendRequest(1000000));
+    }
+
+    channel.shutdown();
+    QVERIFY(sandbox.wait(5000));
+}
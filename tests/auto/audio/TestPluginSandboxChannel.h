@@ -0,0 +1,19 @@
+#ifndef TEST_PLUGIN_SANDBOX_CHANNEL_H
+#define TEST_PLUGIN_SANDBOX_CHANNEL_H
+
+#include <QObject>
+
+class TestPluginSandboxChannel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip(); // the processed samples and MIDI events are returned by the sandbox side
+    void timeout(); // nobody processing the requests, the audio thread is not blocked
+    void slotsAreOwnedUntilAcknowledged(); // a late sandbox is not reading a slot rewritten by the host
+
+    void roundTripLatency(); // benchmark
+    void roundTripLatency_data();
+};
+
+#endif
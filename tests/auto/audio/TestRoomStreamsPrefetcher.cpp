@@ -0,0 +1,128 @@
+#include "TestRoomStreamsPrefetcher.h"
+#include "audio/RoomStreamsPrefetcher.h"
+
+#include <QtTest/QtTest>
+#include <QTcpSocket>
+#include <QNetworkReply>
+
+using audio::RoomStreamsPrefetcher;
+
+void TestRoomStreamsPrefetcher::initTestCase()
+{
+    // more bytes than the bandwidth limit (per second) and the prefetched bytes limit
+    streamBytes.resize(200000);
+    for (int i = 0; i < streamBytes.size(); ++i)
+        streamBytes[i] = static_cast<char>(i % 251);
+
+    connect(&server, &QTcpServer::newConnection, this, [=]() {
+        while (server.hasPendingConnections()) {
+            QTcpSocket *socket = server.nextPendingConnection();
+            socket->write("HTTP/1.0 200 OK\r\nContent-Type: audio/mpeg\r\n\r\n");
+            socket->write(streamBytes); // the connection is not closed, like a live stream
+        }
+    });
+
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+}
+
+QString TestRoomStreamsPrefetcher::getStreamUrl(int stream) const
+{
+    return QString("http://127.0.0.1:%1/stream%2").arg(server.serverPort()).arg(stream);
+}
+
+void TestRoomStreamsPrefetcher::takeNonPrefetchedStream()
+{
+    RoomStreamsPrefetcher prefetcher;
+
+    QByteArray prefetchedBytes;
+    QVERIFY(prefetcher.takeStream(getStreamUrl(0), prefetchedBytes) == nullptr);
+    QVERIFY(prefetchedBytes.isEmpty());
+}
+
+void TestRoomStreamsPrefetcher::streamsLimit()
+{
+    RoomStreamsPrefetcher prefetcher;
+
+    QStringList urls;
+    urls << QString(); // empty urls (rooms without stream) are ignored
+    for (int i = 0; i < RoomStreamsPrefetcher::MAX_STREAMS + 2; ++i)
+        urls << getStreamUrl(i);
+
+    prefetcher.setStreamsToPrefetch(urls);
+
+    for (int i = 0; i < RoomStreamsPrefetcher::MAX_STREAMS; ++i)
+        QVERIFY(prefetcher.isPrefetching(getStreamUrl(i)));
+
+    QVERIFY(!prefetcher.isPrefetching(QString()));
+    QVERIFY(!prefetcher.isPrefetching(getStreamUrl(RoomStreamsPrefetcher::MAX_STREAMS)));
+    QVERIFY(!prefetcher.isPrefetching(getStreamUrl(RoomStreamsPrefetcher::MAX_STREAMS + 1)));
+}
+
+void TestRoomStreamsPrefetcher::nonListedStreamsAreClosed()
+{
+    RoomStreamsPrefetcher prefetcher;
+
+    prefetcher.setStreamsToPrefetch(QStringList() << getStreamUrl(0) << getStreamUrl(1));
+    prefetcher.setStreamsToPrefetch(QStringList() << getStreamUrl(1) << getStreamUrl(2));
+
+    QVERIFY(!prefetcher.isPrefetching(getStreamUrl(0)));
+    QVERIFY(prefetcher.isPrefetching(getStreamUrl(1)));
+    QVERIFY(prefetcher.isPrefetching(getStreamUrl(2)));
+
+    prefetcher.stopAll();
+
+    QVERIFY(!prefetcher.isPrefetching(getStreamUrl(1)));
+    QVERIFY(!prefetcher.isPrefetching(getStreamUrl(2)));
+}
+
+void TestRoomStreamsPrefetcher::bandwidthLimit()
+{
+    RoomStreamsPrefetcher prefetcher;
+
+    const QString url = getStreamUrl(0);
+    prefetcher.setStreamsToPrefetch(QStringList() << url);
+
+    // the server is sending all bytes at once, but only the bandwidth budget is read in the first second
+    QTRY_VERIFY(prefetcher.getPrefetchedBytes(url) > 0);
+    QTest::qWait(200);
+    QVERIFY(prefetcher.getPrefetchedBytes(url) <= RoomStreamsPrefetcher::MAX_BYTES_PER_SECOND);
+}
+
+void TestRoomStreamsPrefetcher::bandwidthIsShared()
+{
+    RoomStreamsPrefetcher prefetcher;
+
+    QStringList urls;
+    for (int i = 0; i < RoomStreamsPrefetcher::MAX_STREAMS; ++i)
+        urls << getStreamUrl(i);
+
+    prefetcher.setStreamsToPrefetch(urls);
+
+    for (const QString &url : urls)
+        QTRY_VERIFY_WITH_TIMEOUT(prefetcher.getPrefetchedBytes(url) > 0, 3000);
+}
+
+void TestRoomStreamsPrefetcher::lastBytesAreTransferred()
+{
+    RoomStreamsPrefetcher prefetcher;
+
+    const QString url = getStreamUrl(0);
+    prefetcher.setStreamsToPrefetch(QStringList() << url);
+
+    const int secondsToRead = streamBytes.size() / RoomStreamsPrefetcher::MAX_BYTES_PER_SECOND + 1;
+    QTRY_COMPARE_WITH_TIMEOUT(prefetcher.getPrefetchedBytes(url), streamBytes.size(), (secondsToRead + 2) * 1000);
+
+    QByteArray prefetchedBytes;
+    QNetworkReply *reply = prefetcher.takeStream(url, prefetchedBytes);
+    QVERIFY(reply != nullptr);
+    QVERIFY(!prefetcher.isPrefetching(url));
+
+    // only the last bytes are useful to start playing the stream
+    QCOMPARE(prefetchedBytes.size(), RoomStreamsPrefetcher::MAX_PREFETCHED_BYTES);
+    QCOMPARE(prefetchedBytes, streamBytes.right(RoomStreamsPrefetcher::MAX_PREFETCHED_BYTES));
+
+    QCOMPARE(reply->readBufferSize(), static_cast<qint64>(0)); // the reply is not limited by the prefetcher anymore
+
+    reply->abort();
+    delete reply;
+}
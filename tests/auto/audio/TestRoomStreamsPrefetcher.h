@@ -0,0 +1,28 @@
+#ifndef TEST_ROOM_STREAMS_PREFETCHER_H
+#define TEST_ROOM_STREAMS_PREFETCHER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QByteArray>
+
+class TestRoomStreamsPrefetcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase(); // a local http server is streaming the same bytes in all urls
+    void takeNonPrefetchedStream();
+    void streamsLimit();
+    void nonListedStreamsAreClosed();
+    void bandwidthLimit();
+    void bandwidthIsShared(); // all streams are prefetching, even when the first streams can exhaust the budget
+    void lastBytesAreTransferred();
+
+private:
+    QString getStreamUrl(int stream) const;
+
+    QTcpServer server;
+    QByteArray streamBytes;
+};
+
+#endif
@@ -2,6 +2,7 @@
 
 #include <QString>
 #include "audio/core/SamplesBuffer.h"
+#include "audio/core/SamplesRingBuffer.h"
 #include <QTest>
 
 using namespace audio;
@@ -256,3 +257,96 @@ void TestSamplesBuffer::append_data()
     QTest::newRow("Appending 2 samples") << "1,2,3" << "4,5" << "1,2,3,4,5";
     QTest::newRow("Appending zero samples") << "1,2,3" << "" << "1,2,3";
 }
+
+void TestSamplesBuffer::ringBuffer()
+{
+    QFETCH(int, capacity);
+    QFETCH(QString, firstWrite);
+    QFETCH(int, firstRead);
+    QFETCH(QString, secondWrite);
+    QFETCH(int, expectedWrittenFrames);
+    QFETCH(QString, expectedSamples);
+
+    SamplesRingBuffer ring(capacity);
+
+    SamplesBuffer buffer = createBuffer(firstWrite);
+    ring.write(buffer);
+
+    SamplesBuffer out(1, capacity);
+    ring.read(out, firstRead);
+
+    buffer = createBuffer(secondWrite);
+    QCOMPARE(ring.write(buffer), static_cast<uint>(expectedWrittenFrames));
+
+    const uint availableFrames = ring.getAvailableFrames();
+    QCOMPARE(ring.read(out, capacity), availableFrames);
+    QCOMPARE(ring.getAvailableFrames(), 0u);
+
+    out.setFrameLenght(availableFrames);
+    checkExpectedValues(expectedSamples, out);
+}
+
+void TestSamplesBuffer::ringBuffer_data()
+{
+    QTest::addColumn<int>("capacity");
+    QTest::addColumn<QString>("firstWrite");
+    QTest::addColumn<int>("firstRead");
+    QTest::addColumn<QString>("secondWrite");
+    QTest::addColumn<int>("expectedWrittenFrames");
+    QTest::addColumn<QString>("expectedSamples");
+
+    QTest::newRow("No wrapping") << 8 << "1,2,3" << 1 << "4,5" << 2 << "2,3,4,5";
+    QTest::newRow("Wrapping") << 4 << "1,2,3" << 2 << "4,5,6" << 3 << "3,4,5,6";
+    QTest::newRow("Full ring") << 4 << "1,2,3" << 0 << "4,5" << 1 << "1,2,3,4";
+    QTest::newRow("Empty writes") << 4 << "" << 0 << "" << 0 << "";
+}
+
+void TestSamplesBuffer::ringBufferDiscard()
+{
+    SamplesRingBuffer ring(4);
+
+    SamplesBuffer buffer = createBuffer("1,2,3");
+    ring.write(buffer);
+
+    QCOMPARE(ring.discard(2), 2u);
+    QCOMPARE(ring.getAvailableFrames(), 1u);
+
+    buffer = createBuffer("4,5,6");
+    QCOMPARE(ring.write(buffer), 3u); // wrapping around the ring end
+
+    QCOMPARE(ring.discard(10), 4u); // discarding all available frames
+    QCOMPARE(ring.getAvailableFrames(), 0u);
+
+    buffer = createBuffer("7");
+    ring.write(buffer);
+
+    SamplesBuffer out(1, 4);
+    QCOMPARE(ring.read(out, 4), 1u);
+    out.setFrameLenght(1);
+    checkExpectedValues("7", out);
+}
+
+void TestSamplesBuffer::ringBufferPositionsWrapping()
+{
+    SamplesRingBuffer ring(3);
+    SamplesBuffer out(1, 3);
+
+    for (int cycle = 0; cycle < 10; ++cycle) {
+        SamplesBuffer buffer = createBuffer("1,2,3");
+        QCOMPARE(ring.write(buffer), 3u);
+        QCOMPARE(ring.getAvailableFrames(), 3u); // the full ring is not confused with an empty ring
+        QCOMPARE(ring.getFreeFrames(), 0u);
+
+        QCOMPARE(ring.read(out, 2), 2u);
+        out.setFrameLenght(2);
+        checkExpectedValues("1,2", out);
+
+        buffer = createBuffer("4,5");
+        QCOMPARE(ring.write(buffer), 2u);
+
+        out.setFrameLenght(3);
+        QCOMPARE(ring.read(out, 3), 3u);
+        checkExpectedValues("3,4,5", out);
+        QCOMPARE(ring.getAvailableFrames(), 0u);
+    }
+}
@@ -34,6 +34,13 @@ private slots:
     void copy();
     void copy_data();
 
+    // write, read and write again in a ring buffer, the second write is wrapping around the ring end
+    void ringBuffer();
+    void ringBuffer_data();
+
+    void ringBufferDiscard(); // the consumer is skipping the old samples without read them
+    void ringBufferPositionsWrapping(); // many write/read cycles in a ring with a non power of 2 capacity
+
 private:
     audio::SamplesBuffer createBuffer(QString comaSeparatedValues);
     void checkExpectedValues(QString comaSeparatedExpectedValues, const audio::SamplesBuffer &buffer);
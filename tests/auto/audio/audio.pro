@@ -1,4 +1,5 @@
 QT += testlib
+QT += network
 QT -= gui
 CONFIG += testcase
 CONFIG += c++11
@@ -6,21 +7,75 @@ TEMPLATE = app
 TARGET = audio
 
 INCLUDEPATH += .
+INCLUDEPATH += fakes # before src/Common, the metronome is using the fake MetronomeUtils
 INCLUDEPATH += ../../../src/Common
 VPATH += ../../../src/Common
 
 HEADERS += TestSamplesBuffer.h
 HEADERS += TestLooper.h
+HEADERS += TestPluginSandboxChannel.h
+HEADERS += TestAudioLoadMonitor.h
+HEADERS += TestNativeEffects.h
+HEADERS += TestFilters.h
+HEADERS += TestRoomStreamsPrefetcher.h
+HEADERS += TestPeaksTelemetry.h
+HEADERS += TestMetronome.h
 HEADERS += audio/core/SamplesBuffer.h
 HEADERS += audio/core/AudioPeak.h
+HEADERS += audio/core/SamplesRingBuffer.h
+HEADERS += audio/core/PeaksTelemetry.h
 HEADERS += looper/Looper.h
+HEADERS += looper/PeaksPyramid.h
+HEADERS += looper/LayersMixer.h
+HEADERS += looper/CompactSamples.h
+HEADERS += audio/PluginSandboxChannel.h
+HEADERS += audio/core/AudioLoadMonitor.h
+HEADERS += audio/core/Filters.h
+HEADERS += audio/core/NativeEffects.h
+HEADERS += audio/RoomStreamsPrefetcher.h
+HEADERS += log/Logging.h
+
+# the metronome node and the sounds cache
+HEADERS += fakes/MetronomeUtils.h
+HEADERS += audio/MetronomeTrackNode.h
+HEADERS += audio/MetronomeSoundBank.h
+HEADERS += audio/core/AudioNode.h
+HEADERS += audio/core/AudioNodeProcessor.h
+HEADERS += audio/core/AudioDriver.h
+HEADERS += midi/MidiBuffer.h
+HEADERS += midi/MidiMessage.h
+SOURCES += audio/MetronomeTrackNode.cpp
+SOURCES += audio/MetronomeSoundBank.cpp
+SOURCES += audio/core/AudioNode.cpp
+SOURCES += audio/core/AudioNodeProcessor.cpp
+SOURCES += audio/core/AudioDriver.cpp
+SOURCES += midi/MidiBuffer.cpp
+SOURCES += midi/MidiMessage.cpp
 
 SOURCES += TestSamplesBuffer.cpp
 SOURCES += TestLooper.cpp
+SOURCES += TestPluginSandboxChannel.cpp
+SOURCES += TestAudioLoadMonitor.cpp
+SOURCES += TestNativeEffects.cpp
+SOURCES += TestFilters.cpp
+SOURCES += TestRoomStreamsPrefetcher.cpp
+SOURCES += TestPeaksTelemetry.cpp
+SOURCES += TestMetronome.cpp
 SOURCES += audio/core/SamplesBuffer.cpp
 SOURCES += audio/core/AudioPeak.cpp
+SOURCES += audio/core/SamplesRingBuffer.cpp
+SOURCES += audio/core/PeaksTelemetry.cpp
 SOURCES += looper/Looper.cpp
 SOURCES += looper/LooperStates.cpp
 SOURCES += looper/LooperLayer.cpp
+SOURCES += looper/PeaksPyramid.cpp
+SOURCES += looper/LayersMixer.cpp
+SOURCES += looper/CompactSamples.cpp
+SOURCES += audio/PluginSandboxChannel.cpp
+SOURCES += audio/core/AudioLoadMonitor.cpp
+SOURCES += audio/core/Filters.cpp
+SOURCES += audio/core/NativeEffects.cpp
+SOURCES += audio/RoomStreamsPrefetcher.cpp
+SOURCES += log/logging.cpp
 
 SOURCES += test_Audio.cpp
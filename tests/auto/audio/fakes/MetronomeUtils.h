@@ -0,0 +1,84 @@
+#ifndef FAKE_METRONOME_UTILS_H
+#define FAKE_METRONOME_UTILS_H
+
+#include "audio/core/SamplesBuffer.h"
+
+#include <QList>
+#include <QString>
+
+namespace audio {
+
+/**
+ * The metronomeUtils members used by MetronomeSoundBank and MetronomeTrackNode. The real sounds are
+ * decoded from resources (ogg, mp3, wav) and resampled, so the tests are creating synthetic clicks
+ * and counting how many times the sounds are created (the disk cache is skipping the creation).
+ */
+
+class metronomeUtils
+{
+public:
+    static void createBuiltInSounds(const QString &alias, SamplesBuffer &firstBeat, SamplesBuffer &offBeat,
+                                    SamplesBuffer &accentBeat, quint32 localSampleRate)
+    {
+        Q_UNUSED(alias)
+
+        createClicks(firstBeat, offBeat, accentBeat, localSampleRate);
+    }
+
+    static void createCustomSounds(const QString &firstBeatAudioFile, const QString &offBeatAudioFile, const QString &accentBeatAudioFile,
+                                   SamplesBuffer &firstBeat, SamplesBuffer &offBeat, SamplesBuffer &accentBeat, quint32 localSampleRate)
+    {
+        Q_UNUSED(firstBeatAudioFile)
+        Q_UNUSED(offBeatAudioFile)
+        Q_UNUSED(accentBeatAudioFile)
+
+        createClicks(firstBeat, offBeat, accentBeat, localSampleRate);
+    }
+
+    static void removeSilenceInBufferStart(SamplesBuffer &buffer)
+    {
+        Q_UNUSED(buffer) // the synthetic clicks have no silence
+    }
+
+    static QList<int> getAccentBeats(int beatsPerAccent, int bpi)
+    {
+        QList<int> accentBeats;
+        for (int i = 1; beatsPerAccent > 0 && i < bpi; i++) {
+            if (i % beatsPerAccent == 0)
+                accentBeats.append(i);
+        }
+        return accentBeats;
+    }
+
+    static int &createdSounds()
+    {
+        static int count = 0;
+        return count;
+    }
+
+private:
+    // 10 ms clicks, the accent is mono
+    static void createClicks(SamplesBuffer &firstBeat, SamplesBuffer &offBeat, SamplesBuffer &accentBeat, quint32 sampleRate)
+    {
+        const uint frames = sampleRate / 100;
+
+        firstBeat = SamplesBuffer(2, frames);
+        offBeat = SamplesBuffer(2, frames);
+        accentBeat = SamplesBuffer(1, frames);
+
+        for (uint s = 0; s < frames; ++s) {
+            const float value = static_cast<float>(s + 1) / frames;
+            firstBeat.set(0, s, value);
+            firstBeat.set(1, s, -value);
+            offBeat.set(0, s, value * 0.25f);
+            offBeat.set(1, s, value * 0.5f);
+            accentBeat.set(0, s, value * 0.75f);
+        }
+
+        createdSounds()++;
+    }
+};
+
+} // namespace
+
+#endif
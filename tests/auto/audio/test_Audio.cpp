@@ -3,15 +3,43 @@
 #include <QtTest>
 #include "TestSamplesBuffer.h"
 #include "TestLooper.h"
+#include "TestPluginSandboxChannel.h"
+#include "TestAudioLoadMonitor.h"
+#include "TestNativeEffects.h"
+#include "TestFilters.h"
+#include "TestRoomStreamsPrefetcher.h"
+#include "TestPeaksTelemetry.h"
+#include "TestMetronome.h"
 
 int main(int argc, char *argv[])
 {
     TestSamplesBuffer testSamplesBuffer;
     TestLooper testLooper;
+    TestPluginSandboxChannel testPluginSandboxChannel;
+    TestAudioLoadMonitor testAudioLoadMonitor;
+    TestNativeEffects testNativeEffects;
+    TestFilters testFilters;
+    TestRoomStreamsPrefetcher testRoomStreamsPrefetcher;
+    TestPeaksTelemetry testPeaksTelemetry;
+    TestMetronome testMetronome;
 
     int result = QTest::qExec(&testSamplesBuffer, argc, argv);
 
     result |= QTest::qExec(&testLooper, argc, argv);
 
+    result |= QTest::qExec(&testPluginSandboxChannel, argc, argv);
+
+    result |= QTest::qExec(&testAudioLoadMonitor, argc, argv);
+
+    result |= QTest::qExec(&testNativeEffects, argc, argv);
+
+    result |= QTest::qExec(&testFilters, argc, argv);
+
+    result |= QTest::qExec(&testRoomStreamsPrefetcher, argc, argv);
+
+    result |= QTest::qExec(&testPeaksTelemetry, argc, argv);
+
+    result |= QTest::qExec(&testMetronome, argc, argv);
+
     return result;
 }
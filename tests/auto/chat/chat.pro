@@ -15,6 +15,7 @@ HEADERS += log/logging.h
 HEADERS += TestChatMessages.h
 HEADERS += TestChatVotingMessages.h
 HEADERS += gui/chat/NinjamChatMessageParser.h
+HEADERS += gui/chat/KeywordMatcher.h
 
 SOURCES += log/logging.cpp
 SOURCES += TestChatMessages.cpp
@@ -25,5 +26,6 @@ SOURCES += gui/chords/ChordProgression.cpp
 SOURCES += gui/BpiUtils.cpp
 SOURCES += TestChatVotingMessages.cpp
 SOURCES += gui/chat/NinjamChatMessageParser.cpp
+SOURCES += gui/chat/KeywordMatcher.cpp
 
 SOURCES += test_Chat.cpp
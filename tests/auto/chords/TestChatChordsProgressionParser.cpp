@@ -92,3 +92,34 @@ void TestChatChordsProgressionParser::measureSeparators_data()
     //QTest::newRow("Measure separator L") << QString("L C L F L G 7 L F"); //removed to avoid the problem in issue #263
     QTest::newRow("Mixed measure separators") << QString("|C ! F I G 7 l F");
 }
+
+void TestChatChordsProgressionParser::containsProgressionThroughput()
+{
+    QStringList messages;
+    messages << QString("Nice jam! :-) see you tomorrow")
+             << QString("I AM TIRED ...")
+             << QString("| C | F | G7 | F")
+             << QString("/bpm 120")
+             << QString("lol")
+             << QString("A long message without chords, only text typed by the users in the chat while they are jamming in the ninjam server.");
+
+    ChatChordsProgressionParser parser;
+
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            for (const QString &message : messages)
+                parser.containsProgression(message);
+        }
+    }
+}
+
+void TestChatChordsProgressionParser::parseThroughput()
+{
+    const QString message("|C |Fmaj7 |G7 |Gº |Am7 |Am7/G |F#m7(b5) |Fmaj9 |C |Fmaj7 |G7 |Gº |Am7 |Am7/G |F#m7(b5) |Fmaj9");
+
+    ChatChordsProgressionParser parser;
+
+    QBENCHMARK {
+        parser.parse(message);
+    }
+}
@@ -23,6 +23,9 @@ private slots:
 
     void upperCaseText(); //test some invalid text containing upper case chords letters (issue #263)
     void upperCaseText_data();
+
+    void containsProgressionThroughput(); // benchmark, most chat messages are not chord progressions
+    void parseThroughput(); // benchmark
 };
 
 #endif // TESTCHATCHORDSPROGRESSIONPARSER_H
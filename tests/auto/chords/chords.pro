@@ -15,6 +15,7 @@ HEADERS += log/logging.h
 HEADERS += TestChatChordsProgressionParser.h
 HEADERS += TestChordsParser.h
 HEADERS += gui/chat/NinjamChatMessageParser.h
+HEADERS += gui/chat/KeywordMatcher.h
 
 SOURCES += log/logging.cpp
 SOURCES += gui/chords/ChatChordsProgressionParser.cpp
@@ -25,5 +26,6 @@ SOURCES += gui/BpiUtils.cpp
 SOURCES += TestChatChordsProgressionParser.cpp
 SOURCES += TestChordsParser.cpp
 SOURCES += gui/chat/NinjamChatMessageParser.cpp
+SOURCES += gui/chat/KeywordMatcher.cpp
 
 SOURCES += test_Chords.cpp
@@ -111,3 +111,41 @@ void TestEmojiParser::combinationEmojis()
     QString result = manager->emojify(message);
     QCOMPARE(result, emojifiedMessage);
 }
+
+void TestEmojiParser::wholeWordCombinations_data()
+{
+    QTest::addColumn<QString>("message");
+
+    QTest::newRow("+1 inside word")  << QString("bpm+1");
+    QTest::newRow("-1 inside word")  << QString("Track-1");
+    QTest::newRow("-1 between numbers")  << QString("4-1");
+}
+
+void TestEmojiParser::wholeWordCombinations()
+{
+    QFETCH(QString, message);
+
+    EmojiManager manager(QString(""), QString(""));
+
+    QCOMPARE(manager.emojify(message), message);
+}
+
+void TestEmojiParser::emojifyThroughput()
+{
+    QStringList messages;
+    messages << QString("Nice jam! :-) see you tomorrow")
+             << QString("I'm leaving :( bye all (y)")
+             << QString("| C | F | G7 | F")
+             << QString("Let's play in ninbot.com : 2049 ?")
+             << QString("Great groove +1 ;) :D")
+             << QString("A long message without emojis, only text typed by the users in the chat while they are jamming in the ninjam server.");
+
+    EmojiManager manager(QString(""), QString(""));
+
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            for (const QString &message : messages)
+                manager.emojify(message);
+        }
+    }
+}
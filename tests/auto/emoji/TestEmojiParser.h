@@ -15,6 +15,11 @@ private slots:
     void combinationEmojisInsideMessages_data();
     void combinationEmojisInsideMessages();
 
+    void wholeWordCombinations_data();
+    void wholeWordCombinations();
+
+    void emojifyThroughput(); // benchmark
+
 };
 
 #endif // TEST_EMOJI_PARSER
@@ -1,7 +1,7 @@
 
 #TODO create a test-common.pri to share common tests configuration
 
-QT += testlib core widgets network
+QT += testlib core widgets network concurrent
 
 CONFIG += testcase c++11
 TEMPLATE = app
@@ -12,11 +12,15 @@ INCLUDEPATH += ../../../src/Common
 VPATH += ../../../src/Common
 
 HEADERS += log/logging.h
+HEADERS += log/StartupTimeline.h
 HEADERS += TestEmojiParser.h
 SOURCES += gui/chat/EmojiManager.h
+HEADERS += gui/chat/KeywordMatcher.h
 
 SOURCES += log/logging.cpp
+SOURCES += log/StartupTimeline.cpp
 SOURCES += TestEmojiParser.cpp
 SOURCES += gui/chat/EmojiManager.cpp
+SOURCES += gui/chat/KeywordMatcher.cpp
 
 SOURCES += test_Emoji.cpp
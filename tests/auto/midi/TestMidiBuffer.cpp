@@ -0,0 +1,242 @@
+#include "TestMidiBuffer.h"
+#include "midi/MidiBuffer.h"
+#include "audio/core/AudioMixer.h"
+#include "audio/core/LocalInputNode.h"
+#include "audio/core/AudioNodeProcessor.h"
+#include "audio/core/SamplesBuffer.h"
+#include "MainController.h" // the fake controller used by LocalInputNode
+
+#include <QtTest/QtTest>
+#include <QAtomicInt>
+#include <QPoint>
+
+#include <cstdlib>
+#include <new>
+
+using midi::MidiBuffer;
+using midi::MidiMessage;
+
+// counting all allocations in this test executable
+static QAtomicInt allocations(0);
+
+void *operator new(std::size_t size)
+{
+    allocations.fetchAndAddRelaxed(1);
+    void *memory = std::malloc(size ? size : 1);
+    if (!memory)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+namespace {
+
+// a VSTi generating MIDI messages (an arpeggiator, for example)
+class MidiGeneratorInstrument : public audio::AudioNodeProcessor
+{
+public:
+    MidiGeneratorInstrument() :
+        receivedMessages(0)
+    {
+    }
+
+    void process(const audio::SamplesBuffer &in, audio::SamplesBuffer &out, midi::MidiBuffer &midiMessages) override
+    {
+        Q_UNUSED(in);
+        Q_UNUSED(out);
+
+        receivedMessages += midiMessages.size();
+    }
+
+    void suspend() override {}
+    void resume() override {}
+    void updateGui() override {}
+    void openEditor(const QPoint &centerOfScreen) override { Q_UNUSED(centerOfScreen); }
+    void closeEditor() override {}
+
+    bool isVirtualInstrument() const override
+    {
+        return true;
+    }
+
+    bool canGenerateMidiMessages() const override
+    {
+        return true;
+    }
+
+    int getReceivedMessages() const
+    {
+        return receivedMessages;
+    }
+
+private:
+    int receivedMessages;
+};
+
+} // namespace
+
+void TestMidiBuffer::computeDeltaFrames()
+{
+    QFETCH(qint64, messageAge); // microseconds
+    QFETCH(int, expectedDeltaFrames);
+
+    const int sampleRate = 48000;
+    const int frames = 480; // 10 ms
+    const qint64 blockTimestamp = 1000000;
+
+    MidiBuffer buffer;
+    buffer.push_back(MidiMessage(0x7F5090, 0, blockTimestamp - messageAge));
+
+    buffer.computeDeltaFrames(blockTimestamp, frames, sampleRate);
+
+    QCOMPARE(buffer[0].getDeltaFrames(), expectedDeltaFrames);
+}
+
+void TestMidiBuffer::computeDeltaFrames_data()
+{
+    QTest::addColumn<qint64>("messageAge");
+    QTest::addColumn<int>("expectedDeltaFrames");
+
+    QTest::newRow("Captured in previous block start") << (qint64)10000 << 0;
+    QTest::newRow("Captured in previous block middle") << (qint64)5000 << 240;
+    QTest::newRow("Captured right now") << (qint64)0 << 479;
+    QTest::newRow("Late message") << (qint64)25000 << 0;
+}
+
+void TestMidiBuffer::computeDeltaFramesIsSortingMessages()
+{
+    const qint64 blockTimestamp = 1000000;
+
+    MidiBuffer buffer;
+    buffer.push_back(MidiMessage(0x7F5090, 0, blockTimestamp - 1000)); // device 0, last message
+    buffer.push_back(MidiMessage(0x7F4690, 1, blockTimestamp - 9000)); // device 1, first message
+    buffer.push_back(MidiMessage(0x7F4890, 1)); // not timestamped
+
+    buffer.computeDeltaFrames(blockTimestamp, 480, 48000);
+
+    QCOMPARE(buffer[0].getData1(), 0x48);
+    QCOMPARE(buffer[0].getDeltaFrames(), 0);
+    QCOMPARE(buffer[1].getData1(), 0x46);
+    QCOMPARE(buffer[2].getData1(), 0x50);
+    QVERIFY(buffer[1].getDeltaFrames() < buffer[2].getDeltaFrames());
+}
+
+void TestMidiBuffer::moveTo()
+{
+    MidiBuffer in;
+    for (int note = 60; note < 70; ++note)
+        in.push_back(MidiMessage(0x7F0090 | (note << 8) | (note % 2), 0)); // even notes in channel 0, odd notes in channel 1
+
+    MidiBuffer out;
+    in.moveTo(out, [](MidiMessage &message) {
+        if (message.getChannel() != 0)
+            return false;
+
+        message.transpose(12);
+        return true;
+    });
+
+    QCOMPARE(out.size(), 5);
+    QCOMPARE(in.size(), 5);
+    for (int i = 0; i < 5; ++i) {
+        QCOMPARE(out[i].getData1(), 60 + i * 2 + 12);
+        QCOMPARE(in[i].getData1(), 61 + i * 2);
+    }
+}
+
+void TestMidiBuffer::copyRange()
+{
+    MidiBuffer block;
+    for (int deltaFrames = 0; deltaFrames < 256; deltaFrames += 32) {
+        MidiMessage message(0x7F3C90, 0);
+        message.setDeltaFrames(deltaFrames);
+        block.push_back(message);
+    }
+
+    MidiBuffer part;
+    block.copyRange(part, 100, 100); // 128, 160 and 192
+
+    QCOMPARE(part.size(), 3);
+    QCOMPARE(part[0].getDeltaFrames(), 28);
+    QCOMPARE(part[1].getDeltaFrames(), 60);
+    QCOMPARE(part[2].getDeltaFrames(), 92);
+    QCOMPARE(block.size(), 8);
+}
+
+void TestMidiBuffer::discardWhenFull()
+{
+    MidiBuffer buffer;
+    for (int i = 0; i < MidiBuffer::CAPACITY; ++i)
+        QVERIFY(buffer.push_back(MidiMessage(0x7F3C90, 0)));
+
+    QVERIFY(buffer.isFull());
+    QVERIFY(!buffer.push_back(MidiMessage(0x7F3C90, 0)));
+    QCOMPARE(buffer.size(), MidiBuffer::CAPACITY);
+
+    MidiBuffer other(buffer);
+    other.append(buffer);
+    QCOMPARE(other.size(), MidiBuffer::CAPACITY);
+}
+
+void TestMidiBuffer::audioCallbackIsNotAllocating()
+{
+    // the audio graph processed in MainController::doAudioProcess: the mixer and a MIDI input track playing a VSTi
+    const int sampleRate = 48000;
+    const int frames = 256;
+
+    controller::MainController controller;
+    QScopedPointer<audio::LocalInputNode> inputTrack(new audio::LocalInputNode(&controller, 0));
+    inputTrack->setMidiInputSelection(0, 0); // device 0, first MIDI channel
+    inputTrack->setTranspose(1);
+
+    auto instrument = new MidiGeneratorInstrument(); // deleted by the node
+    inputTrack->addProcessor(instrument, 0);
+
+    audio::AudioMixer mixer(sampleRate);
+    mixer.addNode(inputTrack.data());
+
+    audio::SamplesBuffer in(2, frames);
+    audio::SamplesBuffer out(2, frames);
+
+    // the buffers are members of MainController
+    QScopedPointer<MidiBuffer> devicesBuffer(new MidiBuffer());
+    QScopedPointer<MidiBuffer> partBuffer(new MidiBuffer());
+
+    auto processCallback = [&](qint64 blockTimestamp) {
+        // MainController::process
+        devicesBuffer->clear();
+        for (int i = 0; i < 16; ++i) // the driver queue, messages from devices 0 and 1
+            devicesBuffer->push_back(MidiMessage(0x7F3C90 | (i % 2), i % 2, blockTimestamp - i * 300));
+        devicesBuffer->computeDeltaFrames(blockTimestamp, frames, sampleRate);
+
+        // MainController::doAudioProcess, block processed in 2 parts
+        for (int offset = 0; offset < frames; offset += frames / 2) {
+            in.setFrameLenght(frames / 2);
+            out.setFrameLenght(frames / 2);
+            out.zero();
+
+            partBuffer->clear();
+            devicesBuffer->copyRange(*partBuffer, offset, frames / 2);
+
+            mixer.process(in, out, sampleRate, *partBuffer);
+        }
+    };
+
+    const qint64 now = MidiMessage::currentTimestamp();
+    processCallback(now); // the first callback is initializing the static buffers in the nodes and mixer
+
+    const int allocationsBefore = allocations.loadAcquire();
+
+    for (int callback = 1; callback <= 100; ++callback)
+        processCallback(now + callback * 5333);
+
+    const int allocationsAfter = allocations.loadAcquire();
+    QCOMPARE(allocationsAfter - allocationsBefore, 0);
+
+    QVERIFY(instrument->getReceivedMessages() > 0); // the filtered messages and the messages generated by plugins
+}
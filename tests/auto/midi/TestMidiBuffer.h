@@ -0,0 +1,23 @@
+#ifndef TEST_MIDI_BUFFER_H
+#define TEST_MIDI_BUFFER_H
+
+#include <QObject>
+
+class TestMidiBuffer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void computeDeltaFrames();
+    void computeDeltaFrames_data();
+
+    void computeDeltaFramesIsSortingMessages(); // messages from different devices are interleaved
+
+    void moveTo(); // filtering, accepted messages moved and the remaining messages compacted in order
+    void copyRange(); // messages in a part of the block, rebased to the part start
+    void discardWhenFull();
+
+    void audioCallbackIsNotAllocating(); // a real mixer and MIDI input track processing under the allocations counter
+};
+
+#endif
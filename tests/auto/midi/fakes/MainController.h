@@ -0,0 +1,47 @@
+#ifndef FAKE_MAIN_CONTROLLER_H
+#define FAKE_MAIN_CONTROLLER_H
+
+#include "midi/MidiBuffer.h"
+#include "midi/MidiMessage.h"
+
+namespace audio {
+class LocalInputNode;
+}
+
+namespace controller {
+
+/**
+ * The MainController members used by audio::LocalInputNode. The real MainController is pulling
+ * the network, video and GUI code, so the test is compiling LocalInputNode.cpp against this header.
+ */
+
+class MainController
+{
+public:
+    quint8 getLooperPreferedMode() const
+    {
+        return 0;
+    }
+
+    quint8 getLooperPreferedLayersCount() const
+    {
+        return 4;
+    }
+
+    audio::LocalInputNode *getInputTrackInGroup(quint8 groupIndex, quint8 trackIndex) const
+    {
+        Q_UNUSED(groupIndex);
+        Q_UNUSED(trackIndex);
+
+        return nullptr; // a single subchannel
+    }
+
+    void pullMidiMessagesFromPlugins(midi::MidiBuffer &outBuffer)
+    {
+        outBuffer.push_back(midi::MidiMessage(0x7F4090, -1)); // a message generated by a VSTi
+    }
+};
+
+} // namespace
+
+#endif
@@ -1,14 +1,60 @@
 QT += testlib
 QT -= gui
 CONFIG += testcase
+CONFIG += c++11
 TEMPLATE = app
 TARGET = midi
 
 INCLUDEPATH += .
+INCLUDEPATH += fakes # before src/Common, LocalInputNode is using the fake MainController
 INCLUDEPATH += ../../../src/Common
 VPATH += ../../../src/Common
 
 HEADERS += midi/MidiMessage.h
+HEADERS += midi/MidiBuffer.h
 SOURCES += midi/MidiMessage.cpp
+SOURCES += midi/MidiBuffer.cpp
+
+# the audio graph processed in each audio callback
+HEADERS += fakes/MainController.h
+HEADERS += audio/core/AudioMixer.h
+HEADERS += audio/core/AudioNode.h
+HEADERS += audio/core/AudioNodeProcessor.h
+HEADERS += audio/core/AudioDriver.h
+HEADERS += audio/core/LocalInputNode.h
+HEADERS += audio/core/SamplesBuffer.h
+HEADERS += audio/core/AudioPeak.h
+HEADERS += audio/core/PeaksTelemetry.h
+HEADERS += audio/core/AudioLoadMonitor.h
+HEADERS += audio/Resampler.h
+HEADERS += audio/SamplesBufferResampler.h
+HEADERS += looper/Looper.h
+HEADERS += looper/LooperStates.h
+HEADERS += looper/LooperLayer.h
+HEADERS += looper/PeaksPyramid.h
+HEADERS += looper/LayersMixer.h
+HEADERS += looper/CompactSamples.h
+HEADERS += log/Logging.h
+SOURCES += audio/core/AudioMixer.cpp
+SOURCES += audio/core/AudioNode.cpp
+SOURCES += audio/core/AudioNodeProcessor.cpp
+SOURCES += audio/core/AudioDriver.cpp
+SOURCES += audio/core/LocalInputNode.cpp
+SOURCES += audio/core/SamplesBuffer.cpp
+SOURCES += audio/core/AudioPeak.cpp
+SOURCES += audio/core/PeaksTelemetry.cpp
+SOURCES += audio/core/AudioLoadMonitor.cpp
+SOURCES += audio/Resampler.cpp
+SOURCES += audio/SamplesBufferResampler.cpp
+SOURCES += looper/Looper.cpp
+SOURCES += looper/LooperStates.cpp
+SOURCES += looper/LooperLayer.cpp
+SOURCES += looper/PeaksPyramid.cpp
+SOURCES += looper/LayersMixer.cpp
+SOURCES += looper/CompactSamples.cpp
+SOURCES += log/logging.cpp
+
+HEADERS += TestMidiBuffer.h
+SOURCES += TestMidiBuffer.cpp
 
 SOURCES += test_MidiMessage.cpp
@@ -2,6 +2,7 @@
 #include <QtTest/QtTest>
 #include <QString>
 #include "midi/MidiMessage.h"
+#include "TestMidiBuffer.h"
 
 using namespace midi;
 
@@ -43,8 +44,14 @@ void TestMidiMessage::transpose_data()
 
 int main(int argc, char *argv[])
 {
-    TestMidiMessage test;
-    return QTest::qExec(&test, argc, argv);
+    TestMidiMessage testMidiMessage;
+    TestMidiBuffer testMidiBuffer;
+
+    int result = QTest::qExec(&testMidiMessage, argc, argv);
+
+    result |= QTest::qExec(&testMidiBuffer, argc, argv);
+
+    return result;
 }
 
 #include "test_MidiMessage.moc"
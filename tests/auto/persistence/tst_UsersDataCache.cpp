@@ -2,6 +2,7 @@
 #include <QObject>
 #include <QString>
 #include <QtTest/QtTest>
+#include <QTemporaryDir>
 #include "persistence/UsersDataCache.h"
 #include "persistence/CacheHeader.h"
 
@@ -36,12 +37,17 @@ private slots:
     void setPanGuard();
 };
 
-// NOTE: UsersDataCache class was not able to test without side effect
-// because destructor write to storage directly.
 class TestUsersDataCache: public QObject
 {
     Q_OBJECT
 private slots:
+    void notCachedUser();
+    void persistedEntries_data();
+    void persistedEntries();
+    void updatedEntry();
+    void leastRecentlyUsedEviction();
+    void resizedStore();
+    void storeInUseByAnotherInstance(); // only one instance is writing in the store file
 };
 
 void TestCacheHeader::invalidRevision()
@@ -180,6 +186,136 @@ void TestCacheEntry::setPanGuard()
     QCOMPARE(entry.getPan(), expect);
 }
 
+void TestUsersDataCache::notCachedUser()
+{
+    QTemporaryDir cacheDir;
+    UsersDataCache cache(QDir(cacheDir.path()));
+
+    CacheEntry entry = cache.getUserCacheEntry("127.0.0.x", "anon", 1);
+    QCOMPARE(entry.getUserName(), QStringLiteral("anon"));
+    QCOMPARE(entry.getChannelID(), static_cast<quint8>(1));
+    QCOMPARE(entry.getGain(), CacheEntry::DEFAULT_GAIN);
+    QCOMPARE(entry.getPan(), CacheEntry::DEFAULT_PAN);
+    QCOMPARE(cache.getEntriesCount(), 0u);
+}
+
+void TestUsersDataCache::persistedEntries_data()
+{
+    QTest::addColumn<int>("entries");
+    QTest::newRow("one entry") << 1;
+    QTest::newRow("many entries") << 500;
+}
+
+void TestUsersDataCache::persistedEntries()
+{
+    QFETCH(int, entries);
+
+    QTemporaryDir cacheDir;
+    {
+        UsersDataCache cache(QDir(cacheDir.path()));
+        for (int i = 0; i < entries; ++i) {
+            CacheEntry entry("127.0.0.x", QString("user%1").arg(i), i % 4);
+            entry.setGain(i / 1000.0f);
+            entry.setPan(1.0f);
+            entry.setMuted(i % 2);
+            entry.setInstrumentIndex(3);
+            cache.updateUserCacheEntry(entry);
+        }
+    }
+
+    UsersDataCache cache(QDir(cacheDir.path())); // reopening the store
+    QCOMPARE(cache.getEntriesCount(), static_cast<quint32>(entries));
+    for (int i = 0; i < entries; ++i) {
+        CacheEntry entry = cache.getUserCacheEntry("127.0.0.x", QString("user%1").arg(i), i % 4);
+        QCOMPARE(entry.getGain(), i / 1000.0f);
+        QCOMPARE(entry.getPan(), 1.0f);
+        QCOMPARE(entry.isMuted(), static_cast<bool>(i % 2));
+        QCOMPARE(entry.getInstrumentIndex(), 3);
+    }
+
+    // same user in another channel is not cached
+    QCOMPARE(cache.getUserCacheEntry("127.0.0.x", "user0", 5).getPan(), CacheEntry::DEFAULT_PAN);
+}
+
+void TestUsersDataCache::updatedEntry()
+{
+    QTemporaryDir cacheDir;
+    UsersDataCache cache(QDir(cacheDir.path()));
+
+    CacheEntry entry("127.0.0.x", "anon", 0);
+    entry.setBoost(2.0f);
+    cache.updateUserCacheEntry(entry);
+
+    entry.setBoost(0.5f);
+    cache.updateUserCacheEntry(entry);
+
+    QCOMPARE(cache.getEntriesCount(), 1u);
+    QCOMPARE(cache.getUserCacheEntry("127.0.0.x", "anon", 0).getBoost(), 0.5f);
+}
+
+void TestUsersDataCache::leastRecentlyUsedEviction()
+{
+    const quint32 maxEntries = 16;
+
+    QTemporaryDir cacheDir;
+    UsersDataCache cache(QDir(cacheDir.path()), maxEntries);
+
+    for (quint32 i = 0; i < maxEntries; ++i) {
+        CacheEntry entry("127.0.0.x", QString("user%1").arg(i), 0);
+        entry.setPan(-1.0f);
+        cache.updateUserCacheEntry(entry);
+    }
+
+    cache.getUserCacheEntry("127.0.0.x", "user0", 0); // user0 is the most recently used now
+
+    cache.updateUserCacheEntry(CacheEntry("127.0.0.x", "newUser", 0)); // the cache is full, evicting
+
+    QVERIFY(cache.getEntriesCount() <= maxEntries);
+    QCOMPARE(cache.getUserCacheEntry("127.0.0.x", "user0", 0).getPan(), -1.0f);
+    QCOMPARE(cache.getUserCacheEntry("127.0.0.x", "user1", 0).getPan(), CacheEntry::DEFAULT_PAN); // the least recently used
+    QCOMPARE(cache.getUserCacheEntry("127.0.0.x", QString("user%1").arg(maxEntries - 1), 0).getPan(), -1.0f);
+}
+
+void TestUsersDataCache::resizedStore()
+{
+    QTemporaryDir cacheDir;
+    {
+        UsersDataCache cache(QDir(cacheDir.path()), 64);
+        CacheEntry entry("127.0.0.x", "anon", 0);
+        entry.setGain(0.25f);
+        cache.updateUserCacheEntry(entry);
+    }
+
+    UsersDataCache cache(QDir(cacheDir.path()), 1024); // the entries are kept when the store size is changed
+    QCOMPARE(cache.getUserCacheEntry("127.0.0.x", "anon", 0).getGain(), 0.25f);
+}
+
+void TestUsersDataCache::storeInUseByAnotherInstance()
+{
+    QTemporaryDir cacheDir;
+    {
+        UsersDataCache cache(QDir(cacheDir.path()));
+        CacheEntry entry("127.0.0.x", "anon", 0);
+        entry.setGain(0.25f);
+        cache.updateUserCacheEntry(entry);
+
+        // another plugin instance or Jamtaba process is reading a copy of the store
+        UsersDataCache otherCache(QDir(cacheDir.path()));
+        QCOMPARE(otherCache.getUserCacheEntry("127.0.0.x", "anon", 0).getGain(), 0.25f);
+
+        CacheEntry otherEntry("127.0.0.x", "other", 0);
+        otherEntry.setGain(0.5f);
+        otherCache.updateUserCacheEntry(otherEntry);
+        QCOMPARE(otherCache.getUserCacheEntry("127.0.0.x", "other", 0).getGain(), 0.5f);
+
+        QCOMPARE(cache.getEntriesCount(), 1u); // the store is not changed by the other instance
+    }
+
+    UsersDataCache cache(QDir(cacheDir.path()));
+    QCOMPARE(cache.getEntriesCount(), 1u);
+    QCOMPARE(cache.getUserCacheEntry("127.0.0.x", "anon", 0).getGain(), 0.25f);
+}
+
 int main(int argc, char *argv[])
 {
     int status = 0;
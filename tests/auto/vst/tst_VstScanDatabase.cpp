@@ -0,0 +1,188 @@
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include "vst/VstScanDatabase.h"
+
+using audio::VstScanDatabase;
+
+class TestVstScanDatabase: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void notScannedPlugin();
+    void persistedResults();
+    void changedPluginIsScannedAgain();
+    void changedBundleExecutableIsScannedAgain(); // Mac plugins are bundles (directories)
+    void clearedDatabase(); // the invalid plugins are scanned again after the plugins cache is cleared
+    void invalidDatabaseFile();
+
+private:
+    QString createPlugin(const QString &fileName, const QByteArray &content = QByteArray("plugin"));
+    QString createBundle(const QString &bundleName, const QString &executableName);
+
+    QTemporaryDir *cacheDir;
+    QTemporaryDir *pluginsDir;
+};
+
+void TestVstScanDatabase::init()
+{
+    cacheDir = new QTemporaryDir();
+    pluginsDir = new QTemporaryDir();
+}
+
+void TestVstScanDatabase::cleanup()
+{
+    delete cacheDir;
+    delete pluginsDir;
+}
+
+QString TestVstScanDatabase::createPlugin(const QString &fileName, const QByteArray &content)
+{
+    const QString pluginPath = QDir(pluginsDir->path()).absoluteFilePath(fileName);
+
+    QFile file(pluginPath);
+    file.open(QFile::WriteOnly);
+    file.write(content);
+
+    return pluginPath;
+}
+
+QString TestVstScanDatabase::createBundle(const QString &bundleName, const QString &executableName)
+{
+    QDir(pluginsDir->path()).mkpath(bundleName + "/Contents/MacOS");
+
+    createPlugin(bundleName + "/Contents/Info.plist",
+                 "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                 "<!DOCTYPE plist PUBLIC \"-//Apple//DTD PLIST 1.0//EN\" \"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+                 "<plist version=\"1.0\">\n"
+                 "<dict>\n"
+                 "    <key>CFBundleDevelopmentRegion</key>\n"
+                 "    <string>English</string>\n"
+                 "    <key>CFBundleExecutable</key>\n"
+                 "    <string>" + executableName.toUtf8() + "</string>\n"
+                 "</dict>\n"
+                 "</plist>\n");
+
+    createPlugin(bundleName + "/Contents/MacOS/" + executableName);
+
+    return QDir(pluginsDir->path()).absoluteFilePath(bundleName);
+}
+
+void TestVstScanDatabase::notScannedPlugin()
+{
+    VstScanDatabase database(QDir(cacheDir->path()));
+    QVERIFY(database.load()); // no database file, first scan
+
+    VstScanDatabase::ScanResult result;
+    QString pluginName;
+    QVERIFY(!database.getScanResult(QFileInfo(createPlugin("plugin.so")), result, pluginName));
+    QCOMPARE(database.size(), 0);
+}
+
+void TestVstScanDatabase::persistedResults()
+{
+    const QString validPlugin = createPlugin("valid.so");
+    const QString invalidPlugin = createPlugin("invalid.so");
+
+    {
+        VstScanDatabase database(QDir(cacheDir->path()));
+        database.load();
+        database.setScanResult(QFileInfo(validPlugin), VstScanDatabase::VALID_PLUGIN, "Valid Plugin");
+        database.setScanResult(QFileInfo(invalidPlugin), VstScanDatabase::INVALID_PLUGIN);
+        QVERIFY(database.save());
+    }
+
+    VstScanDatabase database(QDir(cacheDir->path())); // reopening the database
+    QVERIFY(database.load());
+    QCOMPARE(database.size(), 2);
+
+    VstScanDatabase::ScanResult result;
+    QString pluginName;
+    QVERIFY(database.getScanResult(QFileInfo(validPlugin), result, pluginName));
+    QCOMPARE(result, VstScanDatabase::VALID_PLUGIN);
+    QCOMPARE(pluginName, QString("Valid Plugin"));
+
+    QVERIFY(database.getScanResult(QFileInfo(invalidPlugin), result, pluginName));
+    QCOMPARE(result, VstScanDatabase::INVALID_PLUGIN);
+    QVERIFY(pluginName.isEmpty());
+}
+
+void TestVstScanDatabase::changedPluginIsScannedAgain()
+{
+    const QString plugin = createPlugin("plugin.so");
+
+    VstScanDatabase database(QDir(cacheDir->path()));
+    database.load();
+    database.setScanResult(QFileInfo(plugin), VstScanDatabase::VALID_PLUGIN, "Plugin");
+
+    createPlugin("plugin.so", "updated plugin"); // the file size is changed
+
+    VstScanDatabase::ScanResult result;
+    QString pluginName;
+    QVERIFY(!database.getScanResult(QFileInfo(plugin), result, pluginName));
+}
+
+void TestVstScanDatabase::changedBundleExecutableIsScannedAgain()
+{
+    const QString bundle = createBundle("Plugin.vst", "PluginBinary");
+
+    VstScanDatabase database(QDir(cacheDir->path()));
+    database.load();
+    database.setScanResult(QFileInfo(bundle), VstScanDatabase::VALID_PLUGIN, "Plugin");
+
+    VstScanDatabase::ScanResult result;
+    QString pluginName;
+    QVERIFY(database.getScanResult(QFileInfo(bundle), result, pluginName));
+
+    createPlugin("Plugin.vst/Contents/MacOS/PluginBinary", "updated plugin"); // the bundle directory is not changed
+    QVERIFY(!database.getScanResult(QFileInfo(bundle), result, pluginName));
+}
+
+void TestVstScanDatabase::clearedDatabase()
+{
+    const QString plugin = createPlugin("plugin.so");
+
+    {
+        VstScanDatabase database(QDir(cacheDir->path()));
+        database.load();
+        database.setScanResult(QFileInfo(plugin), VstScanDatabase::INVALID_PLUGIN);
+        database.save();
+
+        database.clear();
+        QCOMPARE(database.size(), 0);
+        QVERIFY(database.save());
+    }
+
+    VstScanDatabase database(QDir(cacheDir->path()));
+    QVERIFY(database.load());
+    QCOMPARE(database.size(), 0);
+
+    VstScanDatabase::ScanResult result;
+    QString pluginName;
+    QVERIFY(!database.getScanResult(QFileInfo(plugin), result, pluginName));
+}
+
+void TestVstScanDatabase::invalidDatabaseFile()
+{
+    QFile file(QDir(cacheDir->path()).absoluteFilePath("vst_scan.bin"));
+    QVERIFY(file.open(QFile::WriteOnly));
+    file.write("not a scan database");
+    file.close();
+
+    VstScanDatabase database(QDir(cacheDir->path()));
+    QVERIFY(!database.load()); // all plugins will be scanned again
+    QCOMPARE(database.size(), 0);
+}
+
+int main(int argc, char *argv[])
+{
+    TestVstScanDatabase test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_VstScanDatabase.moc"
@@ -0,0 +1,19 @@
+QT += testlib
+QT -= gui
+CONFIG += testcase
+CONFIG += c++11
+TEMPLATE = app
+TARGET = vst
+INCLUDEPATH += .
+INCLUDEPATH += ../../../src/Common
+INCLUDEPATH += ../../../src/Standalone
+VPATH += ../../../src/Common
+VPATH += ../../../src/Standalone
+
+# Input
+HEADERS += log/Logging.h
+HEADERS += vst/VstScanDatabase.h
+
+SOURCES += log/logging.cpp
+SOURCES += vst/VstScanDatabase.cpp
+SOURCES += tst_VstScanDatabase.cpp
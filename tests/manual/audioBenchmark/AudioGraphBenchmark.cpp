@@ -0,0 +1,380 @@
+#include "AudioGraphBenchmark.h"
+
+#include "audio/core/AudioDriver.h"
+#include "audio/core/AudioMixer.h"
+#include "audio/core/AudioNode.h"
+#include "audio/NinjamTrackNode.h"
+#include "audio/MetronomeTrackNode.h"
+#include "audio/vorbis/VorbisEncoder.h"
+#include "audio/vorbis/Vorbis.h"
+#include "looper/Looper.h"
+#include "midi/MidiBuffer.h"
+
+#include <QThreadPool>
+
+#include <cmath>
+#include <random>
+
+using audio::AudioLoadMonitor;
+using audio::AudioMixer;
+using audio::Looper;
+using audio::MetronomeTrackNode;
+using audio::NullAudioDriver;
+using audio::SamplesBuffer;
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+const int ENCODED_INTERVALS = 2; // distinct intervals, played in loop by all remote tracks
+const int ENCODING_CHUNK = 4096; // the encoder is fed in chunks, like the encoding thread in NinjamController
+const int INPUT_SIGNAL_SECONDS = 4;
+const int LOOPER_LAYERS = 4;
+
+// deterministic test signal: a sine plus some noise, the noise is more expensive to encode/decode than a pure sine
+void fillSignal(SamplesBuffer &buffer, int sampleRate, double frequency, quint32 seed)
+{
+    std::minstd_rand random(seed);
+    std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+
+    const double phaseIncrement = 2 * PI * frequency / sampleRate;
+    for (int channel = 0; channel < buffer.getChannels(); ++channel) {
+        float *samples = buffer.getSamplesArray(channel);
+        for (uint s = 0; s < buffer.getFrameLenght(); ++s)
+            samples[s] = 0.3f * static_cast<float>(std::sin(phaseIncrement * s + channel)) + noise(random);
+    }
+}
+
+SamplesBuffer createClick(int sampleRate, double frequency)
+{
+    const uint frames = sampleRate * 30 / 1000; // 30 ms
+    const double phaseIncrement = 2 * PI * frequency / sampleRate;
+
+    SamplesBuffer click(2, frames);
+    for (int channel = 0; channel < click.getChannels(); ++channel) {
+        float *samples = click.getSamplesArray(channel);
+        for (uint s = 0; s < frames; ++s)
+            samples[s] = static_cast<float>(std::sin(phaseIncrement * s) * std::exp(-8.0 * s / frames));
+    }
+
+    return click;
+}
+
+} // namespace
+
+/**
+ * The audio path of a LocalInputNode: the node grab a stereo pair from the multi channel input,
+ * the looper is recording before the fader and playing after the fader. LocalInputNode itself
+ * can't be used without a MainController.
+ */
+
+class AudioGraphBenchmark::LocalTrackNode : public audio::AudioNode
+{
+public:
+    LocalTrackNode(int firstInputChannel, Looper::Mode looperMode) :
+        firstInputChannel(firstInputChannel),
+        looper(looperMode, LOOPER_LAYERS)
+    {
+
+    }
+
+    void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, midi::MidiBuffer &midiBuffer) override
+    {
+        internalInputBuffer.setFrameLenght(out.getFrameLenght());
+        internalInputBuffer.set(in, firstInputChannel, 2);
+
+        AudioNode::processReplacing(in, out, sampleRate, midiBuffer);
+    }
+
+    Looper *getLooper()
+    {
+        return &looper;
+    }
+
+protected:
+    void preFaderProcess(SamplesBuffer &out) override
+    {
+        looper.addBuffer(out);
+    }
+
+    void postFaderProcess(SamplesBuffer &out) override
+    {
+        looper.mixToBuffer(out);
+    }
+
+private:
+    int firstInputChannel;
+    Looper looper;
+};
+
+// +++++++++++++++++++++++++++++++++++++++++++
+
+AudioGraphBenchmark::Config::Config() :
+    remoteTracks(8),
+    localTracks(4),
+    seconds(30),
+    sampleRate(48000),
+    remoteSampleRate(44100),
+    bpm(120),
+    bpi(16)
+{
+
+}
+
+AudioGraphBenchmark::Result::Result() :
+    bufferSize(0),
+    frames(0),
+    processingNs(0),
+    remoteTracksNs(0),
+    localTracksNs(0),
+    metronomeNs(0)
+{
+
+}
+
+AudioGraphBenchmark::AudioGraphBenchmark(const Config &config) :
+    config(config),
+    nextEncodedInterval(0),
+    inputSignal(2),
+    metronome(nullptr),
+    intervalPosition(0),
+    intervalStarted(false),
+    stepInput(2),
+    stepOutput(2)
+{
+    encodeIntervals();
+    createInputSignal();
+}
+
+AudioGraphBenchmark::~AudioGraphBenchmark()
+{
+    destroyGraph();
+}
+
+void AudioGraphBenchmark::encodeIntervals()
+{
+    const uint intervalFrames = static_cast<uint>((60.0 / config.bpm) * config.remoteSampleRate * config.bpi);
+
+    SamplesBuffer interval(2, intervalFrames);
+    SamplesBuffer chunk(2, ENCODING_CHUNK);
+
+    for (int i = 0; i < ENCODED_INTERVALS; ++i) {
+        fillSignal(interval, config.remoteSampleRate, 220.0 * (i + 1), i);
+
+        vorbis::Encoder encoder(2, config.remoteSampleRate, vorbis::EncoderQualityNormal);
+        QByteArray encodedInterval;
+        for (uint offset = 0; offset < intervalFrames; offset += ENCODING_CHUNK) {
+            const uint frames = qMin(static_cast<uint>(ENCODING_CHUNK), intervalFrames - offset);
+            chunk.setFrameLenght(frames);
+            chunk.set(interval, offset, frames, 0);
+            encodedInterval.append(encoder.encode(chunk));
+        }
+        encodedInterval.append(encoder.finishIntervalEncoding());
+
+        encodedIntervals.append(encodedInterval);
+    }
+}
+
+void AudioGraphBenchmark::createInputSignal()
+{
+    // a stereo pair for each local track
+    inputSignal = SamplesBuffer(qMax(2, config.localTracks * 2), config.sampleRate * INPUT_SIGNAL_SECONDS);
+    fillSignal(inputSignal, config.sampleRate, 440.0, 1234);
+}
+
+void AudioGraphBenchmark::buildGraph(int bufferSize)
+{
+    destroyGraph();
+
+    audioDriver.reset(new NullAudioDriver());
+    audioDriver->setSampleRate(config.sampleRate);
+    audioDriver->setBufferSize(bufferSize);
+
+    audioMixer.reset(new AudioMixer(config.sampleRate));
+
+    for (int i = 0; i < config.remoteTracks; ++i) {
+        NinjamTrackNode *track = new NinjamTrackNode(i);
+        if (i % 2)
+            track->setLowCutState(NinjamTrackNode::NORMAl);
+
+        track->setPan(i % 2 ? -0.5f : 0.5f);
+        remoteTracks.append(track);
+        audioMixer->addNode(track);
+    }
+
+    const long samplesInInterval = getSamplesInInterval();
+
+    SamplesBuffer layerSamples(2, samplesInInterval);
+    for (int i = 0; i < config.localTracks; ++i) {
+        const bool playingLayers = i % 2 == 0;
+        LocalTrackNode *track = new LocalTrackNode(i * 2, playingLayers ? Looper::AllLayers : Looper::Sequence);
+        Looper *looper = track->getLooper();
+        looper->startNewCycle(samplesInInterval);
+        if (playingLayers) {
+            for (quint8 layer = 0; layer < LOOPER_LAYERS; ++layer) {
+                fillSignal(layerSamples, config.sampleRate, 110.0 * (layer + 1), i * LOOPER_LAYERS + layer);
+                looper->setLayerSamples(layer, layerSamples);
+            }
+            looper->play();
+        }
+        else {
+            looper->toggleRecording(); // the recording starts in the next cycle
+        }
+
+        localTracks.append(track);
+        audioMixer->addNode(track);
+    }
+
+    QSharedPointer<audio::MetronomeSounds> clicks(new audio::MetronomeSounds());
+    clicks->firstBeat = createClick(config.sampleRate, 1760.0);
+    clicks->offBeat = createClick(config.sampleRate, 880.0);
+    clicks->accentBeat = createClick(config.sampleRate, 1320.0);
+
+    metronome = new MetronomeTrackNode(clicks);
+    metronome->setSamplesPerBeat(getSamplesPerBeat());
+    metronome->setBeatsPerAccent(4, config.bpi);
+    audioMixer->addNode(metronome);
+
+    stepInput = SamplesBuffer(inputSignal.getChannels(), bufferSize);
+    stepOutput = SamplesBuffer(2, bufferSize);
+
+    intervalPosition = 0;
+    intervalStarted = false;
+    nextEncodedInterval = 0;
+
+    sendNextInterval(); // the first interval is 'downloaded' before the audio starts
+}
+
+void AudioGraphBenchmark::destroyGraph()
+{
+    audioMixer.reset();
+    audioDriver.reset();
+
+    qDeleteAll(remoteTracks);
+    remoteTracks.clear();
+
+    qDeleteAll(localTracks);
+    localTracks.clear();
+
+    delete metronome;
+    metronome = nullptr;
+}
+
+void AudioGraphBenchmark::sendNextInterval()
+{
+    const QByteArray &encodedInterval = encodedIntervals.at(nextEncodedInterval);
+    nextEncodedInterval = (nextEncodedInterval + 1) % encodedIntervals.size();
+
+    for (NinjamTrackNode *track : remoteTracks)
+        track->addVorbisEncodedInterval(encodedInterval);
+
+    // the first samples are decoded in the thread pool, waiting to keep the runs deterministic
+    QThreadPool::globalInstance()->waitForDone();
+}
+
+void AudioGraphBenchmark::handleNewInterval()
+{
+    for (NinjamTrackNode *track : remoteTracks)
+        track->startNewInterval();
+
+    const long samplesInInterval = getSamplesInInterval();
+    for (LocalTrackNode *track : localTracks)
+        track->getLooper()->startNewCycle(samplesInInterval);
+
+    intervalStarted = true;
+}
+
+// the same interval handling done in NinjamController::process
+void AudioGraphBenchmark::processCallback(const SamplesBuffer &in, SamplesBuffer &out)
+{
+    static const midi::MidiBuffer midiBuffer; // no midi input
+
+    const int sampleRate = audioDriver->getSampleRate();
+    const long samplesInInterval = getSamplesInInterval();
+    const int totalSamplesToProcess = out.getFrameLenght();
+    int offset = 0;
+
+    while (offset < totalSamplesToProcess) {
+        const int samplesToProcessInThisStep = qMin(static_cast<int>(samplesInInterval - intervalPosition),
+                                                    totalSamplesToProcess - offset);
+
+        stepInput.setFrameLenght(samplesToProcessInThisStep);
+        stepInput.set(in, offset, samplesToProcessInThisStep, 0);
+
+        stepOutput.setFrameLenght(samplesToProcessInThisStep);
+        stepOutput.zero();
+
+        if (intervalPosition == 0)
+            handleNewInterval();
+
+        metronome->setIntervalPosition(intervalPosition);
+
+        const bool isLastPart = intervalPosition + samplesToProcessInThisStep >= samplesInInterval;
+        for (NinjamTrackNode *track : remoteTracks)
+            track->setProcessingLastPartOfInterval(isLastPart);
+
+        audioMixer->process(stepInput, stepOutput, sampleRate, midiBuffer);
+        out.add(stepOutput, offset);
+
+        offset += samplesToProcessInThisStep;
+        intervalPosition = (intervalPosition + samplesToProcessInThisStep) % samplesInInterval;
+    }
+}
+
+void AudioGraphBenchmark::takeNodesTime(Result &result)
+{
+    for (NinjamTrackNode *track : remoteTracks)
+        result.remoteTracksNs += track->getProcessingTime().takeElapsed();
+
+    for (LocalTrackNode *track : localTracks)
+        result.localTracksNs += track->getProcessingTime().takeElapsed();
+
+    result.metronomeNs += metronome->getProcessingTime().takeElapsed();
+}
+
+AudioGraphBenchmark::Result AudioGraphBenchmark::run(int bufferSize)
+{
+    buildGraph(bufferSize);
+
+    Result result;
+    result.bufferSize = bufferSize;
+
+    const qint64 callbacks = (static_cast<qint64>(config.seconds) * config.sampleRate + bufferSize - 1) / bufferSize;
+    const qint64 deadline = static_cast<qint64>(bufferSize) * 1000000000 / config.sampleRate;
+    AudioLoadMonitor loadMonitor(callbacks * deadline); // a single window covering the entire run
+
+    SamplesBuffer in(inputSignal.getChannels(), bufferSize);
+    SamplesBuffer out(2, bufferSize);
+    uint inputPosition = 0;
+
+    for (qint64 callback = 0; callback < callbacks; ++callback) {
+
+        // the audio driver work, not measured
+        if (inputPosition + bufferSize > inputSignal.getFrameLenght())
+            inputPosition = 0;
+        in.set(inputSignal, inputPosition, bufferSize, 0);
+        inputPosition += bufferSize;
+        out.zero();
+
+        const qint64 start = AudioLoadMonitor::timestamp();
+        processCallback(in, out);
+        const qint64 end = AudioLoadMonitor::timestamp();
+
+        loadMonitor.addCallback(start, end, bufferSize, config.sampleRate);
+        result.processingNs += end - start;
+        result.frames += bufferSize;
+
+        takeNodesTime(result); // in each callback because the nodes counters are wrapping
+
+        if (intervalStarted) {
+            intervalStarted = false;
+            sendNextInterval();
+        }
+    }
+
+    loadMonitor.takeStats(result.callbacks);
+
+    destroyGraph();
+
+    return result;
+}
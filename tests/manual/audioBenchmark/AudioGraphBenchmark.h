@@ -0,0 +1,137 @@
+#ifndef AUDIO_GRAPH_BENCHMARK_H
+#define AUDIO_GRAPH_BENCHMARK_H
+
+#include "audio/core/AudioLoadMonitor.h"
+#include "audio/core/SamplesBuffer.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QScopedPointer>
+
+class NinjamTrackNode;
+
+namespace audio {
+class AudioMixer;
+class AudioNode;
+class MetronomeTrackNode;
+class NullAudioDriver;
+class Looper;
+}
+
+/**
+ * Headless audio engine benchmark. Builds the same graph used by MainController in a ninjam
+ * session (remote tracks decoding vorbis intervals, local inputs with loopers and the metronome,
+ * all mixed by an AudioMixer) without audio device and server, and drives the audio callback
+ * faster than real time using deterministic synthetic audio.
+ */
+
+class AudioGraphBenchmark
+{
+public:
+    struct Config
+    {
+        Config();
+
+        int remoteTracks;
+        int localTracks; // half of the local tracks are playing looper layers, the other half are recording
+        int seconds; // audio rendered for each buffer size
+        int sampleRate;
+        int remoteSampleRate; // when different from 'sampleRate' the remote tracks are resampled
+        int bpm;
+        int bpi;
+    };
+
+    struct Result
+    {
+        Result();
+
+        int bufferSize;
+        qint64 frames;
+        qint64 processingNs; // the sum of all callbacks duration
+        audio::AudioLoadMonitor::Stats callbacks;
+
+        // per stage CPU time
+        qint64 remoteTracksNs;
+        qint64 localTracksNs;
+        qint64 metronomeNs;
+
+        qint64 getOtherNs() const; // interval handling, mixing and everything not measured in nodes
+        double getFramesPerSecond() const;
+        double getRealtimeFactor(int sampleRate) const; // how many times faster than real time
+    };
+
+    explicit AudioGraphBenchmark(const Config &config);
+    ~AudioGraphBenchmark();
+
+    Result run(int bufferSize); // the graph is rebuilt for each run
+
+    const Config &getConfig() const;
+
+private:
+    class LocalTrackNode;
+
+    void encodeIntervals();
+    void createInputSignal();
+    void buildGraph(int bufferSize);
+    void destroyGraph();
+
+    void processCallback(const audio::SamplesBuffer &in, audio::SamplesBuffer &out);
+    void handleNewInterval();
+    void sendNextInterval(); // simulate the intervals downloaded from the server
+    void takeNodesTime(Result &result);
+
+    long getSamplesInInterval() const;
+    long getSamplesPerBeat() const;
+
+    Config config;
+
+    QList<QByteArray> encodedIntervals; // pre encoded, shared by all remote tracks
+    int nextEncodedInterval;
+
+    audio::SamplesBuffer inputSignal; // a few seconds of multi channel input, played in loop
+
+    QScopedPointer<audio::NullAudioDriver> audioDriver;
+    QScopedPointer<audio::AudioMixer> audioMixer;
+    QList<NinjamTrackNode *> remoteTracks;
+    QList<LocalTrackNode *> localTracks;
+    audio::MetronomeTrackNode *metronome;
+
+    long intervalPosition;
+    bool intervalStarted; // at least one interval was started in the last callback
+
+    // preallocated, the callback is split in interval boundaries
+    audio::SamplesBuffer stepInput;
+    audio::SamplesBuffer stepOutput;
+};
+
+inline const AudioGraphBenchmark::Config &AudioGraphBenchmark::getConfig() const
+{
+    return config;
+}
+
+inline long AudioGraphBenchmark::getSamplesPerBeat() const
+{
+    return (60.0 / config.bpm) * config.sampleRate;
+}
+
+inline long AudioGraphBenchmark::getSamplesInInterval() const
+{
+    return getSamplesPerBeat() * config.bpi;
+}
+
+inline qint64 AudioGraphBenchmark::Result::getOtherNs() const
+{
+    return qMax(static_cast<qint64>(0), processingNs - remoteTracksNs - localTracksNs - metronomeNs);
+}
+
+inline double AudioGraphBenchmark::Result::getFramesPerSecond() const
+{
+    return processingNs > 0 ? frames * 1000000000.0 / processingNs : 0.0;
+}
+
+inline double AudioGraphBenchmark::Result::getRealtimeFactor(int sampleRate) const
+{
+    return sampleRate > 0 ? getFramesPerSecond() / sampleRate : 0.0;
+}
+
+#endif
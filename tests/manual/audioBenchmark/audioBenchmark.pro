@@ -0,0 +1,107 @@
+QT += core concurrent
+QT -= gui
+TEMPLATE = app
+TARGET = audioBenchmark
+
+CONFIG += c++11
+CONFIG += console
+CONFIG -= app_bundle
+
+ROOT_PATH = "../../.."
+
+INCLUDEPATH += .
+INCLUDEPATH += $$ROOT_PATH/src/Common
+INCLUDEPATH += $$ROOT_PATH/libs/includes/ogg
+INCLUDEPATH += $$ROOT_PATH/libs/includes/vorbis
+INCLUDEPATH += $$ROOT_PATH/libs/includes/minimp3
+
+VPATH += $$ROOT_PATH/src/Common
+
+HEADERS += AudioGraphBenchmark.h
+HEADERS += audio/core/AudioNode.h
+HEADERS += audio/core/AudioNodeProcessor.h
+HEADERS += audio/core/AudioDriver.h
+HEADERS += audio/core/AudioMixer.h
+HEADERS += audio/core/SamplesBuffer.h
+HEADERS += audio/core/AudioPeak.h
+HEADERS += audio/core/PeaksTelemetry.h
+HEADERS += audio/core/Filters.h
+HEADERS += audio/core/AudioLoadMonitor.h
+HEADERS += audio/NinjamTrackNode.h
+HEADERS += audio/MetronomeTrackNode.h
+HEADERS += audio/MetronomeSoundBank.h
+HEADERS += audio/Resampler.h
+HEADERS += audio/SamplesBufferResampler.h
+HEADERS += audio/Mp3Decoder.h
+HEADERS += audio/vorbis/VorbisDecoder.h
+HEADERS += audio/vorbis/VorbisEncoder.h
+HEADERS += file/FileReaderFactory.h
+HEADERS += file/WaveFileReader.h
+HEADERS += file/OggFileReader.h
+HEADERS += file/Mp3FileReader.h
+HEADERS += looper/Looper.h
+HEADERS += looper/LooperStates.h
+HEADERS += looper/LooperLayer.h
+HEADERS += looper/PeaksPyramid.h
+HEADERS += looper/LayersMixer.h
+HEADERS += looper/CompactSamples.h
+HEADERS += midi/MidiBuffer.h
+HEADERS += midi/MidiMessage.h
+HEADERS += MetronomeUtils.h
+HEADERS += log/Logging.h
+
+SOURCES += audio/core/AudioNode.cpp
+SOURCES += audio/core/AudioNodeProcessor.cpp
+SOURCES += audio/core/AudioDriver.cpp
+SOURCES += audio/core/AudioMixer.cpp
+SOURCES += audio/core/SamplesBuffer.cpp
+SOURCES += audio/core/AudioPeak.cpp
+SOURCES += audio/core/PeaksTelemetry.cpp
+SOURCES += audio/core/Filters.cpp
+SOURCES += audio/core/AudioLoadMonitor.cpp
+SOURCES += audio/NinjamTrackNode.cpp
+SOURCES += audio/MetronomeTrackNode.cpp
+SOURCES += audio/Resampler.cpp
+SOURCES += audio/SamplesBufferResampler.cpp
+SOURCES += audio/Mp3Decoder.cpp
+SOURCES += audio/vorbis/VorbisDecoder.cpp
+SOURCES += audio/vorbis/VorbisEncoder.cpp
+SOURCES += file/FileReaderFactory.cpp
+SOURCES += file/WaveFileReader.cpp
+SOURCES += file/OggFileReader.cpp
+SOURCES += file/Mp3FileReader.cpp
+SOURCES += looper/Looper.cpp
+SOURCES += looper/LooperStates.cpp
+SOURCES += looper/LooperLayer.cpp
+SOURCES += looper/PeaksPyramid.cpp
+SOURCES += looper/LayersMixer.cpp
+SOURCES += looper/CompactSamples.cpp
+SOURCES += midi/MidiBuffer.cpp
+SOURCES += midi/MidiMessage.cpp
+SOURCES += MetronomeUtils.cpp
+SOURCES += log/logging.cpp
+
+SOURCES += AudioGraphBenchmark.cpp
+SOURCES += main.cpp
+
+win32 {
+    contains(QMAKE_TARGET.arch, x86_64) {
+        LIBS_PATH = "static/win64-msvc"
+    } else {
+        LIBS_PATH = "static/win32-msvc"
+    }
+}
+
+macx {
+    LIBS_PATH = "static/mac64"
+}
+
+linux {
+    contains(QMAKE_HOST.arch, x86_64) {
+        LIBS_PATH = "static/linux64"
+    } else {
+        LIBS_PATH = "static/linux32"
+    }
+}
+
+LIBS += -L$$PWD/$$ROOT_PATH/libs/$$LIBS_PATH -lminimp3 -lvorbisfile -lvorbisenc -lvorbis -logg
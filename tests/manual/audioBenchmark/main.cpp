@@ -0,0 +1,113 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QStringList>
+
+#include "AudioGraphBenchmark.h"
+
+/**
+ * Usage example, failing (exit code 1) when some buffer size is processed slower than 20x real time:
+ *
+ *      audioBenchmark --remote-tracks 16 --local-tracks 4 --buffer-sizes 64,256 --min-realtime-factor 20
+ */
+
+namespace {
+
+double toMilliseconds(qint64 nanoseconds)
+{
+    return nanoseconds / 1000000.0;
+}
+
+double toPercent(qint64 value, qint64 total)
+{
+    return total > 0 ? value * 100.0 / total : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("audioBenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Offline (faster than real time) Jamtaba audio engine benchmark.");
+    parser.addHelpOption();
+
+    AudioGraphBenchmark::Config config;
+
+    QCommandLineOption remoteTracksOption("remote-tracks", "Remote ninjam tracks decoding vorbis intervals.", "count", QString::number(config.remoteTracks));
+    QCommandLineOption localTracksOption("local-tracks", "Local input tracks with loopers.", "count", QString::number(config.localTracks));
+    QCommandLineOption secondsOption("seconds", "Seconds of audio rendered for each buffer size.", "seconds", QString::number(config.seconds));
+    QCommandLineOption sampleRateOption("sample-rate", "Audio driver sample rate.", "rate", QString::number(config.sampleRate));
+    QCommandLineOption remoteSampleRateOption("remote-sample-rate", "Sample rate of the remote intervals.", "rate", QString::number(config.remoteSampleRate));
+    QCommandLineOption bufferSizesOption("buffer-sizes", "Comma separated buffer sizes.", "sizes", "64,128,256,512");
+    QCommandLineOption minRealtimeFactorOption("min-realtime-factor", "Fail when some buffer size is processed slower than this real time factor.", "factor", "0");
+
+    parser.addOption(remoteTracksOption);
+    parser.addOption(localTracksOption);
+    parser.addOption(secondsOption);
+    parser.addOption(sampleRateOption);
+    parser.addOption(remoteSampleRateOption);
+    parser.addOption(bufferSizesOption);
+    parser.addOption(minRealtimeFactorOption);
+
+    parser.process(app);
+
+    config.remoteTracks = qMax(0, parser.value(remoteTracksOption).toInt());
+    config.localTracks = qMax(0, parser.value(localTracksOption).toInt());
+    config.seconds = qMax(1, parser.value(secondsOption).toInt());
+    config.sampleRate = qMax(8000, parser.value(sampleRateOption).toInt());
+    config.remoteSampleRate = qMax(8000, parser.value(remoteSampleRateOption).toInt());
+
+    QList<int> bufferSizes;
+    for (const QString &size : parser.value(bufferSizesOption).split(',', QString::SkipEmptyParts)) {
+        const int bufferSize = size.trimmed().toInt();
+        if (bufferSize > 0)
+            bufferSizes.append(bufferSize);
+    }
+
+    const double minRealtimeFactor = parser.value(minRealtimeFactorOption).toDouble();
+
+    QTextStream out(stdout);
+
+    out << QString("remote tracks: %1 (%2 Hz) local tracks: %3 sample rate: %4 Hz audio per buffer size: %5 s")
+           .arg(config.remoteTracks)
+           .arg(config.remoteSampleRate)
+           .arg(config.localTracks)
+           .arg(config.sampleRate)
+           .arg(config.seconds) << endl;
+
+    out << "buffer  frames/s      x realtime  avg ms   p99 ms   max ms   misses  remote%  local%  metro%  other%" << endl;
+
+    AudioGraphBenchmark benchmark(config);
+
+    bool failed = false;
+    for (int bufferSize : bufferSizes) {
+        const AudioGraphBenchmark::Result result = benchmark.run(bufferSize);
+        const double realtimeFactor = result.getRealtimeFactor(config.sampleRate);
+
+        out << QString("%1  %2  %3  %4  %5  %6  %7  %8  %9  %10  %11")
+               .arg(result.bufferSize, 6)
+               .arg(result.getFramesPerSecond(), 12, 'f', 0)
+               .arg(realtimeFactor, 10, 'f', 1)
+               .arg(toMilliseconds(result.callbacks.averageNs), 7, 'f', 3)
+               .arg(toMilliseconds(result.callbacks.p99Ns), 7, 'f', 3)
+               .arg(toMilliseconds(result.callbacks.maxNs), 7, 'f', 3)
+               .arg(result.callbacks.deadlineMisses, 6)
+               .arg(toPercent(result.remoteTracksNs, result.processingNs), 7, 'f', 1)
+               .arg(toPercent(result.localTracksNs, result.processingNs), 6, 'f', 1)
+               .arg(toPercent(result.metronomeNs, result.processingNs), 6, 'f', 1)
+               .arg(toPercent(result.getOtherNs(), result.processingNs), 6, 'f', 1) << endl;
+
+        if (realtimeFactor < minRealtimeFactor) {
+            out << QString("FAIL: buffer size %1 is processed at %2x real time, the minimum is %3x")
+                   .arg(bufferSize)
+                   .arg(realtimeFactor, 0, 'f', 1)
+                   .arg(minRealtimeFactor, 0, 'f', 1) << endl;
+            failed = true;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
@@ -1,4 +1,4 @@
-QT += core gui widgets network
+QT += core gui widgets network concurrent
 
 CONFIG += testcase
 TEMPLATE = app
@@ -10,19 +10,23 @@ INCLUDEPATH += ../../../src/Common/gui/chat
 VPATH += ../../../src/Common
 
 HEADERS += log/logging.h
+HEADERS += log/StartupTimeline.h
 HEADERS += gui/chat/ChatMessagePanel.h
 HEADERS += gui/chat/ChatPanel.h
 HEADERS += gui/chat/EmojiWidget.h
 HEADERS += gui/chat/ChatTextEditor.h
+HEADERS += gui/chat/KeywordMatcher.h
 HEADERS += gui/UsersColorsPool.h
 HEADERS += geo/IpToLocationResolver.h
 
 SOURCES += log/logging.cpp
+SOURCES += log/StartupTimeline.cpp
 SOURCES += gui/chat/ChatMessagePanel.cpp
 SOURCES += gui/chat/ChatPanel.cpp
 SOURCES += gui/chat/ChatTextEditor.cpp
 SOURCES += gui/chat/EmojiWidget.cpp
 SOURCES += gui/chat/EmojiManager.cpp
+SOURCES += gui/chat/KeywordMatcher.cpp
 SOURCES += gui/IconFactory.cpp
 SOURCES += gui/UsersColorsPool.cpp
 SOURCES += ninjam/client/User.cpp
@@ -0,0 +1,25 @@
+QT += core
+QT -= gui
+TEMPLATE = app
+TARGET = filterBenchmark
+
+CONFIG += c++11
+CONFIG += console
+CONFIG -= app_bundle
+
+ROOT_PATH = "../../.."
+
+INCLUDEPATH += .
+INCLUDEPATH += $$ROOT_PATH/src/Common
+
+VPATH += $$ROOT_PATH/src/Common
+
+HEADERS += audio/core/Filters.h
+HEADERS += audio/core/SamplesBuffer.h
+HEADERS += audio/core/AudioPeak.h
+
+SOURCES += audio/core/Filters.cpp
+SOURCES += audio/core/SamplesBuffer.cpp
+SOURCES += audio/core/AudioPeak.cpp
+
+SOURCES += main.cpp
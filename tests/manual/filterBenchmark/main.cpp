@@ -0,0 +1,163 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+
+#include <cmath>
+#include <functional>
+
+#include "audio/core/Filters.h"
+
+using audio::Filter;
+using audio::FilterBank;
+
+/**
+ * Micro benchmark of the remote tracks low cut filters: the per channel Filter::process() loop versus the
+ * FilterBank processing the track channels together (2 lanes) and all the tracks channels together.
+ *
+ *      filterBenchmark --tracks 16 --buffer-size 128
+ */
+
+namespace {
+
+const double LOW_CUT_FREQUENCY = 120.0;
+
+typedef QVector<QVector<float>> Channels;
+
+Channels createNoise(int channels, int frames)
+{
+    Channels noise(channels, QVector<float>(frames));
+    quint32 seed = 1;
+    for (QVector<float> &channel : noise) {
+        for (float &sample : channel) {
+            seed = seed * 1664525 + 1013904223;
+            sample = (seed >> 8) / 16777216.0f - 0.5f;
+        }
+    }
+    return noise;
+}
+
+// process the entire signal in 'bufferSize' chunks, returning the elapsed nanoseconds
+qint64 run(Channels &channels, int bufferSize, std::function<void(QVector<float *> &, int)> processBuffer)
+{
+    const int frames = channels.first().size();
+    QVector<float *> pointers(channels.size());
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int offset = 0; offset < frames; offset += bufferSize) {
+        for (int c = 0; c < channels.size(); ++c)
+            pointers[c] = channels[c].data() + offset;
+
+        processBuffer(pointers, qMin(bufferSize, frames - offset));
+    }
+
+    return timer.nsecsElapsed();
+}
+
+float getMaxDifference(const Channels &a, const Channels &b)
+{
+    float maxDifference = 0;
+    for (int c = 0; c < a.size(); ++c) {
+        for (int s = 0; s < a[c].size(); ++s)
+            maxDifference = qMax(maxDifference, std::fabs(a[c][s] - b[c][s]));
+    }
+    return maxDifference;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("filterBenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Low cut filters benchmark, per channel biquads versus the multi channel filter bank.");
+    parser.addHelpOption();
+
+    QCommandLineOption tracksOption("tracks", "Stereo remote tracks.", "count", "8");
+    QCommandLineOption bufferSizeOption("buffer-size", "Audio buffer size.", "frames", "256");
+    QCommandLineOption secondsOption("seconds", "Seconds of audio processed.", "seconds", "60");
+    QCommandLineOption sampleRateOption("sample-rate", "Sample rate.", "rate", "48000");
+
+    parser.addOption(tracksOption);
+    parser.addOption(bufferSizeOption);
+    parser.addOption(secondsOption);
+    parser.addOption(sampleRateOption);
+
+    parser.process(app);
+
+    const int tracks = qMax(1, parser.value(tracksOption).toInt());
+    const int bufferSize = qMax(1, parser.value(bufferSizeOption).toInt());
+    const int seconds = qMax(1, parser.value(secondsOption).toInt());
+    const int sampleRate = qMax(8000, parser.value(sampleRateOption).toInt());
+
+    const int channels = tracks * 2;
+    const Channels input = createNoise(channels, seconds * sampleRate);
+
+    // the current low cut, a Filter per channel
+    Channels perChannelOutput = input;
+    QVector<Filter> filters;
+    for (int c = 0; c < channels; ++c)
+        filters.append(Filter(Filter::HighPass, sampleRate, LOW_CUT_FREQUENCY));
+
+    const qint64 perChannelNs = run(perChannelOutput, bufferSize, [&](QVector<float *> &buffers, int frames) {
+        for (int c = 0; c < channels; ++c)
+            filters[c].process(buffers[c], frames);
+    });
+
+    // a filter bank per track, the left and right channels are processed together
+    Channels perTrackOutput = input;
+    QVector<FilterBank> trackBanks;
+    for (int t = 0; t < tracks; ++t)
+        trackBanks.append(FilterBank(Filter::HighPass, sampleRate, LOW_CUT_FREQUENCY));
+
+    const qint64 perTrackNs = run(perTrackOutput, bufferSize, [&](QVector<float *> &buffers, int frames) {
+        for (int t = 0; t < tracks; ++t)
+            trackBanks[t].process(buffers.data() + t * 2, 2, frames);
+    });
+
+    // all tracks channels in the same filter banks, MAX_LANES channels in each bank
+    Channels batchedOutput = input;
+    QVector<FilterBank> batchedBanks;
+    for (int c = 0; c < channels; c += FilterBank::MAX_LANES)
+        batchedBanks.append(FilterBank(Filter::HighPass, sampleRate, LOW_CUT_FREQUENCY));
+
+    const qint64 batchedNs = run(batchedOutput, bufferSize, [&](QVector<float *> &buffers, int frames) {
+        for (int b = 0; b < batchedBanks.size(); ++b) {
+            const int firstChannel = b * FilterBank::MAX_LANES;
+            const int lanes = qMin(static_cast<int>(FilterBank::MAX_LANES), channels - firstChannel);
+            batchedBanks[b].process(buffers.data() + firstChannel, lanes, frames);
+        }
+    });
+
+    const double totalSamples = static_cast<double>(channels) * input.first().size();
+
+    QTextStream out(stdout);
+
+    out << QString("tracks: %1 (%2 channels) buffer size: %3 sample rate: %4 Hz audio: %5 s")
+           .arg(tracks)
+           .arg(channels)
+           .arg(bufferSize)
+           .arg(sampleRate)
+           .arg(seconds) << endl;
+
+    out << "method                 ns/sample  speedup  max difference" << endl;
+
+    auto printResult = [&](const QString &method, qint64 ns, const Channels &output) {
+        out << QString("%1  %2  %3  %4")
+               .arg(method, -21)
+               .arg(ns / totalSamples, 9, 'f', 3)
+               .arg(static_cast<double>(perChannelNs) / ns, 6, 'f', 2)
+               .arg(getMaxDifference(perChannelOutput, output), 14, 'g', 3) << endl;
+    };
+
+    printResult("Filter per channel", perChannelNs, perChannelOutput);
+    printResult("FilterBank per track", perTrackNs, perTrackOutput);
+    printResult("FilterBank batched", batchedNs, batchedOutput);
+
+    return 0;
+}
@@ -1,7 +1,9 @@
 TEMPLATE = subdirs
 
 
+SUBDIRS += audioBenchmark
 SUBDIRS += chat
+SUBDIRS += filterBenchmark
 SUBDIRS += IntervalProgress
 #SUBDIRS += jamWindow  # Problem in RtMidi constructor
 SUBDIRS += map
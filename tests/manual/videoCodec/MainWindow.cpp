@@ -13,7 +13,6 @@
 
 
 MainWindow::MainWindow() :
-    demuxer(nullptr),
     muxer(nullptr)
 {
     QGridLayout *mainLayout = createWidgets();
@@ -37,22 +36,21 @@ MainWindow::MainWindow() :
     connect(muxer, &FFMpegMuxer::dataEncoded, [=](const QByteArray &data, bool isFirstPacket){
 
         if (isFirstPacket && !encodedData.isEmpty()) {
-            if (demuxer)
-                demuxer->deleteLater();
+            FFMpegDemuxer demuxer(encodedData);
+            QImage image;
+            while (demuxer.decodeNextFrame(image)) {
+                decodedImages << image;
+                image = QImage(); // the decoded image is not reused
+            }
 
-            demuxer = new FFMpegDemuxer(nullptr, encodedData);
+            uint frameRate = demuxer.getFrameRate();
+            qDebug() << "decoded images:" << demuxer.getDecodedFrames() << " rate:" << frameRate;
 
-            connect(demuxer, &FFMpegDemuxer::imagesDecoded, this, [=](const QList<QImage> &images, uint frameRate) {
-                qDebug() << "decoded images:" << images.size() << " rate:" << frameRate;
-                decodedImages << images;
+            if (frameRate > 0) {
+                timer->setInterval(1000/frameRate);
+                timer->start();
+            }
 
-                if (frameRate > 0) {
-                    timer->setInterval(1000/frameRate);
-                    timer->start();
-                }
-            });
-
-            demuxer->decode();
             encodedData.clear();
         }
 
@@ -34,7 +34,6 @@ private:
     void initializeCamera(QGridLayout *layout);
 
     FFMpegMuxer *muxer;
-    FFMpegDemuxer *demuxer;
 
     QByteArray encodedData;
 
@@ -1,6 +1,7 @@
 #include <QObject>
 #include <QtTest/QtTest>
 #include <QImage>
+#include <QElapsedTimer>
 
 #include "FFMpegMuxer.h"
 #include "FFMpegDemuxer.h"
@@ -19,6 +20,10 @@ public:
 private slots:
     void encodeDecode();
 
+    // RGB to YUV conversion speed (frames per second) in the camera resolutions
+    void colorConversion();
+    void colorConversion_data();
+
 private:
     FFMpegMuxer *muxer;
 };
@@ -44,14 +49,14 @@ void TestVideoCodec::encodeDecode()
             //    file.write(encodedData);
             //    file.close();
 
-            FFMpegDemuxer demuxer(nullptr, encodedData);
-            QObject::connect(&demuxer, &FFMpegDemuxer::imagesDecoded, [&](QList<QImage> images, uint fps){
-                qDebug() << "images decoded:" << images.size() << " fps:" << fps;
-                QCOMPARE((uint)frameRate, fps);
-                QCOMPARE((quint64)images.size(), framesToEncode);
-            });
+            FFMpegDemuxer demuxer(encodedData);
+            QImage image;
+            while (demuxer.decodeNextFrame(image)) // the same image is reused in all frames
+                QVERIFY(!image.isNull());
 
-            demuxer.decode();
+            qDebug() << "images decoded:" << demuxer.getDecodedFrames() << " fps:" << demuxer.getFrameRate();
+            QCOMPARE((uint)frameRate, demuxer.getFrameRate());
+            QCOMPARE((quint64)demuxer.getDecodedFrames(), framesToEncode);
         }
     });
 
@@ -78,6 +83,56 @@ void TestVideoCodec::encodeDecode()
 }
 
 
+void TestVideoCodec::colorConversion_data()
+{
+    QTest::addColumn<QSize>("resolution");
+    QTest::addColumn<int>("mode");
+
+    const QList<QSize> resolutions = { QSize(160, 120), QSize(320, 180), QSize(320, 240), QSize(640, 480) };
+    for (const QSize &resolution : resolutions) {
+        QString resolutionName = QString("%1x%2").arg(resolution.width()).arg(resolution.height());
+
+        QTest::newRow(qPrintable(resolutionName + " fast")) << resolution << static_cast<int>(ImageToYuvConverter::FastConversion);
+        QTest::newRow(qPrintable(resolutionName + " swscale")) << resolution << static_cast<int>(ImageToYuvConverter::SwsScaleConversion);
+    }
+}
+
+void TestVideoCodec::colorConversion()
+{
+    QFETCH(QSize, resolution);
+    QFETCH(int, mode);
+
+    QImage image(resolution, QImage::Format_RGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x)
+            line[x] = qRgb(rand() % 255, rand() % 255, rand() % 255);
+    }
+
+    AVFrame *frame = av_frame_alloc();
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = resolution.width();
+    frame->height = resolution.height();
+    QCOMPARE(av_frame_get_buffer(frame, 32), 0);
+
+    ImageToYuvConverter converter(static_cast<ImageToYuvConverter::Mode>(mode));
+
+    QElapsedTimer timer;
+    quint64 convertedFrames = 0;
+    timer.start();
+
+    QBENCHMARK {
+        converter.convert(image, frame);
+        convertedFrames++;
+    }
+
+    const qint64 elapsed = timer.nsecsElapsed();
+    if (elapsed > 0)
+        qDebug() << QTest::currentDataTag() << convertedFrames * 1000000000.0 / elapsed << "frames/sec";
+
+    av_frame_free(&frame);
+}
+
 int main(int argc, char *argv[])
 {
     int status = 0;